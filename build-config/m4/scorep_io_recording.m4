@@ -3,7 +3,7 @@
 ##
 ## This file is part of the Score-P software (http://www.score-p.org)
 ##
-## Copyright (c) 2015-2017, 2020,
+## Copyright (c) 2015-2017, 2020, 2024,
 ## Technische Universitaet Dresden, Germany
 ##
 ## Copyright (c) 2022,
@@ -29,11 +29,14 @@ AC_DEFUN([_SCOREP_IO_RECORDING_POSIX_CHECK_SYMBOLS], [
 SCOREP_CHECK_SYMBOLS([POSIX I/O], [], $1,
            [close,
             closedir,
+            copy_file_range,
             creat,
             creat64,
             dup,
             dup2,
             dup3,
+            fallocate,
+            fallocate64,
             fclose,
             fcntl,
             fdatasync,
@@ -64,6 +67,11 @@ SCOREP_CHECK_SYMBOLS([POSIX I/O], [], $1,
             lockf,
             lseek,
             lseek64,
+            madvise,
+            mmap,
+            mmap64,
+            msync,
+            munmap,
             open,
             open64,
             openat,
@@ -89,6 +97,9 @@ SCOREP_CHECK_SYMBOLS([POSIX I/O], [], $1,
             rewind,
             scanf,
             select,
+            sendfile,
+            sendfile64,
+            splice,
             sync,
             syncfs,
             ungetc,
@@ -129,6 +140,7 @@ AFS_SUMMARY_PUSH
 
 scorep_posix_io_support="yes"
 scorep_posix_io_summary_reason=
+scorep_io_uring_support="no"
 
 # check for library wrapping support
 AS_IF([test x"${scorep_libwrap_linktime_support}" != x"yes" &&
@@ -151,7 +163,17 @@ AC_SCOREP_COND_HAVE([POSIX_IO_SUPPORT],
                              [cray*], [# as we do not check for vfprintf corresponding symbol should not be defined
                                      AC_DEFINE([HAVE_POSIX_IO_SYMBOL_VFPRINTF], [0])
                                      AC_DEFINE([HAVE_POSIX_IO_SYMBOL_FPRINTF], [0])],
-                             [SCOREP_CHECK_SYMBOLS([POSIX I/O], [], [scorep_posix_io_wrap_symbols], [vfprintf,fprintf])])])
+                             [SCOREP_CHECK_SYMBOLS([POSIX I/O], [], [scorep_posix_io_wrap_symbols], [vfprintf,fprintf])])
+                     # io_uring has no libc interface, 'syscall' is only wrapped to record it
+                     AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[#include <sys/syscall.h>
+#include <linux/io_uring.h>]],
+                                                        [[long numbers[] = { SYS_io_uring_setup, SYS_io_uring_enter };]])],
+                                       [SCOREP_CHECK_SYMBOLS([POSIX I/O], [], [scorep_posix_io_wrap_symbols], [syscall])
+                                        AS_CASE([" ${scorep_posix_io_wrap_symbols} "],
+                                                [*" syscall "*], [scorep_io_uring_support="yes"])])])
+
+AM_CONDITIONAL([HAVE_IO_URING_SUPPORT],
+               [test x"${scorep_io_uring_support}" = x"yes"])
 
 AFS_SUMMARY_POP([POSIX I/O support], [${scorep_posix_io_support}${scorep_posix_io_summary_reason}])
 
@@ -9,7 +9,7 @@
 ## Copyright (c) 2009-2012,
 ## Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
 ##
-## Copyright (c) 2009-2012, 2014-2017, 2020,
+## Copyright (c) 2009-2012, 2014-2017, 2020, 2024,
 ## Technische Universitaet Dresden, Germany
 ##
 ## Copyright (c) 2009-2012,
@@ -73,6 +73,18 @@ AC_CHECK_TYPE([siginfo_t],
               [has_sampling_siginfo_t="yes"],
               [has_sampling_siginfo_t="no"],
               [[#include <signal.h>]])
+
+AC_MSG_CHECKING([for per-thread CPU-time timers])
+AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <signal.h>
+#include <time.h>]],
+                                [[struct sigevent event;
+timer_t         timer;
+event.sigev_notify = SIGEV_THREAD_ID;
+return timer_create( CLOCK_THREAD_CPUTIME_ID, &event, &timer );]])],
+               [AC_MSG_RESULT([yes])
+                has_sampling_thread_timer="yes"],
+               [AC_MSG_RESULT([no])
+                has_sampling_thread_timer="no"])
 CPPFLAGS="${cppflags_save}"
 
 AC_LANG_POP([C])
@@ -126,7 +138,7 @@ AS_IF([test "x${scorep_return_address}" != x0], [
 AS_IF([test "x${scorep_unwinding_support}" = "xyes"],
       [save_CPPFLAGS=$CPPFLAGS
        CPPFLAGS="$CPPFLAGS ${SCOREP_LIBUNWIND_CPPFLAGS}"
-       AC_CHECK_DECLS([unw_init_local2, unw_init_local_signal, unw_strerror],
+       AC_CHECK_DECLS([unw_init_local2, unw_init_local_signal, unw_strerror, unw_get_proc_name_by_ip],
                       [], [], [[#define UNW_LOCAL_ONLY
 #include <libunwind.h>
 ]])
@@ -153,7 +165,11 @@ AC_SCOREP_COND_HAVE([SAMPLING_SUPPORT],
                             test "x${has_sampling_siginfo_t}" = "xyes"],
                            [AC_DEFINE([HAVE_SAMPLING_SIGACTION], [1],
                                       [Defined if struct member sigaction.sa_sigaction and type siginfo_t are available.])
-                            sampling_summary+=", sa_sigaction"])],
+                            sampling_summary+=", sa_sigaction"
+                            AS_IF([test "x${has_sampling_thread_timer}" = "xyes"],
+                                  [AC_DEFINE([HAVE_SAMPLING_THREAD_TIMER], [1],
+                                             [Defined if per-thread CPU-time timers are available.])
+                                   sampling_summary+=", thread timer"])])],
                     [has_sampling="no"
                      AS_IF([test "x${have_interrupt_generators}" = "xno"],
                            [sampling_summary="no, cannot find any interrupt generator"],
@@ -186,6 +202,8 @@ dnl check will fail, used version provides unw_init_local2
 ac_cv_have_decl_unw_init_local2=yes
 dnl check will fail, used version provides unw_strerror
 ac_cv_have_decl_unw_strerror=yes
+dnl check will fail, used version provides unw_get_proc_name_by_ip
+ac_cv_have_decl_unw_get_proc_name_by_ip=yes
 dnl
 m4_changecom([])
 cat <<_SCOREPEOF > $[]_afs_lib_MAKEFILE
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2011,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2011, 2020,
+ * Copyright (c) 2009-2011, 2020, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2011,
@@ -55,6 +55,7 @@
 #ifndef __cplusplus
 #include <stdbool.h>
 #endif
+#include <stdint.h>
 
 #include <UTILS_Atomic.h>
 
@@ -65,14 +66,16 @@
 #endif /* !GCC_ATOMIC_BUILTINS */
 
 /**
- * A lock object is just a bool. Should be 0-initialized if allocated.
+ * A lock object is a 32 bit word, which can be used as a futex. It is 0 if
+ * unlocked, 1 if locked, and 2 if locked and waiters may be parked. Should
+ * be 0-initialized if allocated.
  */
-typedef bool UTILS_Mutex;
+typedef uint32_t UTILS_Mutex;
 
 /**
  * Initialize an mutex variable to the unlocked state.
  */
-#define UTILS_MUTEX_INIT false
+#define UTILS_MUTEX_INIT 0
 
 
 UTILS_BEGIN_C_DECLS
@@ -96,6 +99,51 @@ STATIC_INLINE void
 UTILS_MutexWait( UTILS_Mutex*          mutex,
                  UTILS_Atomic_Memorder memorder );
 
+/* Waiting strategies of the contended path of UTILS_MutexLock() */
+typedef enum UTILS_MutexMode
+{
+    /* Spin until the mutex is unlocked, the default. */
+    UTILS_MUTEX_MODE_SPIN = 1,
+    /* Spin for a bounded number of iterations, then park on a futex. Yields
+     * instead of parking on systems without futexes. */
+    UTILS_MUTEX_MODE_ADAPTIVE
+} UTILS_MutexMode;
+
+/* Selects the waiting strategy for all mutexes of the package and whether
+ * contention is counted for UTILS_MutexForEachContended(). Until called,
+ * waiters spin and nothing is counted. */
+#define UTILS_MutexConfigure PACKAGE_MANGLE_NAME( UTILS_MutexConfigure )
+void
+UTILS_MutexConfigure( UTILS_MutexMode mode,
+                      uint32_t        spinCount,
+                      bool            countContention );
+
+/* Contended part of UTILS_MutexLock(). Spins for a bounded number of
+ * iterations and then parks the caller, if the adaptive mode was selected
+ * with UTILS_MutexConfigure(). */
+#define UTILS_MutexLockContended PACKAGE_MANGLE_NAME( UTILS_MutexLockContended )
+void
+UTILS_MutexLockContended( UTILS_Mutex* mutex );
+
+/* Wakes one parked waiter of the just unlocked @a mutex. */
+#define UTILS_MutexWakeWaiter PACKAGE_MANGLE_NAME( UTILS_MutexWakeWaiter )
+void
+UTILS_MutexWakeWaiter( UTILS_Mutex* mutex );
+
+/* Called for every contended mutex from UTILS_MutexForEachContended(). */
+typedef void ( * UTILS_MutexContentionCallback )( const UTILS_Mutex* mutex,
+                                                  uint64_t           contended,
+                                                  uint64_t           parked,
+                                                  void*              arg );
+
+/* Reports how often the first contended mutexes of the process had to wait
+ * in UTILS_MutexLock() and how often the waiter was parked. Reports nothing,
+ * unless counting was enabled with UTILS_MutexConfigure(). */
+#define UTILS_MutexForEachContended PACKAGE_MANGLE_NAME( UTILS_MutexForEachContended )
+void
+UTILS_MutexForEachContended( UTILS_MutexContentionCallback callback,
+                             void*                         arg );
+
 UTILS_END_C_DECLS
 
 
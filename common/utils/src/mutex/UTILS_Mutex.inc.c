@@ -4,7 +4,7 @@
  * Copyright (c) 2020-2022,
  * Forschungszentrum Juelich GmbH, Germany
  *
- * Copyright (c) 2020,
+ * Copyright (c) 2020, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -26,18 +26,12 @@ UTILS_MutexLock( UTILS_Mutex* mutex )
 {
     UTILS_BUG_ON( mutex == NULL, "Invalid mutex handle given." );
 
-    /* test-and-test-and-set lock */
-    while ( true )
+    uint32_t unlocked = 0;
+    if ( !UTILS_Atomic_CompareExchangeN_uint32( mutex, &unlocked, 1, false,
+                                                UTILS_ATOMIC_ACQUIRE,
+                                                UTILS_ATOMIC_RELAXED ) )
     {
-        while ( UTILS_Atomic_LoadN_bool( mutex, UTILS_ATOMIC_RELAXED ) == true )
-        {
-            UTILS_CPU_RELAX;
-        }
-        if ( UTILS_Atomic_TestAndSet( mutex, UTILS_ATOMIC_ACQUIRE ) != true )
-        {
-            break;
-        }
-        UTILS_CPU_RELAX;
+        UTILS_MutexLockContended( mutex );
     }
 }
 
@@ -46,13 +40,16 @@ UTILS_MutexTrylock( UTILS_Mutex* mutex )
 {
     UTILS_BUG_ON( mutex == NULL, "Invalid mutex handle given." );
 
-    if ( UTILS_Atomic_LoadN_bool( mutex, UTILS_ATOMIC_RELAXED ) == true )
+    if ( UTILS_Atomic_LoadN_uint32( mutex, UTILS_ATOMIC_RELAXED ) != 0 )
     {
         UTILS_CPU_RELAX;
         return false;
     }
 
-    if ( UTILS_Atomic_TestAndSet( mutex, UTILS_ATOMIC_ACQUIRE ) == true )
+    uint32_t unlocked = 0;
+    if ( !UTILS_Atomic_CompareExchangeN_uint32( mutex, &unlocked, 1, false,
+                                                UTILS_ATOMIC_ACQUIRE,
+                                                UTILS_ATOMIC_RELAXED ) )
     {
         UTILS_CPU_RELAX;
         return false;
@@ -66,7 +63,11 @@ UTILS_MutexUnlock( UTILS_Mutex* mutex )
 {
     UTILS_BUG_ON( mutex == NULL, "Invalid mutex handle given." );
 
-    UTILS_Atomic_clear( mutex, UTILS_ATOMIC_RELEASE );
+    /* Waiters only park after setting the state to 2 */
+    if ( UTILS_Atomic_ExchangeN_uint32( mutex, 0, UTILS_ATOMIC_RELEASE ) == 2 )
+    {
+        UTILS_MutexWakeWaiter( mutex );
+    }
 }
 
 STATIC_INLINE void
@@ -74,7 +75,7 @@ UTILS_MutexWait( UTILS_Mutex* mutex, UTILS_Atomic_Memorder memorder )
 {
     UTILS_BUG_ON( mutex == NULL, "Invalid mutex handle given." );
 
-    while ( UTILS_Atomic_LoadN_bool( mutex, ( memorder ) ) == true )
+    while ( UTILS_Atomic_LoadN_uint32( mutex, ( memorder ) ) != 0 )
     {
         UTILS_CPU_RELAX;
     }
@@ -0,0 +1,193 @@
+/*
+ * This file is part of the Score-P software ecosystem (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+
+/**
+ * @file
+ *
+ * The contended path of UTILS_MutexLock().
+ *
+ * In the default 'spin' mode, waiters spin until the mutex is unlocked. In
+ * the 'adaptive' mode, waiters spin for a bounded number of iterations and
+ * then park on a futex, thus a descheduled lock holder does not let its
+ * waiters burn whole time slices. The mode is selected by the package with
+ * UTILS_MutexConfigure(), e.g., from its configuration variables.
+ */
+
+
+#include <config.h>
+
+#include <UTILS_Mutex.h>
+#include <UTILS_Error.h>
+
+#if defined( __linux__ )
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+
+#define DEFAULT_SPIN_COUNT 1000
+
+/* Number of mutexes with contention statistics, later ones are not counted. */
+#define CONTENTION_TABLE_SIZE 64
+
+
+static uint32_t mutex_mode       = UTILS_MUTEX_MODE_SPIN;
+static uint32_t mutex_spin_count = DEFAULT_SPIN_COUNT;
+static bool     count_contention;
+
+
+typedef struct contention_entry
+{
+    void*    mutex;
+    uint64_t contended;
+    uint64_t parked;
+} contention_entry;
+
+static contention_entry contention_table[ CONTENTION_TABLE_SIZE ];
+
+
+void
+UTILS_MutexConfigure( UTILS_MutexMode mode,
+                      uint32_t        spinCount,
+                      bool            countContention )
+{
+    UTILS_BUG_ON( mode != UTILS_MUTEX_MODE_SPIN && mode != UTILS_MUTEX_MODE_ADAPTIVE,
+                  "Invalid mutex mode %d", ( int )mode );
+
+    UTILS_Atomic_StoreN_uint32( &mutex_spin_count, spinCount, UTILS_ATOMIC_RELAXED );
+    UTILS_Atomic_StoreN_bool( &count_contention, countContention, UTILS_ATOMIC_RELAXED );
+    UTILS_Atomic_StoreN_uint32( &mutex_mode, mode, UTILS_ATOMIC_RELAXED );
+}
+
+
+static contention_entry*
+get_contention_entry( UTILS_Mutex* mutex )
+{
+    /* Entries are never removed, a mutex is counted in its first free slot. */
+    for ( uint32_t i = 0; i < CONTENTION_TABLE_SIZE; i++ )
+    {
+        void* current = UTILS_Atomic_LoadN_void_ptr( &contention_table[ i ].mutex,
+                                                     UTILS_ATOMIC_ACQUIRE );
+        if ( current == NULL )
+        {
+            if ( UTILS_Atomic_CompareExchangeN_void_ptr( &contention_table[ i ].mutex,
+                                                         &current, mutex, false,
+                                                         UTILS_ATOMIC_ACQUIRE_RELEASE,
+                                                         UTILS_ATOMIC_ACQUIRE ) )
+            {
+                return &contention_table[ i ];
+            }
+        }
+        if ( current == mutex )
+        {
+            return &contention_table[ i ];
+        }
+    }
+    return NULL;
+}
+
+
+static void
+park( UTILS_Mutex* mutex )
+{
+#if defined( __linux__ )
+    /* Returns immediately, if the mutex is not in the parked state anymore. */
+    syscall( SYS_futex, mutex, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0 );
+#else
+    sched_yield();
+#endif
+}
+
+
+void
+UTILS_MutexLockContended( UTILS_Mutex* mutex )
+{
+    uint32_t mode = UTILS_Atomic_LoadN_uint32( &mutex_mode, UTILS_ATOMIC_RELAXED );
+
+    /* The table scan is only paid for, if the statistics were requested */
+    contention_entry* entry = NULL;
+    if ( UTILS_Atomic_LoadN_bool( &count_contention, UTILS_ATOMIC_RELAXED ) )
+    {
+        entry = get_contention_entry( mutex );
+    }
+    if ( entry )
+    {
+        UTILS_Atomic_AddFetch_uint64( &entry->contended, 1, UTILS_ATOMIC_RELAXED );
+    }
+
+    /* test-and-test-and-set, bounded in the adaptive mode */
+    uint32_t spin_count = UTILS_Atomic_LoadN_uint32( &mutex_spin_count, UTILS_ATOMIC_RELAXED );
+    for ( uint32_t i = 0; mode == UTILS_MUTEX_MODE_SPIN || i < spin_count; i++ )
+    {
+        uint32_t state = UTILS_Atomic_LoadN_uint32( mutex, UTILS_ATOMIC_RELAXED );
+        if ( state == 0
+             && UTILS_Atomic_CompareExchangeN_uint32( mutex, &state, 1, false,
+                                                      UTILS_ATOMIC_ACQUIRE,
+                                                      UTILS_ATOMIC_RELAXED ) )
+        {
+            return;
+        }
+        if ( state == 2 && mode == UTILS_MUTEX_MODE_ADAPTIVE )
+        {
+            /* There are already parked waiters, do not overtake them for long */
+            break;
+        }
+        UTILS_CPU_RELAX;
+    }
+
+    /* Mark the mutex as having parked waiters, we own it if it was unlocked. */
+    while ( UTILS_Atomic_ExchangeN_uint32( mutex, 2, UTILS_ATOMIC_ACQUIRE ) != 0 )
+    {
+        if ( entry )
+        {
+            UTILS_Atomic_AddFetch_uint64( &entry->parked, 1, UTILS_ATOMIC_RELAXED );
+        }
+        park( mutex );
+    }
+}
+
+
+void
+UTILS_MutexWakeWaiter( UTILS_Mutex* mutex )
+{
+#if defined( __linux__ )
+    syscall( SYS_futex, mutex, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+#endif
+}
+
+
+void
+UTILS_MutexForEachContended( UTILS_MutexContentionCallback callback,
+                             void*                         arg )
+{
+    UTILS_ASSERT( callback );
+
+    for ( uint32_t i = 0; i < CONTENTION_TABLE_SIZE; i++ )
+    {
+        void* mutex = UTILS_Atomic_LoadN_void_ptr( &contention_table[ i ].mutex,
+                                                   UTILS_ATOMIC_ACQUIRE );
+        if ( mutex == NULL )
+        {
+            break;
+        }
+        callback( mutex,
+                  UTILS_Atomic_LoadN_uint64( &contention_table[ i ].contended,
+                                             UTILS_ATOMIC_RELAXED ),
+                  UTILS_Atomic_LoadN_uint64( &contention_table[ i ].parked,
+                                             UTILS_ATOMIC_RELAXED ),
+                  arg );
+    }
+}
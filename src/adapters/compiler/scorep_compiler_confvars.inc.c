@@ -0,0 +1,51 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+
+/**
+ * @file
+ *
+ *
+ */
+
+bool scorep_compiler_defer_region_names;
+
+/*
+ *  Configuration variables for the COMPILER adapter.
+ */
+static const SCOREP_ConfigVariable scorep_compiler_confvars[] = {
+    {
+        "defer_region_names",
+        SCOREP_CONFIG_TYPE_BOOL,
+        &scorep_compiler_defer_region_names,
+        NULL,
+        "false",
+        "Resolve the names of instrumented functions at the end of the measurement",
+        "Applies to compiler instrumentation which identifies functions by\n"
+        "their address. By default, the first enter of a function looks up\n"
+        "its name and source code location in the debug information,\n"
+        "demangles the name and matches it against the filter, which slows\n"
+        "down the first iteration of an application considerably.\n"
+        "If enabled, the first enter only looks up the function's symbol\n"
+        "name, to exclude Score-P internal and compiler-generated functions,\n"
+        "and defines the region by its offset in the shared object. The\n"
+        "names and source code locations of all regions are looked up and\n"
+        "demangled in bulk before the unification, or when the shared object\n"
+        "gets dlclosed. Until then, the regions are named by their offset.\n"
+        "As the filter needs the names at the first enter, this option is\n"
+        "ignored if a filter file is given. The exclusion only considers the\n"
+        "mangled names of the functions. Other features selecting regions\n"
+        "by name during the measurement do not apply to these regions, e.g.,\n"
+        "SCOREP_PROFILING_CLUSTERED_REGION."
+    },
+    SCOREP_CONFIG_TERMINATOR
+};
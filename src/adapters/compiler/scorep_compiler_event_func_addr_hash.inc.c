@@ -4,6 +4,9 @@
  * Copyright (c) 2021-2023,
  * Forschungszentrum Juelich GmbH, Germany
  *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
  * This software may be modified and distributed under the terms of
  * a BSD-style license.  See the COPYING file in the package base
  * directory for details.
@@ -17,12 +20,16 @@
 
 #include <SCOREP_FastHashtab.h>
 #include <SCOREP_Addr2line.h>
+#include <SCOREP_Memory.h>
+
+#include <UTILS_Mutex.h>
 
 #include <jenkins_hash.h>
 
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <inttypes.h>
 #include <fnmatch.h>
 
@@ -91,10 +98,150 @@ func_addr_hash_free_chunk( void* chunk )
     SCOREP_Memory_AlignedFree( chunk );
 }
 
+/* Regions defined by their shared object and offset only, see
+   scorep_compiler_func_addr_hash_defer_region_names(). Their names
+   and source code locations are resolved in bulk later on. */
+typedef struct deferred_region deferred_region;
+struct deferred_region
+{
+    SCOREP_RegionHandle region;
+    void*               so_handle;
+    uintptr_t           offset;
+    deferred_region*    next;
+};
+
+static bool             defer_region_names;
+static deferred_region* deferred_regions;
+static UTILS_Mutex      deferred_regions_mutex = UTILS_MUTEX_INIT;
+
+
+static func_addr_hash_value_t
+define_deferred_region( uintptr_t addr )
+{
+    void*       so_handle;
+    const char* so_file_name;
+    uintptr_t   so_base_addr;
+    uint16_t    so_token_unused;
+
+    /* Async-signal-safe binary search, does not touch the debug information. */
+    SCOREP_Addr2line_LookupSo( addr,
+                               &so_handle,
+                               &so_file_name,
+                               &so_base_addr,
+                               &so_token_unused );
+    if ( so_handle == NULL )
+    {
+        UTILS_DEBUG( "[table-insert] %" PRIuPTR " filtered: unknown shared object", addr );
+        return SCOREP_FILTERED_REGION;
+    }
+
+    /* The symbol table provides the mangled name for the exclusion of
+       compiler-generated functions, without the debug information. */
+    const char* function_name;
+    if ( !SCOREP_Addr2line_SoLookupFunctionName( addr - so_base_addr,
+                                                 so_handle,
+                                                 &function_name ) )
+    {
+        UTILS_DEBUG( "[table-insert] %" PRIuPTR " filtered: no function symbol", addr );
+        return SCOREP_FILTERED_REGION;
+    }
+#if HAVE( PLATFORM_MAC )
+    /* Skip these leading underscores on macOS */
+    if ( '_' == function_name[ 0 ] )
+    {
+        function_name++;
+    }
+#endif  /*HAVE( PLATFORM_MAC )*/
+    if ( func_addr_hash_match_function_name( function_name ) )
+    {
+        UTILS_DEBUG( "[table-insert] %" PRIuPTR " filtered: %s", addr, function_name );
+        return SCOREP_FILTERED_REGION;
+    }
+
+    deferred_region* entry = SCOREP_Memory_AllocForMisc( sizeof( *entry ) );
+    entry->so_handle = so_handle;
+    entry->offset    = addr - so_base_addr;
+
+    /* The placeholder name remains if the lookup fails later on. Other than
+       the address, the offset is the same in all processes. */
+    char placeholder_name[ 2 + 2 * sizeof( uintptr_t ) + 1 ];
+    snprintf( placeholder_name, sizeof( placeholder_name ), "0x%" PRIxPTR, entry->offset );
+    entry->region = SCOREP_Definitions_NewRegion( placeholder_name,
+                                                  NULL,
+                                                  SCOREP_Definitions_NewSourceFile( so_file_name ),
+                                                  SCOREP_INVALID_LINE_NO,
+                                                  SCOREP_INVALID_LINE_NO,
+                                                  SCOREP_PARADIGM_COMPILER,
+                                                  SCOREP_REGION_FUNCTION );
+    UTILS_DEBUG( "[table-insert] %" PRIuPTR " deferred: %s@%s",
+                 addr, placeholder_name, so_file_name );
+
+    UTILS_MutexLock( &deferred_regions_mutex );
+    entry->next      = deferred_regions;
+    deferred_regions = entry;
+    UTILS_MutexUnlock( &deferred_regions_mutex );
+
+    return entry->region;
+}
+
+
+static void
+resolve_deferred_region( const deferred_region* entry )
+{
+    const char* so_file_name_unused;
+    uint16_t    so_token_unused;
+
+    bool        scl_found;
+    const char* file_name     = NULL;
+    const char* function_name = NULL;
+    unsigned    line_no       = SCOREP_INVALID_LINE_NO;
+
+    SCOREP_Addr2line_SoLookupAddr( entry->offset,
+                                   entry->so_handle,
+                                   &so_file_name_unused,
+                                   &so_token_unused,
+                                   &scl_found,
+                                   &file_name,
+                                   &function_name,
+                                   &line_no );
+    if ( !scl_found || function_name == NULL )
+    {
+        UTILS_DEBUG( "[deferred] %s not found",
+                     SCOREP_RegionHandle_GetName( entry->region ) );
+        return;
+    }
+
+#if HAVE( PLATFORM_MAC )
+    /* Skip these leading underscores on macOS */
+    if ( '_' == function_name[ 0 ] )
+    {
+        function_name++;
+    }
+#endif  /*HAVE( PLATFORM_MAC )*/
+
+    char* function_name_demangled;
+    scorep_compiler_demangle( function_name, function_name_demangled );
+    UTILS_DEBUG( "[deferred] %s resolved: %s(%s)@%s:%d",
+                 SCOREP_RegionHandle_GetName( entry->region ),
+                 function_name_demangled, function_name, file_name, line_no );
+    SCOREP_RegionHandle_SetNameAndLocation( entry->region,
+                                            function_name_demangled,
+                                            function_name,
+                                            SCOREP_Definitions_NewSourceFile( file_name ),
+                                            line_no );
+    scorep_compiler_demangle_free( function_name, function_name_demangled );
+}
+
+
 static func_addr_hash_value_t
 func_addr_hash_value_ctor( func_addr_hash_key_t* addr,
                            const void*           ctorDataUnused )
 {
+    if ( defer_region_names )
+    {
+        return define_deferred_region( *addr );
+    }
+
     void*       so_handle_unused;
     const char* so_file_name_unused;
     uintptr_t   so_base_addr_unused;
@@ -196,6 +343,47 @@ scorep_compiler_func_addr_hash_dlclose_cb( void*       soHandle,
                    "shared object is dlopened and addressees are reused, the "
                    "compiler adapter might enter/exit regions referring to "
                    "wrong source code locations", soFileName );
+
+    /* The debug information of the object is still available, resolve
+       the regions of the object before it is gone. */
+    UTILS_MutexLock( &deferred_regions_mutex );
+    deferred_region** entry = &deferred_regions;
+    while ( *entry )
+    {
+        if ( ( *entry )->so_handle == soHandle )
+        {
+            resolve_deferred_region( *entry );
+            *entry = ( *entry )->next;
+        }
+        else
+        {
+            entry = &( *entry )->next;
+        }
+    }
+    UTILS_MutexUnlock( &deferred_regions_mutex );
+}
+
+
+void
+scorep_compiler_func_addr_hash_defer_region_names( void )
+{
+    defer_region_names = true;
+}
+
+
+void
+scorep_compiler_func_addr_hash_resolve_deferred_regions( void )
+{
+    UTILS_MutexLock( &deferred_regions_mutex );
+    deferred_region* entry = deferred_regions;
+    deferred_regions = NULL;
+    UTILS_MutexUnlock( &deferred_regions_mutex );
+
+    while ( entry )
+    {
+        resolve_deferred_region( entry );
+        entry = entry->next;
+    }
 }
 
 
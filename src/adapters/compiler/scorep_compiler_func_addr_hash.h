@@ -4,6 +4,9 @@
  * Copyright (c) 2021,
  * Forschungszentrum Juelich GmbH, Germany
  *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
  * This software may be modified and distributed under the terms of
  * a BSD-style license. See the COPYING file in the package base
  * directory for details.
@@ -22,5 +25,23 @@ scorep_compiler_func_addr_hash_dlclose_cb( void*       soHandle,
                                            uintptr_t   soBaseAddr,
                                            uint16_t    soToken );
 
+/**
+ * From now on, define regions at the first enter by their shared object
+ * and offset only. Only the symbol name is looked up right away, to
+ * exclude functions by name. Their names and source code locations are
+ * resolved by scorep_compiler_func_addr_hash_resolve_deferred_regions(),
+ * or when their shared object gets dlclosed.
+ */
+void
+scorep_compiler_func_addr_hash_defer_region_names( void );
+
+/**
+ * Resolve the names and source code locations of all regions defined
+ * since scorep_compiler_func_addr_hash_defer_region_names(). Needs to be
+ * called before the unification.
+ */
+void
+scorep_compiler_func_addr_hash_resolve_deferred_regions( void );
+
 
 #endif /* SCOREP_COMPILER_FUNC_ADDR_HASH_H */
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2013, 2015, 2020,
+ * Copyright (c) 2009-2013, 2015, 2020, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -36,10 +36,14 @@
 
 #include <SCOREP_Subsystem.h>
 #include <SCOREP_RuntimeManagement.h>
+#include <SCOREP_Config.h>
+
+#include <stdbool.h>
 
 #define SCOREP_DEBUG_MODULE_NAME COMPILER
 #include <UTILS_Debug.h>
 
+#include "scorep_compiler_confvars.inc.c"
 
 #if HAVE( SCOREP_COMPILER_INSTRUMENTATION_GCC_PLUGIN )
 #include "scorep_compiler_mgmt_gcc_plugin.inc.c"
@@ -50,6 +54,18 @@
 #endif /* HAVE( SCOREP_COMPILER_INSTRUMENTATION_NEEDS_ADDR2LINE ) */
 
 
+/** Registers the required configuration variables of the compiler adapter
+    to the measurement system.
+ */
+static SCOREP_ErrorCode
+compiler_subsystem_register( size_t subsystemId )
+{
+    UTILS_DEBUG( "Register environment variables" );
+
+    return SCOREP_ConfigRegister( "compiler", scorep_compiler_confvars );
+}
+
+
 static SCOREP_ErrorCode
 compiler_subsystem_init( void )
 {
@@ -61,6 +77,7 @@ compiler_subsystem_init( void )
 
 #if HAVE( SCOREP_COMPILER_INSTRUMENTATION_NEEDS_ADDR2LINE )
     func_addr_hash_register_obj_close_cb();
+    func_addr_hash_init_deferred_region_names();
 #endif /* HAVE( SCOREP_COMPILER_INSTRUMENTATION_NEEDS_ADDR2LINE ) */
 
     UTILS_DEBUG_EXIT();
@@ -68,9 +85,22 @@ compiler_subsystem_init( void )
 }
 
 
+static SCOREP_ErrorCode
+compiler_subsystem_pre_unify( void )
+{
+#if HAVE( SCOREP_COMPILER_INSTRUMENTATION_NEEDS_ADDR2LINE )
+    scorep_compiler_func_addr_hash_resolve_deferred_regions();
+#endif /* HAVE( SCOREP_COMPILER_INSTRUMENTATION_NEEDS_ADDR2LINE ) */
+
+    return SCOREP_SUCCESS;
+}
+
+
 /* Implementation of the compiler adapter initialization/finalization struct */
 const SCOREP_Subsystem SCOREP_Subsystem_CompilerAdapter =
 {
-    .subsystem_name = "COMPILER",
-    .subsystem_init = &compiler_subsystem_init,
+    .subsystem_name      = "COMPILER",
+    .subsystem_register  = &compiler_subsystem_register,
+    .subsystem_init      = &compiler_subsystem_init,
+    .subsystem_pre_unify = &compiler_subsystem_pre_unify,
 };
@@ -4,6 +4,9 @@
  * Copyright (c) 2022,
  * Forschungszentrum Juelich GmbH, Germany
  *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
  * This software may be modified and distributed under the terms of
  * a BSD-style license. See the COPYING file in the package base
  * directory for details.
@@ -19,6 +22,9 @@
 
 #include <SCOREP_Addr2line.h>
 #include <SCOREP_RuntimeManagement.h>
+#include <SCOREP_Filtering.h>
+
+#include <UTILS_Error.h>
 
 static void
 func_addr_hash_register_obj_close_cb( void )
@@ -28,3 +34,24 @@ func_addr_hash_register_obj_close_cb( void )
         SCOREP_Addr2line_RegisterObjcloseCb( scorep_compiler_func_addr_hash_dlclose_cb );
     }
 }
+
+static void
+func_addr_hash_init_deferred_region_names( void )
+{
+    if ( !scorep_compiler_defer_region_names )
+    {
+        return;
+    }
+
+    /* The filter decides at the first enter whether a region is recorded,
+       thus it needs the names right away. */
+    if ( SCOREP_Filtering_IsEnabled() )
+    {
+        UTILS_WARNING( "Ignoring SCOREP_COMPILER_DEFER_REGION_NAMES as a filter "
+                       "file is given. Region names are resolved at the first "
+                       "enter of a function." );
+        return;
+    }
+
+    scorep_compiler_func_addr_hash_defer_region_names();
+}
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016-2019,
+ * Copyright (c) 2016-2019, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2022,
@@ -33,11 +33,26 @@
 #include <fcntl.h>
 #include <sys/uio.h>
 #include <sys/select.h>
+#include <sys/mman.h>
+
+#if HAVE( POSIX_IO_SYMBOL_SENDFILE ) || HAVE( POSIX_IO_SYMBOL_SENDFILE64 )
+#include <sys/sendfile.h>
+#endif
 
 #if HAVE( POSIX_AIO_SUPPORT )
 #include <aio.h>
 #endif
 
+/*
+ * io_uring has no libc interface, it is recorded from the raw system calls.
+ * 'syscall' is only wrapped if the kernel headers know about io_uring.
+ */
+#if HAVE( POSIX_IO_SYMBOL_SYSCALL )
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#define HAVE_POSIX_IO_URING_SUPPORT 1
+#endif
+
 /*
  * We need a signed integer of 8 bytes for the 64bit I/O wrapper, but we can not
  * use #define _FILE_OFFSET_BITS 64, as this would remove 'off_t' from the scope.
@@ -135,6 +150,56 @@ scorep_posix_io_isoc_init( void );
 void
 scorep_posix_io_isoc_fini( void );
 
+/**
+ * Records the file-backed memory mapping [@a addr, @a addr + @a length) of
+ * the file descriptor @a fd. The mapping gets its own I/O handle, duplicated
+ * from @a fdHandle, thus it stays valid after @a fd was closed. Existing
+ * mappings in this range are replaced.
+ *
+ * @param addr      Start address of the mapping.
+ * @param length    Length of the mapping in bytes.
+ * @param fd        The mapped file descriptor.
+ * @param fdHandle  The I/O handle of @a fd.
+ * @param offset    File offset of @a addr.
+ */
+void
+scorep_posix_io_mapping_insert( void*                 addr,
+                                size_t                length,
+                                int                   fd,
+                                SCOREP_IoHandleHandle fdHandle,
+                                uint64_t              offset );
+
+/**
+ * Looks up the first recorded mapping overlapping [@a addr, @a addr + @a length).
+ *
+ * @param addr         Start address of the range.
+ * @param length       Length of the range in bytes.
+ * @param[out] handle  The I/O handle of the mapping.
+ * @param[out] offset  File offset of the first mapped byte in the range.
+ *
+ * @return True if there is such a mapping.
+ */
+bool
+scorep_posix_io_mapping_find( const void*            addr,
+                              size_t                 length,
+                              SCOREP_IoHandleHandle* handle,
+                              uint64_t*              offset );
+
+/**
+ * Removes the range [@a addr, @a addr + @a length) from the recorded
+ * mappings. Mappings are trimmed or split as needed, the I/O handle of a
+ * mapping is destroyed once no part of it is left, if requested.
+ *
+ * @param addr            Start address of the unmapped range.
+ * @param length          Length of the unmapped range in bytes.
+ * @param destroyHandles  Whether to destroy the I/O handles of removed
+ *                        mappings, false outside of the measurement.
+ */
+void
+scorep_posix_io_mapping_remove( const void* addr,
+                                size_t      length,
+                                bool        destroyHandles );
+
 #if HAVE( POSIX_AIO_SUPPORT )
 
 void
@@ -154,4 +219,38 @@ scorep_posix_io_aio_request_cancel_all( int                   fd,
 
 #endif
 
+#if HAVE( POSIX_IO_URING_SUPPORT )
+
+/**
+ * Records a request submitted to the io_uring instance @a ringFd.
+ *
+ * @return False if a request with the same @a userData is already in flight,
+ *         it cannot be distinguished from this one then.
+ */
+bool
+scorep_posix_io_uring_request_insert( int                    ringFd,
+                                      uint64_t               userData,
+                                      SCOREP_IoHandleHandle  handle,
+                                      SCOREP_IoOperationMode mode );
+
+/**
+ * Removes the in-flight request @a userData of the io_uring instance
+ * @a ringFd, and provides its I/O handle and operation mode.
+ *
+ * @return True if the request was found.
+ */
+bool
+scorep_posix_io_uring_request_remove( int                     ringFd,
+                                      uint64_t                userData,
+                                      SCOREP_IoHandleHandle*  handle,
+                                      SCOREP_IoOperationMode* mode );
+
+/**
+ * Drops all in-flight requests of the io_uring instance @a ringFd.
+ */
+void
+scorep_posix_io_uring_request_remove_all( int ringFd );
+
+#endif
+
 #endif  /* SCOREP_POSIX_IO_H */
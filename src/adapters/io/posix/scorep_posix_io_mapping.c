@@ -0,0 +1,258 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+/**
+ * @file
+ * @ingroup    POSIX_IO_Wrapper
+ *
+ * @brief Table of the file-backed memory mappings of the POSIX I/O adapter
+ */
+
+#include <config.h>
+
+#include "scorep_posix_io_mapping.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <UTILS_Atomic.h>
+#include <UTILS_Error.h>
+#include <UTILS_Mutex.h>
+
+
+/* The I/O handle of a mapping, shared by all of its parts */
+typedef struct mapping_file
+{
+    SCOREP_IoHandleHandle handle;
+    /* Number of table entries referencing this mapping */
+    uint32_t              entries;
+} mapping_file;
+
+typedef struct mapping_entry
+{
+    uintptr_t     start;
+    uintptr_t     end;
+    uint64_t      offset;
+    mapping_file* file;
+} mapping_entry;
+
+static mapping_entry* mapping_table;
+static uint32_t       mapping_count;
+static uint32_t       mapping_capacity;
+static UTILS_Mutex    mapping_mutex = UTILS_MUTEX_INIT;
+
+/* Index of the first mapping ending after @a addr. */
+static uint32_t
+mapping_lower_bound( uintptr_t addr )
+{
+    uint32_t low  = 0;
+    uint32_t high = mapping_count;
+    while ( low < high )
+    {
+        uint32_t mid = low + ( high - low ) / 2;
+        if ( mapping_table[ mid ].end <= addr )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static bool
+mapping_make_room( uint32_t index )
+{
+    if ( mapping_count == mapping_capacity )
+    {
+        uint32_t       capacity = mapping_capacity ? 2 * mapping_capacity : 16;
+        mapping_entry* table    = realloc( mapping_table, capacity * sizeof( *table ) );
+        if ( !table )
+        {
+            UTILS_ERROR( SCOREP_ERROR_MEM_ALLOC_FAILED,
+                         "Cannot grow the table of memory-mapped files." );
+            return false;
+        }
+        mapping_table    = table;
+        mapping_capacity = capacity;
+    }
+
+    memmove( &mapping_table[ index + 1 ], &mapping_table[ index ],
+             ( mapping_count - index ) * sizeof( *mapping_table ) );
+    UTILS_Atomic_StoreN_uint32( &mapping_count, mapping_count + 1, UTILS_ATOMIC_RELAXED );
+    return true;
+}
+
+static void
+mapping_erase( uint32_t index,
+               bool     releaseHandles )
+{
+    mapping_file* file = mapping_table[ index ].file;
+
+    memmove( &mapping_table[ index ], &mapping_table[ index + 1 ],
+             ( mapping_count - index - 1 ) * sizeof( *mapping_table ) );
+    UTILS_Atomic_StoreN_uint32( &mapping_count, mapping_count - 1, UTILS_ATOMIC_RELAXED );
+
+    if ( --file->entries == 0 )
+    {
+        if ( releaseHandles )
+        {
+            scorep_posix_io_mapping_release( file->handle );
+        }
+        free( file );
+    }
+}
+
+static void
+mapping_remove_range( uintptr_t start,
+                      uintptr_t end,
+                      bool      releaseHandles )
+{
+    uint32_t index = mapping_lower_bound( start );
+    while ( index < mapping_count && mapping_table[ index ].start < end )
+    {
+        mapping_entry* entry = &mapping_table[ index ];
+        if ( entry->start < start && entry->end > end )
+        {
+            /* Punch a hole, the right part goes into a new entry. */
+            if ( !mapping_make_room( index + 1 ) )
+            {
+                /* Keep the left part only. */
+                mapping_table[ index ].end = start;
+                return;
+            }
+            mapping_entry* left  = &mapping_table[ index ];
+            mapping_entry* right = &mapping_table[ index + 1 ];
+            *right         = *left;
+            right->offset += end - right->start;
+            right->start   = end;
+            left->end      = start;
+            left->file->entries++;
+            return;
+        }
+        if ( entry->start < start )
+        {
+            entry->end = start;
+            index++;
+        }
+        else if ( entry->end > end )
+        {
+            entry->offset += end - entry->start;
+            entry->start   = end;
+            return;
+        }
+        else
+        {
+            mapping_erase( index, releaseHandles );
+        }
+    }
+}
+
+bool
+scorep_posix_io_mapping_table_insert( uintptr_t             start,
+                                      uintptr_t             end,
+                                      uint64_t              offset,
+                                      SCOREP_IoHandleHandle handle )
+{
+    mapping_file* file = malloc( sizeof( *file ) );
+    if ( !file )
+    {
+        UTILS_ERROR( SCOREP_ERROR_MEM_ALLOC_FAILED,
+                     "Cannot record the memory-mapped file." );
+        return false;
+    }
+    file->handle  = handle;
+    file->entries = 1;
+
+    UTILS_MutexLock( &mapping_mutex );
+
+    mapping_remove_range( start, end, true );
+
+    uint32_t index    = mapping_lower_bound( start );
+    bool     inserted = mapping_make_room( index );
+    if ( inserted )
+    {
+        mapping_table[ index ].start  = start;
+        mapping_table[ index ].end    = end;
+        mapping_table[ index ].offset = offset;
+        mapping_table[ index ].file   = file;
+    }
+
+    UTILS_MutexUnlock( &mapping_mutex );
+
+    if ( !inserted )
+    {
+        free( file );
+    }
+    return inserted;
+}
+
+bool
+scorep_posix_io_mapping_table_find( uintptr_t              start,
+                                    uintptr_t              end,
+                                    SCOREP_IoHandleHandle* handle,
+                                    uint64_t*              offset )
+{
+    /* Most programs map no files, do not lock for their anonymous memory. */
+    if ( UTILS_Atomic_LoadN_uint32( &mapping_count, UTILS_ATOMIC_RELAXED ) == 0 )
+    {
+        return false;
+    }
+
+    bool found = false;
+
+    UTILS_MutexLock( &mapping_mutex );
+
+    uint32_t index = mapping_lower_bound( start );
+    if ( index < mapping_count && mapping_table[ index ].start < end )
+    {
+        const mapping_entry* entry = &mapping_table[ index ];
+        *handle = entry->file->handle;
+        *offset = entry->offset + ( start > entry->start ? start - entry->start : 0 );
+        found   = true;
+    }
+
+    UTILS_MutexUnlock( &mapping_mutex );
+
+    return found;
+}
+
+void
+scorep_posix_io_mapping_table_remove( uintptr_t start,
+                                      uintptr_t end,
+                                      bool      releaseHandles )
+{
+    if ( UTILS_Atomic_LoadN_uint32( &mapping_count, UTILS_ATOMIC_RELAXED ) == 0 )
+    {
+        return;
+    }
+
+    UTILS_MutexLock( &mapping_mutex );
+    mapping_remove_range( start, end, releaseHandles );
+    UTILS_MutexUnlock( &mapping_mutex );
+}
+
+void
+scorep_posix_io_mapping_table_clear( void )
+{
+    UTILS_MutexLock( &mapping_mutex );
+    while ( mapping_count > 0 )
+    {
+        mapping_erase( mapping_count - 1, false );
+    }
+    free( mapping_table );
+    mapping_table    = NULL;
+    mapping_capacity = 0;
+    UTILS_MutexUnlock( &mapping_mutex );
+}
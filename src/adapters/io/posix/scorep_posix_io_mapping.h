@@ -0,0 +1,82 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+#ifndef SCOREP_POSIX_IO_MAPPING_H
+#define SCOREP_POSIX_IO_MAPPING_H
+
+/**
+ *  @file
+ *
+ *  @brief Table of the file-backed memory mappings of the POSIX I/O adapter.
+ *
+ *  The table is sorted by address and has no overlaps. A mapping, which was
+ *  split by a partial unmap, is represented by several entries sharing the
+ *  I/O handle of the mapping. All functions are thread-safe.
+ */
+
+#include <scorep/SCOREP_PublicHandles.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * Records the mapping [@a start, @a end) with the I/O handle @a handle.
+ * Recorded mappings in this range are replaced.
+ *
+ * @return False if the table could not grow, @a handle is not recorded then.
+ */
+bool
+scorep_posix_io_mapping_table_insert( uintptr_t             start,
+                                      uintptr_t             end,
+                                      uint64_t              offset,
+                                      SCOREP_IoHandleHandle handle );
+
+/**
+ * Looks up the first recorded mapping overlapping [@a start, @a end).
+ *
+ * @param[out] handle  The I/O handle of the mapping.
+ * @param[out] offset  File offset of the first mapped byte in the range.
+ */
+bool
+scorep_posix_io_mapping_table_find( uintptr_t              start,
+                                    uintptr_t              end,
+                                    SCOREP_IoHandleHandle* handle,
+                                    uint64_t*              offset );
+
+/**
+ * Removes the range [@a start, @a end) from the recorded mappings. Mappings
+ * are trimmed or split as needed.
+ *
+ * @param releaseHandles  Whether to call @a scorep_posix_io_mapping_release
+ *                        for mappings without any part left.
+ */
+void
+scorep_posix_io_mapping_table_remove( uintptr_t start,
+                                      uintptr_t end,
+                                      bool      releaseHandles );
+
+/**
+ * Forgets all recorded mappings, without releasing their I/O handles.
+ */
+void
+scorep_posix_io_mapping_table_clear( void );
+
+/**
+ * Called by the table, once no part of the mapping of @a handle is left.
+ * Implemented by the user of the table.
+ */
+void
+scorep_posix_io_mapping_release( SCOREP_IoHandleHandle handle );
+
+
+#endif /* SCOREP_POSIX_IO_MAPPING_H */
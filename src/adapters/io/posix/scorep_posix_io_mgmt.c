@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016-2020,
+ * Copyright (c) 2016-2020, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2022,
@@ -27,8 +27,11 @@
 #include <config.h>
 
 #include "scorep_posix_io.h"
+#include "scorep_posix_io_mapping.h"
 
 #include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
 
 #if HAVE( POSIX_GETRLIMIT )
 #include <sys/resource.h>
@@ -38,6 +41,9 @@
 #include <SCOREP_Events.h>
 #include <SCOREP_FastHashtab.h>
 
+#include <UTILS_Atomic.h>
+#include <UTILS_Error.h>
+
 #define SCOREP_DEBUG_MODULE_NAME IO
 #include <UTILS_Debug.h>
 
@@ -377,9 +383,74 @@ scorep_posix_io_init( void )
                                         SCOREP_IO_STATUS_FLAG_NONE );
 }
 
+/************************** Memory mapping table ******************************/
+
+void
+scorep_posix_io_mapping_release( SCOREP_IoHandleHandle handle )
+{
+    SCOREP_IoDestroyHandle( handle );
+}
+
+void
+scorep_posix_io_mapping_insert( void*                 addr,
+                                size_t                length,
+                                int                   fd,
+                                SCOREP_IoHandleHandle fdHandle,
+                                uint64_t              offset )
+{
+    if ( length == 0 )
+    {
+        return;
+    }
+
+    SCOREP_IoHandleDef*   fd_def = SCOREP_LOCAL_HANDLE_DEREF( fdHandle, IoHandle );
+    SCOREP_IoHandleHandle handle =
+        SCOREP_Definitions_NewIoHandle( SCOREP_StringHandle_Get( fd_def->name_handle ),
+                                        fd_def->file_handle,
+                                        SCOREP_IO_PARADIGM_POSIX,
+                                        SCOREP_IO_HANDLE_FLAG_NONE,
+                                        fd_def->scope_handle,
+                                        fd_def->parent_handle,
+                                        0,
+                                        true,
+                                        0,
+                                        NULL );
+
+    SCOREP_IoStatusFlag status_flags = SCOREP_IO_STATUS_FLAG_NONE;
+    scorep_posix_io_get_scorep_io_flags_from_fd( fd, NULL, NULL, &status_flags );
+    SCOREP_IoDuplicateHandle( fdHandle, handle, status_flags );
+
+    uintptr_t start = ( uintptr_t )addr;
+    if ( !scorep_posix_io_mapping_table_insert( start, start + length, offset, handle ) )
+    {
+        SCOREP_IoDestroyHandle( handle );
+    }
+}
+
+bool
+scorep_posix_io_mapping_find( const void*            addr,
+                              size_t                 length,
+                              SCOREP_IoHandleHandle* handle,
+                              uint64_t*              offset )
+{
+    uintptr_t start = ( uintptr_t )addr;
+    return scorep_posix_io_mapping_table_find( start, start + length, handle, offset );
+}
+
+void
+scorep_posix_io_mapping_remove( const void* addr,
+                                size_t      length,
+                                bool        destroyHandles )
+{
+    uintptr_t start = ( uintptr_t )addr;
+    scorep_posix_io_mapping_table_remove( start, start + length, destroyHandles );
+}
+
 void
 scorep_posix_io_fini( void )
 {
+    scorep_posix_io_mapping_table_clear();
+
     SCOREP_IoMgmt_DeregisterParadigm( SCOREP_IO_PARADIGM_POSIX );
 }
 
@@ -491,3 +562,109 @@ scorep_posix_io_aio_request_cancel_all( int                   fd,
 }
 
 #endif
+
+#if HAVE( POSIX_IO_URING_SUPPORT )
+
+/************************** io_uring request table ****************************/
+
+typedef struct
+{
+    uint64_t ring_fd;
+    uint64_t user_data;
+} uring_request_table_key_t;
+
+typedef struct
+{
+    SCOREP_IoHandleHandle  handle;
+    SCOREP_IoOperationMode mode;
+} uring_request_table_value_t;
+
+#define URING_REQUEST_TABLE_HASH_EXPONENT 8
+
+static inline uint32_t
+uring_request_table_bucket_idx( uring_request_table_key_t key )
+{
+    return jenkins_hash( &key, sizeof( key ), 0 ) & hashmask( URING_REQUEST_TABLE_HASH_EXPONENT );
+}
+
+static inline bool
+uring_request_table_equals( uring_request_table_key_t key1,
+                            uring_request_table_key_t key2 )
+{
+    return key1.ring_fd == key2.ring_fd && key1.user_data == key2.user_data;
+}
+
+static inline void*
+uring_request_table_allocate_chunk( size_t chunkSize )
+{
+    return SCOREP_Memory_AlignedAllocForMisc( SCOREP_CACHELINESIZE, chunkSize );
+}
+
+static inline void
+uring_request_table_free_chunk( void* chunk )
+{
+}
+
+static inline uring_request_table_value_t
+uring_request_table_value_ctor( uring_request_table_key_t* key,
+                                void*                      ctorData )
+{
+    return *( uring_request_table_value_t* )ctorData;
+}
+
+static inline void
+uring_request_table_value_dtor( uring_request_table_key_t   key,
+                                uring_request_table_value_t value )
+{
+}
+
+/* nPairsPerChunk: 16+8 bytes per pair, 0 wasted bytes on x86-64 in 128 bytes */
+SCOREP_HASH_TABLE_NON_MONOTONIC( uring_request_table,
+                                 5,
+                                 hashsize( URING_REQUEST_TABLE_HASH_EXPONENT ) );
+
+bool
+scorep_posix_io_uring_request_insert( int                    ringFd,
+                                      uint64_t               userData,
+                                      SCOREP_IoHandleHandle  handle,
+                                      SCOREP_IoOperationMode mode )
+{
+    uring_request_table_key_t   key   = { .ring_fd = ( uint64_t )ringFd, .user_data = userData };
+    uring_request_table_value_t value = { .handle = handle, .mode = mode };
+    uring_request_table_value_t existing;
+    return uring_request_table_get_and_insert( key, &value, &existing );
+}
+
+bool
+scorep_posix_io_uring_request_remove( int                     ringFd,
+                                      uint64_t                userData,
+                                      SCOREP_IoHandleHandle*  handle,
+                                      SCOREP_IoOperationMode* mode )
+{
+    uring_request_table_key_t   key = { .ring_fd = ( uint64_t )ringFd, .user_data = userData };
+    uring_request_table_value_t value;
+    if ( !uring_request_table_get_and_remove( key, &value ) )
+    {
+        return false;
+    }
+    *handle = value.handle;
+    *mode   = value.mode;
+    return true;
+}
+
+static bool
+uring_request_match_ring( uring_request_table_key_t   key,
+                          uring_request_table_value_t value,
+                          void*                       cbData )
+{
+    return key.ring_fd == *( uint64_t* )cbData;
+}
+
+void
+scorep_posix_io_uring_request_remove_all( int ringFd )
+{
+    uint64_t ring_fd = ( uint64_t )ringFd;
+    uring_request_table_remove_if( uring_request_match_ring, &ring_fd );
+}
+
+#endif
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016,
+ * Copyright (c) 2016, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -33,6 +33,11 @@
 
 #include "scorep_posix_io_function_list.inc"
 
+#if HAVE( POSIX_IO_URING_SUPPORT )
+SCOREP_RegionHandle scorep_posix_io_region_io_uring_setup;
+SCOREP_RegionHandle scorep_posix_io_region_io_uring_enter;
+#endif
+
 
 /**
  * Register POSIX I/O functions and initialize data structures
@@ -50,4 +55,21 @@ scorep_posix_io_register_regions( void )
                                                                    SCOREP_REGION_##TYPE );
 
 #include "scorep_posix_io_function_list.inc"
+
+#if HAVE( POSIX_IO_URING_SUPPORT )
+    scorep_posix_io_region_io_uring_setup = SCOREP_Definitions_NewRegion( "io_uring_setup",
+                                                                          NULL,
+                                                                          SCOREP_Definitions_NewSourceFile( "POSIX_IO" ),
+                                                                          SCOREP_INVALID_LINE_NO,
+                                                                          SCOREP_INVALID_LINE_NO,
+                                                                          SCOREP_PARADIGM_IO,
+                                                                          SCOREP_REGION_FILE_IO_METADATA );
+    scorep_posix_io_region_io_uring_enter = SCOREP_Definitions_NewRegion( "io_uring_enter",
+                                                                          NULL,
+                                                                          SCOREP_Definitions_NewSourceFile( "POSIX_IO" ),
+                                                                          SCOREP_INVALID_LINE_NO,
+                                                                          SCOREP_INVALID_LINE_NO,
+                                                                          SCOREP_PARADIGM_IO,
+                                                                          SCOREP_REGION_FILE_IO );
+#endif
 }
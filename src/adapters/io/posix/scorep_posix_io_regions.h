@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016,
+ * Copyright (c) 2016, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -56,6 +56,12 @@
 
 #include "scorep_posix_io_function_list.inc"
 
+#if HAVE( POSIX_IO_URING_SUPPORT )
+/* io_uring is recorded from the 'syscall' wrapper */
+extern SCOREP_RegionHandle scorep_posix_io_region_io_uring_setup;
+extern SCOREP_RegionHandle scorep_posix_io_region_io_uring_enter;
+#endif
+
 /**
  * Register POSIX I/O functions and initialize data structures
  */
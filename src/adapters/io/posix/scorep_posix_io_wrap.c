@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016-2020, 2023,
+ * Copyright (c) 2016-2020, 2023-2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2021,
@@ -59,6 +59,12 @@
 #endif
 /* *INDENT-ON* */
 
+#if HAVE( POSIX_IO_URING_SUPPORT )
+static void
+posix_io_uring_close( int fd );
+
+#endif
+
 /**
  * @brief Issues one IoOperationBegin event per vector entry.
  */
@@ -115,6 +121,66 @@ posix_io_vector_complete( SCOREP_IoFileHandle    handle,
     }
 }
 
+/**
+ * @brief Issues the IoOperationBegin events of a transfer between two file
+ *        descriptors, i.e., a read on @a inHandle and a write on
+ *        @a outHandle. Both may be invalid, if the descriptor is unknown.
+ *        The write uses its own matching id, as both handles may be the same.
+ */
+static inline void
+posix_io_transfer_begin( SCOREP_IoHandleHandle inHandle,
+                         uint64_t              inOffset,
+                         SCOREP_IoHandleHandle outHandle,
+                         uint64_t              outOffset,
+                         size_t                count )
+{
+    if ( inHandle != SCOREP_INVALID_IO_HANDLE )
+    {
+        SCOREP_IoOperationBegin( inHandle,
+                                 SCOREP_IO_OPERATION_MODE_READ,
+                                 SCOREP_IO_OPERATION_FLAG_NON_COLLECTIVE | SCOREP_IO_OPERATION_FLAG_BLOCKING,
+                                 ( uint64_t )count,
+                                 SCOREP_BLOCKING_IO_OPERATION_MATCHING_ID_POSIX,
+                                 inOffset );
+    }
+    if ( outHandle != SCOREP_INVALID_IO_HANDLE )
+    {
+        SCOREP_IoOperationBegin( outHandle,
+                                 SCOREP_IO_OPERATION_MODE_WRITE,
+                                 SCOREP_IO_OPERATION_FLAG_NON_COLLECTIVE | SCOREP_IO_OPERATION_FLAG_BLOCKING,
+                                 ( uint64_t )count,
+                                 SCOREP_INVALID_BLOCKING_IO_OPERATION_MATCHING_ID + 1,
+                                 outOffset );
+    }
+}
+
+/**
+ * @brief Issues the IoOperationComplete events of a transfer started with
+ *        posix_io_transfer_begin().
+ */
+static inline void
+posix_io_transfer_complete( SCOREP_IoHandleHandle inHandle,
+                            SCOREP_IoHandleHandle outHandle,
+                            ssize_t               transferredBytes )
+{
+    uint64_t bytes = transferredBytes > 0 ? ( uint64_t )transferredBytes : 0;
+
+    if ( inHandle != SCOREP_INVALID_IO_HANDLE )
+    {
+        SCOREP_IoOperationComplete( inHandle,
+                                    SCOREP_IO_OPERATION_MODE_READ,
+                                    bytes,
+                                    SCOREP_BLOCKING_IO_OPERATION_MATCHING_ID_POSIX );
+    }
+    if ( outHandle != SCOREP_INVALID_IO_HANDLE )
+    {
+        SCOREP_IoOperationComplete( outHandle,
+                                    SCOREP_IO_OPERATION_MODE_WRITE,
+                                    bytes,
+                                    SCOREP_INVALID_BLOCKING_IO_OPERATION_MATCHING_ID + 1 );
+    }
+}
+
 /* *******************************************************************
  * Function wrappers
  * ******************************************************************/
@@ -163,6 +229,12 @@ SCOREP_LIBWRAP_FUNC_NAME( close )( int fd )
             }
             SCOREP_IoDestroyHandle( handle );
         }
+#if HAVE( POSIX_IO_URING_SUPPORT )
+        if ( ret == 0 )
+        {
+            posix_io_uring_close( fd );
+        }
+#endif
 
         SCOREP_ExitRegion( scorep_posix_io_region_close );
     }
@@ -2403,6 +2475,551 @@ SCOREP_LIBWRAP_FUNC_NAME( writev )( int fd, const struct iovec* iov, int iovcnt
 }
 #endif
 
+/*
+ * Memory-mapped and zero-copy I/O
+ */
+
+#if HAVE( POSIX_IO_SYMBOL_COPY_FILE_RANGE )
+ssize_t
+SCOREP_LIBWRAP_FUNC_NAME( copy_file_range )( int fd_in, scorep_off64_t* off_in, int fd_out, scorep_off64_t* off_out, size_t len, unsigned int flags )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( copy_file_range );
+    ssize_t ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_copy_file_range );
+
+        /*
+         * Copies up to 'len' bytes from 'fd_in' to 'fd_out' within the kernel.
+         * A non-NULL 'off_in'/'off_out' gives the file offset to use instead
+         * of the file offset of the descriptor.
+         */
+        SCOREP_IoHandleHandle in_handle  = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fd_in );
+        SCOREP_IoHandleHandle out_handle = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fd_out );
+        SCOREP_IoHandleHandle io_handle  = in_handle != SCOREP_INVALID_IO_HANDLE ? in_handle : out_handle;
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        posix_io_transfer_begin( in_handle,
+                                 off_in ? ( uint64_t )*off_in : SCOREP_IO_UNKNOWN_OFFSET,
+                                 out_handle,
+                                 off_out ? ( uint64_t )*off_out : SCOREP_IO_UNKNOWN_OFFSET,
+                                 len );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( copy_file_range,
+                                        ( fd_in, off_in, fd_out, off_out, len, flags ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        posix_io_transfer_complete( in_handle, out_handle, ret );
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_copy_file_range );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( copy_file_range,
+                                        ( fd_in, off_in, fd_out, off_out, len, flags ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_FALLOCATE )
+int
+SCOREP_LIBWRAP_FUNC_NAME( fallocate )( int fd, int mode, off_t offset, off_t len )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( fallocate );
+    int ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_fallocate );
+
+        /*
+         * Allocates or deallocates file space, no data is transferred.
+         */
+        SCOREP_IoHandleHandle io_handle = SCOREP_IoMgmt_GetAndPushHandle( SCOREP_IO_PARADIGM_POSIX, &fd );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( fallocate,
+                                        ( fd, mode, offset, len ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_fallocate );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( fallocate,
+                                        ( fd, mode, offset, len ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_FALLOCATE64 )
+int
+SCOREP_LIBWRAP_FUNC_NAME( fallocate64 )( int fd, int mode, scorep_off64_t offset, scorep_off64_t len )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( fallocate64 );
+    int ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_fallocate64 );
+
+        /*
+         * Allocates or deallocates file space, no data is transferred.
+         */
+        SCOREP_IoHandleHandle io_handle = SCOREP_IoMgmt_GetAndPushHandle( SCOREP_IO_PARADIGM_POSIX, &fd );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( fallocate64,
+                                        ( fd, mode, offset, len ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_fallocate64 );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( fallocate64,
+                                        ( fd, mode, offset, len ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_MADVISE )
+int
+SCOREP_LIBWRAP_FUNC_NAME( madvise )( void* addr, size_t length, int advice )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( madvise );
+    int ret;
+
+    SCOREP_IoHandleHandle io_handle;
+    uint64_t              offset;
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN )
+         && scorep_posix_io_mapping_find( addr, length, &io_handle, &offset ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_madvise );
+
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( madvise,
+                                        ( addr, length, advice ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_madvise );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( madvise,
+                                        ( addr, length, advice ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_MMAP )
+void*
+SCOREP_LIBWRAP_FUNC_NAME( mmap )( void* addr, size_t length, int prot, int flags, int fd, off_t offset )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( mmap );
+    void* ret;
+
+    /* Anonymous mappings are memory allocations, not I/O. */
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN )
+         && fd >= 0 && !( flags & MAP_ANONYMOUS ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_mmap );
+
+        SCOREP_IoHandleHandle io_handle = SCOREP_IoMgmt_GetAndPushHandle( SCOREP_IO_PARADIGM_POSIX, &fd );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( mmap,
+                                        ( addr, length, prot, flags, fd, offset ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        if ( io_handle != SCOREP_INVALID_IO_HANDLE && ret != MAP_FAILED )
+        {
+            scorep_posix_io_mapping_insert( ret, length, fd, io_handle, ( uint64_t )offset );
+        }
+        else if ( ret != MAP_FAILED )
+        {
+            scorep_posix_io_mapping_remove( ret, length, true );
+        }
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_mmap );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( mmap,
+                                        ( addr, length, prot, flags, fd, offset ) );
+        if ( ret != MAP_FAILED )
+        {
+            /* A new mapping, e.g., an anonymous one with MAP_FIXED, replaces
+             * the recorded mappings in its range. */
+            scorep_posix_io_mapping_remove( ret, length,
+                                            trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) );
+        }
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_MMAP64 )
+void*
+SCOREP_LIBWRAP_FUNC_NAME( mmap64 )( void* addr, size_t length, int prot, int flags, int fd, scorep_off64_t offset )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( mmap64 );
+    void* ret;
+
+    /* Anonymous mappings are memory allocations, not I/O. */
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN )
+         && fd >= 0 && !( flags & MAP_ANONYMOUS ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_mmap64 );
+
+        SCOREP_IoHandleHandle io_handle = SCOREP_IoMgmt_GetAndPushHandle( SCOREP_IO_PARADIGM_POSIX, &fd );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( mmap64,
+                                        ( addr, length, prot, flags, fd, offset ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        if ( io_handle != SCOREP_INVALID_IO_HANDLE && ret != MAP_FAILED )
+        {
+            scorep_posix_io_mapping_insert( ret, length, fd, io_handle, ( uint64_t )offset );
+        }
+        else if ( ret != MAP_FAILED )
+        {
+            scorep_posix_io_mapping_remove( ret, length, true );
+        }
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_mmap64 );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( mmap64,
+                                        ( addr, length, prot, flags, fd, offset ) );
+        if ( ret != MAP_FAILED )
+        {
+            /* A new mapping, e.g., an anonymous one with MAP_FIXED, replaces
+             * the recorded mappings in its range. */
+            scorep_posix_io_mapping_remove( ret, length,
+                                            trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) );
+        }
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_MSYNC )
+int
+SCOREP_LIBWRAP_FUNC_NAME( msync )( void* addr, size_t length, int flags )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( msync );
+    int ret;
+
+    SCOREP_IoHandleHandle io_handle;
+    uint64_t              offset;
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN )
+         && scorep_posix_io_mapping_find( addr, length, &io_handle, &offset ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_msync );
+
+        /*
+         * Flushes changes of the mapped file in the range [addr, addr + length)
+         * back to the file, attributed to the mapping of the first page.
+         */
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        SCOREP_IoOperationBegin( io_handle,
+                                 SCOREP_IO_OPERATION_MODE_FLUSH,
+                                 SCOREP_IO_OPERATION_FLAG_NON_COLLECTIVE | SCOREP_IO_OPERATION_FLAG_BLOCKING,
+                                 ( uint64_t )length,
+                                 SCOREP_BLOCKING_IO_OPERATION_MATCHING_ID_POSIX /* matching id */,
+                                 offset );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( msync,
+                                        ( addr, length, flags ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        SCOREP_IoOperationComplete( io_handle,
+                                    SCOREP_IO_OPERATION_MODE_FLUSH,
+                                    ret == 0 ? ( uint64_t )length : 0,
+                                    SCOREP_BLOCKING_IO_OPERATION_MATCHING_ID_POSIX /* matching id */ );
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_msync );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( msync,
+                                        ( addr, length, flags ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_MUNMAP )
+int
+SCOREP_LIBWRAP_FUNC_NAME( munmap )( void* addr, size_t length )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( munmap );
+    int ret;
+
+    SCOREP_IoHandleHandle io_handle;
+    uint64_t              offset;
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN )
+         && scorep_posix_io_mapping_find( addr, length, &io_handle, &offset ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_munmap );
+
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( munmap,
+                                        ( addr, length ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        if ( ret == 0 )
+        {
+            /* May destroy the I/O handle of the mapping. */
+            scorep_posix_io_mapping_remove( addr, length, true );
+        }
+
+        SCOREP_ExitRegion( scorep_posix_io_region_munmap );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( munmap,
+                                        ( addr, length ) );
+        if ( ret == 0 )
+        {
+            /* Recorded mappings may be unmapped outside of the measurement,
+             * forget them without events. */
+            scorep_posix_io_mapping_remove( addr, length, false );
+        }
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_SENDFILE )
+ssize_t
+SCOREP_LIBWRAP_FUNC_NAME( sendfile )( int out_fd, int in_fd, off_t* offset, size_t count )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( sendfile );
+    ssize_t ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_sendfile );
+
+        /*
+         * Copies up to 'count' bytes from 'in_fd' to 'out_fd' within the kernel.
+         * If 'offset' is not NULL, 'in_fd' is read from '*offset' and its file
+         * offset is not changed.
+         */
+        SCOREP_IoHandleHandle in_handle  = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &in_fd );
+        SCOREP_IoHandleHandle out_handle = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &out_fd );
+        SCOREP_IoHandleHandle io_handle  = in_handle != SCOREP_INVALID_IO_HANDLE ? in_handle : out_handle;
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        posix_io_transfer_begin( in_handle,
+                                 offset ? ( uint64_t )*offset : SCOREP_IO_UNKNOWN_OFFSET,
+                                 out_handle,
+                                 SCOREP_IO_UNKNOWN_OFFSET,
+                                 count );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( sendfile,
+                                        ( out_fd, in_fd, offset, count ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        posix_io_transfer_complete( in_handle, out_handle, ret );
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_sendfile );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( sendfile,
+                                        ( out_fd, in_fd, offset, count ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_SENDFILE64 )
+ssize_t
+SCOREP_LIBWRAP_FUNC_NAME( sendfile64 )( int out_fd, int in_fd, scorep_off64_t* offset, size_t count )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( sendfile64 );
+    ssize_t ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_sendfile64 );
+
+        /*
+         * Copies up to 'count' bytes from 'in_fd' to 'out_fd' within the kernel.
+         * If 'offset' is not NULL, 'in_fd' is read from '*offset' and its file
+         * offset is not changed.
+         */
+        SCOREP_IoHandleHandle in_handle  = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &in_fd );
+        SCOREP_IoHandleHandle out_handle = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &out_fd );
+        SCOREP_IoHandleHandle io_handle  = in_handle != SCOREP_INVALID_IO_HANDLE ? in_handle : out_handle;
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        posix_io_transfer_begin( in_handle,
+                                 offset ? ( uint64_t )*offset : SCOREP_IO_UNKNOWN_OFFSET,
+                                 out_handle,
+                                 SCOREP_IO_UNKNOWN_OFFSET,
+                                 count );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( sendfile64,
+                                        ( out_fd, in_fd, offset, count ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        posix_io_transfer_complete( in_handle, out_handle, ret );
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_sendfile64 );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( sendfile64,
+                                        ( out_fd, in_fd, offset, count ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
+#if HAVE( POSIX_IO_SYMBOL_SPLICE )
+ssize_t
+SCOREP_LIBWRAP_FUNC_NAME( splice )( int fd_in, scorep_off64_t* off_in, int fd_out, scorep_off64_t* off_out, size_t len, unsigned int flags )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( splice );
+    ssize_t ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_splice );
+
+        /*
+         * Moves up to 'len' bytes between 'fd_in' and 'fd_out', one of them
+         * is a pipe. A non-NULL 'off_in'/'off_out' gives the file offset of
+         * the other descriptor.
+         */
+        SCOREP_IoHandleHandle in_handle  = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fd_in );
+        SCOREP_IoHandleHandle out_handle = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fd_out );
+        SCOREP_IoHandleHandle io_handle  = in_handle != SCOREP_INVALID_IO_HANDLE ? in_handle : out_handle;
+        SCOREP_IoMgmt_PushHandle( io_handle );
+
+        posix_io_transfer_begin( in_handle,
+                                 off_in ? ( uint64_t )*off_in : SCOREP_IO_UNKNOWN_OFFSET,
+                                 out_handle,
+                                 off_out ? ( uint64_t )*off_out : SCOREP_IO_UNKNOWN_OFFSET,
+                                 len );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( splice,
+                                        ( fd_in, off_in, fd_out, off_out, len, flags ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        posix_io_transfer_complete( in_handle, out_handle, ret );
+
+        SCOREP_IoMgmt_PopHandle( io_handle );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_splice );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( splice,
+                                        ( fd_in, off_in, fd_out, off_out, len, flags ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+#endif
+
 #if HAVE( POSIX_AIO_SUPPORT )
 #include "scorep_posix_io_wrap_aio.inc.c"
 #endif /* HAVE( POSIX_AIO_SUPPORT ) */
+
+#if HAVE( POSIX_IO_URING_SUPPORT )
+#include "scorep_posix_io_wrap_uring.inc.c"
+
+/*
+ * Only io_uring_setup and io_uring_enter are recorded, all other system calls
+ * are passed on to the real function without entering the measurement.
+ */
+long
+SCOREP_LIBWRAP_FUNC_NAME( syscall )( long number, ... )
+{
+    /* The kernel takes at most six arguments, pass all of them on. */
+    va_list args;
+    va_start( args, number );
+    long arg1 = va_arg( args, long );
+    long arg2 = va_arg( args, long );
+    long arg3 = va_arg( args, long );
+    long arg4 = va_arg( args, long );
+    long arg5 = va_arg( args, long );
+    long arg6 = va_arg( args, long );
+    va_end( args );
+
+    switch ( number )
+    {
+        case SYS_io_uring_setup:
+            return posix_io_uring_setup( arg1, arg2 );
+        case SYS_io_uring_enter:
+            return posix_io_uring_enter( arg1, arg2, arg3, arg4, arg5, arg6 );
+    }
+
+    INITIALIZE_FUNCTION_POINTER( syscall );
+    return SCOREP_LIBWRAP_FUNC_CALL( syscall,
+                                     ( number, arg1, arg2, arg3, arg4, arg5, arg6 ) );
+}
+#endif /* HAVE( POSIX_IO_URING_SUPPORT ) */
@@ -0,0 +1,569 @@
+/*
+ * io_uring
+ *
+ * Requests are taken from the submission queue when they are handed to the
+ * kernel by io_uring_enter. Only the requests the kernel consumed are recorded,
+ * when io_uring_enter returns, as non-blocking operations with the user data
+ * of the request as matching id. The completion queue is read at
+ * every io_uring_enter, completions are thus recorded when the application
+ * enters the kernel the next time, which is usually the call waiting for them.
+ * The rings are mapped a second time read-only for this purpose.
+ *
+ * A ring is referenced by its list entry and by every io_uring_enter using it.
+ * Closing the ring descriptor, even while another thread waits in
+ * io_uring_enter, only marks it dead, the last reference unmaps it.
+ *
+ * Not recorded are rings created before the measurement started, rings
+ * without a kernel-provided memory mapping, rings polled by a kernel thread
+ * (IORING_SETUP_SQPOLL), registered ring descriptors, and requests on
+ * registered files.
+ */
+
+typedef struct uring_ring uring_ring;
+struct uring_ring
+{
+    uring_ring*                next;
+    int                        fd;
+    /* Protected by uring_rings_lock */
+    uint32_t                   refs;
+    UTILS_Mutex                lock;
+    /* Closed by the application, protected by lock */
+    bool                       dead;
+    /* Number of io_uring_enter calls between taking recordable requests from
+     * the submission queue and recording them, protected by lock */
+    uint32_t                   submitting;
+
+    void*                      sq_map;
+    size_t                     sq_map_size;
+    void*                      cq_map;
+    size_t                     cq_map_size;
+    void*                      sqes_map;
+    size_t                     sqes_map_size;
+
+    uint32_t*                  sq_head;
+    uint32_t*                  sq_tail;
+    const uint32_t*            sq_array;
+    uint32_t                   sq_mask;
+    const struct io_uring_sqe* sqes;
+    uint32_t                   sqe_shift;
+
+    uint32_t*                  cq_tail;
+    uint32_t                   cq_mask;
+    uint32_t                   cq_entries;
+    const struct io_uring_cqe* cqes;
+    uint32_t                   cqe_shift;
+    /* Position of the first completion not yet inspected */
+    uint32_t                   cq_seen;
+};
+
+static uring_ring* uring_rings;
+static UTILS_Mutex uring_rings_lock = UTILS_MUTEX_INIT;
+
+/* Returns a reference to the ring of @a fd, to be dropped with uring_release. */
+static uring_ring*
+uring_find( int fd )
+{
+    UTILS_MutexLock( &uring_rings_lock );
+    uring_ring* ring = uring_rings;
+    while ( ring && ring->fd != fd )
+    {
+        ring = ring->next;
+    }
+    if ( ring )
+    {
+        ring->refs++;
+    }
+    UTILS_MutexUnlock( &uring_rings_lock );
+    return ring;
+}
+
+static void
+uring_unmap( uring_ring* ring )
+{
+    if ( ring->sqes_map )
+    {
+        munmap( ring->sqes_map, ring->sqes_map_size );
+    }
+    if ( ring->cq_map && ring->cq_map != ring->sq_map )
+    {
+        munmap( ring->cq_map, ring->cq_map_size );
+    }
+    if ( ring->sq_map )
+    {
+        munmap( ring->sq_map, ring->sq_map_size );
+    }
+}
+
+static void
+uring_release( uring_ring* ring )
+{
+    UTILS_MutexLock( &uring_rings_lock );
+    bool last = --ring->refs == 0;
+    UTILS_MutexUnlock( &uring_rings_lock );
+
+    if ( last )
+    {
+        uring_unmap( ring );
+        free( ring );
+    }
+}
+
+static void
+uring_remove( int fd )
+{
+    UTILS_MutexLock( &uring_rings_lock );
+    uring_ring** it = &uring_rings;
+    while ( *it && ( *it )->fd != fd )
+    {
+        it = &( *it )->next;
+    }
+    uring_ring* ring = *it;
+    if ( ring )
+    {
+        *it = ring->next;
+    }
+    UTILS_MutexUnlock( &uring_rings_lock );
+
+    if ( ring )
+    {
+        /* Other threads may still be in io_uring_enter with this ring, they
+         * stop recording it. The descriptor may be reused once we return. */
+        UTILS_MutexLock( &ring->lock );
+        ring->dead = true;
+        scorep_posix_io_uring_request_remove_all( fd );
+        UTILS_MutexUnlock( &ring->lock );
+
+        uring_release( ring );
+    }
+}
+
+static void*
+uring_map( int fd, size_t size, off_t offset )
+{
+    void* map = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, offset );
+    return map == MAP_FAILED ? NULL : map;
+}
+
+static void
+uring_register( int                           fd,
+                const struct io_uring_params* params )
+{
+    if ( params->flags & IORING_SETUP_SQPOLL )
+    {
+        return;
+    }
+
+    uring_ring* ring = calloc( 1, sizeof( *ring ) );
+    if ( !ring )
+    {
+        UTILS_ERROR( SCOREP_ERROR_MEM_ALLOC_FAILED,
+                     "Cannot record io_uring instance %d.", fd );
+        return;
+    }
+    ring->fd   = fd;
+    ring->refs = 1;
+
+#ifdef IORING_SETUP_SQE128
+    ring->sqe_shift = ( params->flags & IORING_SETUP_SQE128 ) ? 1 : 0;
+#endif
+#ifdef IORING_SETUP_CQE32
+    ring->cqe_shift = ( params->flags & IORING_SETUP_CQE32 ) ? 1 : 0;
+#endif
+
+    ring->sq_map_size = params->sq_off.array + params->sq_entries * sizeof( uint32_t );
+    ring->cq_map_size = params->cq_off.cqes
+                        + ( ( size_t )params->cq_entries << ring->cqe_shift ) * sizeof( struct io_uring_cqe );
+    if ( params->features & IORING_FEAT_SINGLE_MMAP )
+    {
+        if ( ring->cq_map_size > ring->sq_map_size )
+        {
+            ring->sq_map_size = ring->cq_map_size;
+        }
+        ring->sq_map      = uring_map( fd, ring->sq_map_size, IORING_OFF_SQ_RING );
+        ring->cq_map      = ring->sq_map;
+        ring->cq_map_size = ring->sq_map_size;
+    }
+    else
+    {
+        ring->sq_map = uring_map( fd, ring->sq_map_size, IORING_OFF_SQ_RING );
+        ring->cq_map = uring_map( fd, ring->cq_map_size, IORING_OFF_CQ_RING );
+    }
+    ring->sqes_map_size = ( ( size_t )params->sq_entries << ring->sqe_shift ) * sizeof( struct io_uring_sqe );
+    ring->sqes_map      = uring_map( fd, ring->sqes_map_size, IORING_OFF_SQES );
+
+    if ( !ring->sq_map || !ring->cq_map || !ring->sqes_map )
+    {
+        UTILS_DEBUG( "Cannot map the rings of io_uring instance %d", fd );
+        uring_unmap( ring );
+        free( ring );
+        return;
+    }
+
+    char* sq = ring->sq_map;
+    ring->sq_head  = ( uint32_t* )( sq + params->sq_off.head );
+    ring->sq_tail  = ( uint32_t* )( sq + params->sq_off.tail );
+    ring->sq_mask  = *( const uint32_t* )( sq + params->sq_off.ring_mask );
+    ring->sq_array = ( const uint32_t* )( sq + params->sq_off.array );
+#ifdef IORING_SETUP_NO_SQARRAY
+    if ( params->flags & IORING_SETUP_NO_SQARRAY )
+    {
+        ring->sq_array = NULL;
+    }
+#endif
+    ring->sqes = ring->sqes_map;
+
+    char* cq = ring->cq_map;
+    ring->cq_tail    = ( uint32_t* )( cq + params->cq_off.tail );
+    ring->cq_mask    = *( const uint32_t* )( cq + params->cq_off.ring_mask );
+    ring->cq_entries = *( const uint32_t* )( cq + params->cq_off.ring_entries );
+    ring->cqes       = ( const struct io_uring_cqe* )( cq + params->cq_off.cqes );
+    ring->cq_seen    = UTILS_Atomic_LoadN_uint32( ring->cq_tail, UTILS_ATOMIC_ACQUIRE );
+
+    /* A stale ring with the same descriptor was closed behind our back. */
+    uring_remove( fd );
+
+    UTILS_MutexLock( &uring_rings_lock );
+    ring->next  = uring_rings;
+    uring_rings = ring;
+    UTILS_MutexUnlock( &uring_rings_lock );
+}
+
+static inline bool
+uring_translate_opcode( uint8_t                 opcode,
+                        SCOREP_IoOperationMode* scorepMode )
+{
+    switch ( opcode )
+    {
+        case IORING_OP_READV:
+        case IORING_OP_READ_FIXED:
+/* The opcodes are enumerators, IORING_OP_READ and IORING_OP_WRITE
+ * came with the same kernel release as IORING_FEAT_CUR_PERSONALITY. */
+#ifdef IORING_FEAT_CUR_PERSONALITY
+        case IORING_OP_READ:
+#endif
+            *scorepMode = SCOREP_IO_OPERATION_MODE_READ;
+            return true;
+        case IORING_OP_WRITEV:
+        case IORING_OP_WRITE_FIXED:
+#ifdef IORING_FEAT_CUR_PERSONALITY
+        case IORING_OP_WRITE:
+#endif
+            *scorepMode = SCOREP_IO_OPERATION_MODE_WRITE;
+            return true;
+        case IORING_OP_FSYNC:
+            *scorepMode = SCOREP_IO_OPERATION_MODE_FLUSH;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline uint64_t
+uring_get_request_size( const struct io_uring_sqe* sqe )
+{
+    switch ( sqe->opcode )
+    {
+        case IORING_OP_READV:
+        case IORING_OP_WRITEV:
+        {
+            const struct iovec* iov  = ( const struct iovec* )( uintptr_t )sqe->addr;
+            uint64_t            size = 0;
+            for ( uint32_t i = 0; i < sqe->len; i++ )
+            {
+                size += iov[ i ].iov_len;
+            }
+            return size;
+        }
+        case IORING_OP_FSYNC:
+            return SCOREP_IO_UNKOWN_TRANSFER_SIZE;
+        default:
+            return sqe->len;
+    }
+}
+
+static inline uint64_t
+uring_get_request_offset( const struct io_uring_sqe* sqe )
+{
+    /* -1 means the current file position */
+    if ( sqe->opcode == IORING_OP_FSYNC || sqe->off == ( uint64_t )-1 )
+    {
+        return SCOREP_IO_UNKNOWN_OFFSET;
+    }
+    return sqe->off;
+}
+
+typedef struct uring_request
+{
+    /* Position relative to the submission queue head */
+    uint32_t               position;
+    uint64_t               user_data;
+    SCOREP_IoHandleHandle  handle;
+    SCOREP_IoOperationMode mode;
+    uint64_t               size;
+    uint64_t               offset;
+} uring_request;
+
+/* Takes up to @a toSubmit pending requests from the submission queue and
+ * returns the recordable ones in @a requests, to be freed by the caller.
+ * Nothing is recorded yet, as the kernel may not consume all of them. */
+static uint32_t
+uring_submit_begin( uring_ring*     ring,
+                    uint32_t        toSubmit,
+                    uring_request** requests )
+{
+    uint32_t n_requests = 0;
+    *requests = NULL;
+
+    UTILS_MutexLock( &ring->lock );
+
+    if ( ring->dead )
+    {
+        UTILS_MutexUnlock( &ring->lock );
+        return 0;
+    }
+
+    uint32_t head    = UTILS_Atomic_LoadN_uint32( ring->sq_head, UTILS_ATOMIC_ACQUIRE );
+    uint32_t tail    = UTILS_Atomic_LoadN_uint32( ring->sq_tail, UTILS_ATOMIC_ACQUIRE );
+    uint32_t pending = tail - head;
+    if ( toSubmit > pending )
+    {
+        toSubmit = pending;
+    }
+    if ( toSubmit > 0 )
+    {
+        *requests = malloc( toSubmit * sizeof( **requests ) );
+        if ( !*requests )
+        {
+            UTILS_ERROR( SCOREP_ERROR_MEM_ALLOC_FAILED,
+                         "Cannot record io_uring submissions." );
+            toSubmit = 0;
+        }
+    }
+
+    for ( uint32_t i = 0; i < toSubmit; i++ )
+    {
+        uint32_t index = ( head + i ) & ring->sq_mask;
+        if ( ring->sq_array )
+        {
+            index = ring->sq_array[ index ] & ring->sq_mask;
+        }
+        const struct io_uring_sqe* sqe = &ring->sqes[ index << ring->sqe_shift ];
+
+        SCOREP_IoOperationMode mode;
+        if ( ( sqe->flags & IOSQE_FIXED_FILE ) || !uring_translate_opcode( sqe->opcode, &mode ) )
+        {
+            continue;
+        }
+
+        int                   fd        = sqe->fd;
+        SCOREP_IoHandleHandle io_handle = SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fd );
+        if ( io_handle == SCOREP_INVALID_IO_HANDLE )
+        {
+            continue;
+        }
+
+        /* The application may reuse the entry, once the kernel consumed it. */
+        uring_request* request = &( *requests )[ n_requests++ ];
+        request->position  = i;
+        request->user_data = sqe->user_data;
+        request->handle    = io_handle;
+        request->mode      = mode;
+        request->size      = uring_get_request_size( sqe );
+        request->offset    = uring_get_request_offset( sqe );
+    }
+    if ( n_requests > 0 )
+    {
+        ring->submitting++;
+    }
+
+    UTILS_MutexUnlock( &ring->lock );
+
+    return n_requests;
+}
+
+/* Issues IoOperationBegin and IoOperationIssued for the requests the kernel
+ * consumed. The remaining ones stay in the queue and are recorded by the
+ * io_uring_enter which submits them. */
+static void
+uring_submit_complete( uring_ring*          ring,
+                       const uring_request* requests,
+                       uint32_t             nRequests,
+                       uint32_t             submitted )
+{
+    if ( nRequests == 0 )
+    {
+        return;
+    }
+
+    UTILS_MutexLock( &ring->lock );
+
+    if ( ring->dead )
+    {
+        UTILS_MutexUnlock( &ring->lock );
+        return;
+    }
+    ring->submitting--;
+
+    for ( uint32_t i = 0; i < nRequests && requests[ i ].position < submitted; i++ )
+    {
+        if ( !scorep_posix_io_uring_request_insert( ring->fd,
+                                                    requests[ i ].user_data,
+                                                    requests[ i ].handle,
+                                                    requests[ i ].mode ) )
+        {
+            continue;
+        }
+
+        SCOREP_IoOperationBegin( requests[ i ].handle,
+                                 requests[ i ].mode,
+                                 SCOREP_IO_OPERATION_FLAG_NON_COLLECTIVE | SCOREP_IO_OPERATION_FLAG_NON_BLOCKING,
+                                 requests[ i ].size,
+                                 requests[ i ].user_data,
+                                 requests[ i ].offset );
+        SCOREP_IoOperationIssued( requests[ i ].handle, requests[ i ].user_data );
+    }
+
+    UTILS_MutexUnlock( &ring->lock );
+}
+
+/* Issues IoOperationComplete for all completions not inspected yet. */
+static void
+uring_reap( uring_ring* ring )
+{
+    UTILS_MutexLock( &ring->lock );
+
+    /* Completions of requests taken from the submission queue may already be
+     * posted, before their begin is recorded. The submitting thread reaps
+     * them afterwards. */
+    if ( ring->dead || ring->submitting > 0 )
+    {
+        UTILS_MutexUnlock( &ring->lock );
+        return;
+    }
+
+    uint32_t tail = UTILS_Atomic_LoadN_uint32( ring->cq_tail, UTILS_ATOMIC_ACQUIRE );
+    uint32_t pos  = ring->cq_seen;
+    if ( tail - pos > ring->cq_entries )
+    {
+        /* Older entries may already be overwritten by the kernel. */
+        pos = tail - ring->cq_entries;
+    }
+
+    for ( ; pos != tail; pos++ )
+    {
+        const struct io_uring_cqe* cqe = &ring->cqes[ ( pos & ring->cq_mask ) << ring->cqe_shift ];
+
+        SCOREP_IoHandleHandle  io_handle;
+        SCOREP_IoOperationMode mode;
+        if ( scorep_posix_io_uring_request_remove( ring->fd, cqe->user_data, &io_handle, &mode ) )
+        {
+            SCOREP_IoOperationComplete( io_handle,
+                                        mode,
+                                        cqe->res >= 0 ? ( uint64_t )cqe->res : SCOREP_IO_UNKOWN_TRANSFER_SIZE,
+                                        cqe->user_data );
+        }
+    }
+    ring->cq_seen = tail;
+
+    UTILS_MutexUnlock( &ring->lock );
+}
+
+/* Records the outstanding completions of a closed ring and forgets it. */
+static void
+posix_io_uring_close( int fd )
+{
+    uring_ring* ring = uring_find( fd );
+    if ( ring )
+    {
+        uring_reap( ring );
+        uring_remove( fd );
+        uring_release( ring );
+    }
+}
+
+static long
+posix_io_uring_setup( long entries,
+                      long params )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( syscall );
+    long ret;
+
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_io_uring_setup );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( syscall,
+                                        ( SYS_io_uring_setup, entries, params ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        if ( ret >= 0 )
+        {
+            uring_register( ( int )ret, ( const struct io_uring_params* )params );
+        }
+
+        SCOREP_ExitRegion( scorep_posix_io_region_io_uring_setup );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( syscall,
+                                        ( SYS_io_uring_setup, entries, params ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
+
+static long
+posix_io_uring_enter( long fd,
+                      long toSubmit,
+                      long minComplete,
+                      long flags,
+                      long sig,
+                      long sigsz )
+{
+    bool trigger = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    INITIALIZE_FUNCTION_POINTER( syscall );
+    long ret;
+
+    uring_ring* ring = NULL;
+    if ( trigger && SCOREP_IS_MEASUREMENT_PHASE( WITHIN ) )
+    {
+#ifdef IORING_ENTER_REGISTERED_RING
+        if ( !( flags & IORING_ENTER_REGISTERED_RING ) )
+#endif
+        {
+            ring = uring_find( ( int )fd );
+        }
+    }
+
+    if ( ring )
+    {
+        SCOREP_EnterWrappedRegion( scorep_posix_io_region_io_uring_enter );
+
+        /* Completions reaped by the application since the last call. */
+        uring_reap( ring );
+
+        uring_request* requests;
+        uint32_t       n_requests = uring_submit_begin( ring, ( uint32_t )toSubmit, &requests );
+
+        SCOREP_ENTER_WRAPPED_REGION();
+        ret = SCOREP_LIBWRAP_FUNC_CALL( syscall,
+                                        ( SYS_io_uring_enter, fd, toSubmit, minComplete, flags, sig, sigsz ) );
+        SCOREP_EXIT_WRAPPED_REGION();
+
+        uring_submit_complete( ring, requests, n_requests, ret > 0 ? ( uint32_t )ret : 0 );
+        free( requests );
+        uring_reap( ring );
+        uring_release( ring );
+
+        SCOREP_ExitRegion( scorep_posix_io_region_io_uring_enter );
+    }
+    else
+    {
+        ret = SCOREP_LIBWRAP_FUNC_CALL( syscall,
+                                        ( SYS_io_uring_enter, fd, toSubmit, minComplete, flags, sig, sigsz ) );
+    }
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+    return ret;
+}
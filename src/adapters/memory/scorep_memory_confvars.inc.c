@@ -21,7 +21,8 @@
  *
  */
 
-bool scorep_memory_recording;
+bool     scorep_memory_recording;
+uint64_t scorep_memory_sampling_interval;
 
 /*
  *  Configuration variables for the MEMORY adapter.
@@ -36,5 +37,21 @@ static const SCOREP_ConfigVariable scorep_memory_confvars[] = {
         "Memory recording",
         "Memory (de)allocations are recorded via the libc/C++ API."
     },
+    {
+        "sampling_interval",
+        SCOREP_CONFIG_TYPE_SIZE,
+        &scorep_memory_sampling_interval,
+        NULL,
+        "0",
+        "Average number of allocated bytes between two recorded allocations",
+        "If greater than 0, only a sample of the memory allocations is recorded.\n"
+        "Each thread draws exponentially distributed intervals of allocated bytes,\n"
+        "the allocation which exhausts an interval is recorded, together with its\n"
+        "reallocations and its deallocation. Thus, large allocations are\n"
+        "recorded more likely than small ones. The memory usage metric is\n"
+        "estimated by weighting each sampled allocation with the inverse of its\n"
+        "sampling probability.\n"
+        "With 0, all allocations are recorded."
+    },
     SCOREP_CONFIG_TERMINATOR
 };
@@ -159,7 +159,9 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( size_t size ) \
  \
     UTILS_DEBUG_ENTRY( "%zu", size ); \
  \
-    if ( scorep_memory_recording ) \
+    uint64_t weight; \
+    bool     record = scorep_memory_record_allocation( size, &weight ); \
+    if ( record ) \
     { \
         scorep_memory_attributes_add_enter_alloc_size( size ); \
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_##REGION ] ); \
@@ -173,13 +175,11 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( size_t size ) \
     void* result = SCOREP_LIBWRAP_FUNC_CALL( FUNCTION, ( size ) ); \
     SCOREP_EXIT_WRAPPED_REGION(); \
  \
-    if ( scorep_memory_recording ) \
+    if ( record ) \
     { \
         if ( result ) \
         { \
-            SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric, \
-                                            ( uint64_t )result, \
-                                            size ); \
+            scorep_memory_handle_alloc( ( uint64_t )result, size, weight ); \
         } \
  \
         scorep_memory_attributes_add_exit_return_address( ( uint64_t )result ); \
@@ -212,17 +212,12 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void* ptr ) \
  \
     UTILS_DEBUG_ENTRY( "%p", ptr ); \
  \
-    void* allocation = NULL; \
-    if ( scorep_memory_recording ) \
+    void* allocation; \
+    bool  record = scorep_memory_record_deallocation( ptr, &allocation ); \
+    if ( record ) \
     { \
         scorep_memory_attributes_add_enter_argument_address( ( uint64_t )ptr ); \
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_##REGION ] ); \
- \
-        if ( ptr ) \
-        { \
-            SCOREP_AllocMetric_AcquireAlloc( scorep_memory_metric, \
-                                             ( uint64_t )ptr, &allocation ); \
-        } \
     } \
     else if ( SCOREP_IsUnwindingEnabled() ) \
     { \
@@ -233,7 +228,7 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void* ptr ) \
     SCOREP_LIBWRAP_FUNC_CALL( FUNCTION, ( ptr ) ); \
     SCOREP_EXIT_WRAPPED_REGION(); \
  \
-    if ( scorep_memory_recording ) \
+    if ( record ) \
     { \
         uint64_t dealloc_size = 0; \
         if ( ptr ) \
@@ -272,18 +267,13 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void* ptr, size_t size ) \
  \
     UTILS_DEBUG_ENTRY( "%p, %zu", ptr, size ); \
  \
-    void* allocation = NULL; \
-    if ( scorep_memory_recording ) \
+    void* allocation; \
+    bool  record = scorep_memory_record_deallocation( ptr, &allocation ); \
+    if ( record ) \
     { \
         scorep_memory_attributes_add_enter_argument_address( ( uint64_t )ptr ); \
         scorep_memory_attributes_add_exit_dealloc_size( size ); \
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_##REGION ] ); \
- \
-        if ( ptr ) \
-        { \
-            SCOREP_AllocMetric_AcquireAlloc( scorep_memory_metric, \
-                                             ( uint64_t )ptr, &allocation ); \
-        } \
     } \
     else if ( SCOREP_IsUnwindingEnabled() ) \
     { \
@@ -294,7 +284,7 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void* ptr, size_t size ) \
     SCOREP_LIBWRAP_FUNC_CALL( FUNCTION, ( ptr, size ) ); \
     SCOREP_EXIT_WRAPPED_REGION(); \
  \
-    if ( scorep_memory_recording ) \
+    if ( record ) \
     { \
         uint64_t dealloc_size = 0; \
         if ( ptr ) \
@@ -333,7 +323,9 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( size_t nmemb, \
  \
     UTILS_DEBUG_ENTRY( "%zu, %zu", nmemb, size ); \
  \
-    if ( scorep_memory_recording ) \
+    uint64_t weight; \
+    bool     record = scorep_memory_record_allocation( nmemb * size, &weight ); \
+    if ( record ) \
     { \
         scorep_memory_attributes_add_enter_alloc_size( nmemb * size ); \
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_##REGION ] ); \
@@ -347,13 +339,11 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( size_t nmemb, \
     void* result = SCOREP_LIBWRAP_FUNC_CALL( FUNCTION, ( nmemb, size ) ); \
     SCOREP_EXIT_WRAPPED_REGION(); \
  \
-    if ( scorep_memory_recording ) \
+    if ( record ) \
     { \
         if ( result ) \
         { \
-            SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric, \
-                                            ( uint64_t )result, \
-                                            nmemb * size ); \
+            scorep_memory_handle_alloc( ( uint64_t )result, nmemb * size, weight ); \
         } \
  \
         scorep_memory_attributes_add_exit_return_address( ( uint64_t )result ); \
@@ -387,8 +377,14 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void*  ptr, \
  \
     UTILS_DEBUG_ENTRY( "%p, %zu", ptr, size ); \
  \
-    void* allocation = NULL; \
-    if ( scorep_memory_recording ) \
+    /* In sampling mode, the new allocation is sampled independently of ptr. */ \
+    void*    allocation; \
+    uint64_t weight       = size; \
+    bool     record_free  = scorep_memory_record_deallocation( ptr, &allocation ); \
+    bool     record_alloc = ( ptr == NULL || size != 0 ) \
+                            && scorep_memory_record_allocation( size, &weight ); \
+    bool     record       = record_free || record_alloc; \
+    if ( record ) \
     { \
         /* The size belongs to to the result ptr in \
          * scorep_memory_attributes_add_exit_return_address */ \
@@ -397,12 +393,6 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void*  ptr, \
          * scorep_memory_attributes_add_exit_dealloc_size. */ \
         scorep_memory_attributes_add_enter_argument_address( (  uint64_t )ptr ); \
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_##REGION ] ); \
- \
-        if ( ptr ) \
-        { \
-            SCOREP_AllocMetric_AcquireAlloc( scorep_memory_metric, \
-                                             ( uint64_t )ptr, &allocation ); \
-        } \
     } \
     else if ( SCOREP_IsUnwindingEnabled() ) \
     { \
@@ -413,16 +403,14 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void*  ptr, \
     void* result = SCOREP_LIBWRAP_FUNC_CALL( FUNCTION, ( ptr, size ) ); \
     SCOREP_EXIT_WRAPPED_REGION(); \
  \
-    if ( scorep_memory_recording ) \
+    if ( record ) \
     { \
         /* \
          * If ptr is a null pointer, then it is like malloc. \
          */ \
-        if ( ptr == NULL && result ) \
+        if ( ptr == NULL && result && record_alloc ) \
         { \
-            SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric, \
-                                            ( uint64_t )result, \
-                                            size ); \
+            scorep_memory_handle_alloc( ( uint64_t )result, size, weight ); \
             scorep_memory_attributes_add_exit_return_address( ( uint64_t )result ); \
         } \
         /* \
@@ -436,14 +424,23 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void*  ptr, \
             scorep_memory_attributes_add_exit_dealloc_size( dealloc_size ); \
         } \
         /* Otherwise it is a realloc, treat as realloc on success, ... */ \
+        else if ( result && record_alloc ) \
+        { \
+            uint64_t dealloc_size = 0; \
+            scorep_memory_handle_realloc( ( uint64_t )result, \
+                                          size, \
+                                          weight, \
+                                          allocation, \
+                                          &dealloc_size ); \
+            scorep_memory_attributes_add_exit_dealloc_size( dealloc_size ); \
+            scorep_memory_attributes_add_exit_return_address( ( uint64_t )result ); \
+        } \
+        /* ... or as free of the sampled ptr, if the result was not sampled, ... */ \
         else if ( result ) \
         { \
             uint64_t dealloc_size = 0; \
-            SCOREP_AllocMetric_HandleRealloc( scorep_memory_metric, \
-                                              ( uint64_t )result, \
-                                              size, \
-                                              allocation, \
-                                              &dealloc_size ); \
+            SCOREP_AllocMetric_HandleFree( scorep_memory_metric, \
+                                           allocation, &dealloc_size ); \
             scorep_memory_attributes_add_exit_dealloc_size( dealloc_size ); \
             scorep_memory_attributes_add_exit_return_address( ( uint64_t )result ); \
         } \
@@ -484,7 +481,9 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void** ptr, \
  \
     UTILS_DEBUG_ENTRY( "%zu, %zu", alignment, size ); \
  \
-    if ( scorep_memory_recording ) \
+    uint64_t weight; \
+    bool     record = scorep_memory_record_allocation( size, &weight ); \
+    if ( record ) \
     { \
         scorep_memory_attributes_add_enter_alloc_size( size ); \
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_##REGION ] ); \
@@ -498,13 +497,11 @@ SCOREP_LIBWRAP_FUNC_NAME( FUNCTION )( void** ptr, \
     int result = SCOREP_LIBWRAP_FUNC_CALL( FUNCTION, ( ptr, alignment, size ) ); \
     SCOREP_EXIT_WRAPPED_REGION(); \
  \
-    if ( scorep_memory_recording ) \
+    if ( record ) \
     { \
         if ( result == 0 && *ptr ) \
         { \
-            SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric, \
-                                            ( uint64_t )*ptr, \
-                                            size ); \
+            scorep_memory_handle_alloc( ( uint64_t )*ptr, size, weight ); \
         } \
  \
         scorep_memory_attributes_add_exit_return_address( ( uint64_t )*ptr ); \
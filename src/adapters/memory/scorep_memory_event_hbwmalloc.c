@@ -40,7 +40,9 @@ SCOREP_LIBWRAP_FUNC_NAME( hbw_posix_memalign_psize )( void** ptr,
 
     UTILS_DEBUG_ENTRY( "%zu, %zu, %d", alignment, size, pagesize );
 
-    if ( scorep_memory_recording )
+    uint64_t weight;
+    bool     record = scorep_memory_record_allocation( size, &weight );
+    if ( record )
     {
         scorep_memory_attributes_add_enter_alloc_size( size );
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_HBW_POSIX_MEMALIGN_PSIZE ] );
@@ -54,13 +56,11 @@ SCOREP_LIBWRAP_FUNC_NAME( hbw_posix_memalign_psize )( void** ptr,
     int result = SCOREP_LIBWRAP_FUNC_CALL( hbw_posix_memalign_psize, ( ptr, alignment, size, pagesize ) );
     SCOREP_EXIT_WRAPPED_REGION();
 
-    if ( scorep_memory_recording )
+    if ( record )
     {
         if ( result == 0 && *ptr )
         {
-            SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric,
-                                            ( uint64_t )*ptr,
-                                            size );
+            scorep_memory_handle_alloc( ( uint64_t )*ptr, size, weight );
         }
 
         scorep_memory_attributes_add_exit_return_address( ( uint64_t )*ptr );
@@ -34,7 +34,9 @@ SCOREP_LIBWRAP_FUNC_NAME( aligned_alloc )( size_t alignment,
 
     UTILS_DEBUG_ENTRY( "%zu, %zu", alignment, size );
 
-    if ( scorep_memory_recording )
+    uint64_t weight;
+    bool     record = scorep_memory_record_allocation( size, &weight );
+    if ( record )
     {
         scorep_memory_attributes_add_enter_alloc_size( size );
         SCOREP_EnterWrappedRegion( scorep_memory_regions[ SCOREP_MEMORY_ALIGNED_ALLOC ] );
@@ -48,13 +50,11 @@ SCOREP_LIBWRAP_FUNC_NAME( aligned_alloc )( size_t alignment,
     void* result = SCOREP_LIBWRAP_FUNC_CALL( aligned_alloc, ( alignment, size ) );
     SCOREP_EXIT_WRAPPED_REGION();
 
-    if ( scorep_memory_recording )
+    if ( record )
     {
         if ( result )
         {
-            SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric,
-                                            ( uint64_t )result,
-                                            size );
+            scorep_memory_handle_alloc( ( uint64_t )result, size, weight );
         }
 
         scorep_memory_attributes_add_exit_return_address( ( uint64_t )result );
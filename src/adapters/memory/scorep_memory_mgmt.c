@@ -1,7 +1,7 @@
 /**
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016-2017,
+ * Copyright (c) 2016-2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2016,
@@ -32,10 +32,12 @@
 #include <SCOREP_Paradigms.h>
 #include <SCOREP_Definitions.h>
 #include <SCOREP_AllocMetric.h>
+#include <SCOREP_Memory.h>
 
 #define SCOREP_DEBUG_MODULE_NAME MEMORY
 #include <UTILS_Debug.h>
 #include <UTILS_CStr.h>
+#include <UTILS_Mutex.h>
 
 #include <stddef.h>
 #include <stdbool.h>
@@ -52,6 +54,108 @@ static size_t memory_subsystem_id;
 
 SCOREP_AllocMetric* scorep_memory_metric = NULL;
 
+/* Sampling state for allocations of locations, which are not yet
+ * initialized, i.e., allocations during the creation of the location. */
+static scorep_memory_sampler fallback_sampler;
+static UTILS_Mutex           fallback_sampler_lock = UTILS_MUTEX_INIT;
+
+
+bool
+scorep_memory_sample_allocation( size_t    size,
+                                 uint64_t* weight )
+{
+    SCOREP_Location*       location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_memory_sampler* sampler  =
+        SCOREP_Location_GetSubsystemData( location, memory_subsystem_id );
+    if ( sampler )
+    {
+        return scorep_memory_sampler_sample( sampler,
+                                             scorep_memory_sampling_interval,
+                                             size, weight );
+    }
+
+    /* Sample from the shared state instead of recording it unconditionally,
+     * which would distort the estimated totals. */
+    UTILS_MutexLock( &fallback_sampler_lock );
+    if ( fallback_sampler.random_state == 0 )
+    {
+        scorep_memory_sampler_init( &fallback_sampler,
+                                    ( uint64_t )( uintptr_t )&fallback_sampler,
+                                    scorep_memory_sampling_interval );
+    }
+    bool sampled = scorep_memory_sampler_sample( &fallback_sampler,
+                                                 scorep_memory_sampling_interval,
+                                                 size, weight );
+    UTILS_MutexUnlock( &fallback_sampler_lock );
+    return sampled;
+}
+
+
+void
+scorep_memory_handle_alloc( uint64_t resultAddr,
+                            size_t   size,
+                            uint64_t weight )
+{
+    if ( scorep_memory_sampling_interval == 0 )
+    {
+        SCOREP_AllocMetric_HandleAlloc( scorep_memory_metric, resultAddr, size );
+        return;
+    }
+
+    SCOREP_AllocMetric_HandleSampledAlloc( scorep_memory_metric, resultAddr, size, weight );
+    UTILS_Atomic_AddFetch_uint32( scorep_memory_sampled_filter_counter( resultAddr ),
+                                  1, UTILS_ATOMIC_RELAXED );
+}
+
+
+bool
+scorep_memory_acquire_sampled_allocation( void*  ptr,
+                                          void** allocation )
+{
+    /* The filter may have false positives, thus the lookup can fail. */
+    if ( !SCOREP_AllocMetric_TryAcquireAlloc( scorep_memory_metric,
+                                              ( uint64_t )ptr, allocation ) )
+    {
+        return false;
+    }
+
+    UTILS_Atomic_SubFetch_uint32( scorep_memory_sampled_filter_counter( ( uint64_t )ptr ),
+                                  1, UTILS_ATOMIC_RELAXED );
+    return true;
+}
+
+
+void
+scorep_memory_handle_realloc( uint64_t  resultAddr,
+                              size_t    size,
+                              uint64_t  weight,
+                              void*     allocation,
+                              uint64_t* prevSize )
+{
+    if ( scorep_memory_sampling_interval == 0 )
+    {
+        SCOREP_AllocMetric_HandleRealloc( scorep_memory_metric, resultAddr, size,
+                                          allocation, prevSize );
+        return;
+    }
+
+    if ( allocation == NULL )
+    {
+        /* The previous allocation was not sampled, but the new one is. */
+        scorep_memory_handle_alloc( resultAddr, size, weight );
+        if ( prevSize )
+        {
+            *prevSize = 0;
+        }
+        return;
+    }
+
+    SCOREP_AllocMetric_HandleSampledRealloc( scorep_memory_metric, resultAddr, size,
+                                             weight, allocation, prevSize );
+    UTILS_Atomic_AddFetch_uint32( scorep_memory_sampled_filter_counter( resultAddr ),
+                                  1, UTILS_ATOMIC_RELAXED );
+}
+
 
 static SCOREP_ErrorCode
 memory_subsystem_register( size_t subsystemId )
@@ -85,6 +189,32 @@ memory_subsystem_init( void )
 }
 
 
+static SCOREP_ErrorCode
+memory_subsystem_init_location( SCOREP_Location* location,
+                                SCOREP_Location* parent )
+{
+    if ( !scorep_memory_recording
+         || scorep_memory_sampling_interval == 0
+         || SCOREP_Location_GetType( location ) != SCOREP_LOCATION_TYPE_CPU_THREAD )
+    {
+        return SCOREP_SUCCESS;
+    }
+
+    scorep_memory_sampler* data =
+        SCOREP_Location_AllocForMisc( location, sizeof( *data ) );
+    /* The address differs between processes with address space randomization. */
+    scorep_memory_sampler_init( data,
+                                ( SCOREP_Location_GetId( location ) + 1 )
+                                * UINT64_C( 0x9e3779b97f4a7c15 )
+                                ^ ( uint64_t )( uintptr_t )data,
+                                scorep_memory_sampling_interval );
+
+    SCOREP_Location_SetSubsystemData( location, memory_subsystem_id, data );
+
+    return SCOREP_SUCCESS;
+}
+
+
 static void
 memory_subsystem_end( void )
 {
@@ -134,9 +264,10 @@ register_memory_regions( void )
 /* Implementation of the memory adapter initialization/finalization struct */
 const SCOREP_Subsystem SCOREP_Subsystem_MemoryAdapter =
 {
-    .subsystem_name     = "MEMORY",
-    .subsystem_register = &memory_subsystem_register,
-    .subsystem_init     = &memory_subsystem_init,
-    .subsystem_end      = &memory_subsystem_end,
-    .subsystem_finalize = &memory_subsystem_finalize
+    .subsystem_name          = "MEMORY",
+    .subsystem_register      = &memory_subsystem_register,
+    .subsystem_init          = &memory_subsystem_init,
+    .subsystem_init_location = &memory_subsystem_init_location,
+    .subsystem_end           = &memory_subsystem_end,
+    .subsystem_finalize      = &memory_subsystem_finalize
 };
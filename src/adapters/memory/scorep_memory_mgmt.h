@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016, 2019,
+ * Copyright (c) 2016, 2019, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2017,
@@ -25,8 +25,11 @@
 #include <scorep/SCOREP_PublicTypes.h>
 #include <SCOREP_Config.h>
 #include <SCOREP_AllocMetric.h>
+#include <UTILS_Atomic.h>
+#include "scorep_memory_sampling.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #define SCOREP_MEMORY_REGIONS                            \
     SCOREP_MEMORY_REGION( MALLOC,                   ALLOCATE,   "malloc" ) \
@@ -70,4 +73,100 @@ extern bool scorep_memory_recording;
 
 extern SCOREP_AllocMetric* scorep_memory_metric;
 
+/**
+ * Mean number of allocated bytes between two recorded allocations.
+ * 0 if every allocation is recorded.
+ */
+extern uint64_t scorep_memory_sampling_interval;
+
+
+/**
+ * Advances the sampling interval of the current location by @a size bytes.
+ *
+ * @param[out] weight The estimated number of bytes, the allocation represents.
+ * @return true if the allocation is sampled.
+ */
+bool
+scorep_memory_sample_allocation( size_t    size,
+                                 uint64_t* weight );
+
+/**
+ * Removes the sampled allocation @a ptr from the tracking, if it is known.
+ */
+bool
+scorep_memory_acquire_sampled_allocation( void*  ptr,
+                                          void** allocation );
+
+/**
+ * Tracks a recorded allocation, with @a weight from
+ * @a scorep_memory_record_allocation.
+ */
+void
+scorep_memory_handle_alloc( uint64_t resultAddr,
+                            size_t   size,
+                            uint64_t weight );
+
+/**
+ * Tracks a recorded reallocation of @a allocation, which may be NULL if the
+ * previous allocation was not sampled.
+ */
+void
+scorep_memory_handle_realloc( uint64_t  resultAddr,
+                              size_t    size,
+                              uint64_t  weight,
+                              void*     allocation,
+                              uint64_t* prevSize );
+
+
+/**
+ * Decides whether an allocation of @a size bytes is recorded.
+ */
+static inline bool
+scorep_memory_record_allocation( size_t    size,
+                                 uint64_t* weight )
+{
+    *weight = size;
+    if ( !scorep_memory_recording )
+    {
+        return false;
+    }
+    if ( scorep_memory_sampling_interval == 0 )
+    {
+        return true;
+    }
+    return scorep_memory_sample_allocation( size, weight );
+}
+
+/**
+ * Decides whether the deallocation of @a ptr is recorded and removes it from
+ * the tracking. In sampling mode, only deallocations of sampled allocations
+ * are recorded, all others are rejected by the filter without a lookup.
+ */
+static inline bool
+scorep_memory_record_deallocation( void*  ptr,
+                                   void** allocation )
+{
+    *allocation = NULL;
+    if ( !scorep_memory_recording )
+    {
+        return false;
+    }
+    if ( scorep_memory_sampling_interval == 0 )
+    {
+        if ( ptr )
+        {
+            SCOREP_AllocMetric_AcquireAlloc( scorep_memory_metric,
+                                             ( uint64_t )ptr, allocation );
+        }
+        return true;
+    }
+    if ( ptr == NULL
+         || UTILS_Atomic_LoadN_uint32( scorep_memory_sampled_filter_counter( ( uint64_t )ptr ),
+                                       UTILS_ATOMIC_RELAXED ) == 0 )
+    {
+        return false;
+    }
+    return scorep_memory_acquire_sampled_allocation( ptr, allocation );
+}
+
 #endif /* SCOREP_MEMORY_MGMT_H */
@@ -0,0 +1,107 @@
+/**
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * @brief Allocation sampling of the memory adapter.
+ */
+
+#include <config.h>
+
+#include "scorep_memory_sampling.h"
+
+#include <math.h>
+
+
+uint32_t scorep_memory_sampled_filter[ 1 << SCOREP_MEMORY_SAMPLED_FILTER_EXPONENT ];
+
+
+/* xorshift64*, uniformly distributed in (0, 1] */
+static double
+next_uniform( scorep_memory_sampler* sampler )
+{
+    sampler->random_state ^= sampler->random_state >> 12;
+    sampler->random_state ^= sampler->random_state << 25;
+    sampler->random_state ^= sampler->random_state >> 27;
+    uint64_t value = sampler->random_state * UINT64_C( 0x2545f4914f6cdd1d );
+
+    return ( ( value >> 11 ) + 1 ) * ( 1.0 / ( UINT64_C( 1 ) << 53 ) );
+}
+
+
+void
+scorep_memory_sampler_init( scorep_memory_sampler* sampler,
+                            uint64_t               seed,
+                            uint64_t               interval )
+{
+    /* xorshift has the fixed point 0 */
+    sampler->random_state       = seed ? seed : 1;
+    sampler->bytes_until_sample = scorep_memory_sampler_next_distance( sampler, interval );
+}
+
+
+/* The sampled bytes form a Poisson process, thus the distances between
+ * samples are exponentially distributed. */
+int64_t
+scorep_memory_sampler_next_distance( scorep_memory_sampler* sampler,
+                                     uint64_t               interval )
+{
+    double distance = -log( next_uniform( sampler ) ) * interval;
+    if ( distance >= ( double )INT64_MAX )
+    {
+        return INT64_MAX;
+    }
+    return ( int64_t )distance + 1;
+}
+
+
+uint64_t
+scorep_memory_sample_weight( size_t   size,
+                             uint64_t interval )
+{
+    if ( size == 0 )
+    {
+        return 0;
+    }
+
+    /* An allocation of size bytes is sampled with probability
+     * 1 - exp( -size / interval ). */
+    double probability = -expm1( -( double )size / interval );
+    return ( uint64_t )( size / probability + 0.5 );
+}
+
+
+bool
+scorep_memory_sampler_sample( scorep_memory_sampler* sampler,
+                              uint64_t               interval,
+                              size_t                 size,
+                              uint64_t*              weight )
+{
+    *weight = size;
+
+    sampler->bytes_until_sample -= ( int64_t )size;
+    if ( sampler->bytes_until_sample > 0 )
+    {
+        return false;
+    }
+
+    /* A single allocation may cover several samples, it is recorded once. */
+    do
+    {
+        sampler->bytes_until_sample += scorep_memory_sampler_next_distance( sampler, interval );
+    }
+    while ( sampler->bytes_until_sample <= 0 );
+
+    *weight = scorep_memory_sample_weight( size, interval );
+    return true;
+}
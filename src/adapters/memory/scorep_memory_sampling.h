@@ -0,0 +1,94 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+
+#ifndef SCOREP_MEMORY_SAMPLING_H
+#define SCOREP_MEMORY_SAMPLING_H
+
+/**
+ * @file
+ *
+ * Allocation sampling of the memory adapter, independent of the measurement
+ * system.
+ */
+
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * State of the allocation sampling, usually one per location.
+ */
+typedef struct scorep_memory_sampler
+{
+    /* Remaining bytes until the next sampled allocation */
+    int64_t  bytes_until_sample;
+    uint64_t random_state;
+} scorep_memory_sampler;
+
+
+/**
+ * Seeds @a sampler with @a seed and draws the distance to the first sample.
+ */
+void
+scorep_memory_sampler_init( scorep_memory_sampler* sampler,
+                            uint64_t               seed,
+                            uint64_t               interval );
+
+/**
+ * Draws the distance in bytes to the next sample. The sampled bytes form a
+ * Poisson process with mean distance @a interval.
+ */
+int64_t
+scorep_memory_sampler_next_distance( scorep_memory_sampler* sampler,
+                                     uint64_t               interval );
+
+/**
+ * Estimated number of bytes, a sampled allocation of @a size bytes
+ * represents.
+ */
+uint64_t
+scorep_memory_sample_weight( size_t   size,
+                             uint64_t interval );
+
+/**
+ * Advances @a sampler by @a size bytes.
+ *
+ * @param[out] weight The estimated number of bytes, the allocation represents.
+ * @return true if the allocation is sampled.
+ */
+bool
+scorep_memory_sampler_sample( scorep_memory_sampler* sampler,
+                              uint64_t               interval,
+                              size_t                 size,
+                              uint64_t*              weight );
+
+
+#define SCOREP_MEMORY_SAMPLED_FILTER_EXPONENT 14
+
+/**
+ * Counting filter over the addresses of the sampled allocations, which are
+ * currently alive. A zero counter proves, that an address was not sampled.
+ */
+extern uint32_t scorep_memory_sampled_filter[ 1 << SCOREP_MEMORY_SAMPLED_FILTER_EXPONENT ];
+
+static inline uint32_t*
+scorep_memory_sampled_filter_counter( uint64_t addr )
+{
+    /* Fibonacci hashing, the low bits of addr are mostly zero due to alignment. */
+    return &scorep_memory_sampled_filter[ ( addr * UINT64_C( 0x9e3779b97f4a7c15 ) )
+                                          >> ( 64 - SCOREP_MEMORY_SAMPLED_FILTER_EXPONENT ) ];
+}
+
+#endif /* SCOREP_MEMORY_SAMPLING_H */
@@ -246,7 +246,10 @@ static THREAD_LOCAL_STORAGE_SPECIFIER task_t* tasks_free_list;
 
 /* convenience */
 #define RELEASE_AT_TEAM_END( TASK, OMPT_TASK_DATA ) \
-    UTILS_MutexWait(& ( TASK )->in_overdue_use, UTILS_ATOMIC_RELAXED ); \
+    while ( UTILS_Atomic_LoadN_bool( &( TASK )->in_overdue_use, UTILS_ATOMIC_RELAXED ) ) \
+    { \
+        UTILS_CPU_RELAX; \
+    } \
     ( OMPT_TASK_DATA )->ptr = ( TASK )->next; \
     release_parallel_region( ( TASK )->parallel_region ); \
     release_task_to_pool( TASK ); \
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2017, 2019, 2020, 2022,
+ * Copyright (c) 2009-2017, 2019, 2020, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -84,6 +84,16 @@ SCOREP_Sample( SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
     uint64_t         timestamp     = scorep_get_timestamp( location );
     uint64_t*        metric_values = SCOREP_Metric_Read( location );
 
+    if ( SCOREP_Unwinding_DeferSample( location,
+                                       contextPtr,
+                                       timestamp,
+                                       interruptGeneratorHandle,
+                                       metric_values ) )
+    {
+        /* The sample event is triggered, once its calling context is known */
+        return;
+    }
+
     SCOREP_CallingContextHandle current_calling_context  = SCOREP_INVALID_CALLING_CONTEXT;
     SCOREP_CallingContextHandle previous_calling_context = SCOREP_INVALID_CALLING_CONTEXT;
     uint32_t                    unwind_distance;
@@ -132,6 +142,33 @@ SCOREP_Location_DeactivateCpuSample( SCOREP_Location*            location,
                              metric_values ) );
 }
 
+
+/* Used by the unwinding to trigger samples recorded in deferred mode */
+void
+SCOREP_Location_DeferredCpuSample( SCOREP_Location*                location,
+                                   uint64_t                        timestamp,
+                                   SCOREP_CallingContextHandle     currentCallingContext,
+                                   SCOREP_CallingContextHandle     previousCallingContext,
+                                   uint32_t                        unwindDistance,
+                                   SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
+                                   uint64_t*                       metricValues )
+{
+    UTILS_BUG_ON( !SCOREP_IsUnwindingEnabled(), "Invalid call." );
+    UTILS_BUG_ON( !location || SCOREP_Location_GetType( location ) != SCOREP_LOCATION_TYPE_CPU_THREAD,
+                  "Only CPU locations allowed." );
+    UTILS_BUG_ON( timestamp > SCOREP_Location_GetLastTimestamp( location ),
+                  "Deferred sample from the future." );
+
+    SCOREP_CALL_SUBSTRATE( Sample, SAMPLE,
+                           ( location,
+                             timestamp,
+                             currentCallingContext,
+                             previousCallingContext,
+                             unwindDistance,
+                             interruptGeneratorHandle,
+                             metricValues ) );
+}
+
 void
 SCOREP_EnterWrapper( SCOREP_RegionHandle regionHandle )
 {
@@ -237,6 +274,7 @@ SCOREP_Location_EnterRegion( SCOREP_Location*    location,
         location = SCOREP_Location_GetCurrentCPULocation();
     }
 
+    scorep_process_deferred_samples( location );
     SCOREP_Location_SetLastTimestamp( location, timestamp );
 
     uint64_t* metric_values = SCOREP_Metric_Read( location );
@@ -360,6 +398,7 @@ SCOREP_Location_ExitRegion( SCOREP_Location*    location,
         location = SCOREP_Location_GetCurrentCPULocation();
     }
 
+    scorep_process_deferred_samples( location );
     SCOREP_Location_SetLastTimestamp( location, timestamp );
 
     uint64_t* metric_values = SCOREP_Metric_Read( location );
@@ -638,6 +677,7 @@ void
 SCOREP_MpiCollectiveBegin( void )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -679,6 +719,7 @@ void
 SCOREP_MpiNonBlockingCollectiveRequest( SCOREP_MpiRequestId requestId )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -819,6 +860,8 @@ SCOREP_Location_RmaWinCreate( SCOREP_Location*       location,
                               uint64_t               timestamp,
                               SCOREP_RmaWindowHandle windowHandle )
 {
+    scorep_process_deferred_samples( location );
+
     SCOREP_CALL_SUBSTRATE( RmaWinCreate, RMA_WIN_CREATE,
                            ( location, timestamp, windowHandle ) );
 }
@@ -840,6 +883,8 @@ SCOREP_Location_RmaWinDestroy( SCOREP_Location*       location,
                                uint64_t               timestamp,
                                SCOREP_RmaWindowHandle windowHandle )
 {
+    scorep_process_deferred_samples( location );
+
     SCOREP_CALL_SUBSTRATE( RmaWinDestroy, RMA_WIN_DESTROY,
                            ( location, timestamp, windowHandle ) );
 }
@@ -879,6 +924,7 @@ SCOREP_RmaGroupSync( SCOREP_RmaSyncLevel    syncLevel,
                      SCOREP_GroupHandle     groupHandle )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -895,6 +941,7 @@ SCOREP_RmaRequestLock( SCOREP_RmaWindowHandle windowHandle,
                        SCOREP_LockType        lockType )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -911,6 +958,7 @@ SCOREP_RmaAcquireLock( SCOREP_RmaWindowHandle windowHandle,
                        SCOREP_LockType        lockType )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -927,6 +975,7 @@ SCOREP_RmaTryLock( SCOREP_RmaWindowHandle windowHandle,
                    SCOREP_LockType        lockType )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -942,6 +991,7 @@ SCOREP_RmaReleaseLock( SCOREP_RmaWindowHandle windowHandle,
                        uint64_t               lockId )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -956,6 +1006,7 @@ SCOREP_RmaSync( SCOREP_RmaWindowHandle windowHandle,
                 SCOREP_RmaSyncType     syncType )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -968,6 +1019,7 @@ void
 SCOREP_RmaWaitChange( SCOREP_RmaWindowHandle windowHandle )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
     UTILS_DEBUG_PRINTF( SCOREP_DEBUG_EVENTS, "RMA window:%x", windowHandle );
@@ -1000,6 +1052,8 @@ SCOREP_Location_RmaPut( SCOREP_Location*       location,
                         uint64_t               bytes,
                         uint64_t               matchingId )
 {
+    scorep_process_deferred_samples( location );
+
     SCOREP_CALL_SUBSTRATE( RmaPut, RMA_PUT,
                            ( location, timestamp, windowHandle,
                              remote, bytes, matchingId ) );
@@ -1030,6 +1084,8 @@ SCOREP_Location_RmaGet( SCOREP_Location*       location,
                         uint64_t               bytes,
                         uint64_t               matchingId )
 {
+    scorep_process_deferred_samples( location );
+
     SCOREP_CALL_SUBSTRATE( RmaGet, RMA_GET,
                            ( location, timestamp, windowHandle,
                              remote, bytes, matchingId ) );
@@ -1045,6 +1101,7 @@ SCOREP_RmaAtomic( SCOREP_RmaWindowHandle windowHandle,
                   uint64_t               matchingId )
 {
     SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t timestamp = SCOREP_Location_GetLastTimestamp( location );
 
@@ -1072,6 +1129,8 @@ SCOREP_Location_RmaOpCompleteBlocking( SCOREP_Location*       location,
                                        SCOREP_RmaWindowHandle windowHandle,
                                        uint64_t               matchingId )
 {
+    scorep_process_deferred_samples( location );
+
     SCOREP_CALL_SUBSTRATE( RmaOpCompleteBlocking, RMA_OP_COMPLETE_BLOCKING,
                            ( location, timestamp, windowHandle, matchingId ) );
 }
@@ -1376,6 +1435,8 @@ SCOREP_Location_TriggerCounterUint64( SCOREP_Location*         location,
                                       SCOREP_SamplingSetHandle counterHandle,
                                       uint64_t                 value )
 {
+    scorep_process_deferred_samples( location );
+
     trigger_counter_uint64( location, timestamp, counterHandle, value );
 }
 
@@ -1459,6 +1520,7 @@ SCOREP_Location_TriggerParameterUint64( SCOREP_Location*       location,
         location = SCOREP_Location_GetCurrentCPULocation();
     }
 
+    scorep_process_deferred_samples( location );
     SCOREP_Location_SetLastTimestamp( location, timestamp );
 
     SCOREP_CALL_SUBSTRATE( TriggerParameterUint64, TRIGGER_PARAMETER_UINT64,
@@ -1512,6 +1574,7 @@ SCOREP_Location_TriggerParameterString( SCOREP_Location*       location,
         location = SCOREP_Location_GetCurrentCPULocation();
     }
 
+    scorep_process_deferred_samples( location );
     SCOREP_Location_SetLastTimestamp( location, timestamp );
 
     SCOREP_StringHandle string_handle = SCOREP_Definitions_NewString( value );
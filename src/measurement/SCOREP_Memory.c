@@ -38,6 +38,7 @@
 
 #include <config.h>
 #include <SCOREP_Memory.h>
+#include <SCOREP_Definitions.h>
 #include <UTILS_Error.h>
 #include <UTILS_Mutex.h>
 #include "scorep_environment.h"
@@ -71,6 +72,12 @@ typedef enum memory_tracking
     SCORER_MEMORY_TRACKING_SHIFT
 } memory_tracking;
 
+/*
+ * Number of single pages the page managers of the locations fetch at once
+ * from the allocator and keep in their private caches.
+ */
+#define PAGE_CACHE_SIZE 4
+
 /*
  * Global in order to have it allocated during initialization time and not
  * in the event of out-of-memory
@@ -88,6 +95,7 @@ static UTILS_Mutex out_of_memory_mutex;
 /// The one and only allocator for the measurement and the adapters
 static SCOREP_Allocator_Allocator* allocator;
 static uint32_t                    total_memory;
+static uint32_t                    memory_limit;
 static uint32_t                    page_size;
 
 static bool is_initialized;
@@ -95,6 +103,22 @@ static bool out_of_memory;
 
 static SCOREP_Allocator_PageManager* definitions_page_manager;
 
+/*
+ * Page managers used for local definitions by the threads, which are merged
+ * into definitions_page_manager before unification.
+ */
+struct definitions_page_manager_list
+{
+    struct definitions_page_manager_list* next;
+    SCOREP_Allocator_PageManager*         page_manager;
+};
+/* protected by memory_lock */
+static struct definitions_page_manager_list* definitions_page_managers_head;
+static bool                                  definitions_page_managers_merged;
+/* Incremented by every SCOREP_Memory_Initialize, page managers of the threads
+ * from an earlier initialization are gone. */
+static uint32_t definitions_page_managers_generation;
+
 /*
  * All tracing event page managers. Memory stats needs to access these,
  * but they cannot be assigned reliable to the location.
@@ -109,6 +133,7 @@ static struct tracing_page_manager_list* tracing_page_managers_head;
 
 void
 SCOREP_Memory_Initialize( uint64_t totalMemory,
+                          uint64_t memoryLimit,
                           uint64_t pageSize )
 {
     if ( is_initialized )
@@ -124,6 +149,10 @@ SCOREP_Memory_Initialize( uint64_t totalMemory,
                        "total memory per process. Reducing to its maximum value." );
         totalMemory = UINT32_MAX;
     }
+    if ( memoryLimit == 0 || memoryLimit > UINT32_MAX )
+    {
+        memoryLimit = UINT32_MAX;
+    }
 
     UTILS_BUG_ON( totalMemory < pageSize,
                   "Requested page size must fit into the total memory "
@@ -131,10 +160,12 @@ SCOREP_Memory_Initialize( uint64_t totalMemory,
                   totalMemory, pageSize );
 
     total_memory = totalMemory;
+    memory_limit = memoryLimit;
     page_size    = pageSize;
 
-    allocator = SCOREP_Allocator_CreateAllocator(
+    allocator = SCOREP_Allocator_CreateGrowableAllocator(
         &total_memory,
+        &memory_limit,
         &page_size,
         ( SCOREP_Allocator_Guard )UTILS_MutexLock,
         ( SCOREP_Allocator_Guard )UTILS_MutexUnlock,
@@ -146,6 +177,8 @@ SCOREP_Memory_Initialize( uint64_t totalMemory,
                   totalMemory, pageSize );
 
     assert( definitions_page_manager == 0 );
+    definitions_page_managers_merged = false;
+    definitions_page_managers_generation++;
     definitions_page_manager = SCOREP_Allocator_CreatePageManager( allocator );
     UTILS_BUG_ON( !definitions_page_manager,
                   "Cannot create definitions manager." );
@@ -162,6 +195,7 @@ SCOREP_Memory_Finalize( void )
     is_initialized = false;
 
     assert( definitions_page_manager );
+    SCOREP_Memory_MergeDefinitionPageManagers();
     SCOREP_Allocator_DeletePageManager( definitions_page_manager );
     definitions_page_manager = 0;
 
@@ -184,9 +218,28 @@ SCOREP_Memory_HandleOutOfMemory( void )
         abort();
     }
 
-    UTILS_ERROR( SCOREP_ERROR_MEMORY_OUT_OF_PAGES,
-                 "Out of memory. Please increase SCOREP_TOTAL_MEMORY=%zu and try again.",
-                 total_memory );
+    /* The allocator rounds the limit down to a multiple of the page size,
+     * thus no further page fits if we are within one page of 4 GiB. */
+    if ( memory_limit > UINT32_MAX - page_size )
+    {
+        UTILS_ERROR( SCOREP_ERROR_MEMORY_OUT_OF_PAGES,
+                     "Out of memory. SCOREP_TOTAL_MEMORY_LIMIT=%" PRIu32 " is already at "
+                     "its maximum. Please reduce the measurement overhead, e.g., by "
+                     "filtering, and try again.",
+                     memory_limit );
+    }
+    else if ( memory_limit > total_memory )
+    {
+        UTILS_ERROR( SCOREP_ERROR_MEMORY_OUT_OF_PAGES,
+                     "Out of memory. Please increase SCOREP_TOTAL_MEMORY_LIMIT=%" PRIu32 " and try again.",
+                     memory_limit );
+    }
+    else
+    {
+        UTILS_ERROR( SCOREP_ERROR_MEMORY_OUT_OF_PAGES,
+                     "Out of memory. Please increase SCOREP_TOTAL_MEMORY=%" PRIu32 " and try again.",
+                     total_memory );
+    }
     if ( SCOREP_Env_DoTracing() )
     {
         UTILS_ERROR( SCOREP_ERROR_MEMORY_OUT_OF_PAGES,
@@ -210,7 +263,7 @@ SCOREP_Allocator_PageManager*
 SCOREP_Memory_CreatePageManager( void )
 {
     SCOREP_Allocator_PageManager* page_manager =
-        SCOREP_Allocator_CreatePageManager( allocator );
+        SCOREP_Allocator_CreateCachedPageManager( allocator, PAGE_CACHE_SIZE );
     if ( !page_manager )
     {
         /* aborts */
@@ -474,6 +527,39 @@ SCOREP_Location_AllocForProfile( SCOREP_Location* location, size_t size )
 }
 
 
+void*
+SCOREP_Location_AlignedAllocForProfile( SCOREP_Location* location,
+                                        size_t           alignment,
+                                        size_t           size )
+{
+    if ( size == 0 )
+    {
+        return NULL;
+    }
+    if ( alignment < SCOREP_ALLOCATOR_ALIGNMENT )
+    {
+        return NULL;
+    }
+    /* alignment power of two */
+    if ( ( alignment & ( alignment - 1 ) ) != 0 )
+    {
+        return NULL;
+    }
+
+    void* mem = SCOREP_Allocator_AlignedAlloc(
+        SCOREP_Location_GetOrCreateMemoryPageManager( location,
+                                                      SCOREP_MEMORY_TYPE_PROFILING ),
+        alignment,
+        size );
+    if ( !mem )
+    {
+        /* aborts */
+        SCOREP_Memory_HandleOutOfMemory();
+    }
+    return mem;
+}
+
+
 void
 SCOREP_Memory_FreeProfileMem( SCOREP_Location* location )
 {
@@ -483,6 +569,106 @@ SCOREP_Memory_FreeProfileMem( SCOREP_Location* location )
 }
 
 
+#if HAVE( THREAD_LOCAL_STORAGE )
+static THREAD_LOCAL_STORAGE_SPECIFIER SCOREP_Allocator_PageManager* thread_definitions_page_manager;
+
+/*
+ * Local definitions are allocated from a page manager per thread until
+ * unification, thus creating them does not need a process-wide lock.
+ */
+static THREAD_LOCAL_STORAGE_SPECIFIER SCOREP_Allocator_PageManager* own_definitions_page_manager;
+static THREAD_LOCAL_STORAGE_SPECIFIER uint32_t                      own_definitions_page_manager_generation;
+
+static SCOREP_Allocator_PageManager*
+create_own_definitions_page_manager( void )
+{
+    SCOREP_Allocator_PageManager* page_manager =
+        SCOREP_Allocator_CreatePageManager( allocator );
+    if ( !page_manager )
+    {
+        /* aborts */
+        SCOREP_Memory_HandleOutOfMemory();
+    }
+
+    /* The entry lives in the page manager itself and becomes part of the
+     * definitions page manager, after merging. */
+    struct definitions_page_manager_list* new_entry =
+        SCOREP_Allocator_Alloc( page_manager, sizeof( *new_entry ) );
+    if ( !new_entry )
+    {
+        /* aborts */
+        SCOREP_Memory_HandleOutOfMemory();
+    }
+    new_entry->page_manager = page_manager;
+
+    UTILS_MutexLock( &memory_lock );
+    new_entry->next                = definitions_page_managers_head;
+    definitions_page_managers_head = new_entry;
+    UTILS_MutexUnlock( &memory_lock );
+
+    own_definitions_page_manager            = page_manager;
+    own_definitions_page_manager_generation = definitions_page_managers_generation;
+    return page_manager;
+}
+#endif
+
+
+static inline SCOREP_Allocator_PageManager*
+get_definitions_page_manager( void )
+{
+#if HAVE( THREAD_LOCAL_STORAGE )
+    if ( thread_definitions_page_manager )
+    {
+        return thread_definitions_page_manager;
+    }
+    if ( !definitions_page_managers_merged )
+    {
+        if ( own_definitions_page_manager
+             && own_definitions_page_manager_generation == definitions_page_managers_generation )
+        {
+            return own_definitions_page_manager;
+        }
+        return create_own_definitions_page_manager();
+    }
+#endif
+    return definitions_page_manager;
+}
+
+
+void
+SCOREP_Memory_MergeDefinitionPageManagers( void )
+{
+    if ( definitions_page_managers_merged )
+    {
+        return;
+    }
+    definitions_page_managers_merged = true;
+
+    struct definitions_page_manager_list* entry = definitions_page_managers_head;
+    definitions_page_managers_head = NULL;
+    while ( entry )
+    {
+        struct definitions_page_manager_list* next         = entry->next;
+        SCOREP_Allocator_PageManager*         page_manager = entry->page_manager;
+        SCOREP_Allocator_MovePages( definitions_page_manager, page_manager );
+        SCOREP_Allocator_DeletePageManager( page_manager );
+        entry = next;
+    }
+}
+
+
+bool
+SCOREP_Memory_SetThreadDefinitionPageManager( SCOREP_Allocator_PageManager* pageManager )
+{
+#if HAVE( THREAD_LOCAL_STORAGE )
+    thread_definitions_page_manager = pageManager;
+    return true;
+#else
+    return pageManager == NULL;
+#endif
+}
+
+
 SCOREP_Allocator_MovableMemory
 SCOREP_Memory_AllocForDefinitions( SCOREP_Location* location,
                                    size_t           size )
@@ -493,7 +679,7 @@ SCOREP_Memory_AllocForDefinitions( SCOREP_Location* location,
         return SCOREP_MOVABLE_NULL;
     }
 
-    SCOREP_Allocator_PageManager* page_manager = definitions_page_manager;
+    SCOREP_Allocator_PageManager* page_manager = get_definitions_page_manager();
     if ( location )
     {
         page_manager = SCOREP_Location_GetOrCreateMemoryPageManager(
@@ -512,6 +698,14 @@ SCOREP_Memory_AllocForDefinitions( SCOREP_Location* location,
 }
 
 
+void
+SCOREP_Memory_RollbackAllocForDefinitions( SCOREP_Allocator_MovableMemory movableMemory )
+{
+    SCOREP_Allocator_RollbackAllocMovable( get_definitions_page_manager(),
+                                           movableMemory );
+}
+
+
 void
 SCOREP_Memory_FreeDefinitionMem( void )
 {
@@ -559,12 +753,17 @@ SCOREP_Memory_DumpStats( const char* message )
         {
             memory_dump_stats_common( message, SCOREP_Status_GetRank() == 0 );
             memory_dump_stats_aggr();
+            if ( SCOREP_Status_GetRank() == 0 )
+            {
+                SCOREP_Definitions_DumpLookupCacheStats( false );
+            }
         }
         else
         if ( strcmp( getenv( "SCOREP_DEVELOPMENT_MEMORY_STATS" ), "full" ) == 0 )
         {
             memory_dump_stats_common( message, SCOREP_Status_GetRank() == 0 );
             memory_dump_stats_full();
+            SCOREP_Definitions_DumpLookupCacheStats( true );
         }
     }
 }
@@ -612,6 +811,13 @@ memory_dump_stats_common( const char* message, bool report )
     {
         SCOREP_Allocator_GetPageManagerStats( definitions_page_manager, &stats[ SCORER_MEMORY_TRACKING_DEFINITIONS ] );
     }
+    struct definitions_page_manager_list* definitions_page_manager_entry = definitions_page_managers_head;
+    while ( definitions_page_manager_entry )
+    {
+        SCOREP_Allocator_GetPageManagerStats( definitions_page_manager_entry->page_manager,
+                                              &stats[ SCORER_MEMORY_TRACKING_DEFINITIONS ] );
+        definitions_page_manager_entry = definitions_page_manager_entry->next;
+    }
     SCOREP_Location_ForAll( memory_dump_for_location, NULL );
 
     /* Tracing page managers are collected separately */
@@ -631,9 +837,12 @@ memory_dump_stats_common( const char* message, bool report )
         /* requested */
         fprintf( stderr,     "[Score-P] Memory: Requested:\n" );
         fprintf( stderr,     "[Score-P] %-55s %-15" PRIu32 "\n", "SCOREP_TOTAL_MEMORY [bytes]", total_memory );
+        fprintf( stderr,     "[Score-P] %-55s %-15" PRIu32 "\n", "SCOREP_TOTAL_MEMORY_LIMIT [bytes]", memory_limit );
         fprintf( stderr,     "[Score-P] %-55s %-15" PRIu32 "\n", "SCOREP_PAGE_SIZE [bytes]", page_size );
-        fprintf( stderr,     "[Score-P] %-55s %-15" PRIu32 "\n\n", "Number of pages of size SCOREP_PAGE_SIZE",
+        fprintf( stderr,     "[Score-P] %-55s %-15" PRIu32 "\n", "Number of pages of size SCOREP_PAGE_SIZE",
                  SCOREP_Allocator_GetMaxNumberOfPages( allocator ) );
+        fprintf( stderr,     "[Score-P] %-55s %-15" PRIu32 "\n\n", "Number of committed pages of size SCOREP_PAGE_SIZE",
+                 SCOREP_Allocator_GetNumberOfCommittedPages( allocator ) );
     }
 }
 
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2017, 2019-2020, 2022,
+ * Copyright (c) 2009-2017, 2019-2020, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -65,6 +65,7 @@
 #include <UTILS_Debug.h>
 #include <UTILS_CStr.h>
 #include <UTILS_IO.h>
+#include <UTILS_Mutex.h>
 
 #include <SCOREP_InMeasurement.h>
 #include <SCOREP_Memory.h>
@@ -86,6 +87,7 @@
 #include "scorep_type_utils.h"
 #include "scorep_subsystem_management.h"
 #include "scorep_environment.h"
+#include "scorep_events_common.h"
 #include "scorep_status.h"
 #include "scorep_ipc.h"
 #include <SCOREP_Thread_Mgmt.h>
@@ -473,6 +475,12 @@ SCOREP_InitMeasurementWithArgs( int argc, char* argv[] )
                      "\'scorep-info config-vars --full\'." );
     }
 
+    /* Contention is only counted for SCOREP_DEVELOPMENT_MUTEX_STATS, as the
+     * per-mutex counters cost a table scan in every contended lock. */
+    UTILS_MutexConfigure( SCOREP_Env_GetMutexMode(),
+                          SCOREP_Env_GetMutexSpinCount(),
+                          getenv( "SCOREP_DEVELOPMENT_MUTEX_STATS" ) != NULL );
+
     /*
      * @dependsOn Environment variables
      */
@@ -499,7 +507,9 @@ SCOREP_InitMeasurementWithArgs( int argc, char* argv[] )
     SCOREP_TIME( SCOREP_Status_Initialize, ( ) );
 
     SCOREP_TIME( SCOREP_Memory_Initialize,
-                 ( SCOREP_Env_GetTotalMemory(), SCOREP_Env_GetPageSize() ) );
+                 ( SCOREP_Env_GetTotalMemory(),
+                   SCOREP_Env_GetTotalMemoryLimit(),
+                   SCOREP_Env_GetPageSize() ) );
 
 
     SCOREP_TIME( SCOREP_Paradigms_Initialize, ( ) );
@@ -742,9 +752,10 @@ SCOREP_EnableRecording( void )
 {
     UTILS_DEBUG_ENTRY();
 
-    SCOREP_Location* location      = SCOREP_Location_GetCurrentCPULocation();
-    uint64_t         timestamp     = SCOREP_Timer_GetClockTicks();
-    uint64_t*        metric_values = SCOREP_Metric_Read( location );
+    SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
+    uint64_t  timestamp     = SCOREP_Timer_GetClockTicks();
+    uint64_t* metric_values = SCOREP_Metric_Read( location );
 
     if ( !SCOREP_Thread_InParallel() )
     {
@@ -773,9 +784,10 @@ SCOREP_DisableRecording( void )
 {
     UTILS_DEBUG_ENTRY();
 
-    SCOREP_Location* location      = SCOREP_Location_GetCurrentCPULocation();
-    uint64_t         timestamp     = SCOREP_Timer_GetClockTicks();
-    uint64_t*        metric_values = SCOREP_Metric_Read( location );
+    SCOREP_Location* location = SCOREP_Location_GetCurrentCPULocation();
+    scorep_process_deferred_samples( location );
+    uint64_t  timestamp     = SCOREP_Timer_GetClockTicks();
+    uint64_t* metric_values = SCOREP_Metric_Read( location );
 
     if ( !SCOREP_Thread_InParallel() )
     {
@@ -876,6 +888,34 @@ init_mpp( SCOREP_SynchronizationMode syncMode )
 }
 
 
+static void
+dump_mutex_contention( const UTILS_Mutex* mutex,
+                       uint64_t           contended,
+                       uint64_t           parked,
+                       void*              arg )
+{
+    fprintf( stderr, "[Score-P] %-55p %-15" PRIu64 " %-15" PRIu64 "\n",
+             ( const void* )mutex, contended, parked );
+}
+
+
+/* Lists the contended UTILS_Mutex objects, their addresses can be resolved
+ * with a debugger. */
+static void
+mutex_dump_stats( void )
+{
+    if ( getenv( "SCOREP_DEVELOPMENT_MUTEX_STATS" ) == NULL )
+    {
+        return;
+    }
+
+    fprintf( stderr, "[Score-P] Contended mutexes of rank %d\n", SCOREP_Status_GetRank() );
+    fprintf( stderr, "[Score-P] %-55s %-15s %-15s\n", "Mutex", "contended", "parked" );
+    UTILS_MutexForEachContended( dump_mutex_contention, NULL );
+    fprintf( stderr, "\n" );
+}
+
+
 static void
 scorep_finalize( void )
 {
@@ -968,6 +1008,7 @@ scorep_finalize( void )
     SCOREP_Memory_DumpStats( "[Score-P] ========= Just before unification ============ " );
     SCOREP_TIME( SCOREP_Unify, ( ) );
     SCOREP_Memory_DumpStats( "[Score-P] ========= Just after unification ============= " );
+    mutex_dump_stats();
 
     SCOREP_TIME( SCOREP_Substrates_WriteData, ( ) );
 
@@ -49,12 +49,16 @@
 #include "scorep_runtime_management.h"
 #include <scorep/SCOREP_PublicTypes.h>
 #include <SCOREP_Memory.h>
+#include <SCOREP_InMeasurement.h>
 #include <scorep_system_tree_sequence.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
 #include "scorep_ipc.h"
+#include "scorep_definitions_private.h"
 #include <jenkins_hash.h>
 #include <tracing/SCOREP_Tracing.h>
 
@@ -66,7 +70,8 @@ SCOREP_DefinitionManager* scorep_unified_definition_manager = 0;
 static bool               definitions_initialized           = false;
 
 
-/* global definition lock */
+/* global definition lock, for creating definitions which update other
+ * definitions or own lists, the manager entries have their own locks */
 static UTILS_Mutex definitions_lock;
 
 void
@@ -107,19 +112,312 @@ SCOREP_Definitions_Initialized( void )
 }
 
 
+struct scorep_definitions_lookup_cache
+{
+    scorep_definitions_lookup_cache* next;
+    uint64_t                         lookups[ SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES ];
+    uint64_t                         hits[ SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES ];
+    SCOREP_AnyHandle                 slots[ SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES ]
+    [ hashsize( SCOREP_DEFINITIONS_LOOKUP_CACHE_POWER ) ];
+};
+
+
+/* All caches, for the statistics */
+static scorep_definitions_lookup_cache* lookup_caches_head;
+static UTILS_Mutex                      lookup_caches_lock;
+
+/* Incremented by SCOREP_Definitions_Finalize, which frees all caches */
+static uint32_t lookup_caches_generation;
+
+#if HAVE( THREAD_LOCAL_STORAGE )
+static THREAD_LOCAL_STORAGE_SPECIFIER scorep_definitions_lookup_cache* thread_lookup_cache;
+static THREAD_LOCAL_STORAGE_SPECIFIER uint32_t                         thread_lookup_cache_generation;
+#endif
+
+
+static scorep_definitions_lookup_cache*
+get_lookup_cache( void )
+{
+#if HAVE( THREAD_LOCAL_STORAGE )
+    /* The caches are freed with the definitions */
+    if ( !definitions_initialized )
+    {
+        return NULL;
+    }
+
+    scorep_definitions_lookup_cache* cache = thread_lookup_cache;
+    if ( cache && thread_lookup_cache_generation != lookup_caches_generation )
+    {
+        /* Freed by an earlier SCOREP_Definitions_Finalize */
+        cache = NULL;
+    }
+    if ( cache || SCOREP_IN_SIGNAL_CONTEXT() )
+    {
+        return cache;
+    }
+
+    /* Not from location memory, the thread may not have a location yet */
+    cache = calloc( 1, sizeof( *cache ) );
+    if ( !cache )
+    {
+        return NULL;
+    }
+
+    UTILS_MutexLock( &lookup_caches_lock );
+    cache->next        = lookup_caches_head;
+    lookup_caches_head = cache;
+    UTILS_MutexUnlock( &lookup_caches_lock );
+
+    thread_lookup_cache            = cache;
+    thread_lookup_cache_generation = lookup_caches_generation;
+    return cache;
+#else
+    /* Without thread-local storage, the cache would need a lock too. */
+    return NULL;
+#endif
+}
+
+
+SCOREP_AnyHandle*
+scorep_definitions_lookup_cache_get_slot( scorep_definitions_lookup_cache_type type,
+                                          uint32_t                             hashValue )
+{
+    scorep_definitions_lookup_cache* cache = get_lookup_cache();
+    if ( !cache )
+    {
+        return NULL;
+    }
+
+    cache->lookups[ type ]++;
+    return &cache->slots[ type ][ hashValue & hashmask( SCOREP_DEFINITIONS_LOOKUP_CACHE_POWER ) ];
+}
+
+
+void
+scorep_definitions_lookup_cache_hit( scorep_definitions_lookup_cache_type type )
+{
+#if HAVE( THREAD_LOCAL_STORAGE )
+    thread_lookup_cache->hits[ type ]++;
+#endif
+}
+
+
+static const char*
+lookup_cache_type_2_string( scorep_definitions_lookup_cache_type type )
+{
+    switch ( type )
+    {
+        case SCOREP_DEFINITIONS_LOOKUP_CACHE_STRING:
+            return "strings";
+        case SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLPATH:
+            return "callpaths";
+        case SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLING_CONTEXT:
+            return "calling contexts";
+        default:
+            return "unknown";
+    }
+}
+
+
+static void
+dump_lookup_cache_stats( const char*     label,
+                         const uint64_t* lookups,
+                         const uint64_t* hits )
+{
+    for ( int type = 0; type < SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES; type++ )
+    {
+        char description[ 56 ];
+        snprintf( description, sizeof( description ), "%s%s: hits/lookups",
+                  label, lookup_cache_type_2_string( type ) );
+        fprintf( stderr, "[Score-P] %-55s %" PRIu64 "/%" PRIu64 " (%.1f%%)\n",
+                 description, hits[ type ], lookups[ type ],
+                 lookups[ type ] ? 100.0 * hits[ type ] / lookups[ type ] : 0.0 );
+    }
+}
+
+
+void
+SCOREP_Definitions_DumpLookupCacheStats( bool perThread )
+{
+    uint64_t lookups[ SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES ] = { 0 };
+    uint64_t hits[ SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES ]    = { 0 };
+    uint32_t thread                                                = 0;
+
+    fprintf( stderr, "[Score-P] Definition lookup caches\n" );
+
+    UTILS_MutexLock( &lookup_caches_lock );
+    for ( scorep_definitions_lookup_cache* cache = lookup_caches_head;
+          cache;
+          cache = cache->next, thread++ )
+    {
+        if ( perThread )
+        {
+            char label[ 32 ];
+            snprintf( label, sizeof( label ), "Thread %" PRIu32 " ", thread );
+            dump_lookup_cache_stats( label, cache->lookups, cache->hits );
+        }
+        for ( int type = 0; type < SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES; type++ )
+        {
+            lookups[ type ] += cache->lookups[ type ];
+            hits[ type ]    += cache->hits[ type ];
+        }
+    }
+    UTILS_MutexUnlock( &lookup_caches_lock );
+
+    dump_lookup_cache_stats( "All threads ", lookups, hits );
+    fprintf( stderr, "\n" );
+}
+
+
+/* Largest hash table, the handles need to be addressable with 32 bit */
+#define SCOREP_DEFINITIONS_MAX_HASH_TABLE_POWER ( 28 )
+
+/* The hash table grows, when it holds more definitions per bucket. */
+#define SCOREP_DEFINITIONS_HASH_TABLE_LOAD_FACTOR ( 2 )
+
+/* Number of chains moved into the grown hash table per added definition. */
+#define SCOREP_DEFINITIONS_REHASH_STEP ( 16 )
+
+/*
+ * Each hash table is preceded by this header, which links to the previous
+ * table of the entry. These are only freed together with the entry, as
+ * readers without the entry lock may still search them.
+ */
+typedef struct hash_table_header
+{
+    SCOREP_AnyHandle* previous;
+} hash_table_header;
+
+
+static SCOREP_AnyHandle*
+alloc_hash_table( uint32_t          hashTablePower,
+                  SCOREP_AnyHandle* previous )
+{
+    hash_table_header* header = calloc( 1, sizeof( *header )
+                                        + hashsize( hashTablePower ) * sizeof( SCOREP_AnyHandle ) );
+    if ( !header )
+    {
+        return NULL;
+    }
+    header->previous = previous;
+    return ( SCOREP_AnyHandle* )( header + 1 );
+}
+
+
 void
 scorep_definitions_manager_entry_alloc_hash_table( scorep_definitions_manager_entry* entry,
                                                    uint32_t                          hashTablePower )
 {
-    UTILS_BUG_ON( hashTablePower > 15,
+    UTILS_BUG_ON( hashTablePower > SCOREP_DEFINITIONS_MAX_HASH_TABLE_POWER,
                   "Hash table too big: %u", hashTablePower );
     entry->hash_table_mask = hashmask( hashTablePower );
-    entry->hash_table      = calloc( hashsize( hashTablePower ), sizeof( *entry->hash_table ) );
+    entry->hash_table      = alloc_hash_table( hashTablePower, NULL );
     UTILS_BUG_ON( entry->hash_table == 0,
                   "Can't allocate hash table of size %u",
                   hashTablePower );
 }
 
+
+void
+scorep_definitions_manager_entry_free_hash_table( scorep_definitions_manager_entry* entry )
+{
+    SCOREP_AnyHandle* hash_table = entry->hash_table;
+    while ( hash_table )
+    {
+        hash_table_header* header = ( hash_table_header* )hash_table - 1;
+        hash_table = header->previous;
+        free( header );
+    }
+    entry->hash_table     = NULL;
+    entry->old_hash_table = NULL;
+}
+
+
+/* Moves up to @a numberOfBuckets chains from the old into the current table. */
+static void
+rehash_buckets( scorep_definitions_manager_entry* entry,
+                SCOREP_Allocator_PageManager*     pageManager,
+                uint32_t                          numberOfBuckets )
+{
+    SCOREP_AnyHandle* old_hash_table = entry->old_hash_table;
+    uint32_t          old_size       = entry->old_hash_table_mask + 1;
+
+    while ( numberOfBuckets-- && entry->rehash_index < old_size )
+    {
+        SCOREP_AnyHandle* old_bucket = &old_hash_table[ entry->rehash_index++ ];
+        SCOREP_AnyHandle  handle     = *old_bucket;
+        while ( handle != SCOREP_MOVABLE_NULL )
+        {
+            SCOREP_AnyDef*    definition = SCOREP_HANDLE_DEREF( handle, Any, pageManager );
+            SCOREP_AnyHandle  next       = definition->hash_next;
+            SCOREP_AnyHandle* bucket     =
+                &entry->hash_table[ definition->hash_value & entry->hash_table_mask ];
+
+            /* First publish in the new chain, then remove from the old one,
+             * thus readers without the lock find it in at least one table,
+             * if they do not follow a moved hash_next. */
+            definition->hash_next = *bucket;
+            UTILS_Atomic_StoreN_uint32( bucket, handle, UTILS_ATOMIC_RELEASE );
+            UTILS_Atomic_StoreN_uint32( old_bucket, next, UTILS_ATOMIC_RELEASE );
+            handle = next;
+        }
+    }
+
+    if ( entry->rehash_index == old_size )
+    {
+        UTILS_Atomic_StoreN_void_ptr( &entry->old_hash_table, NULL, UTILS_ATOMIC_RELEASE );
+    }
+}
+
+
+void
+scorep_definitions_manager_entry_grow_hash_table( scorep_definitions_manager_entry* entry,
+                                                  SCOREP_Allocator_PageManager*     pageManager )
+{
+    if ( entry->old_hash_table )
+    {
+        rehash_buckets( entry, pageManager, SCOREP_DEFINITIONS_REHASH_STEP );
+        return;
+    }
+
+    uint64_t size = ( uint64_t )entry->hash_table_mask + 1;
+    if ( entry->counter <= SCOREP_DEFINITIONS_HASH_TABLE_LOAD_FACTOR * size
+         || size >= hashsize( SCOREP_DEFINITIONS_MAX_HASH_TABLE_POWER )
+         || SCOREP_IN_SIGNAL_CONTEXT() )
+    {
+        /* Not needed, not possible, or not safe to call calloc, try again
+         * with the next definition. */
+        return;
+    }
+
+    uint32_t          power      = 0;
+    SCOREP_AnyHandle* hash_table = NULL;
+    while ( hashsize( power ) < 2 * size )
+    {
+        power++;
+    }
+    hash_table = alloc_hash_table( power, entry->hash_table );
+    if ( !hash_table )
+    {
+        /* Keep the current table */
+        return;
+    }
+
+    /* The tables need to be published before their masks, see
+     * scorep_definitions_manager_entry_get_hash_chain(). */
+    entry->rehash_index = 0;
+    UTILS_Atomic_StoreN_void_ptr( &entry->old_hash_table, entry->hash_table,
+                                  UTILS_ATOMIC_RELEASE );
+    UTILS_Atomic_StoreN_uint32( &entry->old_hash_table_mask, entry->hash_table_mask,
+                                UTILS_ATOMIC_RELEASE );
+    UTILS_Atomic_StoreN_void_ptr( &entry->hash_table, hash_table,
+                                  UTILS_ATOMIC_RELEASE );
+    UTILS_Atomic_StoreN_uint32( &entry->hash_table_mask, hashmask( power ),
+                                UTILS_ATOMIC_RELEASE );
+
+    rehash_buckets( entry, pageManager, SCOREP_DEFINITIONS_REHASH_STEP );
+}
+
 #define SCOREP_DEFINITIONS_DEFAULT_HASH_TABLE_POWER ( 8 )
 
 /**
@@ -234,33 +532,33 @@ SCOREP_Definitions_InitializeDefinitionManager( SCOREP_DefinitionManager**    de
 static void
 finalize_definition_manager( SCOREP_DefinitionManager* definitionManager )
 {
-    free( definitionManager->string.hash_table );
-    free( definitionManager->system_tree_node.hash_table );
-    free( definitionManager->system_tree_node_property.hash_table );
-    free( definitionManager->source_file.hash_table );
-    free( definitionManager->region.hash_table );
-    free( definitionManager->group.hash_table );
-    free( definitionManager->interim_communicator.hash_table );
-    free( definitionManager->communicator.hash_table );
-    free( definitionManager->rma_window.hash_table );
-    free( definitionManager->cartesian_topology.hash_table );
-    free( definitionManager->cartesian_coords.hash_table );
-    free( definitionManager->metric.hash_table );
-    free( definitionManager->sampling_set.hash_table );
-    free( definitionManager->sampling_set_recorder.hash_table );
-    free( definitionManager->io_handle.hash_table );
-    free( definitionManager->io_file.hash_table );
-    free( definitionManager->io_file_property.hash_table );
-    free( definitionManager->marker_group.hash_table );
-    free( definitionManager->marker.hash_table );
-    free( definitionManager->parameter.hash_table );
-    free( definitionManager->callpath.hash_table );
-    free( definitionManager->property.hash_table );
-    free( definitionManager->attribute.hash_table );
-    free( definitionManager->location_property.hash_table );
-    free( definitionManager->source_code_location.hash_table );
-    free( definitionManager->calling_context.hash_table );
-    free( definitionManager->interrupt_generator.hash_table );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->string );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->system_tree_node );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->system_tree_node_property );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->source_file );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->region );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->group );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->interim_communicator );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->communicator );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->rma_window );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->cartesian_topology );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->cartesian_coords );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->metric );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->sampling_set );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->sampling_set_recorder );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->io_handle );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->io_file );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->io_file_property );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->marker_group );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->marker );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->parameter );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->callpath );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->property );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->attribute );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->location_property );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->source_code_location );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->calling_context );
+    scorep_definitions_manager_entry_free_hash_table( &definitionManager->interrupt_generator );
 }
 
 void
@@ -284,6 +582,16 @@ SCOREP_Definitions_Finalize( void )
     scorep_system_tree_seq_free();
 
     definitions_initialized = false;
+
+    UTILS_MutexLock( &lookup_caches_lock );
+    while ( lookup_caches_head )
+    {
+        scorep_definitions_lookup_cache* cache = lookup_caches_head;
+        lookup_caches_head = cache->next;
+        free( cache );
+    }
+    lookup_caches_generation++;
+    UTILS_MutexUnlock( &lookup_caches_lock );
 }
 
 
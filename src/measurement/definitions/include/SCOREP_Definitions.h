@@ -81,6 +81,7 @@ struct SCOREP_Allocator_PageManager;
 
 #include <SCOREP_Types.h>
 #include <UTILS_Error.h>
+#include <UTILS_Mutex.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -150,6 +151,13 @@ typedef struct scorep_definitions_manager_entry
     uint32_t          hash_table_mask;
     uint32_t          counter;
     uint32_t*         mapping;
+    /** Protects adding definitions, searching the hash table is lock-free. */
+    UTILS_Mutex       lock;
+    /** The previous hash table, while its chains are moved into hash_table. */
+    SCOREP_AnyHandle* old_hash_table;
+    uint32_t          old_hash_table_mask;
+    /** Next bucket of old_hash_table to move. */
+    uint32_t          rehash_index;
 } scorep_definitions_manager_entry;
 
 
@@ -162,12 +170,16 @@ typedef struct scorep_definitions_manager_entry
 static inline void
 scorep_definitions_manager_init_entry( scorep_definitions_manager_entry* entry )
 {
-    entry->head            = SCOREP_MOVABLE_NULL;
-    entry->tail            = &entry->head;
-    entry->hash_table      = 0;
-    entry->hash_table_mask = 0;
-    entry->counter         = 0;
-    entry->mapping         = 0;
+    entry->head                = SCOREP_MOVABLE_NULL;
+    entry->tail                = &entry->head;
+    entry->hash_table          = 0;
+    entry->hash_table_mask     = 0;
+    entry->counter             = 0;
+    entry->mapping             = 0;
+    entry->lock                = UTILS_MUTEX_INIT;
+    entry->old_hash_table      = 0;
+    entry->old_hash_table_mask = 0;
+    entry->rehash_index        = 0;
 }
 
 
@@ -175,12 +187,61 @@ scorep_definitions_manager_init_entry( scorep_definitions_manager_entry* entry )
  * Allocate memory for a definition type's hash_table in a
  * scorep_definitions_manager_entry @a entry, setting size
  * to 2^hashTablePower.
+ *
+ * The table grows, when definitions are added with
+ * SCOREP_DEFINITIONS_MANAGER_ENTRY_ADD_DEFINITION.
  */
 void
 scorep_definitions_manager_entry_alloc_hash_table( scorep_definitions_manager_entry* entry,
                                                    uint32_t                          hashTablePower );
 
 
+/**
+ * Frees all hash tables of @a entry, allocated by
+ * scorep_definitions_manager_entry_alloc_hash_table() or by growing.
+ */
+void
+scorep_definitions_manager_entry_free_hash_table( scorep_definitions_manager_entry* entry );
+
+
+/**
+ * Grows the hash table of @a entry, if it is loaded too much, or moves some
+ * chains from the previous table, if it is already growing. Needs to be
+ * called with the lock of @a entry held, after adding a definition.
+ */
+void
+scorep_definitions_manager_entry_grow_hash_table( scorep_definitions_manager_entry*    entry,
+                                                  struct SCOREP_Allocator_PageManager* pageManager );
+
+
+/**
+ * Returns the head of the hash chain for @a hashValue in the current
+ * (@a old == false) or the previous (@a old == true) hash table of
+ * @a entry. Can be called without the lock of @a entry, but the chain may
+ * be incomplete then.
+ */
+static inline SCOREP_AnyHandle
+scorep_definitions_manager_entry_get_hash_chain( scorep_definitions_manager_entry* entry,
+                                                 uint32_t                          hashValue,
+                                                 bool                              old )
+{
+    /* The tables only grow and are not freed while in use. The table is
+     * published before its mask, thus the index is always in range. */
+    uint32_t mask = UTILS_Atomic_LoadN_uint32(
+        old ? &entry->old_hash_table_mask : &entry->hash_table_mask,
+        UTILS_ATOMIC_ACQUIRE );
+    SCOREP_AnyHandle* hash_table = UTILS_Atomic_LoadN_void_ptr(
+        old ? &entry->old_hash_table : &entry->hash_table,
+        UTILS_ATOMIC_ACQUIRE );
+    if ( !hash_table )
+    {
+        return SCOREP_MOVABLE_NULL;
+    }
+    return UTILS_Atomic_LoadN_uint32( &hash_table[ hashValue & mask ],
+                                      UTILS_ATOMIC_ACQUIRE );
+}
+
+
 /**
  * Iterator functions for definition. The iterator variable is named
  * @definition.
@@ -432,6 +493,14 @@ void
 SCOREP_Definitions_Finalize( void );
 
 
+/**
+ * Prints the hit rates of the definition lookup caches of this process,
+ * for SCOREP_Memory_DumpStats(). With @a perThread, also for every thread.
+ */
+void
+SCOREP_Definitions_DumpLookupCacheStats( bool perThread );
+
+
 void
 SCOREP_Definitions_Lock( void );
 
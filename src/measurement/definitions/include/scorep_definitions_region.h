@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2013, 2017,
+ * Copyright (c) 2009-2013, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -136,6 +136,26 @@ SCOREP_RegionHandle_SetGroup( SCOREP_RegionHandle handle,
                               const char*         groupName );
 
 
+/**
+ * Replaces the name, canonical name, source file, and begin line of a region.
+ * Intended for adapters that define a region before these are known, e.g.,
+ * by its address only, and resolve them later on. Must be called before
+ * the unification.
+ *
+ * @param handle A region handle.
+ * @param regionName The new region name, see SCOREP_Definitions_NewRegion().
+ * @param regionCanonicalName The new canonical region name.
+ * @param fileHandle The new source file, may be SCOREP_INVALID_SOURCE_FILE.
+ * @param beginLine The new begin line, may be SCOREP_INVALID_LINE_NO.
+ */
+void
+SCOREP_RegionHandle_SetNameAndLocation( SCOREP_RegionHandle     handle,
+                                        const char*             regionName,
+                                        const char*             regionCanonicalName,
+                                        SCOREP_SourceFileHandle fileHandle,
+                                        SCOREP_LineNo           beginLine );
+
+
 uint32_t
 SCOREP_RegionHandle_GetId( SCOREP_RegionHandle handle );
 
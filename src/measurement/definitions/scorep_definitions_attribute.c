@@ -92,7 +92,7 @@ SCOREP_Definitions_NewAttribute( const char*          name,
 {
     UTILS_DEBUG_ENTRY( "%s", name );
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     SCOREP_AttributeHandle new_handle = define_attribute(
         &scorep_local_definition_manager,
@@ -104,7 +104,7 @@ SCOREP_Definitions_NewAttribute( const char*          name,
             description ? description : "" ),
         type );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
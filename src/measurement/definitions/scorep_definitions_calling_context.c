@@ -76,7 +76,28 @@ SCOREP_Definitions_NewCallingContext( uint64_t                        ip,
     UTILS_DEBUG_ENTRY( "ip %" PRIx64 ", region %u, scl %u, parent %u",
                        ip, region, scl, parent );
 
-    SCOREP_Definitions_Lock();
+    /* The cache compares like equal_calling_context() */
+    uint32_t                    key[ 3 ] = { region, scl, parent };
+    SCOREP_AnyHandle*           slot     = scorep_definitions_lookup_cache_get_slot(
+        SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLING_CONTEXT,
+        jenkins_hashword( key, 3, 0 ) );
+    SCOREP_CallingContextHandle cached = slot ? *slot : SCOREP_INVALID_CALLING_CONTEXT;
+    if ( cached != SCOREP_INVALID_CALLING_CONTEXT )
+    {
+        SCOREP_CallingContextDef* definition =
+            SCOREP_LOCAL_HANDLE_DEREF( cached, CallingContext );
+        if ( definition->ip_offset == 0
+             && definition->file_handle == SCOREP_INVALID_STRING
+             && definition->region_handle == region
+             && definition->scl_handle == scl
+             && definition->parent_handle == parent )
+        {
+            scorep_definitions_lookup_cache_hit( SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLING_CONTEXT );
+            return cached;
+        }
+    }
+
+    scorep_definitions_lock_new();
 
     SCOREP_CallingContextHandle new_handle = define_calling_context(
         &scorep_local_definition_manager,
@@ -87,7 +108,12 @@ SCOREP_Definitions_NewCallingContext( uint64_t                        ip,
         scl,
         parent );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
+
+    if ( slot )
+    {
+        *slot = new_handle;
+    }
 
 
     UTILS_DEBUG_EXIT( "ip %" PRIx64 ", region %u, scl %u, parent %u: %u",
@@ -253,7 +279,7 @@ SCOREP_Definitions_NewInterruptGenerator( const char*                   name,
 {
     UTILS_DEBUG_ENTRY();
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     SCOREP_InterruptGeneratorHandle new_handle = define_interrupt_generator(
         &scorep_local_definition_manager,
@@ -265,7 +291,7 @@ SCOREP_Definitions_NewInterruptGenerator( const char*                   name,
         exponent,
         period );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
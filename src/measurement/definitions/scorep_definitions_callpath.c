@@ -96,7 +96,29 @@ SCOREP_Definitions_NewCallpath( SCOREP_CallpathHandle                        par
 {
     UTILS_DEBUG_ENTRY();
 
-    SCOREP_Definitions_Lock();
+    /* Only callpaths without parameters are cached */
+    SCOREP_AnyHandle* slot = NULL;
+    if ( numberOfParameters == 0 )
+    {
+        uint32_t key[ 2 ] = { parentCallpath, region };
+        slot = scorep_definitions_lookup_cache_get_slot(
+            SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLPATH,
+            jenkins_hashword( key, 2, 0 ) );
+    }
+    SCOREP_CallpathHandle cached = slot ? *slot : SCOREP_INVALID_CALLPATH;
+    if ( cached != SCOREP_INVALID_CALLPATH )
+    {
+        SCOREP_CallpathDef* definition = SCOREP_LOCAL_HANDLE_DEREF( cached, Callpath );
+        if ( definition->parent_callpath_handle == parentCallpath
+             && definition->region_handle == region
+             && definition->number_of_parameters == 0 )
+        {
+            scorep_definitions_lookup_cache_hit( SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLPATH );
+            return cached;
+        }
+    }
+
+    scorep_definitions_lock_new();
 
     SCOREP_CallpathHandle new_handle = define_callpath(
         &scorep_local_definition_manager,
@@ -105,8 +127,12 @@ SCOREP_Definitions_NewCallpath( SCOREP_CallpathHandle                        par
         numberOfParameters,
         parameters );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
+    if ( slot )
+    {
+        *slot = new_handle;
+    }
 
     return new_handle;
 }
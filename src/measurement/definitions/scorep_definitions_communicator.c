@@ -513,9 +513,7 @@ define_communicator( SCOREP_DefinitionManager* definition_manager,
                     {
                         existing_definition->name_handle = new_definition->name_handle;
                     }
-                    SCOREP_Allocator_RollbackAllocMovable(
-                        definition_manager->page_manager,
-                        new_handle );
+                    SCOREP_Memory_RollbackAllocForDefinitions( new_handle );
                     return hash_list_iterator;
                 }
             }
@@ -87,7 +87,7 @@ SCOREP_Definitions_NewParameter( const char*          name,
 {
     UTILS_DEBUG_ENTRY( "%s", name );
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     SCOREP_ParameterHandle new_handle = define_parameter(
         &scorep_local_definition_manager,
@@ -96,7 +96,7 @@ SCOREP_Definitions_NewParameter( const char*          name,
             name ? name : "<unknown parameter>" ),
         type );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
@@ -147,6 +147,105 @@
 /* *INDENT-ON* */
 
 
+/**
+ * Creating definitions which only add to their manager entry, i.e., all
+ * which do not update other definitions or own lists, does not need the
+ * global definitions lock. The entries synchronize themselves, as long as
+ * the definition memory is private to the thread, see
+ * SCOREP_Memory_AllocForDefinitions(), which needs thread-local storage.
+ * @{
+ */
+static inline void
+scorep_definitions_lock_new( void )
+{
+#if !HAVE( THREAD_LOCAL_STORAGE )
+    SCOREP_Definitions_Lock();
+#endif
+}
+
+static inline void
+scorep_definitions_unlock_new( void )
+{
+#if !HAVE( THREAD_LOCAL_STORAGE )
+    SCOREP_Definitions_Unlock();
+#endif
+}
+/** @} */
+
+
+/**
+ * Small direct-mapped caches per thread in front of the lookups of
+ * frequently re-defined definitions. Definitions are never removed, thus the
+ * caches need no invalidation. A slot only hints at a handle, the caller
+ * needs to compare the definition with its key.
+ * @{
+ */
+#define SCOREP_DEFINITIONS_LOOKUP_CACHE_POWER 8
+
+typedef enum scorep_definitions_lookup_cache_type
+{
+    SCOREP_DEFINITIONS_LOOKUP_CACHE_STRING,
+    SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLPATH,
+    SCOREP_DEFINITIONS_LOOKUP_CACHE_CALLING_CONTEXT,
+
+    SCOREP_DEFINITIONS_NUMBER_OF_LOOKUP_CACHES
+} scorep_definitions_lookup_cache_type;
+
+typedef struct scorep_definitions_lookup_cache scorep_definitions_lookup_cache;
+
+/**
+ * Returns the slot for @a hashValue in the cache of @a type of the current
+ * thread. Returns NULL if the thread has no cache.
+ */
+SCOREP_AnyHandle*
+scorep_definitions_lookup_cache_get_slot( scorep_definitions_lookup_cache_type type,
+                                          uint32_t                             hashValue );
+
+/**
+ * Counts a hit in the cache of @a type of the current thread, after a
+ * successful scorep_definitions_lookup_cache_get_slot().
+ */
+void
+scorep_definitions_lookup_cache_hit( scorep_definitions_lookup_cache_type type );
+/** @} */
+
+
+/**
+ * Searches the hash chain, starting at @a hash_list_iterator, for a
+ * definition equal to @a new_definition. Leaves the found handle or
+ * SCOREP_MOVABLE_NULL in @a hash_list_iterator.
+ *
+ * Definitions are completely initialized before they are published in the
+ * bucket and are only moved between chains while the hash table grows, thus
+ * this does not need the entry lock. But without it, a definition may be
+ * missed.
+ */
+/* *INDENT-OFF* */
+#define SCOREP_DEFINITIONS_MANAGER_ENTRY_FIND_DEFINITION( Type, \
+                                                          type, \
+                                                          page_manager, \
+                                                          new_definition, \
+                                                          hash_list_iterator ) \
+    do \
+    { \
+        while ( hash_list_iterator != SCOREP_MOVABLE_NULL ) \
+        { \
+            SCOREP_ ## Type ## Def * existing_definition = \
+                SCOREP_Allocator_GetAddressFromMovableMemory( \
+                    page_manager, \
+                    hash_list_iterator ); \
+            if ( existing_definition->hash_value == new_definition->hash_value \
+                 && equal_ ## type( existing_definition, new_definition ) ) \
+            { \
+                break; \
+            } \
+            hash_list_iterator = existing_definition->hash_next; \
+        } \
+    } \
+    while ( 0 )
+/* *INDENT-ON* */
+
+
 /**
  * Search for the definition @a new_definition in the definition manager @a
  * definition_manager, if the manager has a hash table allocated.
@@ -156,6 +255,11 @@
  * If not, chain @a new_definition into the hash table and the definition
  * manager definitions list and assign the sequence number.
  *
+ * The search is first done without the entry lock. Only if the definition
+ * was not found, the lock is taken and the bucket searched again, before
+ * adding the new definition. While the hash table grows, the bucket in the
+ * previous table is searched, too.
+ *
  * @return Let return the calling function with the found definition's handle
  *         or the new definition as return value.
  *
@@ -173,32 +277,75 @@
     { \
         if ( ( entry )->hash_table ) \
         { \
-            SCOREP_AnyHandle* hash_table_bucket = \
-                &( entry )->hash_table[ \
-                    new_definition->hash_value & ( entry )->hash_table_mask ]; \
-            SCOREP_AnyHandle hash_list_iterator = *hash_table_bucket; \
-            while ( hash_list_iterator != SCOREP_MOVABLE_NULL ) \
+            SCOREP_AnyHandle hash_list_iterator = \
+                scorep_definitions_manager_entry_get_hash_chain( \
+                    entry, new_definition->hash_value, false ); \
+            SCOREP_DEFINITIONS_MANAGER_ENTRY_FIND_DEFINITION( Type, \
+                                                              type, \
+                                                              page_manager, \
+                                                              new_definition, \
+                                                              hash_list_iterator ); \
+            if ( hash_list_iterator == SCOREP_MOVABLE_NULL ) \
             { \
-                SCOREP_ ## Type ## Def * existing_definition = \
-                    SCOREP_Allocator_GetAddressFromMovableMemory( \
-                        page_manager, \
-                        hash_list_iterator ); \
-                if ( existing_definition->hash_value == new_definition->hash_value \
-                     && equal_ ## type( existing_definition, new_definition ) ) \
+                hash_list_iterator = scorep_definitions_manager_entry_get_hash_chain( \
+                    entry, new_definition->hash_value, true ); \
+                SCOREP_DEFINITIONS_MANAGER_ENTRY_FIND_DEFINITION( Type, \
+                                                                  type, \
+                                                                  page_manager, \
+                                                                  new_definition, \
+                                                                  hash_list_iterator ); \
+            } \
+            if ( hash_list_iterator == SCOREP_MOVABLE_NULL ) \
+            { \
+                UTILS_MutexLock( &( entry )->lock ); \
+                hash_list_iterator = scorep_definitions_manager_entry_get_hash_chain( \
+                    entry, new_definition->hash_value, false ); \
+                SCOREP_DEFINITIONS_MANAGER_ENTRY_FIND_DEFINITION( Type, \
+                                                                  type, \
+                                                                  page_manager, \
+                                                                  new_definition, \
+                                                                  hash_list_iterator ); \
+                if ( hash_list_iterator == SCOREP_MOVABLE_NULL ) \
+                { \
+                    hash_list_iterator = scorep_definitions_manager_entry_get_hash_chain( \
+                        entry, new_definition->hash_value, true ); \
+                    SCOREP_DEFINITIONS_MANAGER_ENTRY_FIND_DEFINITION( Type, \
+                                                                      type, \
+                                                                      page_manager, \
+                                                                      new_definition, \
+                                                                      hash_list_iterator ); \
+                } \
+                if ( hash_list_iterator == SCOREP_MOVABLE_NULL ) \
                 { \
-                    SCOREP_Allocator_RollbackAllocMovable( \
-                        page_manager, \
-                        new_handle ); \
-                    return hash_list_iterator; \
+                    SCOREP_AnyHandle* hash_table_bucket = \
+                        &( entry )->hash_table[ \
+                            new_definition->hash_value & ( entry )->hash_table_mask ]; \
+                    *( entry )->tail = new_handle; \
+                    ( entry )->tail  = &new_definition->next; \
+                    new_definition->sequence_number = ( entry )->counter++; \
+                    new_definition->hash_next       = *hash_table_bucket; \
+                    UTILS_Atomic_StoreN_uint32( hash_table_bucket, \
+                                                new_handle, \
+                                                UTILS_ATOMIC_RELEASE ); \
+                    scorep_definitions_manager_entry_grow_hash_table( entry, \
+                                                                      page_manager ); \
                 } \
-                hash_list_iterator = existing_definition->hash_next; \
+                UTILS_MutexUnlock( &( entry )->lock ); \
+            } \
+            if ( hash_list_iterator != SCOREP_MOVABLE_NULL ) \
+            { \
+                SCOREP_Memory_RollbackAllocForDefinitions( new_handle ); \
+                return hash_list_iterator; \
             } \
-            new_definition->hash_next = *hash_table_bucket; \
-            *hash_table_bucket        = new_handle; \
         } \
-        *( entry )->tail = new_handle; \
-        ( entry )->tail  = &new_definition->next; \
-        new_definition->sequence_number = ( entry )->counter++; \
+        else \
+        { \
+            UTILS_MutexLock( &( entry )->lock ); \
+            *( entry )->tail = new_handle; \
+            ( entry )->tail  = &new_definition->next; \
+            new_definition->sequence_number = ( entry )->counter++; \
+            UTILS_MutexUnlock( &( entry )->lock ); \
+        } \
     } \
     while ( 0 )
 /* *INDENT-ON* */
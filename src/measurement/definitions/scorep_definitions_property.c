@@ -178,9 +178,7 @@ define_property( SCOREP_DefinitionManager* definition_manager,
                                    existing_definition->condition );
                 }
 
-                SCOREP_Allocator_RollbackAllocMovable(
-                    SCOREP_Memory_GetLocalDefinitionPageManager(),
-                    new_handle );
+                SCOREP_Memory_RollbackAllocForDefinitions( new_handle );
                 return hash_list_iterator;
             }
             hash_list_iterator = existing_definition->hash_next;
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2015, 2017, 2019, 2022,
+ * Copyright (c) 2009-2015, 2017, 2019, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -117,7 +117,7 @@ SCOREP_Definitions_NewRegion( const char*             regionName,
         file_name_handle = SCOREP_LOCAL_HANDLE_DEREF( fileHandle, SourceFile )->name_handle;
     }
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     SCOREP_RegionHandle new_handle = define_region(
         &scorep_local_definition_manager,
@@ -141,7 +141,7 @@ SCOREP_Definitions_NewRegion( const char*             regionName,
         regionType,
         SCOREP_INVALID_STRING );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
@@ -161,6 +161,42 @@ SCOREP_RegionHandle_SetGroup( SCOREP_RegionHandle handle,
     SCOREP_Definitions_Unlock();
 }
 
+
+void
+SCOREP_RegionHandle_SetNameAndLocation( SCOREP_RegionHandle     handle,
+                                        const char*             regionName,
+                                        const char*             regionCanonicalName,
+                                        SCOREP_SourceFileHandle fileHandle,
+                                        SCOREP_LineNo           beginLine )
+{
+    UTILS_DEBUG_ENTRY( "%s", regionName );
+
+    SCOREP_StringHandle file_name_handle = SCOREP_INVALID_STRING;
+    if ( fileHandle != SCOREP_INVALID_SOURCE_FILE )
+    {
+        file_name_handle = SCOREP_LOCAL_HANDLE_DEREF( fileHandle, SourceFile )->name_handle;
+    }
+
+    SCOREP_Definitions_Lock();
+
+    SCOREP_RegionDef* region = SCOREP_LOCAL_HANDLE_DEREF( handle, Region );
+
+    /* The definition stays in the hash bucket of its old attributes. Thus
+     * a later definition with the new attributes results in a second, equal
+     * local definition, which the unification maps to the same region. */
+    region->name_handle = scorep_definitions_new_string(
+        &scorep_local_definition_manager,
+        regionName ? regionName : "<unknown region>" );
+    region->canonical_name_handle = scorep_definitions_new_string(
+        &scorep_local_definition_manager,
+        regionCanonicalName ? regionCanonicalName :
+        regionName ? regionName : "<unknown region>" );
+    region->file_name_handle = file_name_handle;
+    region->begin_line       = beginLine;
+
+    SCOREP_Definitions_Unlock();
+}
+
 void
 scorep_definitions_unify_region( SCOREP_RegionDef*             definition,
                                  SCOREP_Allocator_PageManager* handlesPageManager )
@@ -228,9 +228,7 @@ define_rma_window( SCOREP_DefinitionManager* definition_manager,
                     existing_definition->name_handle      = new_definition->name_handle;
                     existing_definition->has_default_name = false;
                 }
-                SCOREP_Allocator_RollbackAllocMovable(
-                    definition_manager->page_manager,
-                    new_handle );
+                SCOREP_Memory_RollbackAllocForDefinitions( new_handle );
                 return hash_list_iterator;
             }
             hash_list_iterator = existing_definition->hash_next;
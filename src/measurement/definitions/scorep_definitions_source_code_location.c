@@ -78,7 +78,7 @@ SCOREP_Definitions_NewSourceCodeLocation( const char*   file,
 {
     UTILS_DEBUG_ENTRY( "%s:%d", file, lineNumber );
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     file = file ? file : "";
 
@@ -90,7 +90,7 @@ SCOREP_Definitions_NewSourceCodeLocation( const char*   file,
             simplify_path, ( void* )file ),
         lineNumber );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
@@ -96,7 +96,7 @@ SCOREP_Definitions_NewSourceFile( const char* fileName )
 {
     UTILS_DEBUG_ENTRY( "%s", fileName );
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     fileName = fileName ? fileName : "<unknown source file>";
 
@@ -107,7 +107,7 @@ SCOREP_Definitions_NewSourceFile( const char* fileName )
             strlen( fileName ),
             simplify_path, ( void* )fileName ) );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
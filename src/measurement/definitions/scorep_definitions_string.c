@@ -73,12 +73,34 @@ SCOREP_Definitions_NewString( const char* str )
 
     UTILS_DEBUG_ENTRY( "%s", str );
 
-    SCOREP_Definitions_Lock();
+    size_t              length = strlen( str );
+    uint32_t            hash   = jenkins_hash( str, length, 0 );
+    SCOREP_AnyHandle*   slot   = scorep_definitions_lookup_cache_get_slot(
+        SCOREP_DEFINITIONS_LOOKUP_CACHE_STRING, hash );
+    SCOREP_StringHandle cached = slot ? *slot : SCOREP_INVALID_STRING;
+    if ( cached != SCOREP_INVALID_STRING )
+    {
+        SCOREP_StringDef* definition = SCOREP_LOCAL_HANDLE_DEREF( cached, String );
+        if ( definition->hash_value == hash
+             && definition->string_length == length
+             && 0 == memcmp( definition->string_data, str, length ) )
+        {
+            scorep_definitions_lookup_cache_hit( SCOREP_DEFINITIONS_LOOKUP_CACHE_STRING );
+            return cached;
+        }
+    }
+
+    scorep_definitions_lock_new();
 
     SCOREP_StringHandle new_handle = scorep_definitions_new_string(
         &scorep_local_definition_manager, str );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
+
+    if ( slot )
+    {
+        *slot = new_handle;
+    }
 
     return new_handle;
 }
@@ -93,13 +115,13 @@ SCOREP_Definitions_NewStringGenerator( size_t                             string
 
     UTILS_DEBUG_ENTRY( "%zu", stringLength );
 
-    SCOREP_Definitions_Lock();
+    scorep_definitions_lock_new();
 
     SCOREP_StringHandle new_handle = scorep_definitions_new_string_generator(
         &scorep_local_definition_manager,
         stringLength, generator, generatorArg );
 
-    SCOREP_Definitions_Unlock();
+    scorep_definitions_unlock_new();
 
     return new_handle;
 }
@@ -112,6 +134,13 @@ scorep_definitions_unify_string( SCOREP_StringDef*             definition,
     UTILS_ASSERT( definition );
     UTILS_ASSERT( handlesPageManager );
 
+    if ( definition->unified != SCOREP_INVALID_STRING )
+    {
+        /* Already resolved by the digest exchange of the MPP unification,
+         * the content was not transferred. */
+        return;
+    }
+
     definition->unified = scorep_definitions_new_string(
         scorep_unified_definition_manager,
         definition->string_data );
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2012,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2012,
+ * Copyright (c) 2009-2012, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2012,
@@ -109,6 +109,12 @@ SCOREP_Filtering_Finalize( void )
     scorep_filter_is_enabled = false;
 }
 
+bool
+SCOREP_Filtering_IsEnabled( void )
+{
+    return scorep_filter_is_enabled;
+}
+
 bool
 SCOREP_Filtering_Match( const char* fileName,
                         const char* functionName,
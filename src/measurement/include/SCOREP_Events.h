@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2017, 2020, 2022,
+ * Copyright (c) 2009-2017, 2020, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -131,6 +131,28 @@ void
 SCOREP_Location_DeactivateCpuSample( SCOREP_Location*            location,
                                      SCOREP_CallingContextHandle previousCallingContext );
 
+/**
+ * Trigger a sample, which was recorded earlier and whose calling context was
+ * resolved only now by the unwinding. The timestamp is not checked against
+ * the last timestamp of the location.
+ *
+ * @param location                 Location of the sample
+ * @param timestamp                Time when the sample was taken
+ * @param currentCallingContext    The calling context of the sample
+ * @param previousCallingContext   The previous calling context
+ * @param unwindDistance           The unwind distance
+ * @param interruptGeneratorHandle Handle of the interrupt generator
+ * @param metricValues             Metric values read when the sample was taken
+ */
+void
+SCOREP_Location_DeferredCpuSample( SCOREP_Location*                location,
+                                   uint64_t                        timestamp,
+                                   SCOREP_CallingContextHandle     currentCallingContext,
+                                   SCOREP_CallingContextHandle     previousCallingContext,
+                                   uint32_t                        unwindDistance,
+                                   SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
+                                   uint64_t*                       metricValues );
+
 /**
  * Process a region enter event in the measurement system.
  *
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2012,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2012,
+ * Copyright (c) 2009-2012, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2012,
@@ -40,6 +40,13 @@
 
 #include <stdbool.h>
 
+/**
+ * @return True if a filter file was given, i.e., regions might get filtered.
+ */
+bool
+SCOREP_Filtering_IsEnabled( void );
+
+
 bool
 SCOREP_Filtering_Match( const char* fileName,
                         const char* functionName,
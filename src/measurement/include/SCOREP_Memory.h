@@ -74,11 +74,14 @@ typedef enum SCOREP_MemoryType
  * i.e. everything except otf2.
  *
  * @param totalMemory total amount of memory in bytes the measurement system
- * should use.
+ * should use initially.
+ * @param memoryLimit amount of memory in bytes the measurement system may grow
+ * to, 0 for the maximum.
  * @param pageSize size of a single page in bytes, needs to be <= @a totalMemory
  */
 void
 SCOREP_Memory_Initialize( uint64_t totalMemory,
+                          uint64_t memoryLimit,
                           uint64_t pageSize );
 
 
@@ -292,6 +295,17 @@ SCOREP_Location_AllocForProfile( SCOREP_Location* location,
  * @}
  */
 
+
+/**
+ * Like SCOREP_Location_AllocForProfile(), but the returned address is a
+ * multiple of @a alignment. The requirements on @a alignment are the same
+ * as for SCOREP_Location_AlignedAllocForMisc(), otherwise NULL is returned.
+ */
+void*
+SCOREP_Location_AlignedAllocForProfile( SCOREP_Location* location,
+                                        size_t           alignment,
+                                        size_t           size );
+
 /**
  * Release the allocated runtime profile memory for @a location.
  *
@@ -333,6 +347,38 @@ void
 SCOREP_Memory_FreeDefinitionMem( void );
 
 
+/**
+ * Discards the last allocation of SCOREP_Memory_AllocForDefinitions() with
+ * a NULL location of the calling thread.
+ */
+void
+SCOREP_Memory_RollbackAllocForDefinitions( SCOREP_Allocator_MovableMemory movableMemory );
+
+
+/**
+ * Until this is called, SCOREP_Memory_AllocForDefinitions() with a NULL
+ * location allocates from a page manager private to the calling thread.
+ * Moves the pages of all these into the definitions page manager, later
+ * allocations are done from it. Needs to be called while no other thread
+ * creates definitions.
+ */
+void
+SCOREP_Memory_MergeDefinitionPageManagers( void );
+
+
+/**
+ * Lets all following calls to SCOREP_Memory_AllocForDefinitions() with a
+ * NULL location of the calling thread allocate from @a pageManager, until
+ * it is called with NULL. Used to create definitions concurrently, the pages
+ * need to be moved to the definition page manager afterwards with
+ * SCOREP_Allocator_MovePages().
+ *
+ * @return false, if there is no thread-local storage to support this.
+ */
+bool
+SCOREP_Memory_SetThreadDefinitionPageManager( SCOREP_Allocator_PageManager* pageManager );
+
+
 void*
 SCOREP_Memory_GetAddressFromMovableMemory( SCOREP_Allocator_MovableMemory movableMemory,
                                            SCOREP_Allocator_PageManager*  movablePageManager );
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2017, 2019-2020, 2022-2023,
+ * Copyright (c) 2017, 2019-2020, 2022-2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2022,
@@ -39,20 +39,32 @@
 #define SCOREP_DEBUG_MODULE_NAME IO_MANAGEMENT
 #include <UTILS_Debug.h>
 #include <UTILS_Mutex.h>
+#include <UTILS_Atomic.h>
 
-#define SCOREP_IO_HANDLE_HASHTABLE_POWER 6
-#define SCOREP_IO_HANDLE_HASHTABLE_MASK hashmask( SCOREP_IO_HANDLE_HASHTABLE_POWER )
-#define SCOREP_IO_HANDLE_HASHTABLE_SIZE hashsize( SCOREP_IO_HANDLE_HASHTABLE_POWER )
+/* Initial number of slots in the handle table of a paradigm */
+#define IO_HANDLE_TABLE_INITIAL_POWER 6
+
+/* File descriptors below 2^(10+12) are direct-indexed, 1024 per page */
+#define IO_FD_TABLE_PAGE_POWER 10
+#define IO_FD_TABLE_PAGE_SIZE hashsize( IO_FD_TABLE_PAGE_POWER )
+#define IO_FD_TABLE_PAGES hashsize( 12 )
 
 /** @brief Payload in every IoHandleHandle definition. */
 typedef struct io_handle_payload
 {
     /** @brief Hash value of the paradigm specific I/O handle */
-    uint32_t              hash;
-    /** @brief Next handle entry in the active handle hash table */
-    SCOREP_IoHandleHandle next;
+    uint32_t hash;
 } io_handle_payload;
 
+/** @brief Open-addressing table of the active I/O handles of a paradigm. */
+typedef struct io_handle_table
+{
+    /** @brief The previous, smaller table, still visible to concurrent readers */
+    struct io_handle_table* retired;
+    uint32_t                capacity;
+    SCOREP_IoHandleHandle   slots[];
+} io_handle_table;
+
 /** @brief An entry in the current I/O handle stack. */
 typedef struct io_handle_stack_entry
 {
@@ -74,10 +86,17 @@ typedef struct io_mgmt_paradigm
     /** @brief The size for the paradigm specific I/O handle value
         (i.e., sizeof(int|FILE*|MPI_File)). */
     size_t                payload_size;
-    /** @brief Hash table of all active I/O handles. */
-    SCOREP_IoHandleHandle handles[ SCOREP_IO_HANDLE_HASHTABLE_SIZE ];
-    /** @brief mutex to protect @a handles table for this I/O paradigm */
-    UTILS_Mutex           mutex;
+    /** @brief Pages of the direct-indexed table of file descriptors,
+        only for the POSIX paradigm. */
+    SCOREP_IoHandleHandle** fd_pages;
+    /** @brief Hash table of all active I/O handles, lock-free for readers. */
+    io_handle_table*        handles;
+    /** @brief Number of used slots in @a handles */
+    uint32_t                count;
+    /** @brief Odd while a writer moves entries in @a handles */
+    uint32_t                sequence;
+    /** @brief mutex to serialize writers of the @a handles table */
+    UTILS_Mutex             mutex;
 } io_mgmt_paradigm;
 
 /** @brief The per-location data, which holds the locations handle stack. */
@@ -205,6 +224,73 @@ handle_stack_pop( io_mgmt_location_data* data )
     data->unused_handle_stack_entries = elem;
 }
 
+/************************** Direct-indexed fd table ****************************/
+
+/* File descriptors are small, dense integers. Readers and writers access
+ * the slots atomically, without the paradigm mutex. */
+
+static inline bool
+fd_table_index( io_mgmt_paradigm* paradigm,
+                const void*       ioHandle,
+                uint32_t*         fd )
+{
+    if ( !paradigm->fd_pages )
+    {
+        return false;
+    }
+
+    int value;
+    memcpy( &value, ioHandle, sizeof( value ) );
+    if ( value < 0 || value >= IO_FD_TABLE_PAGES * IO_FD_TABLE_PAGE_SIZE )
+    {
+        /* Use the hash table for the rest */
+        return false;
+    }
+    *fd = value;
+    return true;
+}
+
+static inline SCOREP_IoHandleHandle*
+fd_table_slot( io_mgmt_paradigm* paradigm,
+               uint32_t          fd,
+               bool              create )
+{
+    SCOREP_IoHandleHandle** page_ref = &paradigm->fd_pages[ fd >> IO_FD_TABLE_PAGE_POWER ];
+    SCOREP_IoHandleHandle*  page     =
+        UTILS_Atomic_LoadN_void_ptr( page_ref, UTILS_ATOMIC_ACQUIRE );
+    if ( !page )
+    {
+        if ( !create )
+        {
+            return NULL;
+        }
+
+        SCOREP_IoHandleHandle* new_page = calloc( IO_FD_TABLE_PAGE_SIZE, sizeof( *new_page ) );
+        UTILS_BUG_ON( !new_page, "Cannot allocate I/O handle table page." );
+        if ( UTILS_Atomic_CompareExchangeN_void_ptr( page_ref, ( void* )&page, new_page,
+                                                     false,
+                                                     UTILS_ATOMIC_ACQUIRE_RELEASE,
+                                                     UTILS_ATOMIC_ACQUIRE ) )
+        {
+            page = new_page;
+        }
+        else
+        {
+            /* Another thread was faster */
+            free( new_page );
+        }
+    }
+
+    return &page[ fd & hashmask( IO_FD_TABLE_PAGE_POWER ) ];
+}
+
+/**************************** Active handle table *****************************/
+
+/* Readers probe the table without the mutex. Writers hold the mutex and make
+ * @a sequence odd while they move entries, thus readers retry. Grown tables
+ * are published as a whole and the old ones are kept until the paradigm is
+ * deregistered. */
+
 /** @brief Returns the memory address of the I/O paradigm value from a
     IoHandleHandle payload. */
 static inline void*
@@ -213,64 +299,261 @@ payload_get_handle( io_handle_payload* payload )
     return payload + 1;
 }
 
-static inline SCOREP_IoHandleHandle*
-get_handle_ref( SCOREP_IoParadigmType paradigm,
+static inline bool
+handle_matches( io_mgmt_paradigm*     paradigm,
+                SCOREP_IoHandleHandle handle,
                 const void*           ioHandle,
-                uint32_t              hash,
-                io_handle_payload**   entry )
+                uint32_t              hash )
 {
-    size_t handle_size = io_paradigms[ paradigm ]->payload_size;
-    if ( hash == 0 )
+    io_handle_payload* entry = SCOREP_IoHandleHandle_GetPayload( handle );
+    UTILS_BUG_ON( !entry, "Invalid payload for handle definition %u", handle );
+
+    return entry->hash == hash &&
+           memcmp( payload_get_handle( entry ), ioHandle, paradigm->payload_size ) == 0;
+}
+
+static io_handle_table*
+handle_table_new( uint32_t capacity )
+{
+    io_handle_table* table = calloc( 1, sizeof( *table ) + capacity * sizeof( *table->slots ) );
+    UTILS_BUG_ON( !table, "Cannot allocate I/O handle table." );
+    table->capacity = capacity;
+    return table;
+}
+
+/* Returns the slot index of ioHandle or of the empty slot terminating its
+ * probe sequence. Needs the mutex or a consistent table. */
+static uint32_t
+handle_table_find( io_mgmt_paradigm* paradigm,
+                   io_handle_table*  table,
+                   const void*       ioHandle,
+                   uint32_t          hash )
+{
+    uint32_t mask  = table->capacity - 1;
+    uint32_t index = hash & mask;
+    while ( table->slots[ index ] != SCOREP_INVALID_IO_HANDLE
+            && !handle_matches( paradigm, table->slots[ index ], ioHandle, hash ) )
     {
-        hash = jenkins_hash( ioHandle, handle_size, 0 );
+        index = ( index + 1 ) & mask;
     }
-    size_t index = hash & SCOREP_IO_HANDLE_HASHTABLE_MASK;
+    return index;
+}
 
-    SCOREP_IoHandleHandle* handle_iterator = &io_paradigms[ paradigm ]->handles[ index ];
+static SCOREP_IoHandleHandle
+handle_table_lookup( io_mgmt_paradigm* paradigm,
+                     const void*       ioHandle,
+                     uint32_t          hash )
+{
+    while ( true )
+    {
+        uint32_t sequence = UTILS_Atomic_LoadN_uint32( &paradigm->sequence,
+                                                       UTILS_ATOMIC_ACQUIRE );
+        if ( sequence & 1 )
+        {
+            UTILS_CPU_RELAX;
+            continue;
+        }
+
+        io_handle_table*      table  = UTILS_Atomic_LoadN_void_ptr( &paradigm->handles,
+                                                                    UTILS_ATOMIC_ACQUIRE );
+        SCOREP_IoHandleHandle result = SCOREP_INVALID_IO_HANDLE;
+        uint32_t              mask   = table->capacity - 1;
+        uint32_t              index  = hash & mask;
+        /* Bounded, the table may be inconsistent while entries are moved */
+        for ( uint32_t i = 0; i < table->capacity; i++ )
+        {
+            SCOREP_IoHandleHandle handle =
+                UTILS_Atomic_LoadN_uint32( &table->slots[ index ], UTILS_ATOMIC_ACQUIRE );
+            if ( handle == SCOREP_INVALID_IO_HANDLE )
+            {
+                break;
+            }
+            if ( handle_matches( paradigm, handle, ioHandle, hash ) )
+            {
+                result = handle;
+                break;
+            }
+            index = ( index + 1 ) & mask;
+        }
 
-    while ( *handle_iterator != SCOREP_INVALID_IO_HANDLE )
+        UTILS_Atomic_ThreadFence( UTILS_ATOMIC_ACQUIRE );
+        if ( UTILS_Atomic_LoadN_uint32( &paradigm->sequence,
+                                        UTILS_ATOMIC_RELAXED ) == sequence )
+        {
+            return result;
+        }
+    }
+}
+
+/* Needs the mutex */
+static void
+handle_table_grow( io_mgmt_paradigm* paradigm )
+{
+    io_handle_table* old_table = paradigm->handles;
+    io_handle_table* new_table = handle_table_new( old_table->capacity * 2 );
+    uint32_t         mask      = new_table->capacity - 1;
+
+    for ( uint32_t i = 0; i < old_table->capacity; i++ )
     {
-        *entry = SCOREP_IoHandleHandle_GetPayload( *handle_iterator );
+        SCOREP_IoHandleHandle handle = old_table->slots[ i ];
+        if ( handle == SCOREP_INVALID_IO_HANDLE )
+        {
+            continue;
+        }
+        io_handle_payload* entry = SCOREP_IoHandleHandle_GetPayload( handle );
+        uint32_t           index = entry->hash & mask;
+        while ( new_table->slots[ index ] != SCOREP_INVALID_IO_HANDLE )
+        {
+            index = ( index + 1 ) & mask;
+        }
+        new_table->slots[ index ] = handle;
+    }
+
+    new_table->retired = old_table;
+    UTILS_Atomic_StoreN_void_ptr( &paradigm->handles, new_table, UTILS_ATOMIC_RELEASE );
+}
 
-        UTILS_BUG_ON( !*entry, "Invalid payload for handle definition %u", *handle_iterator );
+/* Needs the mutex */
+static SCOREP_IoHandleHandle
+handle_table_remove( io_mgmt_paradigm* paradigm,
+                     const void*       ioHandle,
+                     uint32_t          hash )
+{
+    io_handle_table* table = paradigm->handles;
+    uint32_t         index = handle_table_find( paradigm, table, ioHandle, hash );
+    if ( table->slots[ index ] == SCOREP_INVALID_IO_HANDLE )
+    {
+        return SCOREP_INVALID_IO_HANDLE;
+    }
+    SCOREP_IoHandleHandle old_handle = table->slots[ index ];
 
-        if ( ( *entry )->hash == hash &&
-             memcmp( payload_get_handle( *entry ), ioHandle, handle_size ) == 0 )
+    UTILS_Atomic_AddFetch_uint32( &paradigm->sequence, 1, UTILS_ATOMIC_RELAXED );
+    UTILS_Atomic_ThreadFence( UTILS_ATOMIC_RELEASE );
+
+    /* Backward-shift deletion, keeps the probe sequences free of gaps */
+    uint32_t mask = table->capacity - 1;
+    uint32_t hole = index;
+    uint32_t next = ( hole + 1 ) & mask;
+    while ( table->slots[ next ] != SCOREP_INVALID_IO_HANDLE )
+    {
+        io_handle_payload* entry = SCOREP_IoHandleHandle_GetPayload( table->slots[ next ] );
+        uint32_t           home  = entry->hash & mask;
+        if ( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) )
         {
-            break;
+            UTILS_Atomic_StoreN_uint32( &table->slots[ hole ], table->slots[ next ],
+                                        UTILS_ATOMIC_RELAXED );
+            hole = next;
         }
-        handle_iterator = &( *entry )->next;
+        next = ( next + 1 ) & mask;
     }
+    UTILS_Atomic_StoreN_uint32( &table->slots[ hole ], SCOREP_INVALID_IO_HANDLE,
+                                UTILS_ATOMIC_RELAXED );
+    paradigm->count--;
+
+    UTILS_Atomic_AddFetch_uint32( &paradigm->sequence, 1, UTILS_ATOMIC_RELEASE );
 
-    return handle_iterator;
+    return old_handle;
+}
+
+/* Needs the mutex, returns the replaced handle */
+static SCOREP_IoHandleHandle
+handle_table_insert( io_mgmt_paradigm*     paradigm,
+                     SCOREP_IoHandleHandle handle,
+                     const void*           ioHandle,
+                     uint32_t              hash )
+{
+    uint32_t index = handle_table_find( paradigm, paradigm->handles, ioHandle, hash );
+    if ( paradigm->handles->slots[ index ] != SCOREP_INVALID_IO_HANDLE )
+    {
+        SCOREP_IoHandleHandle old_handle = paradigm->handles->slots[ index ];
+        UTILS_Atomic_StoreN_uint32( &paradigm->handles->slots[ index ], handle,
+                                    UTILS_ATOMIC_RELEASE );
+        return old_handle;
+    }
+
+    if ( 2 * ( paradigm->count + 1 ) > paradigm->handles->capacity )
+    {
+        handle_table_grow( paradigm );
+        index = handle_table_find( paradigm, paradigm->handles, ioHandle, hash );
+    }
+    UTILS_Atomic_StoreN_uint32( &paradigm->handles->slots[ index ], handle,
+                                UTILS_ATOMIC_RELEASE );
+    paradigm->count++;
+
+    return SCOREP_INVALID_IO_HANDLE;
+}
+
+/******************************************************************************/
+
+static inline SCOREP_IoHandleHandle
+get_handle( SCOREP_IoParadigmType paradigm,
+            const void*           ioHandle )
+{
+    io_mgmt_paradigm* io_paradigm = io_paradigms[ paradigm ];
+
+    uint32_t fd;
+    if ( fd_table_index( io_paradigm, ioHandle, &fd ) )
+    {
+        SCOREP_IoHandleHandle* slot = fd_table_slot( io_paradigm, fd, false );
+        return slot ? UTILS_Atomic_LoadN_uint32( slot, UTILS_ATOMIC_ACQUIRE )
+               : SCOREP_INVALID_IO_HANDLE;
+    }
+
+    return handle_table_lookup( io_paradigm, ioHandle,
+                                jenkins_hash( ioHandle, io_paradigm->payload_size, 0 ) );
 }
 
 static inline void
 insert_handle( SCOREP_IoParadigmType paradigm,
-               SCOREP_IoHandleHandle handle,
-               const void*           ioHandle,
-               uint32_t              hash )
+               SCOREP_IoHandleHandle handle )
 {
-    io_handle_payload*     entry;
-    SCOREP_IoHandleHandle* handle_iterator = get_handle_ref( paradigm, ioHandle, hash, &entry );
-    if ( *handle_iterator != SCOREP_INVALID_IO_HANDLE )
+    io_mgmt_paradigm*  io_paradigm = io_paradigms[ paradigm ];
+    io_handle_payload* entry       = SCOREP_IoHandleHandle_GetPayload( handle );
+    const void*        io_handle   = payload_get_handle( entry );
+
+    SCOREP_IoHandleHandle old_handle;
+    uint32_t              fd;
+    if ( fd_table_index( io_paradigm, io_handle, &fd ) )
     {
-        if ( SCOREP_Env_RunVerbose() )
-        {
-            fprintf( stderr, "[Score-P] warning: duplicate %s handle, previous handle not destroyed",
-                     io_paradigms[ paradigm ]->definition->name );
-        }
+        old_handle = UTILS_Atomic_ExchangeN_uint32( fd_table_slot( io_paradigm, fd, true ),
+                                                    handle, UTILS_ATOMIC_ACQUIRE_RELEASE );
+    }
+    else
+    {
+        UTILS_MutexLock( &io_paradigm->mutex );
+        old_handle = handle_table_insert( io_paradigm, handle, io_handle, entry->hash );
+        UTILS_MutexUnlock( &io_paradigm->mutex );
+    }
+
+    if ( old_handle != SCOREP_INVALID_IO_HANDLE && SCOREP_Env_RunVerbose() )
+    {
+        fprintf( stderr, "[Score-P] warning: duplicate %s handle, previous handle not destroyed",
+                 io_paradigm->definition->name );
+    }
+}
 
-        /* drop duplicate from hash table */
-        *handle_iterator = entry->next;
-        entry->next      = SCOREP_INVALID_IO_HANDLE;
+static inline SCOREP_IoHandleHandle
+remove_handle( SCOREP_IoParadigmType paradigm,
+               const void*           ioHandle )
+{
+    io_mgmt_paradigm* io_paradigm = io_paradigms[ paradigm ];
+
+    uint32_t fd;
+    if ( fd_table_index( io_paradigm, ioHandle, &fd ) )
+    {
+        SCOREP_IoHandleHandle* slot = fd_table_slot( io_paradigm, fd, false );
+        return slot ? UTILS_Atomic_ExchangeN_uint32( slot, SCOREP_INVALID_IO_HANDLE,
+                                                     UTILS_ATOMIC_ACQUIRE_RELEASE )
+               : SCOREP_INVALID_IO_HANDLE;
     }
 
-    /* entry was overwritten by get_handle_ref, but hash value still set */
-    entry = SCOREP_IoHandleHandle_GetPayload( handle );
-    size_t index = entry->hash & SCOREP_IO_HANDLE_HASHTABLE_MASK;
-    entry->next                                = io_paradigms[ paradigm ]->handles[ index ];
-    io_paradigms[ paradigm ]->handles[ index ] = handle;
+    UTILS_MutexLock( &io_paradigm->mutex );
+    SCOREP_IoHandleHandle handle =
+        handle_table_remove( io_paradigm, ioHandle,
+                             jenkins_hash( ioHandle, io_paradigm->payload_size, 0 ) );
+    UTILS_MutexUnlock( &io_paradigm->mutex );
+
+    return handle;
 }
 
 void
@@ -323,6 +606,14 @@ SCOREP_IoMgmt_RegisterParadigm( SCOREP_IoParadigmType     paradigm,
     va_end( va );
 
     io_paradigms[ paradigm ]->payload_size = payloadSize;
+    io_paradigms[ paradigm ]->handles      =
+        handle_table_new( hashsize( IO_HANDLE_TABLE_INITIAL_POWER ) );
+    if ( paradigm == SCOREP_IO_PARADIGM_POSIX )
+    {
+        io_paradigms[ paradigm ]->fd_pages =
+            calloc( IO_FD_TABLE_PAGES, sizeof( *io_paradigms[ paradigm ]->fd_pages ) );
+        UTILS_ASSERT( io_paradigms[ paradigm ]->fd_pages );
+    }
 }
 
 void
@@ -333,6 +624,21 @@ SCOREP_IoMgmt_DeregisterParadigm( SCOREP_IoParadigmType paradigm )
     UTILS_BUG_ON( !io_paradigms[ paradigm ],
                   "Paradigm cannot be de-registered because it was never registered" );
 
+    if ( io_paradigms[ paradigm ]->fd_pages )
+    {
+        for ( uint32_t i = 0; i < IO_FD_TABLE_PAGES; i++ )
+        {
+            free( io_paradigms[ paradigm ]->fd_pages[ i ] );
+        }
+        free( io_paradigms[ paradigm ]->fd_pages );
+    }
+    io_handle_table* table = io_paradigms[ paradigm ]->handles;
+    while ( table )
+    {
+        io_handle_table* retired = table->retired;
+        free( table );
+        table = retired;
+    }
     free( io_paradigms[ paradigm ] );
 
     io_paradigms[ paradigm ] = NULL;
@@ -390,18 +696,10 @@ SCOREP_IoMgmt_CreatePreCreatedHandle( SCOREP_IoParadigmType            paradigm,
                                                                    ( void** )&payload,
                                                                    accessMode,
                                                                    statusFlags );
-    payload->next = SCOREP_INVALID_IO_HANDLE;
     payload->hash = jenkins_hash( ioHandle, io_paradigms[ paradigm ]->payload_size, 0 );
     memcpy( payload_get_handle( payload ), ioHandle, io_paradigms[ paradigm ]->payload_size );
-    size_t index = payload->hash & SCOREP_IO_HANDLE_HASHTABLE_MASK;
-
-    UTILS_MutexLock( &io_paradigms[ paradigm ]->mutex );
-
-    /* do we need to check for duplicates? */
-    payload->next                              = io_paradigms[ paradigm ]->handles[ index ];
-    io_paradigms[ paradigm ]->handles[ index ] = handle;
 
-    UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
+    insert_handle( paradigm, handle );
 }
 
 void
@@ -446,7 +744,6 @@ SCOREP_IoMgmt_BeginHandleCreation( SCOREP_IoParadigmType            paradigm,
                                                                    payload_size,
                                                                    ( void** )&payload );
     payload->hash = 0;
-    payload->next = SCOREP_INVALID_IO_HANDLE;
 
     handle_stack_push( data, handle, true );
 
@@ -485,11 +782,7 @@ SCOREP_IoMgmt_CompleteHandleCreation( SCOREP_IoParadigmType paradigm,
     entry->hash = jenkins_hash( ioHandle, io_paradigms[ paradigm ]->payload_size, 0 );
     memcpy( payload_get_handle( entry ), ioHandle, io_paradigms[ paradigm ]->payload_size );
 
-    UTILS_MutexLock( &io_paradigms[ paradigm ]->mutex );
-
-    insert_handle( paradigm, handle, payload_get_handle( entry ), entry->hash );
-
-    UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
+    insert_handle( paradigm, handle );
 
     SCOREP_IoHandleHandle_Complete( handle, file, unifyKey );
 
@@ -536,7 +829,6 @@ SCOREP_IoMgmt_BeginHandleDuplication( SCOREP_IoParadigmType paradigm,
                                                                    payload_size,
                                                                    ( void** )&payload );
     payload->hash = 0;
-    payload->next = SCOREP_INVALID_IO_HANDLE;
 
     handle_stack_push( data, handle, true );
 
@@ -576,11 +868,7 @@ SCOREP_IoMgmt_CompleteHandleDuplication( SCOREP_IoParadigmType paradigm,
     entry->hash = jenkins_hash( ioHandle, io_paradigms[ paradigm ]->payload_size, 0 );
     memcpy( payload_get_handle( entry ), ioHandle, io_paradigms[ paradigm ]->payload_size );
 
-    UTILS_MutexLock( &io_paradigms[ paradigm ]->mutex );
-
-    insert_handle( paradigm, handle, payload_get_handle( entry ), entry->hash );
-
-    UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
+    insert_handle( paradigm, handle );
 
     SCOREP_IoHandleHandle_Complete( handle, file, unifyKey );
 
@@ -614,25 +902,11 @@ SCOREP_IoHandleHandle
 SCOREP_IoMgmt_RemoveHandle( SCOREP_IoParadigmType paradigm,
                             const void*           ioHandle )
 {
-    io_mgmt_location_data* data = get_location_data();
-
-    UTILS_MutexLock( &io_paradigms[ paradigm ]->mutex );
-
-    io_handle_payload*     entry;
-    SCOREP_IoHandleHandle* handle_iterator = get_handle_ref( paradigm, ioHandle, 0, &entry );
-    if ( *handle_iterator == SCOREP_INVALID_IO_HANDLE )
+    SCOREP_IoHandleHandle old_handle = remove_handle( paradigm, ioHandle );
+    if ( old_handle == SCOREP_INVALID_IO_HANDLE )
     {
         UTILS_WARNING( "[Paradigm: %d] Could not find I/O handle in hashtable", paradigm );
-
-        UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
-
-        return SCOREP_INVALID_IO_HANDLE;
     }
-    SCOREP_IoHandleHandle old_handle = *handle_iterator;
-    *handle_iterator = entry->next;
-    entry->next      = SCOREP_INVALID_IO_HANDLE;
-
-    UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
 
     return old_handle;
 }
@@ -649,11 +923,7 @@ SCOREP_IoMgmt_ReinsertHandle( SCOREP_IoParadigmType paradigm,
 
     UTILS_BUG_ON( entry->hash == 0, "Reinserted I/O handle without initialized hash value" );
 
-    UTILS_MutexLock( &io_paradigms[ paradigm ]->mutex );
-
-    insert_handle( paradigm, handle, payload_get_handle( entry ), entry->hash );
-
-    UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
+    insert_handle( paradigm, handle );
 }
 
 void
@@ -718,20 +988,15 @@ SCOREP_IoMgmt_GetIoHandle( SCOREP_IoParadigmType paradigm,
                   "Invalid I/O paradigm %d", paradigm );
     UTILS_BUG_ON( !io_paradigms[ paradigm ], "The given paradigm was not registered" );
 
-    UTILS_MutexLock( &io_paradigms[ paradigm ]->mutex );
-
-    io_handle_payload*     entry;
-    SCOREP_IoHandleHandle* handle_iterator = get_handle_ref( paradigm, ioHandle, 0, &entry );
-    if ( *handle_iterator == SCOREP_INVALID_IO_HANDLE )
+    SCOREP_IoHandleHandle handle = get_handle( paradigm, ioHandle );
+    if ( handle == SCOREP_INVALID_IO_HANDLE )
     {
         UTILS_DEBUG_PRINTF( SCOREP_DEBUG_IO_MANAGEMENT,
                             "[Paradigm: %d] Could not find I/O handle in hashtable",
                             paradigm );
     }
 
-    UTILS_MutexUnlock( &io_paradigms[ paradigm ]->mutex );
-
-    return *handle_iterator;
+    return handle;
 }
 
 SCOREP_IoFileHandle
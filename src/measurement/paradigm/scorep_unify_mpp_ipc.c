@@ -42,6 +42,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include <scorep_ipc.h>
@@ -53,6 +54,25 @@
 
 #include <UTILS_Error.h>
 
+#include <jenkins_hash.h>
+
+
+/**
+ * Strings shorter than this are always transferred in full, because the
+ * digest would not be smaller than the string.
+ */
+#define DIGEST_MIN_STRING_LENGTH 16
+
+/** Number of uint32_t per string digest: handle, hash, length, content hash */
+#define DIGEST_SIZE 4
+
+/** A range inside a definition page, which is not transferred. */
+typedef struct page_hole
+{
+    uint32_t offset;
+    uint32_t length;
+} page_hole;
+
 
 static void
 unify_mpp_hierarchical( void );
@@ -77,6 +97,10 @@ receive_mappings( int rank );
 static int
 calculate_comm_partners( int*  parent,
                          int** children );
+static int
+calculate_comm_partners_fan_in( unsigned int fanIn,
+                                int*         parent,
+                                int**        children );
 static void
 receive_and_unify_remote_definitions( int                           rank,
                                       SCOREP_DefinitionManager*     remote_definition_manager,
@@ -112,7 +136,17 @@ unify_mpp_hierarchical( void )
     int  me       = SCOREP_Ipc_GetRank();
     int* children = NULL;
 
-    num_children = calculate_comm_partners( &parent, &children );
+    uint64_t fan_in = SCOREP_Env_GetUnifyFanIn();
+    if ( fan_in >= 2 )
+    {
+        num_children = calculate_comm_partners_fan_in( fan_in < SCOREP_Ipc_GetSize()
+                                                       ? fan_in : SCOREP_Ipc_GetSize(),
+                                                       &parent, &children );
+    }
+    else
+    {
+        num_children = calculate_comm_partners( &parent, &children );
+    }
     SCOREP_DefinitionManager* remote_definition_managers =
         calloc( num_children, sizeof( *remote_definition_managers ) );
     SCOREP_Allocator_PageManager* remote_page_manager =
@@ -252,6 +286,330 @@ calculate_comm_partners( int*  parent,
 }
 
 
+/**
+ * Calculate the communication partners of me in a tree where every process
+ * has at most @a fanIn children.
+ *
+ * @return the number of children.
+ */
+int
+calculate_comm_partners_fan_in( unsigned int fanIn,
+                                int*         parent,
+                                int**        children )
+{
+    unsigned int size = SCOREP_Ipc_GetSize();
+    unsigned int me   = SCOREP_Ipc_GetRank();
+
+    *parent = me == 0 ? 0 : ( me - 1 ) / fanIn;
+
+    unsigned int number_of_children = 0;
+    uint64_t     first_child        = ( uint64_t )me * fanIn + 1;
+    if ( first_child < size )
+    {
+        number_of_children = size - first_child < fanIn ? size - first_child : fanIn;
+    }
+
+    *children = malloc( sizeof( **children ) * number_of_children );
+    for ( unsigned int child = 0; child < number_of_children; child++ )
+    {
+        ( *children )[ child ] = first_child + child;
+    }
+
+    return number_of_children;
+}
+
+
+static int
+compare_addresses( const void* a,
+                   const void* b )
+{
+    const char* address_a = *( const char* const* )a;
+    const char* address_b = *( const char* const* )b;
+    return ( address_a > address_b ) - ( address_a < address_b );
+}
+
+
+static void* const* page_starts_to_sort;
+
+static int
+compare_page_starts( const void* a,
+                     const void* b )
+{
+    const char* address_a = page_starts_to_sort[ *( const uint32_t* )a ];
+    const char* address_b = page_starts_to_sort[ *( const uint32_t* )b ];
+    return ( address_a > address_b ) - ( address_a < address_b );
+}
+
+
+static void
+sort_pages_by_address( uint32_t* pages,
+                       uint32_t  numberOfPages,
+                       void**    pageStarts )
+{
+    page_starts_to_sort = pageStarts;
+    qsort( pages, numberOfPages, sizeof( *pages ), compare_page_starts );
+    page_starts_to_sort = NULL;
+}
+
+
+static uint32_t
+get_max_page_fill( uint32_t        numberOfPages,
+                   const uint32_t* pageFills )
+{
+    uint32_t max_fill = 1;
+    for ( uint32_t page = 0; page < numberOfPages; page++ )
+    {
+        if ( pageFills[ page ] > max_fill )
+        {
+            max_fill = pageFills[ page ];
+        }
+    }
+    return max_fill;
+}
+
+
+static uint32_t
+get_string_content_hash( const SCOREP_StringDef* definition )
+{
+    /* a second, independent hash, to make collisions practically impossible */
+    return jenkins_hash( definition->string_data,
+                         definition->string_length,
+                         ~definition->hash_value );
+}
+
+
+/**
+ * Searches the unified strings for one with the given digest.
+ */
+static SCOREP_StringHandle
+find_unified_string( const uint32_t* digest )
+{
+    scorep_definitions_manager_entry* entry =
+        &scorep_unified_definition_manager->string;
+    /* The table may be growing, search the not yet moved chains too */
+    for ( int old = 0; old < 2; old++ )
+    {
+        SCOREP_StringHandle handle =
+            scorep_definitions_manager_entry_get_hash_chain( entry, digest[ 1 ], old );
+        while ( handle != SCOREP_INVALID_STRING )
+        {
+            SCOREP_StringDef* definition = SCOREP_UNIFIED_HANDLE_DEREF( handle, String );
+            if ( definition->hash_value == digest[ 1 ]
+                 && definition->string_length == digest[ 2 ]
+                 && get_string_content_hash( definition ) == digest[ 3 ] )
+            {
+                return handle;
+            }
+            handle = definition->hash_next;
+        }
+    }
+    return SCOREP_INVALID_STRING;
+}
+
+
+/**
+ * Receives the digests of the longer strings of the child @a rank and tells
+ * it which strings we already have. The content of these strings will not be
+ * transferred, instead their definitions are resolved by
+ * resolve_known_strings().
+ *
+ * @return Number of known strings, their remote handles and our unified
+ *         handles are in @a knownStrings.
+ */
+static uint32_t
+receive_string_digests( int        rank,
+                        uint32_t** knownStrings )
+{
+    uint32_t number_of_digests;
+    SCOREP_Ipc_Recv( &number_of_digests, 1, SCOREP_IPC_UINT32_T, rank );
+    *knownStrings = NULL;
+    if ( number_of_digests == 0 )
+    {
+        return 0;
+    }
+
+    uint32_t* digests = malloc( number_of_digests * DIGEST_SIZE * sizeof( *digests ) );
+    uint8_t*  known   = malloc( number_of_digests );
+    UTILS_BUG_ON( digests == NULL || known == NULL,
+                  "Can't allocate memory for %u string digests", number_of_digests );
+    SCOREP_Ipc_Recv( digests, number_of_digests * DIGEST_SIZE,
+                     SCOREP_IPC_UINT32_T, rank );
+
+    uint32_t number_of_known = 0;
+    for ( uint32_t i = 0; i < number_of_digests; i++ )
+    {
+        uint32_t*           digest = &digests[ i * DIGEST_SIZE ];
+        SCOREP_StringHandle handle = find_unified_string( digest );
+        known[ i ] = handle != SCOREP_INVALID_STRING;
+        if ( known[ i ] )
+        {
+            /* reuse the digest storage for the pair of handles */
+            digests[ 2 * number_of_known ]     = digest[ 0 ];
+            digests[ 2 * number_of_known + 1 ] = handle;
+            number_of_known++;
+        }
+    }
+    SCOREP_Ipc_Send( known, number_of_digests, SCOREP_IPC_BYTE, rank );
+    free( known );
+
+    *knownStrings = digests;
+    return number_of_known;
+}
+
+
+/**
+ * Sets the unified member of the received string definitions, the parent
+ * already has.
+ */
+static void
+resolve_known_strings( SCOREP_Allocator_PageManager* remotePageManager,
+                       uint32_t                      numberOfKnownStrings,
+                       const uint32_t*               knownStrings )
+{
+    for ( uint32_t i = 0; i < numberOfKnownStrings; i++ )
+    {
+        SCOREP_StringDef* definition = SCOREP_HANDLE_DEREF( knownStrings[ 2 * i ],
+                                                            String,
+                                                            remotePageManager );
+        definition->unified = knownStrings[ 2 * i + 1 ];
+    }
+}
+
+
+/**
+ * Sends the digests of the longer unified strings to @a parent.
+ *
+ * @return The content of the strings the parent already has, which does not
+ *         need to be transferred. Sorted by address.
+ */
+static SCOREP_StringDef**
+send_string_digests( int       parent,
+                     uint32_t* numberOfKnownStrings )
+{
+    uint32_t number_of_digests = 0;
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_BEGIN( scorep_unified_definition_manager,
+                                                         String,
+                                                         string )
+    {
+        number_of_digests += definition->string_length >= DIGEST_MIN_STRING_LENGTH;
+    }
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_END();
+
+    SCOREP_Ipc_Send( &number_of_digests, 1, SCOREP_IPC_UINT32_T, parent );
+    *numberOfKnownStrings = 0;
+    if ( number_of_digests == 0 )
+    {
+        return NULL;
+    }
+
+    uint32_t*          digests     = malloc( number_of_digests * DIGEST_SIZE * sizeof( *digests ) );
+    SCOREP_StringDef** definitions = malloc( number_of_digests * sizeof( *definitions ) );
+    uint8_t*           known       = malloc( number_of_digests );
+    UTILS_BUG_ON( digests == NULL || definitions == NULL || known == NULL,
+                  "Can't allocate memory for %u string digests", number_of_digests );
+
+    uint32_t i = 0;
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_BEGIN( scorep_unified_definition_manager,
+                                                         String,
+                                                         string )
+    {
+        if ( definition->string_length >= DIGEST_MIN_STRING_LENGTH )
+        {
+            digests[ i * DIGEST_SIZE ]     = handle;
+            digests[ i * DIGEST_SIZE + 1 ] = definition->hash_value;
+            digests[ i * DIGEST_SIZE + 2 ] = definition->string_length;
+            digests[ i * DIGEST_SIZE + 3 ] = get_string_content_hash( definition );
+            definitions[ i ]               = definition;
+            i++;
+        }
+    }
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_END();
+
+    SCOREP_Ipc_Send( digests, number_of_digests * DIGEST_SIZE,
+                     SCOREP_IPC_UINT32_T, parent );
+    free( digests );
+    SCOREP_Ipc_Recv( known, number_of_digests, SCOREP_IPC_BYTE, parent );
+
+    uint32_t number_of_known = 0;
+    for ( i = 0; i < number_of_digests; i++ )
+    {
+        if ( known[ i ] )
+        {
+            definitions[ number_of_known++ ] = definitions[ i ];
+        }
+    }
+    free( known );
+
+    qsort( definitions, number_of_known, sizeof( *definitions ), compare_addresses );
+    *numberOfKnownStrings = number_of_known;
+    return definitions;
+}
+
+
+/**
+ * Calculates the holes of all pages from the known strings. @a holes are
+ * ordered by page and by offset inside the page, @a holeCounts has the
+ * number of holes per page.
+ */
+static void
+calculate_page_holes( uint32_t           numberOfPages,
+                      void**             pageStarts,
+                      const uint32_t*    pageFills,
+                      uint32_t           numberOfKnownStrings,
+                      SCOREP_StringDef** knownStrings,
+                      uint32_t*          holeCounts,
+                      page_hole*         holes )
+{
+    uint32_t* pages = malloc( numberOfPages * sizeof( *pages ) );
+    UTILS_BUG_ON( pages == NULL && numberOfPages > 0,
+                  "Can't allocate memory for %u pages", numberOfPages );
+    for ( uint32_t page = 0; page < numberOfPages; page++ )
+    {
+        pages[ page ]      = page;
+        holeCounts[ page ] = 0;
+    }
+    sort_pages_by_address( pages, numberOfPages, pageStarts );
+
+    /* first count, then place the holes per page */
+    uint32_t* string_pages = malloc( numberOfKnownStrings * sizeof( *string_pages ) );
+    UTILS_BUG_ON( string_pages == NULL && numberOfKnownStrings > 0,
+                  "Can't allocate memory for %u strings", numberOfKnownStrings );
+    uint32_t sorted_page = 0;
+    for ( uint32_t i = 0; i < numberOfKnownStrings; i++ )
+    {
+        char* data = knownStrings[ i ]->string_data;
+        while ( data >= ( char* )pageStarts[ pages[ sorted_page ] ]
+                + pageFills[ pages[ sorted_page ] ] )
+        {
+            sorted_page++;
+            UTILS_BUG_ON( sorted_page == numberOfPages,
+                          "String definition not in any definition page" );
+        }
+        string_pages[ i ] = pages[ sorted_page ];
+        holeCounts[ pages[ sorted_page ] ]++;
+    }
+
+    uint32_t* next_hole = pages;
+    uint32_t  offset    = 0;
+    for ( uint32_t page = 0; page < numberOfPages; page++ )
+    {
+        next_hole[ page ] = offset;
+        offset           += holeCounts[ page ];
+    }
+    for ( uint32_t i = 0; i < numberOfKnownStrings; i++ )
+    {
+        uint32_t page = string_pages[ i ];
+        holes[ next_hole[ page ] ].offset =
+            knownStrings[ i ]->string_data - ( char* )pageStarts[ page ];
+        holes[ next_hole[ page ] ].length = knownStrings[ i ]->string_length;
+        next_hole[ page ]++;
+    }
+
+    free( string_pages );
+    free( pages );
+}
+
+
 void
 receive_and_unify_remote_definitions( int                           rank,
                                       SCOREP_DefinitionManager*     remote_definition_manager,
@@ -271,6 +629,10 @@ receive_and_unify_remote_definitions( int                           rank,
     // page_manager member was overwritten by recv
     remote_definition_manager->page_manager = remote_page_manager;
 
+    // 2b) Tell the child, which of its longer strings we already have
+    uint32_t* known_strings;
+    uint32_t  number_of_known_strings = receive_string_digests( rank, &known_strings );
+
     // 3) Get the number of pages we get.
     uint32_t number_of_pages;
     SCOREP_Ipc_Recv( &number_of_pages,
@@ -308,7 +670,32 @@ receive_and_unify_remote_definitions( int                           rank,
                      SCOREP_IPC_UINT32_T,
                      rank );
 
+    // 4c) Get the holes of the pages, i.e., the content of the known strings
+    uint32_t*  hole_counts = NULL;
+    page_hole* holes       = NULL;
+    uint8_t*   packed_page = NULL;
+    if ( number_of_known_strings > 0 )
+    {
+        hole_counts = malloc( number_of_pages * sizeof( *hole_counts ) );
+        holes       = malloc( number_of_known_strings * sizeof( *holes ) );
+        UTILS_BUG_ON( hole_counts == NULL || holes == NULL,
+                      "Can't allocate memory for %u page holes",
+                      number_of_known_strings );
+        SCOREP_Ipc_Recv( hole_counts,
+                         number_of_pages,
+                         SCOREP_IPC_UINT32_T,
+                         rank );
+        SCOREP_Ipc_Recv( holes,
+                         2 * number_of_known_strings,
+                         SCOREP_IPC_UINT32_T,
+                         rank );
+        packed_page = malloc( get_max_page_fill( number_of_pages, *moved_page_fills ) );
+        UTILS_BUG_ON( packed_page == NULL,
+                      "Can't allocate memory for the receive buffer" );
+    }
+
     // 5) Receive all remote pages from rank
+    page_hole* page_holes = holes;
     for ( uint32_t page = 0; page < number_of_pages; page++ )
     {
         /* Allocate local page */
@@ -322,13 +709,49 @@ receive_and_unify_remote_definitions( int                           rank,
             SCOREP_Memory_HandleOutOfMemory();
         }
 
-        SCOREP_Ipc_Recv( page_memory,
-                         ( *moved_page_fills )[ page ],
+        if ( !hole_counts || hole_counts[ page ] == 0 )
+        {
+            SCOREP_Ipc_Recv( page_memory,
+                             ( *moved_page_fills )[ page ],
+                             SCOREP_IPC_BYTE,
+                             rank );
+            continue;
+        }
+
+        /* The page was sent without its holes, scatter it into place */
+        uint32_t packed_size = ( *moved_page_fills )[ page ];
+        for ( uint32_t hole = 0; hole < hole_counts[ page ]; hole++ )
+        {
+            packed_size -= page_holes[ hole ].length;
+        }
+        SCOREP_Ipc_Recv( packed_page,
+                         packed_size,
                          SCOREP_IPC_BYTE,
                          rank );
+
+        uint8_t* dest   = page_memory;
+        uint8_t* src    = packed_page;
+        uint32_t offset = 0;
+        for ( uint32_t hole = 0; hole < hole_counts[ page ]; hole++ )
+        {
+            memcpy( dest + offset, src, page_holes[ hole ].offset - offset );
+            src   += page_holes[ hole ].offset - offset;
+            offset = page_holes[ hole ].offset;
+            memset( dest + offset, 0, page_holes[ hole ].length );
+            offset += page_holes[ hole ].length;
+        }
+        memcpy( dest + offset, src, ( *moved_page_fills )[ page ] - offset );
+        page_holes += hole_counts[ page ];
     }
+    free( packed_page );
+    free( holes );
+    free( hole_counts );
 
     // 6) Unify received remote definitions to our one
+    resolve_known_strings( remote_page_manager,
+                           number_of_known_strings,
+                           known_strings );
+    free( known_strings );
     SCOREP_CopyDefinitionsToUnified( remote_definition_manager );
     SCOREP_CreateDefinitionMappings( remote_definition_manager );
     SCOREP_AssignDefinitionMappingsFromUnified( remote_definition_manager );
@@ -350,6 +773,11 @@ send_local_unified_definitions_to_parent( int        parent,
                      SCOREP_IPC_BYTE,
                      parent );
 
+    // 1b) Exchange the digests of my longer strings with my parent
+    uint32_t           number_of_known_strings;
+    SCOREP_StringDef** known_strings = send_string_digests( parent,
+                                                            &number_of_known_strings );
+
     // 2) Send the page manager infos to my parent
     uint32_t number_of_used_pages =
         SCOREP_Allocator_GetNumberOfUsedPages( scorep_unified_definition_manager->page_manager );
@@ -394,13 +822,69 @@ send_local_unified_definitions_to_parent( int        parent,
                      number_of_used_pages,
                      SCOREP_IPC_UINT32_T, parent );
 
+    // 2b) Send the holes of the pages, i.e., the content of the known strings
+    uint32_t*  hole_counts = NULL;
+    page_hole* holes       = NULL;
+    uint8_t*   packed_page = NULL;
+    if ( number_of_known_strings > 0 )
+    {
+        hole_counts = malloc( number_of_used_pages * sizeof( *hole_counts ) );
+        holes       = malloc( number_of_known_strings * sizeof( *holes ) );
+        UTILS_BUG_ON( hole_counts == NULL || holes == NULL,
+                      "Can't allocate memory for %u page holes",
+                      number_of_known_strings );
+        calculate_page_holes( number_of_used_pages,
+                              moved_page_starts,
+                              *moved_page_fills,
+                              number_of_known_strings,
+                              known_strings,
+                              hole_counts,
+                              holes );
+        SCOREP_Ipc_Send( hole_counts,
+                         number_of_used_pages,
+                         SCOREP_IPC_UINT32_T, parent );
+        SCOREP_Ipc_Send( holes,
+                         2 * number_of_known_strings,
+                         SCOREP_IPC_UINT32_T, parent );
+        packed_page = malloc( get_max_page_fill( number_of_used_pages, *moved_page_fills ) );
+        UTILS_BUG_ON( packed_page == NULL,
+                      "Can't allocate memory for the send buffer" );
+    }
+    free( known_strings );
+
     // 3) Send all pages to my parent
+    page_hole* page_holes = holes;
     for ( uint32_t page = 0; page < number_of_used_pages; page++ )
     {
-        SCOREP_Ipc_Send( moved_page_starts[ page ],
-                         ( *moved_page_fills )[ page ],
+        if ( !hole_counts || hole_counts[ page ] == 0 )
+        {
+            SCOREP_Ipc_Send( moved_page_starts[ page ],
+                             ( *moved_page_fills )[ page ],
+                             SCOREP_IPC_BYTE, parent );
+            continue;
+        }
+
+        /* Leave out the holes */
+        const uint8_t* src    = moved_page_starts[ page ];
+        uint8_t*       dest   = packed_page;
+        uint32_t       offset = 0;
+        for ( uint32_t hole = 0; hole < hole_counts[ page ]; hole++ )
+        {
+            memcpy( dest, src + offset, page_holes[ hole ].offset - offset );
+            dest  += page_holes[ hole ].offset - offset;
+            offset = page_holes[ hole ].offset + page_holes[ hole ].length;
+        }
+        memcpy( dest, src + offset, ( *moved_page_fills )[ page ] - offset );
+        dest += ( *moved_page_fills )[ page ] - offset;
+
+        SCOREP_Ipc_Send( packed_page,
+                         dest - packed_page,
                          SCOREP_IPC_BYTE, parent );
+        page_holes += hole_counts[ page ];
     }
+    free( packed_page );
+    free( holes );
+    free( hole_counts );
 
     // 4) Prepare manager to receive my parents mappings
     SCOREP_CreateDefinitionMappings( scorep_unified_definition_manager );
@@ -204,6 +204,7 @@ SCOREP_Profile_Finalize( void )
         {
             /* Cut off children */
             current->first_child = NULL;
+            current->child_index = NULL;
 
             /* Metrics are freed, too */
             current->dense_metrics       = NULL;
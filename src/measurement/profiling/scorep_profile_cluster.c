@@ -2056,6 +2056,7 @@ scorep_cluster_postprocess( void )
         {
             scorep_profile_type_set_int_value( &cluster->root->type_specific_data,
                                                counter );
+            scorep_profile_invalidate_child_index( cluster->root->parent );
             counter++;
         }
     }
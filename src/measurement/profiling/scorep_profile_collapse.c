@@ -63,6 +63,7 @@ substitute_collapse( scorep_profile_node* node, void* param )
         memset( &node->type_specific_data, 0, sizeof( node->type_specific_data ) );
         scorep_profile_type_set_region_handle( &node->type_specific_data,
                                                scorep_profile_collapse_region );
+        scorep_profile_invalidate_child_index( node->parent );
     }
 }
 
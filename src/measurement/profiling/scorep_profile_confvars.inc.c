@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2012,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2012, 2015,
+ * Copyright (c) 2009-2012, 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2012,
@@ -92,6 +92,12 @@ bool scorep_profile_enable_clustering;
  */
 bool scorep_profile_enable_core_files;
 
+/**
+   Stores the number of ranks whose Cube data is written by one rank. Zero
+   lets the root rank write all data.
+ */
+uint64_t scorep_profile_cube_ranks_per_writer;
+
 
 /**
    Option table for output format configuration.
@@ -290,7 +296,9 @@ static const SCOREP_ConfigVariable scorep_profile_confvars[] = {
         "dynamic region are defined by the user, the region is clustered "
         "which is exited first. If another region should be clustered instead "
         "you can specify the region name in this variable. If the variable is "
-        "unset or empty, the first exited dynamic region is clustered."
+        "unset or empty, the first exited dynamic region is clustered. "
+        "Regions, whose names are resolved at the end of the measurement, see "
+        "SCOREP_COMPILER_DEFER_REGION_NAMES, cannot be selected by name."
     },
     {
         "enable_core_files",
@@ -304,6 +312,21 @@ static const SCOREP_ConfigVariable scorep_profile_confvars[] = {
         "stack at these points. It is not recommended to enable this feature for "
         "large scale measurements."
     },
+    {
+        "cube_ranks_per_writer",
+        SCOREP_CONFIG_TYPE_NUMBER,
+        &scorep_profile_cube_ranks_per_writer,
+        NULL,
+        "0",
+        "Number of ranks per writer of the Cube4 metric data",
+        "By default, the metric data of all ranks is gathered to one rank, which "
+        "writes the whole Cube4 file. If set to a value n > 0, only the definitions "
+        "and the index are written by this rank. The metric data is collected by "
+        "every n-th rank from itself and the following n - 1 ranks and written "
+        "directly into the Cube4 file. This reduces the memory requirements and "
+        "the time needed for writing at large scale, but requires a file system "
+        "which supports concurrent writes from several processes into one file."
+    },
     SCOREP_CONFIG_TERMINATOR
 };
 
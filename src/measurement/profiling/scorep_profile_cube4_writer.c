@@ -42,6 +42,9 @@
 #include <scorep_profile_cube4_writer.h>
 #include <sys/stat.h>
 #include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 
 #include <SCOREP_RuntimeManagement.h>
 #include <SCOREP_Memory.h>
@@ -614,6 +617,311 @@ set_bitstring_for_unknown_metric( scorep_cube_writing_data* writeSet,
 }
 
 
+/* *****************************************************************************
+   Parallel writing of the metric data
+*******************************************************************************/
+
+/* Whether Cube writes rows of the metric without conversion. */
+static bool
+is_native_uint64( cube_metric* metric )
+{
+    switch ( metric->dtype_params->type )
+    {
+        case CUBE_DATA_TYPE_DOUBLE:
+        case CUBE_DATA_TYPE_MIN_DOUBLE:
+        case CUBE_DATA_TYPE_MAX_DOUBLE:
+            return false;
+        default:
+            return true;
+    }
+}
+
+static bool
+is_native_doubles( cube_metric* metric )
+{
+    switch ( metric->dtype_params->type )
+    {
+        case CUBE_DATA_TYPE_INT64:
+        case CUBE_DATA_TYPE_UINT64:
+            return false;
+        default:
+            return true;
+    }
+}
+
+static bool
+is_native_cube_type_tau_atomic( cube_metric* metric )
+{
+    return metric->dtype_params->type == CUBE_DATA_TYPE_TAU_ATOMIC;
+}
+
+/**
+   Returns the number of ranks whose data is written by this rank.
+ */
+static uint32_t
+get_number_of_writer_members( scorep_cube_writing_data* writeSet )
+{
+    if ( writeSet->my_rank != writeSet->writer_rank )
+    {
+        return 0;
+    }
+    uint32_t members = writeSet->ranks_number - writeSet->my_rank;
+    return members < writeSet->ranks_per_writer ? members : writeSet->ranks_per_writer;
+}
+
+/**
+   Assigns every rank to a writer and opens the Cube file on the writers.
+   The writer is the first rank of a block of ranks_per_writer consecutive
+   ranks. Because the locations of consecutive ranks are consecutive in the
+   rows, a writer writes one contiguous slice per row.
+   Disables parallel writing if a writer fails to open the file.
+   @param writeSet Structure containing write data. The Cube file must
+                   already be created by the root rank.
+   @param comm     Communicator of all ranks in the order they are written
+                   to CUBE.
+ */
+static void
+init_parallel_writing( scorep_cube_writing_data* writeSet,
+                       SCOREP_Ipc_Group*         comm )
+{
+    writeSet->writer_rank  = writeSet->my_rank
+                             - writeSet->my_rank % writeSet->ranks_per_writer;
+    writeSet->writer_items = writeSet->local_items;
+    writeSet->row_offsets  = malloc( writeSet->callpath_number * sizeof( uint64_t ) );
+    UTILS_ASSERT( writeSet->row_offsets );
+
+    int32_t opened = 1;
+    if ( writeSet->my_rank == writeSet->writer_rank )
+    {
+        uint32_t members = get_number_of_writer_members( writeSet );
+        writeSet->member_items = malloc( members * sizeof( uint32_t ) );
+        UTILS_ASSERT( writeSet->member_items );
+        writeSet->member_items[ 0 ] = writeSet->local_items;
+        for ( uint32_t i = 1; i < members; i++ )
+        {
+            SCOREP_IpcGroup_Recv( comm, &writeSet->member_items[ i ], 1,
+                                  SCOREP_IPC_UINT32_T, writeSet->my_rank + i );
+            writeSet->writer_items += writeSet->member_items[ i ];
+        }
+
+        /* Same name as created by Cube */
+        const char* dirname  = SCOREP_GetExperimentDirName();
+        const char* basename = scorep_profile_get_basename();
+        char*       filename = malloc( strlen( dirname ) + 1 + strlen( basename )
+                                       + strlen( ".cubex" ) + 1 );
+        UTILS_ASSERT( filename );
+        sprintf( filename, "%s/%s.cubex", dirname, basename );
+
+        writeSet->data_file = open( filename, O_WRONLY );
+        if ( writeSet->data_file == -1 )
+        {
+            UTILS_ERROR_POSIX( "Failed to open '%s' for parallel writing", filename );
+            opened = 0;
+        }
+        free( filename );
+    }
+    else
+    {
+        SCOREP_IpcGroup_Send( comm, &writeSet->local_items, 1,
+                              SCOREP_IPC_UINT32_T, writeSet->writer_rank );
+    }
+
+    int32_t all_opened = 0;
+    SCOREP_IpcGroup_Allreduce( comm, &opened, &all_opened, 1,
+                               SCOREP_IPC_INT32_T, SCOREP_IPC_MIN );
+    if ( !all_opened )
+    {
+        UTILS_WARNING( "Falling back to writing all profile data from one rank." );
+        writeSet->ranks_per_writer = 0;
+    }
+}
+
+/**
+   Starts the data of @a metric in the Cube file and computes the file offsets
+   of all rows. Cube writes the rows of a metric at fixed positions, thus, the
+   offsets are known once the data file of the metric is started. Writing the
+   last row extends the file to its final size. The rows written here contain
+   zeros and are overwritten by the writers.
+   Must be called on the root rank only.
+   @returns false if the rows can not be written in parallel, e.g., because
+            Cube converts the values.
+ */
+static bool
+prepare_rows_on_root( scorep_cube_writing_data* writeSet,
+                      cube_metric*              metric,
+                      size_t                    itemSize )
+{
+    if ( metric->compressed == CUBE_TRUE ||
+         metric->nthrd != writeSet->global_items ||
+         ( size_t )cube_metric_size_dtype__( metric->dtype_params ) != itemSize )
+    {
+        return false;
+    }
+
+    uint64_t first = 0;
+    while ( first < writeSet->callpath_number &&
+            !SCOREP_Bitstring_IsSet( writeSet->bit_vector, first ) )
+    {
+        first++;
+    }
+    if ( first == writeSet->callpath_number )
+    {
+        return false;
+    }
+
+    void* zeros = calloc( writeSet->global_items, itemSize );
+    UTILS_ASSERT( zeros );
+    cube_write_sev_row( writeSet->my_cube, metric,
+                        cube_get_cnode( writeSet->my_cube, first ), zeros );
+    if ( metric->data_file == NULL )
+    {
+        /* Cube does not store data for this metric */
+        free( zeros );
+        return false;
+    }
+
+    /* Position of the row of each Cube cnode id among the stored rows */
+    uint64_t* positions = malloc( metric->ncn * sizeof( uint64_t ) );
+    UTILS_ASSERT( positions );
+    uint64_t  known = 0;
+    for ( uint32_t cid = 0; cid < metric->ncn; cid++ )
+    {
+        positions[ cid ] = metric->metric_format == CUBE_INDEX_FORMAT_SPARSE ? known : cid;
+        if ( metric->metric_format == CUBE_INDEX_FORMAT_SPARSE &&
+             cube_is_bit_set__( metric->known_cnodes, cid ) )
+        {
+            known++;
+        }
+    }
+
+    const unsigned* enumeration = ( const unsigned* )metric->local_cnode_enumeration->data;
+    uint64_t        base        = metric->start_pos_of_datafile + CUBE_DATAFILE_MARKER_SIZE;
+    uint64_t        row_size    = ( uint64_t )metric->nthrd * itemSize;
+    uint64_t        last        = first;
+    for ( uint64_t cp_index = 0; cp_index < writeSet->callpath_number; cp_index++ )
+    {
+        if ( !SCOREP_Bitstring_IsSet( writeSet->bit_vector, cp_index ) )
+        {
+            writeSet->row_offsets[ cp_index ] = UINT64_MAX;
+            continue;
+        }
+        cube_cnode* cnode = cube_get_cnode( writeSet->my_cube, cp_index );
+        writeSet->row_offsets[ cp_index ] =
+            base + positions[ enumeration[ cube_cnode_get_id( cnode ) ] ] * row_size;
+        if ( writeSet->row_offsets[ cp_index ] > writeSet->row_offsets[ last ] )
+        {
+            last = cp_index;
+        }
+    }
+    free( positions );
+
+    if ( last != first )
+    {
+        cube_write_sev_row( writeSet->my_cube, metric,
+                            cube_get_cnode( writeSet->my_cube, last ), zeros );
+    }
+    free( zeros );
+
+    /* The writers must not be overwritten by buffered data */
+    fflush( metric->data_file );
+    return true;
+}
+
+/**
+   Decides whether the rows of @a metric are written in parallel and
+   distributes the row offsets. Must be called on all ranks.
+   @param nativeRow Whether Cube writes the rows of @a metric unconverted.
+                    Only evaluated on the root rank.
+   @param itemSize  Size of one value in a row.
+ */
+static bool
+begin_parallel_metric( scorep_cube_writing_data* writeSet,
+                       SCOREP_Ipc_Group*         comm,
+                       cube_metric*              metric,
+                       bool                      nativeRow,
+                       size_t                    itemSize )
+{
+    if ( writeSet->ranks_per_writer == 0 )
+    {
+        return false;
+    }
+
+    uint32_t parallel = 0;
+    if ( writeSet->my_rank == writeSet->root_rank )
+    {
+        parallel = nativeRow && prepare_rows_on_root( writeSet, metric, itemSize );
+    }
+    SCOREP_IpcGroup_Bcast( comm, &parallel, 1, SCOREP_IPC_UINT32_T,
+                           writeSet->root_rank );
+    if ( parallel )
+    {
+        SCOREP_IpcGroup_Bcast( comm, writeSet->row_offsets,
+                               writeSet->callpath_number, SCOREP_IPC_UINT64_T,
+                               writeSet->root_rank );
+    }
+    return parallel;
+}
+
+/**
+   Writes the slice of this rank of one row. The values are sent to the
+   writer, which writes the values of all its ranks at once.
+   @param values    The aggregated values of this rank.
+   @param buffer    Space for the values of all ranks of the writer. Only
+                    used on writers.
+   @param itemSize  Size of one value.
+   @param number    Number of elements of @a datatype per value.
+ */
+static void
+write_row_slice( scorep_cube_writing_data* writeSet,
+                 SCOREP_Ipc_Group*         comm,
+                 uint64_t                  cpIndex,
+                 const void*               values,
+                 void*                     buffer,
+                 size_t                    itemSize,
+                 int                       number,
+                 SCOREP_Ipc_Datatype       datatype )
+{
+    if ( writeSet->my_rank != writeSet->writer_rank )
+    {
+        SCOREP_IpcGroup_Send( comm, values, writeSet->local_items * number,
+                              datatype, writeSet->writer_rank );
+        return;
+    }
+
+    char* pos = buffer;
+    memcpy( pos, values, writeSet->local_items * itemSize );
+    pos += writeSet->local_items * itemSize;
+    uint32_t members = get_number_of_writer_members( writeSet );
+    for ( uint32_t i = 1; i < members; i++ )
+    {
+        SCOREP_IpcGroup_Recv( comm, pos, writeSet->member_items[ i ] * number,
+                              datatype, writeSet->my_rank + i );
+        pos += writeSet->member_items[ i ] * itemSize;
+    }
+
+    size_t      size   = writeSet->writer_items * itemSize;
+    off_t       offset = writeSet->row_offsets[ cpIndex ]
+                         + ( uint64_t )writeSet->offset * itemSize;
+    const char* data   = buffer;
+    while ( size > 0 )
+    {
+        ssize_t written = pwrite( writeSet->data_file, data, size, offset );
+        if ( written == -1 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            UTILS_ERROR_POSIX( "Failed to write profile data" );
+            return;
+        }
+        data   += written;
+        offset += written;
+        size   -= written;
+    }
+}
+
+
 /* *INDENT-OFF* */
 
 /**
@@ -651,6 +959,18 @@ set_bitstring_for_unknown_metric( scorep_cube_writing_data* writeSet,
             cube_set_known_cnodes_for_metric( writeSet->my_cube, metric,                                 \
                                               ( char* )writeSet->bit_vector );                           \
         }                                                                                                \
+        /* Write slices of the rows on several ranks, if possible */                                     \
+        bool  parallel     = begin_parallel_metric( writeSet, comm, metric,                              \
+                                                    writeSet->my_rank == writeSet->root_rank &&          \
+                                                    is_native_##cube_type( metric ),                     \
+                                                    sizeof( type ) );                                    \
+        type* group_values = NULL;                                                                       \
+        if ( parallel && writeSet->my_rank == writeSet->writer_rank )                                    \
+        {                                                                                                \
+            group_values = ( type* )malloc( writeSet->writer_items * sizeof( type ) );                   \
+            UTILS_ASSERT( group_values );                                                                \
+        }                                                                                                \
+                                                                                                         \
         /* Iterate over all unified callpathes */                                                        \
         for ( uint64_t cp_index = 0; cp_index < writeSet->callpath_number; cp_index++ )                  \
         {                                                                                                \
@@ -675,6 +995,14 @@ set_bitstring_for_unknown_metric( scorep_cube_writing_data* writeSet,
             scorep_profile_aggregate_##type( &local_values,                                              \
                                              &aggregated_values,                                         \
                                              writeSet );                                                 \
+            if ( parallel )                                                                              \
+            {                                                                                            \
+                write_row_slice( writeSet, comm, cp_index,                                               \
+                                 aggregated_values, group_values, sizeof( type ),                        \
+                                 NUMBER, SCOREP_IPC_##TYPE );                                            \
+                continue;                                                                                \
+            }                                                                                            \
+                                                                                                         \
             /* Collect data from all processes */                                                        \
             SCOREP_IpcGroup_Barrier( comm );                                                             \
             if ( writeSet->same_thread_num )                                                             \
@@ -715,7 +1043,14 @@ set_bitstring_for_unknown_metric( scorep_cube_writing_data* writeSet,
             }                                                                                            \
         }                                                                                                \
                                                                                                          \
+        /* All slices must be written before Cube continues with the file */                             \
+        if ( parallel )                                                                                  \
+        {                                                                                                \
+            SCOREP_IpcGroup_Barrier( comm );                                                             \
+        }                                                                                                \
+                                                                                                         \
         /* Clean up */                                                                                   \
+        free( group_values );                                                                            \
         free( global_values );                                                                           \
         free( local_values );                                                                            \
         free( aggregated_values );                                                                       \
@@ -795,6 +1130,12 @@ delete_cube_writing_data( scorep_cube_writing_data* writeSet )
     free( writeSet->metric_map );
     free( writeSet->unified_metric_map );
     free( writeSet->bit_vector );
+    free( writeSet->member_items );
+    free( writeSet->row_offsets );
+    if ( writeSet->data_file != -1 )
+    {
+        close( writeSet->data_file );
+    }
     if ( writeSet->my_cube != NULL )
     {
         cube_free( writeSet->my_cube );
@@ -813,6 +1154,9 @@ delete_cube_writing_data( scorep_cube_writing_data* writeSet )
     writeSet->metric_map         = NULL;
     writeSet->unified_metric_map = NULL;
     writeSet->bit_vector         = NULL;
+    writeSet->member_items       = NULL;
+    writeSet->row_offsets        = NULL;
+    writeSet->data_file          = -1;
 }
 
 /**
@@ -837,6 +1181,10 @@ init_cube_writing_data( scorep_cube_writing_data*   writeSet,
     writeSet->metric_map         = NULL;
     writeSet->unified_metric_map = NULL;
     writeSet->bit_vector         = NULL;
+    writeSet->member_items       = NULL;
+    writeSet->row_offsets        = NULL;
+    writeSet->data_file          = -1;
+    writeSet->ranks_per_writer   = 0;
 
     /* ------------------------------------ Start initializing */
 
@@ -973,6 +1321,20 @@ init_cube_writing_data( scorep_cube_writing_data*   writeSet,
                                1,
                                SCOREP_IPC_INT32_T,
                                SCOREP_IPC_BOR );
+
+    /* Check whether the rows are written by several ranks */
+    if ( writeSet->my_rank == writeSet->root_rank )
+    {
+        uint64_t ranks_per_writer = scorep_profile_get_cube_ranks_per_writer();
+        writeSet->ranks_per_writer = ranks_per_writer < writeSet->ranks_number
+                                     ? ranks_per_writer : writeSet->ranks_number;
+    }
+    SCOREP_IpcGroup_Bcast( comm, &writeSet->ranks_per_writer, 1,
+                           SCOREP_IPC_UINT32_T, writeSet->root_rank );
+    if ( writeSet->ranks_per_writer > 0 )
+    {
+        init_parallel_writing( writeSet, comm );
+    }
     return true;
 }
 
@@ -68,6 +68,15 @@ typedef struct
     scorep_profile_node** id_2_node;                /**< maps global sequence number */
     SCOREP_MetricHandle*  metric_map;               /**< map sequence no to handle */
 
+    /* available on all processes, if the metric data is written in parallel */
+    uint32_t  ranks_per_writer;                     /**< Ranks per writer, 0 if disabled */
+    uint32_t  writer_rank;                          /**< Rank that writes our data */
+    uint32_t  writer_items;                         /**< Items written by this rank */
+    uint32_t* member_items;                         /**< Items of the ranks we write for */
+    uint64_t* row_offsets;                          /**< File offsets of the rows of the
+                                                         current metric */
+    int       data_file;                            /**< Cube file, -1 if not opened */
+
     /* Use only on root process */
     cube_t* my_cube;                                /**< Cube object that is created */
     int*    items_per_rank;                         /**< List of data items per rank */
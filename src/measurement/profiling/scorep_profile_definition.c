@@ -63,6 +63,7 @@ extern uint64_t scorep_profile_cluster_mode;
 extern char*    scorep_profile_clustered_region;
 extern bool     scorep_profile_enable_clustering;
 extern bool     scorep_profile_enable_core_files;
+extern uint64_t scorep_profile_cube_ranks_per_writer;
 
 /*----------------------------------------------------------------------------------------
    Global variables
@@ -156,6 +157,12 @@ scorep_profile_get_basename( void )
     return scorep_profile_basename;
 }
 
+uint64_t
+scorep_profile_get_cube_ranks_per_writer( void )
+{
+    return scorep_profile_cube_ranks_per_writer;
+}
+
 uint64_t
 scorep_profile_get_output_format( void )
 {
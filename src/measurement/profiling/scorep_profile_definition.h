@@ -162,6 +162,12 @@ scorep_profile_get_task_exchange_num( void );
 const char*
 scorep_profile_get_basename( void );
 
+/**
+   Returns the configuration value for SCOREP_PROFILE_CUBE_RANKS_PER_WRITER.
+ */
+uint64_t
+scorep_profile_get_cube_ranks_per_writer( void );
+
 /**
    Returns the configuration value for SCOREP_PROFILE_OUTPUT_FORMAT.
  */
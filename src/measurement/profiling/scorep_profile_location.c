@@ -108,6 +108,8 @@ scorep_profile_finalize_location( SCOREP_Profile_LocationData* location )
     location->fork_list_head        = NULL;
     location->fork_list_tail        = NULL;
     location->free_nodes            = NULL;
+    location->node_arena            = NULL;
+    location->node_arena_free       = 0;
     location->free_int_metrics      = NULL;
     location->free_double_metrics   = NULL;
     location->free_tasks            = NULL;
@@ -143,6 +145,8 @@ scorep_profile_create_location_data( SCOREP_Location* locationData )
     location->current_depth         = 0;
     location->implicit_depth        = 0;
     location->free_nodes            = NULL;
+    location->node_arena            = NULL;
+    location->node_arena_free       = 0;
     location->free_int_metrics      = NULL;
     location->free_double_metrics   = NULL;
     location->current_task_node     = NULL;
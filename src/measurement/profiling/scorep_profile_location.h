@@ -66,6 +66,8 @@ struct SCOREP_Profile_LocationData
     uint32_t                             current_depth;            /**< Stores the current length of the callpath */
     uint32_t                             implicit_depth;           /**< Depth of the implicit task */
     scorep_profile_node*                 free_nodes;               /**< List of records for recycling */
+    char*                                node_arena;               /**< Next unused node in the current node block */
+    uint32_t                             node_arena_free;          /**< Number of unused nodes in @a node_arena */
     scorep_profile_sparse_metric_int*    free_int_metrics;         /**< List of records for recycling */
     scorep_profile_sparse_metric_double* free_double_metrics;      /**< List of records for recycling */
     scorep_profile_node*                 free_stubs;               /**< List of stubs for recycling */
@@ -54,6 +54,45 @@
 
 #include <SCOREP_Metric_Management.h>
 
+/**
+   Number of children of a node, above which @ref scorep_profile_find_create_child
+   builds a hash index over the children instead of walking the sibling list.
+ */
+#define SCOREP_PROFILE_CHILD_INDEX_THRESHOLD 8
+
+/**
+   Initial number of slots of a child index. Must be a power of two.
+ */
+#define SCOREP_PROFILE_CHILD_INDEX_MIN_CAPACITY 16
+
+/**
+   Number of nodes allocated at once by @ref scorep_profile_alloc_node.
+ */
+#define SCOREP_PROFILE_NODE_ARENA_BLOCK 32
+
+typedef struct
+{
+    uint64_t             hash;
+    scorep_profile_node* node;
+} scorep_profile_child_index_slot;
+
+/**
+   Open addressing hash table with linear probing over the children of a node.
+   It is allocated from the profile memory of the location and never freed
+   explicitly. A grown table replaces the old one, which stays in the page
+   until the profile memory is released.
+ */
+struct scorep_profile_child_index
+{
+    /** first_child of the parent, when the index was last synchronized. Children
+        prepended by other means than scorep_profile_find_create_child, e.g.,
+        scorep_profile_add_child, are detected by a changed first_child. */
+    scorep_profile_node*            head;
+    uint32_t                        capacity;
+    uint32_t                        size;
+    scorep_profile_child_index_slot slots[];
+};
+
 /* ***************************************************************************************
    Creation / Destruction
 *****************************************************************************************/
@@ -86,6 +125,7 @@ scorep_profile_create_node( SCOREP_Profile_LocationData* location,
     node->first_enter_time    = timestamp;
     node->last_exit_time      = timestamp;
     node->node_type           = type;
+    node->child_index         = NULL;
     scorep_profile_copy_type_data( &node->type_specific_data, data, type );
 
     /* Initialize dense metric values */
@@ -179,6 +219,10 @@ scorep_profile_release_subtree( SCOREP_Profile_LocationData* location,
         location->free_double_metrics   = root->first_double_sparse;
     }
 
+    /* A released node must not be found in the child index of its former parent */
+    root->parent      = NULL;
+    root->child_index = NULL;
+
     /* Insert this node into list of released nodes */
     if ( scorep_profile_get_task_context( root ) == SCOREP_PROFILE_TASK_CONTEXT_UNTIED )
     {
@@ -215,6 +259,7 @@ scorep_profile_alloc_node( SCOREP_Profile_LocationData* location,
     }
 
     /* Allocate new memory if no released nodes are available */
+    uint32_t number_of_metrics = SCOREP_Metric_GetNumberOfStrictlySynchronousMetrics();
 
     /* Reserve space for the node record and dense metrics.
      *  Thread root nodes must not be deleted in Periscope phases, while all other
@@ -225,35 +270,49 @@ scorep_profile_alloc_node( SCOREP_Profile_LocationData* location,
     if ( type == SCOREP_PROFILE_NODE_THREAD_ROOT )
     {
         new_node = ( scorep_profile_node* )
-                   SCOREP_Location_AllocForMisc( location->location_data,
-                                                 sizeof( scorep_profile_node ) );
+                   SCOREP_Location_AlignedAllocForMisc( location->location_data,
+                                                        SCOREP_CACHELINESIZE,
+                                                        sizeof( scorep_profile_node ) );
+        memset( new_node, 0, sizeof( *new_node ) );
+
+        /* Reserve space for dense metrics,
+           Since the metric number may vary on reinitialization, allocate it
+           also for root nodes from profile memory which get freed on
+           finalization and reallocate the memory for root nodes on
+           reinitialization
+         */
+        if ( number_of_metrics > 0 )
+        {
+            new_node->dense_metrics = ( scorep_profile_dense_metric* )
+                                      SCOREP_Location_AllocForProfile( location->location_data,
+                                                                       number_of_metrics * sizeof( scorep_profile_dense_metric ) );
+        }
     }
     else
     {
-        new_node = ( scorep_profile_node* )
-                   SCOREP_Location_AllocForProfile( location->location_data,
-                                                    sizeof( scorep_profile_node ) );
-    }
-    memset( new_node, 0, sizeof( *new_node ) );
-
-    /* Reserve space for dense metrics,
-       Since the metric number may vary on reinitialization, allocate it
-       also for root nodes from profile memory which get freed on
-       finalization and reallocate the memory for root nodes on
-       reinitialization
-     */
-    if ( SCOREP_Metric_GetNumberOfStrictlySynchronousMetrics() > 0 )
-    {
-        /* Size of the allocated memory for dense metrics */
-        uint32_t size = SCOREP_Metric_GetNumberOfStrictlySynchronousMetrics() *
-                        sizeof( scorep_profile_dense_metric );
+        /* Nodes are carved from blocks of cache line aligned slots, each
+           holding the node followed by its dense metrics. */
+        size_t slot_size = sizeof( scorep_profile_node )
+                           + number_of_metrics * sizeof( scorep_profile_dense_metric );
+        slot_size = ( slot_size + SCOREP_CACHELINESIZE - 1 )
+                    & ~( ( size_t )SCOREP_CACHELINESIZE - 1 );
+
+        if ( location->node_arena_free == 0 )
+        {
+            location->node_arena = SCOREP_Location_AlignedAllocForProfile( location->location_data,
+                                                                           SCOREP_CACHELINESIZE,
+                                                                           SCOREP_PROFILE_NODE_ARENA_BLOCK * slot_size );
+            location->node_arena_free = SCOREP_PROFILE_NODE_ARENA_BLOCK;
+        }
+        new_node                  = ( scorep_profile_node* )location->node_arena;
+        location->node_arena     += slot_size;
+        location->node_arena_free--;
 
-        new_node->dense_metrics = ( scorep_profile_dense_metric* )
-                                  SCOREP_Location_AllocForProfile( location->location_data, size );
-    }
-    else
-    {
-        new_node->dense_metrics = NULL;
+        memset( new_node, 0, slot_size );
+        if ( number_of_metrics > 0 )
+        {
+            new_node->dense_metrics = ( scorep_profile_dense_metric* )( new_node + 1 );
+        }
     }
 
     scorep_profile_set_task_context( new_node, context );
@@ -351,6 +410,10 @@ scorep_profile_move_children(  scorep_profile_node* destination,
         return;
     }
 
+    /* Children are appended to the end of the list, which the index can not detect */
+    scorep_profile_invalidate_child_index( source );
+    scorep_profile_invalidate_child_index( destination );
+
     /* Set new parent of all children of source. */
     while ( child != NULL )
     {
@@ -395,6 +458,15 @@ scorep_profile_move_children(  scorep_profile_node* destination,
     source->first_child = NULL;
 }
 
+void
+scorep_profile_invalidate_child_index( scorep_profile_node* parent )
+{
+    if ( parent != NULL )
+    {
+        parent->child_index = NULL;
+    }
+}
+
 /* Removes a node with it subtree from its parents children */
 void
 scorep_profile_remove_node( scorep_profile_node* node )
@@ -412,6 +484,7 @@ scorep_profile_remove_node( scorep_profile_node* node )
     else
     {
         before = parent->first_child;
+        scorep_profile_invalidate_child_index( parent );
     }
 
     /* If node is the first entry */
@@ -517,6 +590,161 @@ scorep_profile_find_child( scorep_profile_node* parent,
     return child;
 }
 
+static inline uint64_t
+child_index_hash( scorep_profile_node_type   nodeType,
+                  scorep_profile_type_data_t specificData )
+{
+    /* Same as scorep_profile_node_hash() */
+    uint64_t val = nodeType;
+    val  = ( val >> 1 ) | ( val << 31 );
+    val += scorep_profile_hash_for_type_data( specificData, nodeType );
+    return val;
+}
+
+static inline uint32_t
+child_index_slot( const struct scorep_profile_child_index* index,
+                  uint64_t                                 hash )
+{
+    /* Fibonacci hashing, handles are often small consecutive numbers */
+    return ( uint32_t )( ( hash * UINT64_C( 0x9E3779B97F4A7C15 ) ) >> 32 )
+           & ( index->capacity - 1 );
+}
+
+static struct scorep_profile_child_index*
+child_index_alloc( SCOREP_Profile_LocationData* location,
+                   uint32_t                     capacity )
+{
+    size_t                             size  = sizeof( struct scorep_profile_child_index )
+                                               + capacity * sizeof( scorep_profile_child_index_slot );
+    struct scorep_profile_child_index* index =
+        SCOREP_Location_AllocForProfile( location->location_data, size );
+    if ( index == NULL )
+    {
+        return NULL;
+    }
+    memset( index, 0, size );
+    index->capacity = capacity;
+    return index;
+}
+
+/* Inserts child, if no equal child is in the index yet. */
+static void
+child_index_insert( struct scorep_profile_child_index* index,
+                    uint64_t                           hash,
+                    scorep_profile_node*               child )
+{
+    uint32_t slot = child_index_slot( index, hash );
+    while ( index->slots[ slot ].node != NULL )
+    {
+        if ( index->slots[ slot ].hash == hash &&
+             scorep_profile_compare_nodes( index->slots[ slot ].node, child ) )
+        {
+            return;
+        }
+        slot = ( slot + 1 ) & ( index->capacity - 1 );
+    }
+    index->slots[ slot ].hash = hash;
+    index->slots[ slot ].node = child;
+    index->size++;
+}
+
+static scorep_profile_node*
+child_index_lookup( const struct scorep_profile_child_index* index,
+                    uint64_t                                 hash,
+                    scorep_profile_node_type                 nodeType,
+                    scorep_profile_type_data_t               specificData )
+{
+    uint32_t slot = child_index_slot( index, hash );
+    while ( index->slots[ slot ].node != NULL )
+    {
+        scorep_profile_node* child = index->slots[ slot ].node;
+        if ( index->slots[ slot ].hash == hash &&
+             child->node_type == nodeType &&
+             scorep_profile_compare_type_data( specificData,
+                                               child->type_specific_data,
+                                               nodeType ) )
+        {
+            return child;
+        }
+        slot = ( slot + 1 ) & ( index->capacity - 1 );
+    }
+    return NULL;
+}
+
+/* (Re-)builds the child index of @a parent from its sibling list. */
+static void
+child_index_build( SCOREP_Profile_LocationData* location,
+                   scorep_profile_node*         parent,
+                   uint32_t                     numChildren )
+{
+    uint32_t capacity = SCOREP_PROFILE_CHILD_INDEX_MIN_CAPACITY;
+    while ( capacity < 2 * numChildren )
+    {
+        capacity *= 2;
+    }
+
+    struct scorep_profile_child_index* index = parent->child_index;
+    if ( index != NULL && index->capacity >= capacity )
+    {
+        memset( index->slots, 0, index->capacity * sizeof( scorep_profile_child_index_slot ) );
+        index->size = 0;
+    }
+    else
+    {
+        index = child_index_alloc( location, capacity );
+    }
+    parent->child_index = index;
+    if ( index == NULL )
+    {
+        return;
+    }
+
+    for ( scorep_profile_node* child = parent->first_child;
+          child != NULL;
+          child = child->next_sibling )
+    {
+        child_index_insert( index,
+                            child_index_hash( child->node_type,
+                                              child->type_specific_data ),
+                            child );
+    }
+    index->head = parent->first_child;
+}
+
+/* Adds a new first child of @a parent to its child index. */
+static void
+child_index_add( SCOREP_Profile_LocationData* location,
+                 scorep_profile_node*         parent,
+                 uint64_t                     hash,
+                 scorep_profile_node*         child )
+{
+    struct scorep_profile_child_index* index = parent->child_index;
+
+    /* Keep the load factor below 3/4 */
+    if ( 4 * ( index->size + 1 ) > 3 * index->capacity )
+    {
+        struct scorep_profile_child_index* grown =
+            child_index_alloc( location, 2 * index->capacity );
+        if ( grown == NULL )
+        {
+            parent->child_index = NULL;
+            return;
+        }
+        for ( uint32_t i = 0; i < index->capacity; i++ )
+        {
+            if ( index->slots[ i ].node != NULL )
+            {
+                child_index_insert( grown, index->slots[ i ].hash, index->slots[ i ].node );
+            }
+        }
+        index               = grown;
+        parent->child_index = index;
+    }
+
+    child_index_insert( index, hash, child );
+    index->head = child;
+}
+
 /* Find or create a child node of a specified type */
 scorep_profile_node*
 scorep_profile_find_create_child( SCOREP_Profile_LocationData* location,
@@ -525,27 +753,69 @@ scorep_profile_find_create_child( SCOREP_Profile_LocationData* location,
                                   scorep_profile_type_data_t   specific_data,
                                   uint64_t                     timestamp )
 {
-    /* Search matching node */
     UTILS_ASSERT( parent != NULL );
-    scorep_profile_node* child = parent->first_child;
-    while ( ( child != NULL ) &&
-            ( ( child->node_type != node_type ) ||
-              ( !scorep_profile_compare_type_data( specific_data,
-                                                   child->type_specific_data,
-                                                   node_type ) ) ) )
+    scorep_profile_node* child = NULL;
+    uint64_t             hash  = child_index_hash( node_type, specific_data );
+
+    /* Use the index, if no children were prepended behind its back */
+    struct scorep_profile_child_index* index = parent->child_index;
+    if ( index != NULL && index->head == parent->first_child )
     {
-        child = child->next_sibling;
+        child = child_index_lookup( index, hash, node_type, specific_data );
+        if ( child != NULL && child->parent == parent )
+        {
+            return child;
+        }
+        if ( child != NULL )
+        {
+            /* Stale entry, the children were modified without updating the index */
+            parent->child_index = NULL;
+        }
     }
 
-    /* If not found -> create new node */
-    if ( child == NULL )
+    if ( parent->child_index == NULL || parent->child_index->head != parent->first_child )
+    {
+        /* Search matching node */
+        uint32_t num_children = 0;
+        child = parent->first_child;
+        while ( ( child != NULL ) &&
+                ( ( child->node_type != node_type ) ||
+                  ( !scorep_profile_compare_type_data( specific_data,
+                                                       child->type_specific_data,
+                                                       node_type ) ) ) )
+        {
+            child = child->next_sibling;
+            num_children++;
+        }
+
+        /* The remaining children are only counted, if the index needs to be built */
+        if ( num_children >= SCOREP_PROFILE_CHILD_INDEX_THRESHOLD ||
+             parent->child_index != NULL )
+        {
+            for ( scorep_profile_node* rest = child; rest != NULL; rest = rest->next_sibling )
+            {
+                num_children++;
+            }
+            child_index_build( location, parent, num_children );
+        }
+
+        if ( child != NULL )
+        {
+            return child;
+        }
+    }
+
+    /* Not found -> create new node */
+    child = scorep_profile_create_node( location, parent, node_type,
+                                        specific_data,
+                                        timestamp,
+                                        scorep_profile_get_task_context( parent ) );
+    child->next_sibling = parent->first_child;
+    parent->first_child = child;
+
+    if ( parent->child_index != NULL )
     {
-        child = scorep_profile_create_node( location, parent, node_type,
-                                            specific_data,
-                                            timestamp,
-                                            scorep_profile_get_task_context( parent ) );
-        child->next_sibling = parent->first_child;
-        parent->first_child = child;
+        child_index_add( location, parent, hash, child );
     }
 
     return child;
@@ -772,6 +1042,7 @@ scorep_profile_substitute_thread_starts( scorep_profile_node* old,
         if ( child != NULL )
         {
             scorep_profile_type_set_fork_node( &child->type_specific_data, substitute );
+            scorep_profile_invalidate_child_index( root );
         }
     }
 }
@@ -801,6 +1072,7 @@ merge_thread_starts( scorep_profile_node* destination,
         if ( dest == NULL )
         {
             scorep_profile_type_set_fork_node( &src->type_specific_data, destination );
+            scorep_profile_invalidate_child_index( root );
             continue;
         }
 
@@ -131,24 +131,40 @@ typedef enum
 
    The  field @a flag is an bitstring to set various flags. Possible flags are defined
    in @a scorep_profile_node_flag.
+
+   Nodes with many children get a hash index over their children in @a child_index,
+   which is used by @ref scorep_profile_find_create_child. The index is only a lookup
+   aid, the sibling list stays the authoritative representation of the children.
+
+   The fields are grouped by their use during measurement. On 64 bit systems, the
+   first cache line holds everything needed to find a child on enter, the second
+   one the data updated on enter and exit, and the rest is touched rarely. Nodes are
+   allocated cache line aligned with their dense metrics directly behind them, see
+   @ref scorep_profile_alloc_node.
  */
 typedef struct scorep_profile_node_struct
 {
-    SCOREP_CallpathHandle                callpath_handle;
+    /* Child lookup */
+    scorep_profile_node_type             node_type;
+    uint8_t                              flags;
+    scorep_profile_type_data_t           type_specific_data;
     struct scorep_profile_node_struct*   parent;
     struct scorep_profile_node_struct*   first_child;
     struct scorep_profile_node_struct*   next_sibling;
+    struct scorep_profile_child_index*   child_index;
+    uint64_t                             count;            // For dense metrics
+
+    /* Enter and exit */
+    scorep_profile_dense_metric          inclusive_time;
     scorep_profile_dense_metric*         dense_metrics;
+    uint64_t                             last_exit_time;   // Required by Scalasca
+
+    /* Rarely used */
+    SCOREP_CallpathHandle                callpath_handle;
     scorep_profile_sparse_metric_double* first_double_sparse;
     scorep_profile_sparse_metric_int*    first_int_sparse;
-    scorep_profile_dense_metric          inclusive_time;
-    uint64_t                             count;            // For dense metrics
     uint64_t                             hits;             // For samples
     uint64_t                             first_enter_time; // Required by Scalasca
-    uint64_t                             last_exit_time;   // Required by Scalasca
-    scorep_profile_node_type             node_type;
-    scorep_profile_type_data_t           type_specific_data;
-    uint8_t                              flags;
 } scorep_profile_node;
 
 /**
@@ -345,6 +361,16 @@ void
 scorep_profile_move_children(  scorep_profile_node* destination,
                                scorep_profile_node* source );
 
+/**
+   Drops the hash index over the children of @a parent. It is rebuilt on demand
+   by @ref scorep_profile_find_create_child. Must be called whenever the
+   node type or the type specific data of a child of @a parent are changed in
+   place, because the index is keyed by these.
+   @param parent Pointer to the node whose children changed. May be NULL.
+ */
+void
+scorep_profile_invalidate_child_index( scorep_profile_node* parent );
+
 /**
    Removes the node from the profile structure. The whole subtree rooted in
    @a node is removed.
@@ -225,6 +225,7 @@ substitute_dynamic_instances_in_node( scorep_profile_node* node,
         node->node_type = SCOREP_PROFILE_NODE_REGULAR_REGION;
         memset( &node->type_specific_data, 0, sizeof( node->type_specific_data ) );
         scorep_profile_type_set_region_handle( &node->type_specific_data, handle );
+        scorep_profile_invalidate_child_index( parent );
     }
 }
 
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2011,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2011, 2015-2016, 2019, 2022,
+ * Copyright (c) 2009-2011, 2015-2016, 2019, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2011,
@@ -42,6 +42,7 @@
 #include "scorep_environment.h"
 
 #include <UTILS_Error.h>
+#include <UTILS_Mutex.h>
 
 #include <SCOREP_Types.h>
 #include <SCOREP_Config.h>
@@ -65,13 +66,17 @@ static bool env_variables_initialized = false;
  */
 static bool     env_verbose;
 static uint64_t env_total_memory;
+static uint64_t env_total_memory_limit;
 static uint64_t env_page_size;
 static char*    env_experiment_directory;
 static bool     env_overwrite_experiment_directory;
 static char*    env_machine_name;
 static char*    env_executable;
 static bool     env_system_tree_sequence;
+static uint64_t env_unify_fan_in;
 static bool     force_cfg_files;
+static uint64_t env_mutex_mode;
+static uint64_t env_mutex_spin_count;
 
 /*
  * Tracing setup
@@ -89,6 +94,29 @@ static bool env_profiling;
 static bool env_unwinding;
 
 
+/* Default set with the configure option --enable-adaptive-mutex */
+#if HAVE( BACKEND_SCOREP_MUTEX_ADAPTIVE )
+#define MUTEX_MODE_DEFAULT "adaptive"
+#else
+#define MUTEX_MODE_DEFAULT "spin"
+#endif
+
+static const SCOREP_ConfigType_SetEntry mutex_mode_table[] = {
+    {
+        "spin",
+        UTILS_MUTEX_MODE_SPIN,
+        "Waiters spin until the lock is released."
+    },
+    {
+        "adaptive",
+        UTILS_MUTEX_MODE_ADAPTIVE,
+        "Waiters spin for SCOREP_MUTEX_SPIN_COUNT iterations, then sleep until "
+        "the lock is released."
+    },
+    { NULL, 0, NULL }
+};
+
+
 /** @brief Measurement system configure variables */
 static const SCOREP_ConfigVariable core_enable_confvars[] = {
     {
@@ -152,7 +180,23 @@ static const SCOREP_ConfigVariable core_confvars[] = {
         "Total memory in bytes per process to be consumed by the measurement system",
         "SCOREP_TOTAL_MEMORY will be split into pages of size SCOREP_PAGE_SIZE "
         "(potentially reduced to a multiple of SCOREP_PAGE_SIZE). Maximum size is 4 GB"
-        "minus one SCOREP_PAGE_SIZE."
+        "minus one SCOREP_PAGE_SIZE.\n"
+        "The memory is committed up-front. If exhausted, the measurement system "
+        "commits further memory in steps of SCOREP_TOTAL_MEMORY, up to "
+        "SCOREP_TOTAL_MEMORY_LIMIT."
+    },
+    {
+        "total_memory_limit",
+        SCOREP_CONFIG_TYPE_SIZE,
+        &env_total_memory_limit,
+        NULL,
+        "0",
+        "Hard limit in bytes for the memory consumed by the measurement system per process",
+        "The address space for SCOREP_TOTAL_MEMORY_LIMIT is reserved at "
+        "initialization, but only committed on demand. A value of 0 or any "
+        "value larger than 4 GB results in the maximum of 4 GB minus one "
+        "SCOREP_PAGE_SIZE. If set to SCOREP_TOTAL_MEMORY or less, the memory "
+        "does not grow."
     },
     {
         "page_size",
@@ -230,6 +274,21 @@ static const SCOREP_ConfigVariable core_confvars[] = {
         "Currently, system tree sequence definitions support only MPI "
         "(and trivially single-process) applications."
     },
+    {
+        "unify_fan_in",
+        SCOREP_CONFIG_TYPE_NUMBER,
+        &env_unify_fan_in,
+        NULL,
+        "0",
+        "Number of children per process in the tree of the definition unification",
+        "The definitions of all processes are unified along a tree. With the "
+        "default of 0, the tree is a binomial tree, where the root has "
+        "log2(number of processes) children. Any value of 2 or greater "
+        "results in a tree where each process has at most that many "
+        "children, which bounds the number of messages a process receives "
+        "in each level. A value of 1 is invalid and treated like 0. Needs "
+        "to be the same for all processes."
+    },
     {
         "force_cfg_files",
         SCOREP_CONFIG_TYPE_BOOL,
@@ -244,6 +303,27 @@ static const SCOREP_ConfigVariable core_confvars[] = {
         "If this is set to 'false', the directory will only be created if any "
         "substrate actually writes data."
     },
+    {
+        "mutex",
+        SCOREP_CONFIG_TYPE_OPTIONSET,
+        &env_mutex_mode,
+        ( void* )mutex_mode_table,
+        MUTEX_MODE_DEFAULT, /* configure-provided default */
+        "Waiting strategy for contended locks of the measurement system",
+        "The 'adaptive' mode avoids that waiting threads consume their whole "
+        "time slice while the holder of the lock is not scheduled, e.g., if "
+        "there are more threads than cores. The default is 'adaptive', if "
+        "Score-P was configured with --enable-adaptive-mutex. Available modes:"
+    },
+    {
+        "mutex_spin_count",
+        SCOREP_CONFIG_TYPE_NUMBER,
+        &env_mutex_spin_count,
+        NULL,
+        "1000",
+        "Number of spin iterations before a waiter sleeps in the 'adaptive' SCOREP_MUTEX mode",
+        "Values larger than 2^32-1 are reduced to 2^32-1."
+    },
     SCOREP_CONFIG_TERMINATOR
 };
 
@@ -304,6 +384,14 @@ SCOREP_Env_GetTotalMemory( void )
 }
 
 
+uint64_t
+SCOREP_Env_GetTotalMemoryLimit( void )
+{
+    assert( env_variables_initialized );
+    return env_total_memory_limit;
+}
+
+
 uint64_t
 SCOREP_Env_GetPageSize( void )
 {
@@ -359,6 +447,34 @@ SCOREP_Env_UseSystemTreeSequence( void )
     return env_system_tree_sequence;
 }
 
+uint64_t
+SCOREP_Env_GetUnifyFanIn( void )
+{
+    assert( env_variables_initialized );
+    if ( env_unify_fan_in == 1 )
+    {
+        UTILS_WARN_ONCE( "A fan-in of 1 for the definition unification, set via "
+                         "`SCOREP_UNIFY_FAN_IN`, is invalid. Using the "
+                         "binomial tree instead." );
+        return 0;
+    }
+    return env_unify_fan_in;
+}
+
+uint64_t
+SCOREP_Env_GetMutexMode( void )
+{
+    assert( env_variables_initialized );
+    return env_mutex_mode;
+}
+
+uint32_t
+SCOREP_Env_GetMutexSpinCount( void )
+{
+    assert( env_variables_initialized );
+    return env_mutex_spin_count > UINT32_MAX ? UINT32_MAX : env_mutex_spin_count;
+}
+
 void
 SCOREP_RegisterAllConfigVariables( void )
 {
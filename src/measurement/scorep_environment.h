@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2011,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2011, 2015-2016, 2019,
+ * Copyright (c) 2009-2011, 2015-2016, 2019, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2011,
@@ -64,6 +64,9 @@ SCOREP_Env_RunVerbose( void );
 uint64_t
 SCOREP_Env_GetTotalMemory( void );
 
+uint64_t
+SCOREP_Env_GetTotalMemoryLimit( void );
+
 uint64_t
 SCOREP_Env_GetPageSize( void );
 
@@ -82,6 +85,15 @@ SCOREP_Env_GetExecutable( void );
 bool
 SCOREP_Env_UseSystemTreeSequence( void );
 
+uint64_t
+SCOREP_Env_GetUnifyFanIn( void );
+
+uint64_t
+SCOREP_Env_GetMutexMode( void );
+
+uint32_t
+SCOREP_Env_GetMutexSpinCount( void );
+
 /*
  * Tracing setup
  */
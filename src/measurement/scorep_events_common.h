@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2013, 2015,
+ * Copyright (c) 2009-2013, 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -41,11 +41,32 @@
 #include <SCOREP_Timer_Ticks.h>
 #include "scorep_status.h"
 #include <SCOREP_RuntimeManagement.h>
+#include <SCOREP_InMeasurement.h>
 #include <SCOREP_Location.h>
+#include <SCOREP_Unwinding.h>
+
+
+/**
+ * Triggers the samples recorded by the deferred unwinding on @a location.
+ * Their timestamps precede the next event, thus this needs to be called
+ * before any other event is triggered on @a location. Samples handled in
+ * the signal handler take care of the deferred ones themselves.
+ *
+ * @param location          Current Score-P location
+ */
+static inline void
+scorep_process_deferred_samples( SCOREP_Location* location )
+{
+    if ( SCOREP_IsUnwindingEnabled() && !SCOREP_IN_SIGNAL_CONTEXT() )
+    {
+        SCOREP_Unwinding_ProcessDeferredSamples( location );
+    }
+}
 
 
 /**
- * Returns the current Score-P timestamp.
+ * Returns the current Score-P timestamp. Triggers the deferred samples of
+ * @a location first.
  *
  * @param location          Current Score-P location
  *
@@ -54,6 +75,8 @@
 static inline uint64_t
 scorep_get_timestamp( SCOREP_Location* location )
 {
+    scorep_process_deferred_samples( location );
+
     uint64_t timestamp = SCOREP_Timer_GetClockTicks();
     SCOREP_Location_SetLastTimestamp( location, timestamp );
     return timestamp;
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2019, 2022,
+ * Copyright (c) 2009-2019, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -57,8 +57,13 @@
 #include <SCOREP_Memory.h>
 
 #include <SCOREP_Hashtab.h>
+#include <SCOREP_InMeasurement.h>
+#include <UTILS_Atomic.h>
 #include <jenkins_hash.h>
 
+#include <pthread.h>
+#include <unistd.h>
+
 static void
 resolve_interim_definitions( void );
 
@@ -145,39 +150,305 @@ SCOREP_Unify( void )
     while ( 0 )
 
 
+/*
+ * Local unification runs the definition types of one stage concurrently on a
+ * small set of threads. Each type is unified by exactly one thread in the
+ * order of its definitions, thus the sequence numbers are the same as when
+ * unifying serially. A type references only types of earlier stages.
+ */
+
+/** Maximum number of threads used to unify definitions. */
+#define UNIFY_MAX_THREADS 8
+
+/** Number of string, region, and callpath definitions, from which on threads are used. */
+#define UNIFY_PARALLEL_THRESHOLD 4096
+
+
+typedef void ( *unify_definitions_func )( SCOREP_DefinitionManager* definitionManager );
+
+typedef struct unify_task
+{
+    unify_definitions_func unify;
+    /** Not unified when using system tree sequence definitions. */
+    bool                   is_system_tree;
+} unify_task;
+
+#define UNIFY_DEFINITIONS_FUNC( Type, type ) \
+    static void \
+    unify_definitions_ ## type( SCOREP_DefinitionManager* definitionManager ) \
+    { \
+        UNIFY_DEFINITION( definitionManager, Type, type ); \
+    }
+
+UNIFY_DEFINITIONS_FUNC( String, string )
+UNIFY_DEFINITIONS_FUNC( SystemTreeNode, system_tree_node )
+UNIFY_DEFINITIONS_FUNC( SystemTreeNodeProperty, system_tree_node_property )
+UNIFY_DEFINITIONS_FUNC( LocationGroup, location_group )
+UNIFY_DEFINITIONS_FUNC( Location, location )
+UNIFY_DEFINITIONS_FUNC( LocationProperty, location_property )
+UNIFY_DEFINITIONS_FUNC( SourceFile, source_file )
+UNIFY_DEFINITIONS_FUNC( Region, region )
+UNIFY_DEFINITIONS_FUNC( Group, group )
+UNIFY_DEFINITIONS_FUNC( Communicator, communicator )
+UNIFY_DEFINITIONS_FUNC( RmaWindow, rma_window )
+UNIFY_DEFINITIONS_FUNC( Metric, metric )
+UNIFY_DEFINITIONS_FUNC( SamplingSet, sampling_set )
+UNIFY_DEFINITIONS_FUNC( SamplingSetRecorder, sampling_set_recorder )
+UNIFY_DEFINITIONS_FUNC( Parameter, parameter )
+UNIFY_DEFINITIONS_FUNC( Callpath, callpath )
+UNIFY_DEFINITIONS_FUNC( Property, property )
+UNIFY_DEFINITIONS_FUNC( Attribute, attribute )
+UNIFY_DEFINITIONS_FUNC( CartesianTopology, cartesian_topology )
+UNIFY_DEFINITIONS_FUNC( CartesianCoords, cartesian_coords )
+UNIFY_DEFINITIONS_FUNC( SourceCodeLocation, source_code_location )
+UNIFY_DEFINITIONS_FUNC( CallingContext, calling_context )
+UNIFY_DEFINITIONS_FUNC( InterruptGenerator, interrupt_generator )
+UNIFY_DEFINITIONS_FUNC( IoFile, io_file )
+UNIFY_DEFINITIONS_FUNC( IoFileProperty, io_file_property )
+UNIFY_DEFINITIONS_FUNC( IoHandle, io_handle )
+
+#undef UNIFY_DEFINITIONS_FUNC
+
+#define UNIFY_TASK( type ) { unify_definitions_ ## type, false }
+#define UNIFY_SYSTEM_TREE_TASK( type ) { unify_definitions_ ## type, true }
+#define UNIFY_STAGE_END { NULL, false }
+
+/* Everything references strings */
+static const unify_task unify_stage_0[] =
+{
+    UNIFY_TASK( string ),
+    UNIFY_STAGE_END
+};
+
+static const unify_task unify_stage_1[] =
+{
+    UNIFY_SYSTEM_TREE_TASK( system_tree_node ),
+    UNIFY_TASK( source_file ),
+    UNIFY_TASK( region ),
+    UNIFY_TASK( group ),
+    UNIFY_TASK( metric ),
+    UNIFY_TASK( parameter ),
+    UNIFY_TASK( property ),
+    UNIFY_TASK( attribute ),
+    UNIFY_TASK( source_code_location ),
+    UNIFY_TASK( interrupt_generator ),
+    UNIFY_STAGE_END
+};
+
+static const unify_task unify_stage_2[] =
+{
+    /* system tree node */
+    UNIFY_SYSTEM_TREE_TASK( system_tree_node_property ),
+    UNIFY_SYSTEM_TREE_TASK( location_group ),
+    UNIFY_TASK( io_file ),
+    /* group */
+    UNIFY_TASK( communicator ),
+    /* region, parameter */
+    UNIFY_TASK( callpath ),
+    /* region, source code location */
+    UNIFY_TASK( calling_context ),
+    UNIFY_STAGE_END
+};
+
+static const unify_task unify_stage_3[] =
+{
+    /* location group */
+    UNIFY_SYSTEM_TREE_TASK( location ),
+    /* communicator */
+    UNIFY_TASK( rma_window ),
+    UNIFY_TASK( cartesian_topology ),
+    /* io file, communicator */
+    UNIFY_TASK( io_file_property ),
+    UNIFY_TASK( io_handle ),
+    UNIFY_STAGE_END
+};
+
+static const unify_task unify_stage_4[] =
+{
+    /* location */
+    UNIFY_SYSTEM_TREE_TASK( location_property ),
+    /* metric, location, and the scopes */
+    UNIFY_TASK( sampling_set ),
+    /* cartesian topology */
+    UNIFY_TASK( cartesian_coords ),
+    UNIFY_STAGE_END
+};
+
+static const unify_task unify_stage_5[] =
+{
+    /* sampling set, location */
+    UNIFY_TASK( sampling_set_recorder ),
+    UNIFY_STAGE_END
+};
+
+static const unify_task* const unify_stages[] =
+{
+    unify_stage_0,
+    unify_stage_1,
+    unify_stage_2,
+    unify_stage_3,
+    unify_stage_4,
+    unify_stage_5,
+    NULL
+};
+
+#undef UNIFY_TASK
+#undef UNIFY_SYSTEM_TREE_TASK
+#undef UNIFY_STAGE_END
+
+
+typedef struct unify_stage
+{
+    SCOREP_DefinitionManager* definition_manager;
+    unify_definitions_func    tasks[ 16 ];
+    uint32_t                  number_of_tasks;
+    uint32_t                  next_task;
+} unify_stage;
+
+typedef struct unify_worker
+{
+    unify_stage*                  stage;
+    SCOREP_Allocator_PageManager* page_manager;
+    pthread_t                     thread;
+} unify_worker;
+
+
+static void
+run_unify_tasks( unify_stage* stage )
+{
+    uint32_t task;
+    while ( ( task = UTILS_Atomic_FetchAdd_uint32( &stage->next_task, 1,
+                                                   UTILS_ATOMIC_RELAXED ) )
+            < stage->number_of_tasks )
+    {
+        stage->tasks[ task ]( stage->definition_manager );
+    }
+}
+
+
+static void*
+unify_worker_main( void* arg )
+{
+    unify_worker* worker = arg;
+
+    SCOREP_IN_MEASUREMENT_INCREMENT();
+    SCOREP_Memory_SetThreadDefinitionPageManager( worker->page_manager );
+    run_unify_tasks( worker->stage );
+    SCOREP_Memory_SetThreadDefinitionPageManager( NULL );
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+
+    return NULL;
+}
+
+
+static uint32_t
+get_number_of_unify_threads( SCOREP_DefinitionManager* definitionManager )
+{
+    if ( definitionManager->string.counter
+         + definitionManager->region.counter
+         + definitionManager->callpath.counter < UNIFY_PARALLEL_THRESHOLD )
+    {
+        return 1;
+    }
+
+    long number_of_cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    if ( number_of_cpus < 1 )
+    {
+        return 1;
+    }
+    return number_of_cpus < UNIFY_MAX_THREADS ? number_of_cpus : UNIFY_MAX_THREADS;
+}
+
+
 void
 SCOREP_CopyDefinitionsToUnified( SCOREP_DefinitionManager* sourceDefinitionManager )
 {
     UTILS_ASSERT( sourceDefinitionManager );
-    UNIFY_DEFINITION( sourceDefinitionManager, String, string );
-    if ( !SCOREP_Status_UseSystemTreeSequenceDefinitions() )
+
+    scorep_unify_copy_definitions( sourceDefinitionManager,
+                                   get_number_of_unify_threads( sourceDefinitionManager ) );
+}
+
+
+void
+scorep_unify_copy_definitions( SCOREP_DefinitionManager* sourceDefinitionManager,
+                               uint32_t                  numberOfThreads )
+{
+    UTILS_ASSERT( sourceDefinitionManager );
+
+    /* Every thread allocates the new unified definitions from its own page
+     * manager, the master thread takes the first one. */
+    unify_worker workers[ UNIFY_MAX_THREADS ];
+    uint32_t     number_of_threads = numberOfThreads;
+    if ( number_of_threads > UNIFY_MAX_THREADS )
     {
-        UNIFY_DEFINITION( sourceDefinitionManager, SystemTreeNode, system_tree_node );
-        UNIFY_DEFINITION( sourceDefinitionManager, SystemTreeNodeProperty, system_tree_node_property );
-        UNIFY_DEFINITION( sourceDefinitionManager, LocationGroup, location_group );
-        UNIFY_DEFINITION( sourceDefinitionManager, Location, location );
-        UNIFY_DEFINITION( sourceDefinitionManager, LocationProperty, location_property );
+        number_of_threads = UNIFY_MAX_THREADS;
+    }
+    if ( number_of_threads > 1 )
+    {
+        for ( uint32_t i = 0; i < number_of_threads; i++ )
+        {
+            workers[ i ].page_manager = SCOREP_Memory_CreatePageManager();
+        }
+        if ( !SCOREP_Memory_SetThreadDefinitionPageManager( workers[ 0 ].page_manager ) )
+        {
+            for ( uint32_t i = 0; i < number_of_threads; i++ )
+            {
+                SCOREP_Allocator_DeletePageManager( workers[ i ].page_manager );
+            }
+            number_of_threads = 1;
+        }
+    }
+
+    for ( const unify_task* const* stage_tasks = unify_stages; *stage_tasks; stage_tasks++ )
+    {
+        unify_stage stage;
+        stage.definition_manager = sourceDefinitionManager;
+        stage.number_of_tasks    = 0;
+        stage.next_task          = 0;
+        for ( const unify_task* task = *stage_tasks; task->unify; task++ )
+        {
+            if ( task->is_system_tree && SCOREP_Status_UseSystemTreeSequenceDefinitions() )
+            {
+                continue;
+            }
+            UTILS_BUG_ON( stage.number_of_tasks == sizeof( stage.tasks ) / sizeof( stage.tasks[ 0 ] ),
+                          "Too many definition types in one unification stage" );
+            stage.tasks[ stage.number_of_tasks++ ] = task->unify;
+        }
+
+        uint32_t number_of_workers = 1;
+        while ( number_of_workers < number_of_threads
+                && number_of_workers < stage.number_of_tasks )
+        {
+            workers[ number_of_workers ].stage = &stage;
+            if ( pthread_create( &workers[ number_of_workers ].thread, NULL,
+                                 unify_worker_main, &workers[ number_of_workers ] ) != 0 )
+            {
+                /* the remaining tasks are done by the others */
+                break;
+            }
+            number_of_workers++;
+        }
+
+        run_unify_tasks( &stage );
+
+        for ( uint32_t i = 1; i < number_of_workers; i++ )
+        {
+            pthread_join( workers[ i ].thread, NULL );
+        }
+    }
+
+    if ( number_of_threads > 1 )
+    {
+        SCOREP_Memory_SetThreadDefinitionPageManager( NULL );
+        for ( uint32_t i = 0; i < number_of_threads; i++ )
+        {
+            SCOREP_Allocator_MovePages( scorep_unified_definition_manager->page_manager,
+                                        workers[ i ].page_manager );
+            SCOREP_Allocator_DeletePageManager( workers[ i ].page_manager );
+        }
     }
-    UNIFY_DEFINITION( sourceDefinitionManager, SourceFile, source_file );
-    UNIFY_DEFINITION( sourceDefinitionManager, Region, region );
-    UNIFY_DEFINITION( sourceDefinitionManager, Group, group );
-    UNIFY_DEFINITION( sourceDefinitionManager, Communicator, communicator );
-    UNIFY_DEFINITION( sourceDefinitionManager, RmaWindow, rma_window );
-    UNIFY_DEFINITION( sourceDefinitionManager, Metric, metric );
-    UNIFY_DEFINITION( sourceDefinitionManager, SamplingSet, sampling_set );
-    UNIFY_DEFINITION( sourceDefinitionManager, SamplingSetRecorder, sampling_set_recorder );
-    UNIFY_DEFINITION( sourceDefinitionManager, Parameter, parameter );
-    UNIFY_DEFINITION( sourceDefinitionManager, Callpath, callpath );
-    UNIFY_DEFINITION( sourceDefinitionManager, Property, property );
-    UNIFY_DEFINITION( sourceDefinitionManager, Attribute, attribute );
-    UNIFY_DEFINITION( sourceDefinitionManager, CartesianTopology, cartesian_topology );
-    UNIFY_DEFINITION( sourceDefinitionManager, CartesianCoords, cartesian_coords );
-    UNIFY_DEFINITION( sourceDefinitionManager, SourceCodeLocation, source_code_location );
-    UNIFY_DEFINITION( sourceDefinitionManager, CallingContext, calling_context );
-    UNIFY_DEFINITION( sourceDefinitionManager, InterruptGenerator, interrupt_generator );
-    UNIFY_DEFINITION( sourceDefinitionManager, IoFile, io_file );
-    UNIFY_DEFINITION( sourceDefinitionManager, IoFileProperty, io_file_property );
-    UNIFY_DEFINITION( sourceDefinitionManager, IoHandle, io_handle );
 }
 
 
@@ -280,6 +551,10 @@ SCOREP_Unify_CreateUnifiedDefinitionManager( void )
     UTILS_BUG_ON( scorep_unified_definition_manager != NULL,
                   "Unified definition manager already created" );
 
+    /* The unified definitions share the page manager with the local ones,
+     * which were allocated per thread until now. */
+    SCOREP_Memory_MergeDefinitionPageManagers();
+
     bool alloc_hash_tables = true;
     SCOREP_Definitions_InitializeDefinitionManager( &scorep_unified_definition_manager,
                                                     SCOREP_Memory_GetLocalDefinitionPageManager(),
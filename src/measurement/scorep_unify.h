@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2013,
+ * Copyright (c) 2009-2013, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -62,6 +62,16 @@ void
 SCOREP_CopyDefinitionsToUnified( SCOREP_DefinitionManager* sourceDefinitionManager );
 
 
+/**
+ * Same as SCOREP_CopyDefinitionsToUnified(), but uses @a numberOfThreads
+ * threads, regardless of the number of definitions and CPUs. Used by the
+ * tests to compare the serial with the concurrent unification.
+ */
+void
+scorep_unify_copy_definitions( SCOREP_DefinitionManager* sourceDefinitionManager,
+                               uint32_t                  numberOfThreads );
+
+
 void
 SCOREP_CreateDefinitionMappings( SCOREP_DefinitionManager* definitionManager );
 
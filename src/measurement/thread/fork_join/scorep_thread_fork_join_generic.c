@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2016, 2019-2020, 2022,
+ * Copyright (c) 2009-2016, 2019-2020, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -303,6 +303,7 @@ SCOREP_ThreadForkJoin_TaskCreate( SCOREP_ParadigmType paradigm,
 {
     struct scorep_thread_private_data* tpd      = scorep_thread_get_private_data();
     SCOREP_Location*                   location = scorep_thread_get_location( tpd );
+    scorep_process_deferred_samples( location );
     /* use the timestamp from the associated enter */
     uint64_t                         timestamp = SCOREP_Location_GetLastTimestamp( location );
     SCOREP_InterimCommunicatorHandle team      = scorep_thread_get_team( tpd );
@@ -55,6 +55,7 @@
 #include "scorep_tracing_definitions.h"
 #include <scorep_clock_synchronization.h>
 #include "scorep_tracing_internal.h"
+#include "scorep_tracing_async_flush.h"
 
 #include <SCOREP_Substrates_Management.h>
 #include <scorep_substrates_definition.h>
@@ -73,6 +74,11 @@ static OTF2_Archive* scorep_otf2_archive;
 static bool event_files_opened;
 
 
+/* Whether event buffers are double buffered and written by a background
+ * thread, see SCOREP_TRACING_ASYNC_FLUSH. */
+static bool async_flush;
+
+
 size_t scorep_tracing_substrate_id;
 
 
@@ -118,6 +124,21 @@ scorep_tracing_get_file_substrate( void )
 }
 
 
+static OTF2_Compression
+scorep_tracing_get_compression( void )
+{
+    switch ( scorep_tracing_compression )
+    {
+        case SCOREP_TRACING_COMPRESSION_ZLIB:
+            return OTF2_COMPRESSION_ZLIB;
+        case SCOREP_TRACING_COMPRESSION_ZSTD:
+            return OTF2_COMPRESSION_ZSTD;
+        default:
+            return OTF2_COMPRESSION_NONE;
+    }
+}
+
+
 static OTF2_FlushType
 scorep_on_trace_pre_flush( void*         userData,
                            OTF2_FileType fileType,
@@ -143,7 +164,7 @@ scorep_on_trace_pre_flush( void*         userData,
                         fileType == OTF2_FILETYPE_LOCAL_DEFS ? "Def" : "Evt",
                         fileType == OTF2_FILETYPE_GLOBAL_DEFS ? 0 : locationId );
 
-    if ( fileType == OTF2_FILETYPE_EVENTS && !final )
+    if ( fileType == OTF2_FILETYPE_EVENTS && !final && !async_flush )
     {
         /* A buffer flush happen in an event buffer before the end of the measurement */
 
@@ -227,6 +248,17 @@ scorep_tracing_chunk_allocate( void*         userData,
 {
     UTILS_DEBUG_ENTRY( "chunk size: %" PRIu64, chunkSize );
 
+    if ( async_flush && OTF2_FILETYPE_EVENTS == fileType )
+    {
+        if ( !*perBufferData )
+        {
+            *perBufferData = scorep_tracing_async_flush_create_buffer(
+                scorep_tracing_async_flush_buffer_size );
+        }
+
+        return scorep_tracing_async_flush_alloc( *perBufferData, chunkSize );
+    }
+
     if ( !*perBufferData )
     {
         /* This manager has a pre-allocated page, which is much smaller
@@ -263,6 +295,16 @@ scorep_tracing_chunk_free_all( void*         userData,
         return;
     }
 
+    if ( async_flush && OTF2_FILETYPE_EVENTS == fileType )
+    {
+        scorep_tracing_async_flush_free_all( *perBufferData, final );
+        if ( final )
+        {
+            *perBufferData = NULL;
+        }
+        return;
+    }
+
     /* drop all used pages */
     SCOREP_Allocator_Free( *perBufferData );
 
@@ -274,6 +316,22 @@ scorep_tracing_chunk_free_all( void*         userData,
 }
 
 
+static OTF2_CallbackCode
+scorep_tracing_chunk_hand_over( void*          userData,
+                                OTF2_FileType  fileType,
+                                uint64_t       locationId,
+                                void**         perBufferData,
+                                OTF2_ChunkSet* chunkSet )
+{
+    UTILS_DEBUG_ENTRY();
+
+    UTILS_BUG_ON( !async_flush || OTF2_FILETYPE_EVENTS != fileType || !*perBufferData,
+                  "Unexpected hand-over of trace chunks." );
+
+    return scorep_tracing_async_flush_hand_over( *perBufferData, chunkSet );
+}
+
+
 static OTF2_MemoryCallbacks scorep_tracing_chunk_callbacks =
 {
     .otf2_allocate = scorep_tracing_chunk_allocate,
@@ -289,6 +347,13 @@ scorep_tracing_register_memory_callbacks( OTF2_Archive* archive )
                                          &scorep_tracing_chunk_callbacks,
                                          NULL );
     UTILS_ASSERT( status == OTF2_SUCCESS );
+
+    if ( async_flush )
+    {
+        status = OTF2_Archive_SetMemoryHandOverCallback( archive,
+                                                         scorep_tracing_chunk_hand_over );
+        UTILS_ASSERT( status == OTF2_SUCCESS );
+    }
 }
 
 
@@ -326,6 +391,14 @@ SCOREP_Tracing_Initialize( size_t substrateId )
     }
 #endif
 
+    async_flush = scorep_tracing_async_flush;
+    if ( async_flush && OTF2_SUBSTRATE_POSIX != scorep_tracing_get_file_substrate() )
+    {
+        UTILS_WARNING( "Ignoring asynchronous trace buffer flushes via SCOREP_TRACING_ASYNC_FLUSH, "
+                       "as it is only supported with the POSIX trace substrate." );
+        async_flush = false;
+    }
+
     /* Check for valid scorep_tracing_max_procs_per_sion_file */
     if ( 0 == scorep_tracing_max_procs_per_sion_file )
     {
@@ -334,15 +407,43 @@ SCOREP_Tracing_Initialize( size_t substrateId )
             scorep_tracing_max_procs_per_sion_file );
     }
 
+    OTF2_Compression compression = scorep_tracing_get_compression();
     scorep_otf2_archive = OTF2_Archive_Open( SCOREP_GetExperimentDirName(),
                                              "traces",
                                              OTF2_FILEMODE_WRITE,
                                              SCOREP_TRACING_CHUNK_SIZE,
                                              OTF2_UNDEFINED_UINT64,
                                              scorep_tracing_get_file_substrate(),
-                                             OTF2_COMPRESSION_NONE );
+                                             compression );
+    if ( !scorep_otf2_archive && OTF2_COMPRESSION_NONE != compression )
+    {
+        UTILS_WARNING( "Writing uncompressed trace, as the compression selected "
+                       "via SCOREP_TRACING_COMPRESSION is not supported by OTF2." );
+        compression         = OTF2_COMPRESSION_NONE;
+        scorep_otf2_archive = OTF2_Archive_Open( SCOREP_GetExperimentDirName(),
+                                                 "traces",
+                                                 OTF2_FILEMODE_WRITE,
+                                                 SCOREP_TRACING_CHUNK_SIZE,
+                                                 OTF2_UNDEFINED_UINT64,
+                                                 scorep_tracing_get_file_substrate(),
+                                                 compression );
+    }
     UTILS_BUG_ON( !scorep_otf2_archive, "Couldn't create OTF2 archive." );
 
+    if ( OTF2_COMPRESSION_NONE != compression
+         && 0 != scorep_tracing_compression_level )
+    {
+        if ( scorep_tracing_compression_level > INT32_MAX )
+        {
+            UTILS_FATAL( "Invalid value for SCOREP_TRACING_COMPRESSION_LEVEL: %" PRIu64,
+                         scorep_tracing_compression_level );
+        }
+        OTF2_ErrorCode otf2_err =
+            OTF2_Archive_SetCompressionLevel( scorep_otf2_archive,
+                                              ( int32_t )scorep_tracing_compression_level );
+        UTILS_ASSERT( otf2_err == OTF2_SUCCESS );
+    }
+
     scorep_tracing_register_flush_callbacks( scorep_otf2_archive );
     scorep_tracing_register_memory_callbacks( scorep_otf2_archive );
 
@@ -458,6 +559,12 @@ SCOREP_Tracing_FinalizeEventWriters( void )
 {
     UTILS_ASSERT( scorep_otf2_archive );
 
+    if ( async_flush )
+    {
+        /* All pending writes need to be finished before the final flush. */
+        scorep_tracing_async_flush_finalize();
+    }
+
     SCOREP_Location_ForAll( scorep_trace_finalize_event_writer_cb,
                             NULL );
 
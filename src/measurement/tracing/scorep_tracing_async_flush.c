@@ -0,0 +1,254 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+
+/**
+ * @file
+ *
+ *
+ */
+
+
+#include <config.h>
+
+#include "scorep_tracing_async_flush.h"
+
+#include <SCOREP_Memory.h>
+#include <SCOREP_InMeasurement.h>
+
+#define SCOREP_DEBUG_MODULE_NAME TRACING
+#include <UTILS_Debug.h>
+#include <UTILS_Error.h>
+
+#include <pthread.h>
+#include <inttypes.h>
+
+
+struct scorep_tracing_flush_buffer
+{
+    SCOREP_Allocator_PageManager* page_managers[ 2 ];
+    /** Index of the half the location records into. */
+    uint32_t                      active;
+    /** Bytes allocated from the active half. */
+    uint64_t                      allocated;
+    uint64_t                      half_size;
+
+    /* Protected by writer_mutex. */
+    /** The other half is handed over and not yet written. */
+    bool                          in_flight;
+    OTF2_ChunkSet*                chunk_set;
+    scorep_tracing_flush_buffer*  next;
+};
+
+
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signals new entries in the queue or the shutdown. */
+static pthread_cond_t writer_work_cond = PTHREAD_COND_INITIALIZER;
+/** Signals a written chunk set. */
+static pthread_cond_t writer_done_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_t                    writer_thread;
+static bool                         writer_running;
+static bool                         writer_finalized;
+static scorep_tracing_flush_buffer* queue_head;
+static scorep_tracing_flush_buffer* queue_tail;
+
+
+scorep_tracing_flush_buffer*
+scorep_tracing_async_flush_create_buffer( uint64_t halfSize )
+{
+    scorep_tracing_flush_buffer* buffer =
+        SCOREP_Memory_AllocForMisc( sizeof( *buffer ) );
+    UTILS_BUG_ON( !buffer, "Cannot allocate double buffer for tracing." );
+
+    buffer->page_managers[ 0 ] = SCOREP_Memory_CreateTracingPageManager( true );
+    buffer->page_managers[ 1 ] = SCOREP_Memory_CreateTracingPageManager( true );
+    buffer->active             = 0;
+    buffer->allocated          = 0;
+    buffer->half_size          = halfSize;
+    buffer->in_flight          = false;
+    buffer->chunk_set          = NULL;
+    buffer->next               = NULL;
+
+    return buffer;
+}
+
+
+void*
+scorep_tracing_async_flush_alloc( scorep_tracing_flush_buffer* buffer,
+                                  uint64_t                     size )
+{
+    /* Always provide at least one chunk per half. */
+    if ( buffer->allocated > 0 && buffer->allocated + size > buffer->half_size )
+    {
+        return NULL;
+    }
+
+    void* chunk = SCOREP_Allocator_Alloc( buffer->page_managers[ buffer->active ], size );
+    if ( chunk )
+    {
+        buffer->allocated += size;
+    }
+    return chunk;
+}
+
+
+void
+scorep_tracing_async_flush_free_all( scorep_tracing_flush_buffer* buffer,
+                                     bool                         final )
+{
+    SCOREP_Allocator_Free( buffer->page_managers[ buffer->active ] );
+    buffer->allocated = 0;
+
+    if ( final )
+    {
+        pthread_mutex_lock( &writer_mutex );
+        UTILS_BUG_ON( buffer->in_flight,
+                      "Final flush of a trace buffer with pending writes." );
+        pthread_mutex_unlock( &writer_mutex );
+
+        SCOREP_Memory_DeleteTracingPageManager( buffer->page_managers[ 0 ], true );
+        SCOREP_Memory_DeleteTracingPageManager( buffer->page_managers[ 1 ], true );
+        buffer->page_managers[ 0 ] = NULL;
+        buffer->page_managers[ 1 ] = NULL;
+    }
+}
+
+
+static void*
+writer_main( void* arg )
+{
+    /* Everything this thread does is part of the measurement, keep the
+     * pthread and I/O wrappers from recording it. */
+    SCOREP_IN_MEASUREMENT_INCREMENT();
+
+    pthread_mutex_lock( &writer_mutex );
+    while ( true )
+    {
+        while ( !queue_head && !writer_finalized )
+        {
+            pthread_cond_wait( &writer_work_cond, &writer_mutex );
+        }
+        if ( !queue_head )
+        {
+            /* finalized and nothing left to write */
+            break;
+        }
+
+        scorep_tracing_flush_buffer* buffer = queue_head;
+        queue_head = buffer->next;
+        if ( !queue_head )
+        {
+            queue_tail = NULL;
+        }
+        buffer->next = NULL;
+
+        OTF2_ChunkSet*                chunk_set    = buffer->chunk_set;
+        SCOREP_Allocator_PageManager* page_manager =
+            buffer->page_managers[ buffer->active ^ 1 ];
+        buffer->chunk_set = NULL;
+        pthread_mutex_unlock( &writer_mutex );
+
+        OTF2_ErrorCode err = OTF2_ChunkSet_Write( chunk_set );
+        if ( OTF2_SUCCESS != err )
+        {
+            UTILS_FATAL( "Could not write trace buffer: %s",
+                         OTF2_Error_GetDescription( err ) );
+        }
+        SCOREP_Allocator_Free( page_manager );
+
+        pthread_mutex_lock( &writer_mutex );
+        buffer->in_flight = false;
+        pthread_cond_broadcast( &writer_done_cond );
+    }
+    pthread_mutex_unlock( &writer_mutex );
+
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+
+    return NULL;
+}
+
+
+OTF2_CallbackCode
+scorep_tracing_async_flush_hand_over( scorep_tracing_flush_buffer* buffer,
+                                      OTF2_ChunkSet*               chunkSet )
+{
+    pthread_mutex_lock( &writer_mutex );
+
+    if ( writer_finalized )
+    {
+        pthread_mutex_unlock( &writer_mutex );
+        return OTF2_CALLBACK_ERROR;
+    }
+
+    if ( !writer_running )
+    {
+        int ret = pthread_create( &writer_thread, NULL, writer_main, NULL );
+        if ( ret != 0 )
+        {
+            /* Do not try again, all further flushes are synchronous. */
+            writer_finalized = true;
+            pthread_mutex_unlock( &writer_mutex );
+            UTILS_WARNING( "Cannot create trace writer thread, "
+                           "falling back to synchronous buffer flushes." );
+            return OTF2_CALLBACK_ERROR;
+        }
+        writer_running = true;
+    }
+
+    /* Backpressure: the other half needs to be written, before we can
+     * record into it again. */
+    while ( buffer->in_flight )
+    {
+        UTILS_DEBUG_PRINTF( SCOREP_DEBUG_TRACING,
+                            "Waiting for previous trace buffer write" );
+        pthread_cond_wait( &writer_done_cond, &writer_mutex );
+    }
+
+    buffer->chunk_set = chunkSet;
+    buffer->in_flight = true;
+    buffer->active   ^= 1;
+    buffer->allocated = 0;
+
+    buffer->next = NULL;
+    if ( queue_tail )
+    {
+        queue_tail->next = buffer;
+    }
+    else
+    {
+        queue_head = buffer;
+    }
+    queue_tail = buffer;
+
+    pthread_cond_signal( &writer_work_cond );
+    pthread_mutex_unlock( &writer_mutex );
+
+    return OTF2_CALLBACK_SUCCESS;
+}
+
+
+void
+scorep_tracing_async_flush_finalize( void )
+{
+    pthread_mutex_lock( &writer_mutex );
+    writer_finalized = true;
+    bool join = writer_running;
+    writer_running = false;
+    pthread_cond_signal( &writer_work_cond );
+    pthread_mutex_unlock( &writer_mutex );
+
+    if ( join )
+    {
+        pthread_join( writer_thread, NULL );
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+#ifndef SCOREP_TRACING_ASYNC_FLUSH_H
+#define SCOREP_TRACING_ASYNC_FLUSH_H
+
+
+/**
+ * @file
+ *
+ * Double-buffered event chunks, which are written by a background thread.
+ *
+ * Each event buffer owns two page managers. The location records into the
+ * active one, while the chunks of the other one are written by the writer
+ * thread of the process. The location has to wait only if it fills its
+ * active half while the other half is still being written.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <otf2/otf2.h>
+
+
+typedef struct scorep_tracing_flush_buffer scorep_tracing_flush_buffer;
+
+
+/**
+ * Creates the double buffer for one event writer.
+ *
+ * @param halfSize Maximum number of bytes allocated per half.
+ */
+scorep_tracing_flush_buffer*
+scorep_tracing_async_flush_create_buffer( uint64_t halfSize );
+
+
+/**
+ * Allocates @a size bytes from the active half.
+ *
+ * @return NULL if the active half is exhausted, which makes OTF2 flush.
+ */
+void*
+scorep_tracing_async_flush_alloc( scorep_tracing_flush_buffer* buffer,
+                                  uint64_t                     size );
+
+
+/**
+ * Releases the memory of the active half, when OTF2 wrote the chunks itself.
+ * In the @a final case, both halves are deleted.
+ */
+void
+scorep_tracing_async_flush_free_all( scorep_tracing_flush_buffer* buffer,
+                                     bool                         final );
+
+
+/**
+ * Passes the filled chunks of the active half to the writer thread and
+ * switches to the other half. Waits if the other half is still in flight.
+ *
+ * @return OTF2_CALLBACK_SUCCESS if the chunks were taken over.
+ */
+OTF2_CallbackCode
+scorep_tracing_async_flush_hand_over( scorep_tracing_flush_buffer* buffer,
+                                      OTF2_ChunkSet*               chunkSet );
+
+
+/**
+ * Waits until all handed over chunks are written and terminates the writer
+ * thread. Later flushes will be done synchronously.
+ */
+void
+scorep_tracing_async_flush_finalize( void );
+
+
+#endif /* SCOREP_TRACING_ASYNC_FLUSH_H */
@@ -44,12 +44,47 @@
 
 bool     scorep_tracing_use_sion;
 uint64_t scorep_tracing_max_procs_per_sion_file;
+bool     scorep_tracing_async_flush;
+uint64_t scorep_tracing_async_flush_buffer_size;
+uint64_t scorep_tracing_compression;
+uint64_t scorep_tracing_compression_level;
 /* Need to initialize variable, as it is not guaranteed that it will be set by
  * the config system, if unwinding is not supported.
  */
 bool scorep_tracing_convert_calling_context = false;
 
 
+/**
+ * Values of SCOREP_TRACING_COMPRESSION, mapped to the OTF2 compression
+ * when opening the archive.
+ */
+enum
+{
+    SCOREP_TRACING_COMPRESSION_NONE,
+    SCOREP_TRACING_COMPRESSION_ZLIB,
+    SCOREP_TRACING_COMPRESSION_ZSTD
+};
+
+static const SCOREP_ConfigType_SetEntry scorep_tracing_compression_table[] = {
+    {
+        "none",
+        SCOREP_TRACING_COMPRESSION_NONE,
+        "Trace files are not compressed."
+    },
+    {
+        "zlib",
+        SCOREP_TRACING_COMPRESSION_ZLIB,
+        "Compress trace files with zlib."
+    },
+    {
+        "zstd",
+        SCOREP_TRACING_COMPRESSION_ZSTD,
+        "Compress trace files with zstd."
+    },
+    { NULL, 0, NULL }
+};
+
+
 /** @brief Measurement system configure variables */
 static const SCOREP_ConfigVariable scorep_tracing_confvars[] = {
     {
@@ -72,6 +107,56 @@ static const SCOREP_ConfigVariable scorep_tracing_confvars[] = {
         "files to fulfill this constraint. E.g., having 4 processes and setting "
         "the maximum to 3 would result in 2 files each holding 2 processes."
     },
+    {
+        "async_flush",
+        SCOREP_CONFIG_TYPE_BOOL,
+        &scorep_tracing_async_flush,
+        NULL,
+        "false",
+        "Write full trace buffers in a background thread",
+        "Instead of writing a full trace buffer in the recording thread, the "
+        "buffer is handed over to a background writer thread of the process, "
+        "and recording continues into a second buffer. The recording thread "
+        "waits only if the second buffer is full too, before the first one "
+        "was written. The time for the hand-over, including this wait, is "
+        "recorded as a buffer flush.\n"
+        "Each location uses up to twice SCOREP_TRACING_ASYNC_FLUSH_BUFFER_SIZE "
+        "bytes of SCOREP_TOTAL_MEMORY for its event buffers.\n"
+        "Not available with the SIONlib substrate."
+    },
+    {
+        "async_flush_buffer_size",
+        SCOREP_CONFIG_TYPE_SIZE,
+        &scorep_tracing_async_flush_buffer_size,
+        NULL,
+        "4M",
+        "Size of each of the two event buffers per location for SCOREP_TRACING_ASYNC_FLUSH",
+        "A buffer holds at least one trace chunk of 1 MiB."
+    },
+    {
+        "compression",
+        SCOREP_CONFIG_TYPE_OPTIONSET,
+        &scorep_tracing_compression,
+        ( void* )scorep_tracing_compression_table,
+        "none",
+        "Compression of the trace files",
+        "Each trace chunk is compressed individually when written, thus readers "
+        "can still seek in the event files. The codec needs to be supported by "
+        "the OTF2 library, otherwise the trace is written uncompressed.\n"
+        "Possible values:"
+    },
+    {
+        "compression_level",
+        SCOREP_CONFIG_TYPE_SIZE,
+        &scorep_tracing_compression_level,
+        NULL,
+        "0",
+        "Compression level for SCOREP_TRACING_COMPRESSION",
+        "Higher levels trade write time for smaller files. zlib accepts 1 to "
+        "9, zstd 1 to 19 and above. 0 selects the default level of the codec. "
+        "Only non-negative levels are accepted, thus the fast modes of zstd, "
+        "which use negative levels, cannot be selected."
+    },
     SCOREP_CONFIG_TERMINATOR
 };
 
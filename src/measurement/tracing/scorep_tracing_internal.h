@@ -51,6 +51,10 @@
 
 extern bool     scorep_tracing_use_sion;
 extern uint64_t scorep_tracing_max_procs_per_sion_file;
+extern bool     scorep_tracing_async_flush;
+extern uint64_t scorep_tracing_async_flush_buffer_size;
+extern uint64_t scorep_tracing_compression;
+extern uint64_t scorep_tracing_compression_level;
 extern bool     scorep_tracing_convert_calling_context;
 
 extern SCOREP_AttributeHandle scorep_tracing_pid_attribute;
@@ -4,6 +4,9 @@
  * Copyright (c) 2021-2022,
  * Forschungszentrum Juelich GmbH, Germany
  *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
  * This software may be modified and distributed under the terms of
  * a BSD-style license.  See the COPYING file in the package base
  * directory for details.
@@ -16,7 +19,8 @@
  * loadtime- (lt_) and runtime-loaded (rt_) shared objects and
  * corresponding libbfd images. Shared objects are obtained via
  * dl_iterate_phdr; the loadtime ones at measurement initialization
- * and the runtime ones via rtdl-audit callbacks.
+ * and the runtime ones via rtdl-audit callbacks. The libbfd images of
+ * loadtime objects are opened on the first lookup into the object.
  */
 
 #include <config.h>
@@ -66,12 +70,56 @@
 #endif /* ! bfd_get_section_flags */
 
 
+/* Allocated section of a libbfd image, an object's sections are sorted
+   by vma to find the section of an address by binary search. */
+typedef struct so_section so_section;
+struct so_section
+{
+    bfd_vma       vma;
+    bfd_size_type size;
+    asection*     section;
+};
+
+
+/* Function symbol of a libbfd image, an object's function symbols are
+   sorted by vma to find the function of an address by binary search. */
+typedef struct so_function so_function;
+struct so_function
+{
+    bfd_vma     vma;
+    const char* name;
+};
+
+
+/* Source code location of a libbfd image, valid from vma up to the vma of
+   the next entry. An object's entries are sorted by vma, one per row of its
+   DWARF line table whose location differs from the previous row. The
+   location is libbfd's answer for vma, the strings are owned by the abfd.
+   Entries not covered mark the end of a line sequence. */
+typedef struct so_line so_line;
+struct so_line
+{
+    bfd_vma      vma;
+    const char*  file_name;
+    const char*  function_name;
+    unsigned int line_no;
+    bool         covered;
+    bool         found;
+};
+
+
+typedef struct lt_object lt_object;
+
+
 /* *INDENT-OFF* */
 static int count_shared_objs( struct dl_phdr_info* info, size_t unused, void* cnt );
 static bool is_obj_relevant( const char* name );
-static bool iterate_segments( struct dl_phdr_info* info, const char** name, uintptr_t* baseAddr, bfd** abfd, asymbol*** symbols, uintptr_t* beginAddrMin, uintptr_t* endAddrMax, bool adjustName );
+static bool iterate_segments( struct dl_phdr_info* info, const char** name, uintptr_t* baseAddr, uintptr_t* beginAddrMin, uintptr_t* endAddrMax, bool adjustName );
 static int fill_lt_arrays_cb( struct dl_phdr_info* info, size_t unused, void* cnt );
+static bool load_bfd( lt_object* obj );
 static void init_abfd( const char* name, bfd** abfd, asymbol*** symbols, long* nSyms );
+static void index_functions( lt_object* obj );
+static void index_lines( lt_object* obj );
 /* *INDENT-ON* */
 
 
@@ -80,18 +128,28 @@ static void init_abfd( const char* name, bfd** abfd, asymbol*** symbols, long* n
    addresses where the second ones contains the remaining
    metadata. The capacity of the array might be larger than the actual
    element count.
-   We bfd-lookup (addr - base_addr) if addr in [begin_addr, end_addr]. */
+   We bfd-lookup (addr - base_addr) if addr in [begin_addr, end_addr].
+   The bfd members and the indexes of sections, functions, and lines are
+   built on the first lookup into the object under the bfd_mutex, and
+   published by bfd_loaded. They are not modified afterwards, thus lookups
+   answered by the indexes don't need the bfd_mutex. */
 static size_t lt_objs_capacity;    /* upper bound of loadtime objects */
 static size_t     lt_object_count; /* number of loadtime objects used */
 static uintptr_t* lt_begin_addrs;
 #define SO_OBJECT_COMMON \
     uintptr_t end_addr; \
-    uintptr_t   base_addr; \
-    bfd*        abfd; \
-    asymbol**   symbols; \
-    const char* name; \
-    uint16_t    token
-typedef struct lt_object lt_object;
+    uintptr_t    base_addr; \
+    bfd*         abfd; \
+    asymbol**    symbols; \
+    so_section*  sections; \
+    size_t       n_sections; \
+    so_function* functions; \
+    size_t       n_functions; \
+    so_line*     lines; \
+    size_t       n_lines; \
+    const char*  name; \
+    bool         bfd_loaded; \
+    uint16_t     token
 struct lt_object
 {
     SO_OBJECT_COMMON;
@@ -100,6 +158,12 @@ static lt_object* lt_objects;
 
 static bool addr2line_initialized;
 
+/* libbfd is not thread-safe, not even for different bfds, as it shares
+   caches and error state globally. Serialize all libbfd calls after
+   initialization, including the loading of the bfds. Lookups answered by
+   the indexes don't call into libbfd. */
+static UTILS_Mutex bfd_mutex = UTILS_MUTEX_INIT;
+
 void
 SCOREP_Addr2line_Initialize( void )
 {
@@ -123,7 +187,7 @@ SCOREP_Addr2line_Initialize( void )
     /* some versions of libbfd have bfd_init to return void, others return unsigned. */
     bfd_init();
 
-    /* fill arrays but ignore shared objects that don't report any symbols */
+    /* fill arrays, libbfd images are opened on first lookup */
     dl_iterate_phdr( fill_lt_arrays_cb, ( void* )&lt_object_count );
     UTILS_BUG_ON( lt_object_count > lt_objs_capacity,
                   "Actual count must not exceed capacity." );
@@ -190,19 +254,15 @@ fill_lt_arrays_cb( struct dl_phdr_info* info, size_t unused, void* cnt )
        [begin_addr_min, end_addr_max] */
     const char* name           = NULL;
     uintptr_t   base_addr      = 0;
-    bfd*        abfd           = NULL;
-    asymbol**   symbols        = NULL;
     uintptr_t   begin_addr_min = UINTPTR_MAX;
     uintptr_t   end_addr_max   = 0;
-    bool        has_symbols    = iterate_segments( info,
+    bool        has_segments   = iterate_segments( info,
                                                    &name,
                                                    &base_addr,
-                                                   &abfd,
-                                                   &symbols,
                                                    &begin_addr_min,
                                                    &end_addr_max,
                                                    true /* adjustName */ );
-    if ( !has_symbols )
+    if ( !has_segments )
     {
         return 0;
     }
@@ -224,11 +284,10 @@ fill_lt_arrays_cb( struct dl_phdr_info* info, size_t unused, void* cnt )
         }
     }
 
+    memset( &lt_objects[ insert ], 0, sizeof( lt_object ) );
     lt_begin_addrs[ insert ]       = begin_addr_min;
     lt_objects[ insert ].end_addr  = end_addr_max;
     lt_objects[ insert ].base_addr = base_addr;
-    lt_objects[ insert ].abfd      = abfd;
-    lt_objects[ insert ].symbols   = symbols;
     lt_objects[ insert ].name      = name;
     lt_objects[ insert ].token     = SCOREP_ADDR2LINE_LT_OBJECT_TOKEN;
 
@@ -242,14 +301,13 @@ static bool
 iterate_segments( struct dl_phdr_info* info,
                   const char**         name,
                   uintptr_t*           baseAddr,
-                  bfd**                abfd,
-                  asymbol***           symbols,
                   uintptr_t*           beginAddrMin,
                   uintptr_t*           endAddrMax,
                   bool                 adjustName )
 {
     *name     = info->dlpi_name;
     *baseAddr = ( uintptr_t )info->dlpi_addr;
+    bool has_segments = false;
     /* iterate over segments to find all loadable program segments (PT_LOAD)
        ones that are readable (PF_R) */
     for ( int i = 0; i < info->dlpi_phnum; i++ )
@@ -257,33 +315,26 @@ iterate_segments( struct dl_phdr_info* info,
         if ( info->dlpi_phdr[ i ].p_type == PT_LOAD
              && info->dlpi_phdr[ i ].p_flags & PF_R )
         {
-            if ( !*abfd )
+            if ( !has_segments )
             {
-                /* A pathname is needed to open a bfd. */
+                /* A pathname is needed to open a bfd later on. */
                 UTILS_BUG_ON( !*name, "Valid name form dl_phdr_info expected." );
 
-                bool is_executable = false;
-                if ( adjustName && *name[ 0 ] == '\0' )
-                {
-                    /* As dl_iterate_phdr returns "" for the executable itself,
-                       we need to acquire the executable name. */
-                    bool unused;
-                    *name         = SCOREP_GetExecutableName( &unused );
-                    is_executable = true;
-                }
-
-                long n_syms = 0; /* bfd_canonicalize_symtab returns long */
-                init_abfd( *name, abfd, symbols, &n_syms );
-                /* objects that don't report symbols are ignored */
-                if ( n_syms < 1 )
+                if ( adjustName )
                 {
-                    return false;
-                }
-
-                if ( adjustName && !is_executable )
-                {
-                    *name = UTILS_CStr_dup( info->dlpi_name );
+                    if ( *name[ 0 ] == '\0' )
+                    {
+                        /* As dl_iterate_phdr returns "" for the executable itself,
+                           we need to acquire the executable name. */
+                        bool unused;
+                        *name = SCOREP_GetExecutableName( &unused );
+                    }
+                    else
+                    {
+                        *name = UTILS_CStr_dup( info->dlpi_name );
+                    }
                 }
+                has_segments = true;
             }
             uintptr_t begin_addr = *baseAddr + ( uintptr_t )info->dlpi_phdr[ i ].p_vaddr;
             if ( begin_addr < *beginAddrMin )
@@ -297,7 +348,7 @@ iterate_segments( struct dl_phdr_info* info,
             }
         }
     }
-    if ( !*abfd )
+    if ( !has_segments )
     {
         UTILS_WARNING( "No readable PT_LOAD segment found for '%s'. "
                        "Is this supposed to happen?",
@@ -316,6 +367,91 @@ iterate_segments( struct dl_phdr_info* info,
 }
 
 
+static void
+count_sections_cb( bfd* abfd, asection* section, void* nSections )
+{
+    ++*( size_t* )nSections;
+}
+
+
+typedef struct collect_sections_t collect_sections_t;
+struct collect_sections_t
+{
+    so_section* sections;
+    size_t      n_sections;
+};
+
+
+static void
+collect_sections_cb( bfd* abfd, asection* section, void* payload )
+{
+    collect_sections_t* data = payload;
+    /* Thread-local sections overlap with the following ones and don't
+       contain code. */
+    if ( !( bfd_get_section_flags( abfd, section ) & SEC_ALLOC )
+         || ( bfd_get_section_flags( abfd, section ) & SEC_THREAD_LOCAL )
+         || bfd_get_section_size( section ) == 0 )
+    {
+        return;
+    }
+    so_section* entry = &data->sections[ data->n_sections++ ];
+    entry->vma     = bfd_get_section_vma( abfd, section );
+    entry->size    = bfd_get_section_size( section );
+    entry->section = section;
+}
+
+
+static int
+compare_sections( const void* a, const void* b )
+{
+    const so_section* section_a = a;
+    const so_section* section_b = b;
+    if ( section_a->vma < section_b->vma )
+    {
+        return -1;
+    }
+    return section_a->vma > section_b->vma;
+}
+
+
+/* Needs the bfd_mutex. Opens the abfd of obj->name and builds the indexes
+   of obj, all lookups into obj are answered by them or by the abfd. */
+static bool
+load_bfd( lt_object* obj )
+{
+    long n_syms = 0; /* bfd_canonicalize_symtab returns long */
+    init_abfd( obj->name, &obj->abfd, &obj->symbols, &n_syms );
+    /* objects that don't report symbols are ignored */
+    if ( n_syms < 1 )
+    {
+        obj->abfd    = NULL;
+        obj->symbols = NULL;
+        return false;
+    }
+
+    /* Build the index of allocated sections once, instead of iterating
+       over all sections per lookup. */
+    size_t n_sections = 0;
+    bfd_map_over_sections( obj->abfd, count_sections_cb, &n_sections );
+    collect_sections_t data = {
+        .sections   = malloc( ( n_sections ? n_sections : 1 ) * sizeof( so_section ) ),
+        .n_sections = 0
+    };
+    UTILS_BUG_ON( !data.sections, "Could not allocate section index for abfd of %s", obj->name );
+    bfd_map_over_sections( obj->abfd, collect_sections_cb, &data );
+    qsort( data.sections, data.n_sections, sizeof( so_section ), compare_sections );
+
+    obj->sections   = data.sections;
+    obj->n_sections = data.n_sections;
+    UTILS_DEBUG( "Indexed %zu of %zu sections for abfd of %s",
+                 data.n_sections, n_sections, obj->name );
+
+    index_functions( obj );
+    index_lines( obj );
+    return true;
+}
+
+
 static void
 init_abfd( const char* name, bfd** abfd, asymbol*** symbols, long* nSyms )
 {
@@ -375,7 +511,6 @@ struct lookup_bfd_t
 {
     uintptr_t begin_addr;
     uintptr_t end_addr;
-    asymbol** symbols;
 
     /* OUT members */
     bool*         scl_found_begin_addr;
@@ -389,7 +524,7 @@ struct lookup_bfd_t
 
 /* *INDENT-OFF* */
 static lt_object* lookup_so( uintptr_t addr );
-static void section_iterator( bfd* abfd, asection* section, void* payload );
+static void lookup_bfd( lt_object* obj, lookup_bfd_t* data );
 /* *INDENT-ON* */
 
 
@@ -447,7 +582,6 @@ SCOREP_Addr2line_SoLookupAddr( uintptr_t    offset,
     lookup_bfd_t data = {
         .begin_addr           = offset,
         .end_addr             = 0,
-        .symbols              = so_handle->symbols,
         .scl_found_begin_addr = sclFound,
         .scl_found_end_addr   = &scl_found_unused,
         .scl_file_name        = sclFileName,
@@ -458,7 +592,7 @@ SCOREP_Addr2line_SoLookupAddr( uintptr_t    offset,
     *( data.scl_found_begin_addr ) = false;
     *( data.scl_found_end_addr )   = false;
 
-    bfd_map_over_sections( so_handle->abfd, section_iterator, &data );
+    lookup_bfd( so_handle, &data );
 }
 
 
@@ -495,7 +629,6 @@ SCOREP_Addr2line_SoLookupAddrRange( uintptr_t    beginOffset,
     lookup_bfd_t data = {
         .begin_addr           = beginOffset,
         .end_addr             = endOffset,
-        .symbols              = so_handle->symbols,
         .scl_found_begin_addr = sclFoundBegin,
         .scl_found_end_addr   = sclFoundEnd,
         .scl_file_name        = sclFileName,
@@ -506,7 +639,7 @@ SCOREP_Addr2line_SoLookupAddrRange( uintptr_t    beginOffset,
     *( data.scl_found_begin_addr ) = false;
     *( data.scl_found_end_addr )   = false;
 
-    bfd_map_over_sections( so_handle->abfd, section_iterator, &data );
+    lookup_bfd( so_handle, &data );
 }
 
 
@@ -544,7 +677,6 @@ SCOREP_Addr2line_LookupAddr( uintptr_t    programCounterAddr,
         lookup_bfd_t data = {
             .begin_addr           = programCounterAddr - handle->base_addr,
             .end_addr             = 0,
-            .symbols              = handle->symbols,
             .scl_found_begin_addr = sclFound,
             .scl_found_end_addr   = &found_end_addr_unused,
             .scl_file_name        = sclFileName,
@@ -555,7 +687,7 @@ SCOREP_Addr2line_LookupAddr( uintptr_t    programCounterAddr,
         *( data.scl_found_begin_addr ) = false;
         *( data.scl_found_end_addr )   = false;
 
-        bfd_map_over_sections( handle->abfd, section_iterator, &data );
+        lookup_bfd( handle, &data );
     }
     else
     {
@@ -622,7 +754,6 @@ SCOREP_Addr2line_LookupAddrRange( uintptr_t    beginProgramCounterAddr,
         lookup_bfd_t data = {
             .begin_addr           = beginProgramCounterAddr - handle->base_addr,
             .end_addr             = endProgramCounterAddr - handle->base_addr,
-            .symbols              = handle->symbols,
             .scl_found_begin_addr = sclFoundBegin,
             .scl_found_end_addr   = sclFoundEnd,
             .scl_file_name        = sclFileName,
@@ -633,7 +764,7 @@ SCOREP_Addr2line_LookupAddrRange( uintptr_t    beginProgramCounterAddr,
         *( data.scl_found_begin_addr ) = false;
         *( data.scl_found_end_addr )   = false;
 
-        bfd_map_over_sections( handle->abfd, section_iterator, &data );
+        lookup_bfd( handle, &data );
     }
     else
     {
@@ -717,21 +848,30 @@ lookup_so( uintptr_t addr )
 {
     /* addr to be in [begin_addr, end_addr] of shared object representation */
 
-    /* search linearly in loadtime objects */
+    /* binary search in loadtime objects for the last one beginning at
+       or before addr */
     if ( lt_object_count > 0
          && addr >= lt_begin_addrs[ 0 ]
          && addr <= lt_objects[ lt_object_count - 1 ].end_addr )
     {
-        size_t i = 0;
-        while ( i < lt_object_count - 1
-                && lt_begin_addrs[ i + 1 ] < addr )
+        size_t low  = 0;
+        size_t high = lt_object_count;
+        while ( high - low > 1 )
         {
-            ++i;
+            size_t mid = low + ( high - low ) / 2;
+            if ( lt_begin_addrs[ mid ] <= addr )
+            {
+                low = mid;
+            }
+            else
+            {
+                high = mid;
+            }
         }
-        if ( lt_objects[ i ].end_addr > addr )
+        if ( lt_objects[ low ].end_addr > addr )
         {
             /* found addr in loadtime objects */
-            return &lt_objects[ i ];
+            return &lt_objects[ low ];
         }
     }
 
@@ -765,39 +905,55 @@ lookup_so( uintptr_t addr )
 }
 
 
-static void
-section_iterator( bfd* abfd, asection* section, void* payload )
+/* binary search for the allocated section containing offset */
+static const so_section*
+find_section( const lt_object* obj, uintptr_t offset )
 {
-    lookup_bfd_t* data = payload;
-    if ( *( data->scl_found_begin_addr ) )
+    size_t low  = 0;
+    size_t high = obj->n_sections;
+    while ( low < high )
     {
-        return;
+        size_t mid = low + ( high - low ) / 2;
+        if ( obj->sections[ mid ].vma <= offset )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
     }
-    if ( !( bfd_get_section_flags( abfd, section ) & SEC_ALLOC ) )
+    if ( low == 0 )
     {
-        return;
+        return NULL;
     }
+    const so_section* section = &obj->sections[ low - 1 ];
     /* consider address if in [vma, vma+size] */
-    bfd_vma vma = bfd_get_section_vma( abfd, section );
-    if ( data->begin_addr < vma
-         || ( data->end_addr != 0 && data->end_addr < vma ) )
-    {
-        return;
-    }
-    bfd_size_type size = bfd_get_section_size( section );
-    if ( data->begin_addr >= vma + size
-         || ( data->end_addr != 0
-              && data->end_addr >= vma + size ) )
+    if ( offset >= section->vma + section->size )
     {
-        return;
+        return NULL;
     }
-    *( data->scl_found_begin_addr ) = bfd_find_nearest_line( abfd,
-                                                             section,
-                                                             data->symbols,
-                                                             data->begin_addr - vma,
-                                                             data->scl_file_name,
-                                                             data->scl_function_name,
-                                                             data->scl_begin_lno );
+    return section;
+}
+
+
+/* Needs the bfd_mutex. libbfd's source code location of offset in
+   section, after walking the inline chain. */
+static bool
+find_nearest_line( lt_object*        obj,
+                   const so_section* section,
+                   uintptr_t         offset,
+                   const char**      fileName,
+                   const char**      functionName,
+                   unsigned int*     lineNo )
+{
+    bool found = bfd_find_nearest_line( obj->abfd,
+                                        section->section,
+                                        obj->symbols,
+                                        offset - section->vma,
+                                        fileName,
+                                        functionName,
+                                        lineNo );
     /* Calling bfd_find_inliner_info seems, after superficial testing,
        to not alter the result for function addressees provided by
        __cyg_profile_func_enter/exit. For callsite addressees, e.g.,
@@ -805,32 +961,564 @@ section_iterator( bfd* abfd, asection* section, void* payload )
        __cyg_profile_func_enter/exit's callsite parameter, walking the
        inline chain brings source code location information back from
        unexpected locations to user code. */
-    while ( bfd_find_inliner_info( abfd,
-                                   data->scl_file_name,
-                                   data->scl_function_name,
-                                   data->scl_begin_lno ) )
+    while ( bfd_find_inliner_info( obj->abfd,
+                                   fileName,
+                                   functionName,
+                                   lineNo ) )
+    {
+    }
+    return found;
+}
+
+
+/* Start of a row or the end of a sequence in a DWARF line table */
+typedef struct line_row line_row;
+struct line_row
+{
+    bfd_vma vma;
+    bool    end_sequence;
+};
+
+
+typedef struct collect_rows_t collect_rows_t;
+struct collect_rows_t
+{
+    line_row* rows;
+    size_t    n_rows;
+    size_t    capacity;
+};
+
+
+static void
+add_row( collect_rows_t* data, bfd_vma vma, bool endSequence )
+{
+    if ( data->n_rows == data->capacity )
+    {
+        data->capacity = data->capacity ? 2 * data->capacity : 1024;
+        data->rows     = realloc( data->rows, data->capacity * sizeof( line_row ) );
+        UTILS_BUG_ON( !data->rows, "Could not allocate %zu line table rows", data->capacity );
+    }
+    data->rows[ data->n_rows ].vma          = vma;
+    data->rows[ data->n_rows ].end_sequence = endSequence;
+    data->n_rows++;
+}
+
+
+/* Reads an unsigned integer of size bytes in the byte order of the image */
+static uint64_t
+read_uint( const bfd_byte* pos, size_t size, bool bigEndian )
+{
+    uint64_t value = 0;
+    for ( size_t i = 0; i < size; i++ )
+    {
+        value |= ( uint64_t )pos[ bigEndian ? size - 1 - i : i ] << ( 8 * i );
+    }
+    return value;
+}
+
+
+/* Reads an (S|U)LEB128, signed ones are only skipped */
+static uint64_t
+read_leb128( const bfd_byte** pos, const bfd_byte* end )
+{
+    uint64_t value = 0;
+    unsigned shift = 0;
+    while ( *pos < end )
+    {
+        bfd_byte byte = *( *pos )++;
+        if ( shift < 64 )
+        {
+            value |= ( uint64_t )( byte & 0x7f ) << shift;
+        }
+        shift += 7;
+        if ( !( byte & 0x80 ) )
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+
+/* Collects the addresses of all rows of the line number programs in a
+   .debug_line section of DWARF version 2 to 5. Only the addresses are of
+   interest, the source code locations of the rows are taken from libbfd.
+   Returns false if the section is malformed. */
+static bool
+collect_line_rows( const bfd_byte* contents,
+                   size_t          size,
+                   bool            bigEndian,
+                   collect_rows_t* data )
+{
+    const bfd_byte* pos         = contents;
+    const bfd_byte* section_end = contents + size;
+    while ( section_end - pos >= 4 )
+    {
+        /* unit header */
+        size_t   offset_size = 4;
+        uint64_t unit_length = read_uint( pos, 4, bigEndian );
+        pos += 4;
+        if ( unit_length == 0xffffffff )
+        {
+            if ( section_end - pos < 8 )
+            {
+                return false;
+            }
+            offset_size = 8;
+            unit_length = read_uint( pos, 8, bigEndian );
+            pos        += 8;
+        }
+        if ( unit_length > ( uint64_t )( section_end - pos ) || unit_length < 2 )
+        {
+            return false;
+        }
+        const bfd_byte* unit_end = pos + unit_length;
+
+        uint16_t version = read_uint( pos, 2, bigEndian );
+        pos += 2;
+        if ( version < 2 || version > 5 )
+        {
+            return false;
+        }
+        if ( version >= 5 )
+        {
+            /* address_size and segment_selector_size */
+            pos += 2;
+        }
+        if ( unit_end - pos < ( ptrdiff_t )offset_size + 4 )
+        {
+            return false;
+        }
+        uint64_t header_length = read_uint( pos, offset_size, bigEndian );
+        pos += offset_size;
+        if ( header_length > ( uint64_t )( unit_end - pos ) )
+        {
+            return false;
+        }
+        const bfd_byte* program = pos + header_length;
+
+        uint8_t min_inst_length = *pos++;
+        uint8_t max_ops         = 1;
+        if ( version >= 4 )
+        {
+            max_ops = *pos++;
+        }
+        pos++; /* default_is_stmt */
+        pos++; /* line_base */
+        uint8_t line_range  = *pos++;
+        uint8_t opcode_base = *pos++;
+        if ( line_range == 0 || max_ops == 0 || opcode_base == 0
+             || program - pos < opcode_base - 1 )
+        {
+            return false;
+        }
+        const bfd_byte* standard_opcode_lengths = pos;
+
+        /* line number program, the state machine only tracks the address */
+        pos = program;
+        bfd_vma  address  = 0;
+        uint64_t op_index = 0;
+#define ADVANCE( operation_advance ) \
+    do { \
+        uint64_t advance = op_index + ( operation_advance ); \
+        address += min_inst_length * ( advance / max_ops ); \
+        op_index = advance % max_ops; \
+    } while ( 0 )
+        while ( pos < unit_end )
+        {
+            uint8_t opcode = *pos++;
+            if ( opcode >= opcode_base )
+            {
+                /* special opcode */
+                ADVANCE( ( opcode - opcode_base ) / line_range );
+                add_row( data, address, false );
+                continue;
+            }
+            switch ( opcode )
+            {
+                case 0: /* extended opcode */
+                {
+                    uint64_t length = read_leb128( &pos, unit_end );
+                    if ( length == 0 || length > ( uint64_t )( unit_end - pos ) )
+                    {
+                        return false;
+                    }
+                    const bfd_byte* next = pos + length;
+                    switch ( *pos++ )
+                    {
+                        case 1: /* DW_LNE_end_sequence */
+                            add_row( data, address, true );
+                            address  = 0;
+                            op_index = 0;
+                            break;
+                        case 2: /* DW_LNE_set_address */
+                            if ( length - 1 > sizeof( uint64_t ) )
+                            {
+                                return false;
+                            }
+                            address  = read_uint( pos, length - 1, bigEndian );
+                            op_index = 0;
+                            break;
+                    }
+                    pos = next;
+                    break;
+                }
+                case 1: /* DW_LNS_copy */
+                    add_row( data, address, false );
+                    break;
+                case 2: /* DW_LNS_advance_pc */
+                    ADVANCE( read_leb128( &pos, unit_end ) );
+                    break;
+                case 8: /* DW_LNS_const_add_pc */
+                    ADVANCE( ( 255 - opcode_base ) / line_range );
+                    break;
+                case 9: /* DW_LNS_fixed_advance_pc, takes an uhalf */
+                    if ( unit_end - pos < 2 )
+                    {
+                        return false;
+                    }
+                    address += read_uint( pos, 2, bigEndian );
+                    op_index = 0;
+                    pos     += 2;
+                    break;
+                default:
+                    /* skip the LEB128 operands of all other standard opcodes */
+                    for ( uint8_t i = 0; i < standard_opcode_lengths[ opcode - 1 ]; i++ )
+                    {
+                        read_leb128( &pos, unit_end );
+                    }
+                    break;
+            }
+        }
+#undef ADVANCE
+        pos = unit_end;
+    }
+    return true;
+}
+
+
+static int
+compare_rows( const void* a, const void* b )
+{
+    const line_row* row_a = a;
+    const line_row* row_b = b;
+    if ( row_a->vma != row_b->vma )
+    {
+        return row_a->vma < row_b->vma ? -1 : 1;
+    }
+    /* a sequence starting where another ends wins */
+    return ( int )row_a->end_sequence - ( int )row_b->end_sequence;
+}
+
+
+/* Needs the bfd_mutex and a loaded abfd. Builds the line index from the
+   rows of the object's own .debug_line section. Without one, e.g. if the
+   debug information is in a separate file, all source code location
+   lookups into obj are done by libbfd. */
+static void
+index_lines( lt_object* obj )
+{
+    asection* debug_line = bfd_get_section_by_name( obj->abfd, ".debug_line" );
+    if ( !debug_line )
+    {
+        UTILS_DEBUG( "No .debug_line in abfd of %s", obj->name );
+        return;
+    }
+    bfd_byte* contents = NULL;
+    if ( !bfd_malloc_and_get_section( obj->abfd, debug_line, &contents ) )
+    {
+        UTILS_DEBUG( "Could not read .debug_line of abfd of %s", obj->name );
+        free( contents );
+        return;
+    }
+
+    collect_rows_t rows = { .rows = NULL, .n_rows = 0, .capacity = 0 };
+    bool           ok   = collect_line_rows( contents,
+                                             bfd_get_section_size( debug_line ),
+                                             bfd_big_endian( obj->abfd ),
+                                             &rows );
+    free( contents );
+    if ( !ok || rows.n_rows == 0 )
+    {
+        UTILS_DEBUG( "No usable line table in abfd of %s", obj->name );
+        free( rows.rows );
+        return;
+    }
+    qsort( rows.rows, rows.n_rows, sizeof( line_row ), compare_rows );
+
+    /* Ask libbfd once per row start, consecutive rows with the same
+       answer are merged. */
+    obj->lines = malloc( rows.n_rows * sizeof( so_line ) );
+    UTILS_BUG_ON( !obj->lines, "Could not allocate line index for abfd of %s", obj->name );
+    for ( size_t i = 0; i < rows.n_rows; i++ )
+    {
+        if ( i > 0 && rows.rows[ i ].vma == rows.rows[ i - 1 ].vma )
+        {
+            continue;
+        }
+
+        so_line entry;
+        memset( &entry, 0, sizeof( entry ) );
+        entry.vma = rows.rows[ i ].vma;
+        if ( !rows.rows[ i ].end_sequence )
+        {
+            const so_section* section = find_section( obj, entry.vma );
+            if ( !section )
+            {
+                /* e.g., the rows of discarded functions */
+                continue;
+            }
+            entry.covered = true;
+            entry.found   = find_nearest_line( obj, section, entry.vma,
+                                               &entry.file_name,
+                                               &entry.function_name,
+                                               &entry.line_no );
+        }
+
+        if ( obj->n_lines > 0 )
+        {
+            const so_line* last = &obj->lines[ obj->n_lines - 1 ];
+            if ( last->covered == entry.covered
+                 && last->found == entry.found
+                 && last->file_name == entry.file_name
+                 && last->function_name == entry.function_name
+                 && last->line_no == entry.line_no )
+            {
+                continue;
+            }
+        }
+        obj->lines[ obj->n_lines++ ] = entry;
+    }
+    free( rows.rows );
+    UTILS_DEBUG( "Indexed %zu source code locations for abfd of %s",
+                 obj->n_lines, obj->name );
+}
+
+
+/* Answers the source code location of offset in section from the line
+   index of obj. Returns false if offset is not covered by the index. */
+static bool
+lookup_line( const lt_object*  obj,
+             const so_section* section,
+             uintptr_t         offset,
+             bool*             found,
+             const char**      fileName,
+             const char**      functionName,
+             unsigned int*     lineNo )
+{
+    /* binary search for the last entry starting at or before offset */
+    size_t low  = 0;
+    size_t high = obj->n_lines;
+    while ( low < high )
+    {
+        size_t mid = low + ( high - low ) / 2;
+        if ( obj->lines[ mid ].vma <= offset )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    if ( low == 0 )
+    {
+        return false;
+    }
+    const so_line* line = &obj->lines[ low - 1 ];
+    /* entries of other sections do not cover offset */
+    if ( !line->covered || line->vma < section->vma )
+    {
+        return false;
+    }
+
+    *found        = line->found;
+    *fileName     = line->file_name;
+    *functionName = line->function_name;
+    *lineNo       = line->line_no;
+    return true;
+}
+
+
+/* Opens the abfd and builds the indexes on the first lookup into obj */
+static bool
+ensure_bfd_loaded( lt_object* obj )
+{
+    /* acquire: pairs with the release below, the indexes are complete */
+    if ( !UTILS_Atomic_LoadN_bool( &obj->bfd_loaded, UTILS_ATOMIC_ACQUIRE ) )
+    {
+        UTILS_MutexLock( &bfd_mutex );
+        if ( !obj->bfd_loaded )
+        {
+            UTILS_DEBUG( "Load abfd of %s on first lookup", obj->name );
+            load_bfd( obj );
+            UTILS_Atomic_StoreN_bool( &obj->bfd_loaded, true, UTILS_ATOMIC_RELEASE );
+        }
+        UTILS_MutexUnlock( &bfd_mutex );
+    }
+    return obj->abfd != NULL;
+}
+
+
+static void
+lookup_bfd( lt_object* obj, lookup_bfd_t* data )
+{
+    if ( !ensure_bfd_loaded( obj ) )
+    {
+        return;
+    }
+
+    const so_section* section = find_section( obj, data->begin_addr );
+    if ( !section
+         || ( data->end_addr != 0
+              && ( data->end_addr < section->vma
+                   || data->end_addr >= section->vma + section->size ) ) )
     {
+        return;
     }
 
+    /* Lookups covered by the line index don't need libbfd */
+    const char*  filename_unused;
+    const char*  funcname_unused;
+    unsigned int end_lno;
+    bool         found_end;
+    if ( lookup_line( obj, section, data->begin_addr,
+                      data->scl_found_begin_addr,
+                      data->scl_file_name,
+                      data->scl_function_name,
+                      data->scl_begin_lno ) )
+    {
+        if ( !*( data->scl_found_begin_addr ) || data->end_addr == 0 )
+        {
+            return;
+        }
+        if ( lookup_line( obj, section, data->end_addr,
+                          &found_end,
+                          &filename_unused,
+                          &funcname_unused,
+                          &end_lno ) )
+        {
+            *( data->scl_found_end_addr ) = found_end;
+            *( data->scl_end_lno )        = end_lno;
+            return;
+        }
+    }
+
+    /* libbfd is not thread-safe, serialize all lookups, see bfd_mutex */
+    UTILS_MutexLock( &bfd_mutex );
+    *( data->scl_found_begin_addr ) = find_nearest_line( obj,
+                                                         section,
+                                                         data->begin_addr,
+                                                         data->scl_file_name,
+                                                         data->scl_function_name,
+                                                         data->scl_begin_lno );
     if ( *( data->scl_found_begin_addr ) && data->end_addr != 0 )
     {
-        const char* filename_unused;
-        const char* funcname_unused;
-        *( data->scl_found_end_addr ) = bfd_find_nearest_line( abfd,
-                                                               section,
-                                                               data->symbols,
-                                                               data->end_addr - vma,
-                                                               &filename_unused,
-                                                               &funcname_unused,
-                                                               data->scl_end_lno );
-        while ( bfd_find_inliner_info( abfd,
-                                       &filename_unused,
-                                       &funcname_unused,
-                                       data->scl_end_lno ) )
+        *( data->scl_found_end_addr ) = find_nearest_line( obj,
+                                                           section,
+                                                           data->end_addr,
+                                                           &filename_unused,
+                                                           &funcname_unused,
+                                                           data->scl_end_lno );
+    }
+    UTILS_MutexUnlock( &bfd_mutex );
+}
+
+
+static int
+compare_functions( const void* a, const void* b )
+{
+    const so_function* function_a = a;
+    const so_function* function_b = b;
+    if ( function_a->vma < function_b->vma )
+    {
+        return -1;
+    }
+    return function_a->vma > function_b->vma;
+}
+
+
+/* Needs the bfd_mutex and a loaded abfd */
+static void
+index_functions( lt_object* obj )
+{
+    size_t n_functions = 0;
+    for ( asymbol** symbol = obj->symbols; *symbol; symbol++ )
+    {
+        if ( ( *symbol )->flags & BSF_FUNCTION )
         {
+            n_functions++;
         }
     }
-    return;
+    if ( n_functions == 0 )
+    {
+        return;
+    }
+
+    obj->functions = malloc( n_functions * sizeof( so_function ) );
+    UTILS_BUG_ON( !obj->functions, "Could not allocate function index for abfd of %s", obj->name );
+    for ( asymbol** symbol = obj->symbols; *symbol; symbol++ )
+    {
+        if ( ( *symbol )->flags & BSF_FUNCTION )
+        {
+            so_function* entry = &obj->functions[ obj->n_functions++ ];
+            entry->vma  = bfd_asymbol_value( *symbol );
+            entry->name = bfd_asymbol_name( *symbol );
+        }
+    }
+    qsort( obj->functions, obj->n_functions, sizeof( so_function ), compare_functions );
+    UTILS_DEBUG( "Indexed %zu functions for abfd of %s", obj->n_functions, obj->name );
+}
+
+
+/* binary search for the last function starting at or before offset */
+static const so_function*
+find_function( const lt_object* obj, uintptr_t offset )
+{
+    size_t low  = 0;
+    size_t high = obj->n_functions;
+    while ( low < high )
+    {
+        size_t mid = low + ( high - low ) / 2;
+        if ( obj->functions[ mid ].vma <= offset )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    if ( low == 0 )
+    {
+        return NULL;
+    }
+    return &obj->functions[ low - 1 ];
+}
+
+
+bool
+SCOREP_Addr2line_SoLookupFunctionName( uintptr_t    offset,
+                                       void*        soHandle,
+                                       const char** functionName )
+{
+    UTILS_BUG_ON( soHandle == NULL, "Need valid soHandle but NULL provided" );
+    UTILS_BUG_ON( functionName == NULL, "Need valid OUT handle but NULL provided." );
+    lt_object* obj = ( lt_object* )soHandle;
+
+    if ( !ensure_bfd_loaded( obj ) )
+    {
+        return false;
+    }
+    /* The function needs to start in the section of offset */
+    const so_section*  section  = find_section( obj, offset );
+    const so_function* function = find_function( obj, offset );
+    if ( section && function && function->vma >= section->vma )
+    {
+        *functionName = function->name;
+        return true;
+    }
+    return false;
 }
 
 
@@ -856,8 +1544,14 @@ SCOREP_Addr2line_Finalize( void )
     const char* exe_name = SCOREP_GetExecutableName( &unused );
     for ( size_t i = 0; i < lt_object_count; i++ )
     {
-        free( lt_objects[ i ].symbols );
-        bfd_close( lt_objects[ i ].abfd );
+        if ( lt_objects[ i ].abfd )
+        {
+            free( lt_objects[ i ].symbols );
+            free( lt_objects[ i ].sections );
+            free( lt_objects[ i ].functions );
+            free( lt_objects[ i ].lines );
+            bfd_close( lt_objects[ i ].abfd );
+        }
         if ( strcmp( lt_objects[ i ].name, exe_name ) != 0 )
         {
             free( ( char* )lt_objects[ i ].name );
@@ -871,6 +1565,9 @@ SCOREP_Addr2line_Finalize( void )
     while ( scorep_rt_objects_head )
     {
         free( scorep_rt_objects_head->symbols );
+        free( scorep_rt_objects_head->sections );
+        free( scorep_rt_objects_head->functions );
+        free( scorep_rt_objects_head->lines );
         bfd_close( scorep_rt_objects_head->abfd );
         free( ( char* )scorep_rt_objects_head->name );
         scorep_rt_objects_head = scorep_rt_objects_head->next;
@@ -880,6 +1577,9 @@ SCOREP_Addr2line_Finalize( void )
     while ( scorep_rt_objects_dlclosed_head )
     {
         free( scorep_rt_objects_dlclosed_head->symbols );
+        free( scorep_rt_objects_dlclosed_head->sections );
+        free( scorep_rt_objects_dlclosed_head->functions );
+        free( scorep_rt_objects_dlclosed_head->lines );
         bfd_close( scorep_rt_objects_dlclosed_head->abfd );
         free( ( char* )scorep_rt_objects_dlclosed_head->name );
         scorep_rt_objects_dlclosed_head = scorep_rt_objects_dlclosed_head->next;
@@ -1002,31 +1702,46 @@ insert_rt_object_cb( struct dl_phdr_info* info, size_t unused, void* data )
 
     const char* name           = NULL;
     uintptr_t   base_addr      = 0;
-    bfd*        abfd           = NULL;
-    asymbol**   symbols        = NULL;
     uintptr_t   begin_addr_min = UINTPTR_MAX;
     uintptr_t   end_addr_max   = 0;
-    bool        has_symbols    = iterate_segments( info,
-                                                   &name,
-                                                   &base_addr,
-                                                   &abfd,
-                                                   &symbols,
-                                                   &begin_addr_min,
-                                                   &end_addr_max,
-                                                   false /* adjustName */ );
+    if ( !iterate_segments( info,
+                            &name,
+                            &base_addr,
+                            &begin_addr_min,
+                            &end_addr_max,
+                            false /* adjustName */ ) )
+    {
+        return 1;
+    }
+
+    /* runtime objects are opened and indexed right away, as objects that
+       don't report any symbols are not tracked */
+    lt_object loaded;
+    memset( &loaded, 0, sizeof( loaded ) );
+    loaded.name = name;
+    UTILS_MutexLock( &bfd_mutex );
+    bool has_symbols = load_bfd( &loaded );
+    UTILS_MutexUnlock( &bfd_mutex );
     if ( !has_symbols )
     {
         return 1;
     }
 
-    /* create shared object representation */
+    /* create shared object representation, published by the rwlock below */
     rt_object* new = SCOREP_Memory_AllocForMisc( sizeof( rt_object ) );
     memset( new, 0, sizeof( rt_object ) );
 
     new->end_addr     = end_addr_max;
     new->base_addr    = base_addr;
-    new->abfd         = abfd;
-    new->symbols      = symbols;
+    new->abfd         = loaded.abfd;
+    new->symbols      = loaded.symbols;
+    new->sections     = loaded.sections;
+    new->n_sections   = loaded.n_sections;
+    new->functions    = loaded.functions;
+    new->n_functions  = loaded.n_functions;
+    new->lines        = loaded.lines;
+    new->n_lines      = loaded.n_lines;
+    new->bfd_loaded   = true;
     new->name         = UTILS_CStr_dup( name );
     new->token        = ++scorep_rt_objopen_calls_tracked;
     new->begin_addr   = begin_addr_min;
@@ -4,6 +4,9 @@
  * Copyright (c) 2021-2022,
  * Forschungszentrum Juelich GmbH, Germany
  *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
  * This software may be modified and distributed under the terms of
  * a BSD-style license. See the COPYING file in the package base
  * directory for details.
@@ -29,7 +32,8 @@
  * collects the shared objects loaded at this time for addr2line
  * lookup. As measurement initialization is usually triggered by a
  * ctor, this would be the load-time objects only. Multiple calls do
- * no harm.
+ * no harm. The symbols and debug information of a load-time object
+ * are read on the first source code location lookup into it.
  *
  * @note Shared objects introduced via dlopen are handled via
  * rtdl-audit, if available and active. See scorep_libaudit.c.
@@ -94,6 +98,8 @@ SCOREP_Addr2line_ConvertRetAddr2PrgCntAddr( uintptr_t returnAddr )
  * changed. All loadtime shared object return the same token
  * (SCOREP_ADDR2LINE_LT_OBJECT_TOKEN) as they won't be dlclosed during
  * normal program execution.
+ * Load-time objects are found even if they don't provide symbols,
+ * source code location lookups into them will fail though.
  *
  * @note SCOREP_Addr2line_LookupSo() is async-signal-safe.
  */
@@ -115,6 +121,9 @@ SCOREP_Addr2line_LookupSo( uintptr_t    programCounterAddr,
  * populated even if @a sclFound returns false.
  *
  * See SCOREP_Addr2line_LookupSo() for @a soToken.
+ *
+ * @note Source code location lookups are thread-safe. They are serialized,
+ * as libbfd is not thread-safe.
  */
 void
 SCOREP_Addr2line_SoLookupAddr( uintptr_t    offset,
@@ -129,6 +138,24 @@ SCOREP_Addr2line_SoLookupAddr( uintptr_t    offset,
                                unsigned*    sclLineNo );
 
 
+/**
+ * Looks up the (mangled) name of the function symbol containing @a
+ * offset in @a soHandle, see SCOREP_Addr2line_SoLookupAddr(). Only the
+ * symbol table is searched, not the debug information. Thus, this is
+ * much cheaper than a source code location lookup, but inlined functions
+ * are not found.
+ *
+ * @return False if no function symbol was found, @a functionName is
+ * untouched then.
+ *
+ * @note Thread-safe, serialized with the source code location lookups.
+ */
+bool
+SCOREP_Addr2line_SoLookupFunctionName( uintptr_t    offset,
+                                       void*        soHandle,
+                                       const char** functionName );
+
+
 /**
  * Similar to SCOREP_Addr2line_SoLookupAddr(), but try to match @a
  * beginOffset and @a endOffset with @a sclBeginLineNo and @a
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -102,6 +102,41 @@ SCOREP_Unwinding_GetCallingContext( SCOREP_Location*             location,
                                     SCOREP_CallingContextHandle* previousCallingContext,
                                     uint32_t*                    unwindDistance );
 
+/**
+ * Record a sample without creating its calling context yet. If deferred
+ * unwinding is enabled, only the instruction addresses of the current stack
+ * are stored in a per-location buffer. The calling contexts and the sample
+ * events are created by @a SCOREP_Unwinding_ProcessDeferredSamples before the
+ * next event on this location, by the next sample handled immediately, or
+ * when the location is deactivated. If the buffer is full, the recorded
+ * samples are processed and this sample needs to be handled immediately.
+ * @param location                    Score-P location
+ * @param contextPtr                  Signal context of the sample, may be NULL
+ * @param timestamp                   Time when the sample was taken
+ * @param interruptGeneratorHandle    Handle of the interrupt generator
+ * @param metricValues                The strictly synchronous metric values
+ *
+ * @return True if the sample was recorded, false if the caller needs to
+ *         handle it immediately via @a SCOREP_Unwinding_GetCallingContext.
+ */
+bool
+SCOREP_Unwinding_DeferSample( SCOREP_Location*                location,
+                              void*                           contextPtr,
+                              uint64_t                        timestamp,
+                              SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
+                              const uint64_t*                 metricValues );
+
+/**
+ * Create the calling contexts of all samples recorded by
+ * @a SCOREP_Unwinding_DeferSample and trigger their sample events.
+ * Needs to be called before any other event is triggered on @a location.
+ * Does nothing if there are no such samples or if @a location is not the
+ * current CPU location.
+ * @param location                    Score-P location
+ */
+void
+SCOREP_Unwinding_ProcessDeferredSamples( SCOREP_Location* location );
+
 void
 SCOREP_Unwinding_ProcessCallingContext( SCOREP_Location*                location,
                                         uint64_t                        timestamp,
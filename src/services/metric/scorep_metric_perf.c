@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2019,
+ * Copyright (c) 2015, 2019, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -43,6 +43,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/syscall.h>
 
 #include "SCOREP_Metric_Source.h"
@@ -50,6 +51,11 @@
 /** @def SCOREP_METRIC_MAXNUM Maximum number of PERF metrics concurrently used by a process */
 #define SCOREP_METRIC_MAXNUM 20
 
+/** @def HAVE_PERF_RDPMC Counters can be read in user space with rdpmc */
+#if defined( __x86_64__ ) || defined( __i386__ )
+#define HAVE_PERF_RDPMC 1
+#endif
+
 /**
  * @def STRICTLY_SYNCHRONOUS_METRIC Index of strictly synchronous metrics in the metric definition array
  * @def PER_PROCESS_METRIC          Index of per-process metrics in the metric definition array
@@ -117,13 +123,17 @@ typedef struct scorep_metric_definition_data
 typedef struct scorep_event_map
 {
     /** Identifier of event set */
-    int      event_fd;
+    int                                   event_fd;
     /** Return values for the eventsets (additional one for PERF which introduces an offset) */
-    uint64_t values[ SCOREP_METRIC_MAXNUM + 1 ];
+    uint64_t                              values[ SCOREP_METRIC_MAXNUM + 1 ];
     /** Number of recorded events in this set */
-    int      num_events;
+    int                                   num_events;
     /** Component identifier */
-    int      component;
+    int                                   component;
+    /** File descriptors of the recorded events, the first one is @a event_fd */
+    int                                   event_fds[ SCOREP_METRIC_MAXNUM ];
+    /** Mapped user page of each recorded event, NULL if not mapped */
+    volatile struct perf_event_mmap_page* pages[ SCOREP_METRIC_MAXNUM ];
 } scorep_event_map;
 
 /**
@@ -533,6 +543,114 @@ metric_perf_close( void )
     }
 }
 
+/** @brief Maps the user page of a PERF event. It allows to read the counter
+ *         of the event in user space, without a system call.
+ *
+ *  @param fd   File descriptor of the event.
+ *
+ *  @return The mapped page, or NULL if the counter is always read with read().
+ */
+static volatile struct perf_event_mmap_page*
+metric_perf_map_user_page( int fd )
+{
+#if HAVE( PERF_RDPMC )
+    void* page = mmap( NULL, sysconf( _SC_PAGESIZE ), PROT_READ, MAP_SHARED, fd, 0 );
+    if ( page == MAP_FAILED )
+    {
+        UTILS_DEBUG_PRINTF( SCOREP_DEBUG_METRIC,
+                            "[PERF] Cannot map user page of event: %s",
+                            strerror( errno ) );
+        return NULL;
+    }
+    return page;
+#else
+    return NULL;
+#endif
+}
+
+#if HAVE( PERF_RDPMC )
+
+/** @brief Reads the hardware counter @a counter with rdpmc. */
+static inline uint64_t
+metric_perf_rdpmc( uint32_t counter )
+{
+    uint32_t low;
+    uint32_t high;
+    __asm__ __volatile__ ( "rdpmc" : "=a" ( low ), "=d" ( high ) : "c" ( counter ) );
+    return ( ( uint64_t )high << 32 ) | low;
+}
+
+/** @brief Reads the counter of a PERF event in user space, following the
+ *         protocol documented in linux/perf_event.h.
+ *
+ *  @param page         Mapped user page of the event.
+ *  @param value[out]   The counter value.
+ *
+ *  @return False if the event is currently not readable in user space, e.g.,
+ *          software events or events that are not scheduled on a counter.
+ */
+static inline bool
+metric_perf_read_user_counter( volatile struct perf_event_mmap_page* page,
+                               uint64_t*                             value )
+{
+    uint32_t seq;
+    uint64_t count;
+    do
+    {
+        seq = page->lock;
+        __asm__ __volatile__ ( "" ::: "memory" );
+
+        uint32_t index = page->index;
+        uint16_t width = page->pmc_width;
+        /* A width of 0 or more than 64 bits cannot be sign extended */
+        if ( !page->cap_user_rdpmc || index == 0 || width == 0 || width > 64 )
+        {
+            return false;
+        }
+        /* Sign extend the pmc_width bits wide hardware counter */
+        int64_t pmc = ( int64_t )( metric_perf_rdpmc( index - 1 ) << ( 64 - width ) ) >> ( 64 - width );
+        count = page->offset + pmc;
+
+        __asm__ __volatile__ ( "" ::: "memory" );
+    }
+    while ( page->lock != seq );
+
+    *value = count;
+    return true;
+}
+
+#endif /* HAVE( PERF_RDPMC ) */
+
+/** @brief Reads the values of all events of an event map. The counters are
+ *         read in user space if possible, otherwise the group is read with
+ *         read(). Must be called by the thread that created the event map.
+ *
+ *  @param eventMap     The event map, its values are updated.
+ */
+static inline void
+metric_perf_read_event_map( scorep_event_map* eventMap )
+{
+#if HAVE( PERF_RDPMC )
+    int i = 0;
+    while ( i < eventMap->num_events
+            && eventMap->pages[ i ] != NULL
+            && metric_perf_read_user_counter( eventMap->pages[ i ], &eventMap->values[ i + 1 ] ) )
+    {
+        i++;
+    }
+    if ( i == eventMap->num_events )
+    {
+        return;
+    }
+#endif
+
+    int retval = read( eventMap->event_fd, eventMap->values, ( eventMap->num_events + 1 ) * sizeof( uint64_t ) );
+    if ( retval != ( eventMap->num_events + 1 ) * sizeof( uint64_t ) )
+    {
+        metric_perf_error( retval, "PERF read" );
+    }
+}
+
 /** @brief  Creates per-thread counter sets.
  *
  *  @param definitions          Metric definition data.
@@ -598,7 +716,9 @@ metric_perf_create_event_set( scorep_metric_definition_data* definitions )
                 event_set->event_map[ j ]->component = component;
                 event_map                            = event_set->event_map[ j ];
                 /* we have to think of the offset (1) that is needed for reading a group of PERF events */
-                event_set->values[ i ] = &( event_map->values[ event_map->num_events + 1 ] );
+                event_set->values[ i ]                        = &( event_map->values[ event_map->num_events + 1 ] );
+                event_map->event_fds[ event_map->num_events ] = event_map->event_fd;
+                event_map->pages[ event_map->num_events ]     = metric_perf_map_user_page( event_map->event_fd );
                 event_map->num_events++;
             }
         }
@@ -613,7 +733,9 @@ metric_perf_create_event_set( scorep_metric_definition_data* definitions )
             {
                 event_map = event_set->event_map[ j ];
                 /* we have to think of the offset (1) that is needed for reading a group of PERF events */
-                event_set->values[ i ] = &( event_map->values[ event_map->num_events + 1 ] );
+                event_set->values[ i ]                        = &( event_map->values[ event_map->num_events + 1 ] );
+                event_map->event_fds[ event_map->num_events ] = fd;
+                event_map->pages[ event_map->num_events ]     = metric_perf_map_user_page( fd );
                 event_map->num_events++;
             }
         }
@@ -957,16 +1079,10 @@ strictly_synchronous_read( SCOREP_Metric_EventSet* eventSet,
     UTILS_ASSERT( eventSet );
     UTILS_ASSERT( values );
 
-    int retval;
-
     /* For each used eventset */
     for ( uint32_t i = 0; i < SCOREP_METRIC_MAXNUM && eventSet->event_map[ i ] != NULL; i++ )
     {
-        retval = read( eventSet->event_map[ i ]->event_fd, eventSet->event_map[ i ]->values, ( eventSet->event_map[ i ]->num_events + 1 ) * sizeof( uint64_t ) );
-        if ( retval != ( eventSet->event_map[ i ]->num_events + 1 ) * sizeof( uint64_t ) )
-        {
-            metric_perf_error( retval, "PERF read" );
-        }
+        metric_perf_read_event_map( eventSet->event_map[ i ] );
     }
 
     for ( uint32_t i = 0; i < eventSet->definitions->number_of_metrics; i++ )
@@ -997,16 +1113,10 @@ synchronous_read( SCOREP_Metric_EventSet* eventSet,
     UTILS_ASSERT( values );
     UTILS_ASSERT( isUpdated );
 
-    int retval;
-
     /* For each used eventset */
     for ( uint32_t i = 0; i < SCOREP_METRIC_MAXNUM && eventSet->event_map[ i ] != NULL; i++ )
     {
-        retval = read( eventSet->event_map[ i ]->event_fd, eventSet->event_map[ i ]->values, ( eventSet->event_map[ i ]->num_events + 1 ) * sizeof( uint64_t ) );
-        if ( retval != ( eventSet->event_map[ i ]->num_events + 1 ) * sizeof( uint64_t ) )
-        {
-            metric_perf_error( retval, "PERF read" );
-        }
+        metric_perf_read_event_map( eventSet->event_map[ i ] );
     }
 
     for ( uint32_t i = 0; i < eventSet->definitions->number_of_metrics; i++ )
@@ -1039,6 +1149,18 @@ free_event_set( SCOREP_Metric_EventSet* eventSet )
         {
             metric_perf_warning( retval, "PERF ioctl( fd, PERF_EVENT_IOC_DISABLE)" );
         }
+        for ( int k = 0; k < eventSet->event_map[ i ]->num_events; k++ )
+        {
+            if ( eventSet->event_map[ i ]->pages[ k ] != NULL )
+            {
+                munmap( ( void* )eventSet->event_map[ i ]->pages[ k ], sysconf( _SC_PAGESIZE ) );
+            }
+            /* The group leader is closed last */
+            if ( k > 0 )
+            {
+                close( eventSet->event_map[ i ]->event_fds[ k ] );
+            }
+        }
         retval = close( eventSet->event_map[ i ]->event_fd );
         if ( retval )
         {
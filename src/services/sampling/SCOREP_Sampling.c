@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015,
+ * Copyright (c) 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2022,
@@ -40,6 +40,10 @@ extern const scorep_sampling_interrupt_generator scorep_sampling_interrupt_gener
 /** Signal handler for PERF interrupts */
 extern const scorep_sampling_interrupt_generator scorep_sampling_interrupt_generator_perf;
 #endif
+#if HAVE( SAMPLING_THREAD_TIMER )
+/** Signal handler for per-thread timer interrupts */
+extern const scorep_sampling_interrupt_generator scorep_sampling_interrupt_generator_thread_timer;
+#endif
 
 /* Insert signal handlers according to the order of
  * SCOREP_Sampling_InterruptGeneratorType. The type will be
@@ -56,7 +60,12 @@ static const scorep_sampling_interrupt_generator* scorep_sampling_interrupt_gene
     NULL,
 #endif
 #if HAVE( METRIC_PERF )
-    &scorep_sampling_interrupt_generator_perf
+    &scorep_sampling_interrupt_generator_perf,
+#else
+    NULL,
+#endif
+#if HAVE( SAMPLING_THREAD_TIMER )
+    &scorep_sampling_interrupt_generator_thread_timer
 #else
     NULL
 #endif
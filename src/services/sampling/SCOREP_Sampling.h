@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015,
+ * Copyright (c) 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2022,
@@ -24,6 +24,7 @@
 #include <signal.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
 #include <unistd.h>
 
 
@@ -40,6 +41,8 @@ typedef enum scorep_sampling_interrupt_generator_type
     SCOREP_SAMPLING_TRIGGER_PAPI,
     /** Linux perf event */
     SCOREP_SAMPLING_TRIGGER_PERF,
+    /** Per-thread CPU-time timer */
+    SCOREP_SAMPLING_TRIGGER_THREAD_TIMER,
 
     /** For internal use only. */
     SCOREP_SAMPLING_TRIGGER_MAX
@@ -59,8 +62,13 @@ typedef struct scorep_sampling_single_location_data
     void* perf_mmap_buffer;
 #endif
 
-#if !HAVE( PAPI ) && !HAVE( METRIC_PERF )
-    /** Dummy value to avoid empty structure if neither PAPI nor PERF is supported */
+#if HAVE( SAMPLING_THREAD_TIMER )
+    timer_t thread_timer;
+    bool    thread_timer_created;
+#endif
+
+#if !HAVE( PAPI ) && !HAVE( METRIC_PERF ) && !HAVE( SAMPLING_THREAD_TIMER )
+    /** Dummy value to avoid empty structure if neither PAPI, PERF, nor thread timers are supported */
     bool dummy;
 #endif
 } scorep_sampling_single_location_data;
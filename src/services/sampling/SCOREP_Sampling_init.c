@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2020,
+ * Copyright (c) 2015, 2020, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2022,
@@ -126,7 +126,8 @@ sampling_subsystem_init( void )
     }
 
     /* Parse list of metric names */
-    size_t list_len = 0;
+    size_t list_len   = 0;
+    bool   has_itimer = false;
     token = strtok( env_sampling, scorep_sampling_separator );
     while ( token )
     {
@@ -143,6 +144,15 @@ sampling_subsystem_init( void )
         if ( strstr( token, "timer" ) == token )
         {
             sampling_sources[ list_len ].period = 1000;
+#if HAVE( SAMPLING_THREAD_TIMER )
+            sampling_sources[ list_len ].type = SCOREP_SAMPLING_TRIGGER_THREAD_TIMER;
+#else
+            sampling_sources[ list_len ].type = SCOREP_SAMPLING_TRIGGER_ITIMER;
+#endif
+        }
+        else if ( strstr( token, "itimer" ) == token )
+        {
+            sampling_sources[ list_len ].period = 1000;
             sampling_sources[ list_len ].type   = SCOREP_SAMPLING_TRIGGER_ITIMER;
         }
         else
@@ -158,6 +168,18 @@ sampling_subsystem_init( void )
                 sampling_sources[ list_len ].type   = SCOREP_SAMPLING_TRIGGER_PAPI;
             }
         }
+        /* 'timer' falls back to the interval timer, there is only one per process */
+        if ( sampling_sources[ list_len ].type == SCOREP_SAMPLING_TRIGGER_ITIMER )
+        {
+            if ( has_itimer )
+            {
+                UTILS_WARNING( "Only one interval timer can be used for sampling, ignoring '%s'.",
+                               token );
+                token = strtok( NULL, scorep_sampling_separator );
+                continue;
+            }
+            has_itimer = true;
+        }
         /* separate in eventname and period */
         char* divider = strrchr( token, '@' );
         if ( divider == NULL )
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015,
+ * Copyright (c) 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -20,7 +20,9 @@
 /**
  * Set the sampling event and period: <event_name>(@<period>)
  * Possible values are:
- *  - timer (POSIX timer), period in us, default == 1000
+ *  - timer (per-thread POSIX timer if available, otherwise process-wide
+ *    interval timer), period in us, default == 1000
+ *  - itimer (process-wide interval timer), period in us, default == 1000
  *  - PAPI events e.g., (PAPI_<event>), period in number of events, default == 1000000
  *  - perf event (perf_[hw|sw|raw]_<event>), period in number of events, default == 1000000
  * As default this value is not set, thus sampling is disabled.
@@ -66,9 +68,12 @@ static const SCOREP_ConfigVariable scorep_sampling_confvars[] = {
         "\240\240\240\240\240period in number of events, default:\24010000000\n"
         "\240\240\240\240\240e.g., PAPI_TOT_CYC@2000000\n"
 #endif
-        "\240-\240timer (POSIX timer, invalid for multi-threaded)\n"
+        "\240-\240timer (POSIX timer measuring the CPU time of each thread,\n"
+        "\240\240\240\240\240if supported, otherwise same as itimer)\n"
         "\240\240\240\240\240period in us, default:\24010000\n"
         "\240\240\240\240\240e.g., timer@2000\n"
+        "\240-\240itimer (process-wide POSIX interval timer, invalid for multi-threaded)\n"
+        "\240\240\240\240\240period in us, default:\24010000\n"
         ,
     },
     {
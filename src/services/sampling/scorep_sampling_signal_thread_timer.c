@@ -0,0 +1,232 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license. See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+
+/**
+ * @file
+ *
+ * Interrupt generator based on a POSIX timer per location. The timer
+ * measures the CPU time of its thread (CLOCK_THREAD_CPUTIME_ID) and the
+ * signal is delivered to this thread (SIGEV_THREAD_ID). In contrast to
+ * the process-wide ITIMER_PROF, every thread is thus sampled with the
+ * requested period, independent of how the kernel distributes signals.
+ * It uses a real-time signal, SIGPROF is used by the itimer and perf
+ * interrupt generators, which can be combined with this one.
+ */
+
+#include <config.h>
+
+#include "SCOREP_Sampling.h"
+
+#if HAVE( SAMPLING_THREAD_TIMER )
+
+#include <SCOREP_Definitions.h>
+#include <SCOREP_InMeasurement.h>
+#include <SCOREP_Events.h>
+
+#define SCOREP_DEBUG_MODULE_NAME SAMPLING
+#include <UTILS_Debug.h>
+#include <UTILS_Error.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <sys/syscall.h>
+
+/* Not provided by older C libraries */
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/** The signal of the timers, SIGRTMIN is not a constant */
+#define THREAD_TIMER_SIGNAL ( SIGRTMIN + 3 )
+
+
+/** Definition handle of this interrupt generator */
+static SCOREP_InterruptGeneratorHandle thread_timer_interrupt_generator = SCOREP_INVALID_INTERRUPT_GENERATOR;
+
+/** Whether the process-wide signal handler was already installed */
+static volatile sig_atomic_t thread_timer_handler_installed;
+
+/* *********************************************************************
+ * Helper functions
+ **********************************************************************/
+
+/**
+ * Set up the timer
+ *
+ * @param timer         timer object
+ * @param timeInUsec    Interval in micro seconds, 0 disarms the timer
+ *
+ */
+static void
+set_timer_value( struct itimerspec* timer,
+                 uint64_t           timeInUsec )
+{
+    timer->it_interval.tv_sec  = timeInUsec / 1000000;
+    timer->it_interval.tv_nsec = ( timeInUsec % 1000000 ) * 1000;
+    timer->it_value            = timer->it_interval;
+}
+
+/**
+ * The signal handler. This is the only function triggered by a sample.
+ *
+ * @param signalNumber          Signal number
+ * @param signalInfo            Signal information
+ * @param contextPtr            Context
+ */
+static void
+thread_timer_signal_handler( int        signalNumber,
+                             siginfo_t* signalInfo,
+                             void*      contextPtr )
+{
+    bool outside = SCOREP_IN_MEASUREMENT_TEST_AND_INCREMENT();
+    SCOREP_ENTER_SIGNAL_CONTEXT();
+
+    if ( outside && scorep_sampling_is_enabled() )
+    {
+        SCOREP_Sample( thread_timer_interrupt_generator, contextPtr );
+    }
+
+    SCOREP_EXIT_SIGNAL_CONTEXT();
+    SCOREP_IN_MEASUREMENT_DECREMENT();
+}
+
+/**
+ * Arm or disarm the timer of a location.
+ *
+ * @param samplingData      Location specific sampling data
+ * @param timeInUsec        Interval in micro seconds, 0 disarms the timer
+ */
+static void
+arm_timer( scorep_sampling_single_location_data* samplingData,
+           uint64_t                              timeInUsec )
+{
+    if ( !samplingData->thread_timer_created )
+    {
+        return;
+    }
+
+    struct itimerspec timer_value;
+    set_timer_value( &timer_value, timeInUsec );
+    if ( 0 != timer_settime( samplingData->thread_timer, 0, &timer_value, NULL ) )
+    {
+        UTILS_WARNING( "Failed to %s sampling timer: %s",
+                       timeInUsec ? "arm" : "disarm", strerror( errno ) );
+    }
+}
+
+
+/* *********************************************************************
+ * Signal handler functions
+ **********************************************************************/
+
+static void
+initialize_interrupt_generator( scorep_sampling_interrupt_generator_definition definition )
+{
+    thread_timer_interrupt_generator =
+        SCOREP_Definitions_NewInterruptGenerator( definition.event,
+                                                  SCOREP_INTERRUPT_GENERATOR_MODE_TIME,
+                                                  SCOREP_METRIC_BASE_DECIMAL,
+                                                  -6 /* micro seconds */,
+                                                  definition.period );
+
+    /* The handler is shared by all locations, install it only once. */
+    struct sigaction signal_action;
+    memset( &signal_action, 0, sizeof( signal_action ) );
+    signal_action.sa_sigaction = thread_timer_signal_handler;
+    /*
+     * SA_SIGINFO:  we want the 3 argument version of the signal handler
+     * SA_RESTART:  restart interrupted system calls
+     */
+    signal_action.sa_flags = SA_SIGINFO | SA_RESTART;
+    /* A full set means no signal can arrive while the signal handler is
+       running. All signals are blocked and queued */
+    sigfillset( &signal_action.sa_mask );
+
+    if ( 0 != sigaction( THREAD_TIMER_SIGNAL, &signal_action, NULL ) )
+    {
+        UTILS_WARNING( "Failed to install signal handler for sampling." );
+        return;
+    }
+    thread_timer_handler_installed = 1;
+}
+
+static void
+create_interrupt_generator( scorep_sampling_single_location_data*          samplingData,
+                            scorep_sampling_interrupt_generator_definition definition )
+{
+    UTILS_DEBUG( "Creating thread timer (period %" PRIu64 ")", definition.period );
+
+    if ( !thread_timer_handler_installed )
+    {
+        return;
+    }
+
+    /* Called by the thread of the location, the signal is directed to it. */
+    struct sigevent event;
+    memset( &event, 0, sizeof( event ) );
+    event.sigev_notify           = SIGEV_THREAD_ID;
+    event.sigev_signo            = THREAD_TIMER_SIGNAL;
+    event.sigev_notify_thread_id = syscall( SYS_gettid );
+
+    if ( 0 != timer_create( CLOCK_THREAD_CPUTIME_ID, &event, &samplingData->thread_timer ) )
+    {
+        UTILS_WARNING( "Failed to create sampling timer: %s", strerror( errno ) );
+        return;
+    }
+    samplingData->thread_timer_created = true;
+
+    arm_timer( samplingData, definition.period );
+}
+
+static void
+enable_interrupt_generator( scorep_sampling_single_location_data* samplingData,
+                            uint64_t                              samplingInterval )
+{
+    arm_timer( samplingData, samplingInterval );
+}
+
+static void
+disable_interrupt_generator( scorep_sampling_single_location_data* samplingData )
+{
+    arm_timer( samplingData, 0 );
+}
+
+static void
+finalize_interrupt_generator( scorep_sampling_single_location_data* samplingData )
+{
+    if ( !samplingData->thread_timer_created )
+    {
+        return;
+    }
+
+    /* May be called by a different thread, timers are process resources. */
+    if ( 0 != timer_delete( samplingData->thread_timer ) )
+    {
+        UTILS_WARNING( "Failed to delete sampling timer: %s", strerror( errno ) );
+    }
+    samplingData->thread_timer_created = false;
+}
+
+
+const scorep_sampling_interrupt_generator scorep_sampling_interrupt_generator_thread_timer =
+{
+    .initialize_interrupt_generator = initialize_interrupt_generator,
+    .create_interrupt_generator     = create_interrupt_generator,
+    .enable_interrupt_generator     = enable_interrupt_generator,
+    .disable_interrupt_generator    = disable_interrupt_generator,
+    .finalize_interrupt_generator   = finalize_interrupt_generator
+};
+
+#endif /* HAVE( SAMPLING_THREAD_TIMER ) */
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -186,6 +186,52 @@ SCOREP_Unwinding_GetCallingContext( SCOREP_Location*             location,
     }
 }
 
+bool
+SCOREP_Unwinding_DeferSample( SCOREP_Location*                location,
+                              void*                           contextPtr,
+                              uint64_t                        timestamp,
+                              SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
+                              const uint64_t*                 metricValues )
+{
+    if ( scorep_unwinding_deferred_samples == 0 )
+    {
+        return false;
+    }
+
+    SCOREP_LocationType location_type = SCOREP_Location_GetType( location );
+    UTILS_BUG_ON( location_type != SCOREP_LOCATION_TYPE_CPU_THREAD, "Processing samples on non-CPU location is currently not supported" );
+    void* location_data = SCOREP_Location_GetSubsystemData( location, scorep_unwinding_subsystem_id );
+    return scorep_unwinding_cpu_defer_sample( location_data,
+                                              contextPtr,
+                                              timestamp,
+                                              interruptGeneratorHandle,
+                                              metricValues );
+}
+
+void
+SCOREP_Unwinding_ProcessDeferredSamples( SCOREP_Location* location )
+{
+    if ( scorep_unwinding_deferred_samples == 0
+         || SCOREP_Location_GetType( location ) != SCOREP_LOCATION_TYPE_CPU_THREAD )
+    {
+        return;
+    }
+
+    SCOREP_Unwinding_CpuLocationData* location_data = SCOREP_Location_GetSubsystemData( location, scorep_unwinding_subsystem_id );
+    if ( location_data == NULL || location_data->n_deferred_samples == 0 )
+    {
+        return;
+    }
+
+    /* The buffer is only accessed by the thread owning the location */
+    if ( location != SCOREP_Location_GetCurrentCPULocation() )
+    {
+        return;
+    }
+
+    scorep_unwinding_cpu_process_deferred_samples( location_data );
+}
+
 typedef struct process_calling_context_data_struct
 {
     SCOREP_Location*                location;
@@ -285,6 +331,25 @@ unwinding_subsystem_register( size_t subsystemId )
     return SCOREP_ConfigRegister( "unwinding", scorep_unwinding_confvars );
 }
 
+/** @brief Checks the configuration of the unwinding services.
+ *
+ *  @return SCOREP_SUCCESS
+ */
+static SCOREP_ErrorCode
+unwinding_subsystem_init( void )
+{
+#if !HAVE( FRAME_POINTER_UNWINDING )
+    if ( SCOREP_IsUnwindingEnabled() && scorep_unwinding_frame_pointers )
+    {
+        UTILS_WARNING( "Unwinding by frame pointers is not supported on this platform, "
+                       "using libunwind." );
+        scorep_unwinding_frame_pointers = false;
+    }
+#endif
+
+    return SCOREP_SUCCESS;
+}
+
 static SCOREP_ErrorCode
 unwinding_subsystem_pre_unify( void )
 {
@@ -321,8 +386,21 @@ unwinding_subsystem_init_location( SCOREP_Location* location,
     switch ( location_type )
     {
         case SCOREP_LOCATION_TYPE_CPU_THREAD:
-            location_data = scorep_unwinding_cpu_get_location_data( location );
+        {
+            SCOREP_Unwinding_CpuLocationData* cpu_location_data =
+                scorep_unwinding_cpu_get_location_data( location );
+            if ( scorep_unwinding_deferred_samples > 0 )
+            {
+                cpu_location_data->deferred_capacity =
+                    scorep_unwinding_deferred_samples > UINT32_MAX
+                    ? UINT32_MAX : scorep_unwinding_deferred_samples;
+                cpu_location_data->deferred_depth =
+                    scorep_unwinding_deferred_depth > UINT32_MAX
+                    ? UINT32_MAX : scorep_unwinding_deferred_depth;
+            }
+            location_data = cpu_location_data;
             break;
+        }
 
         case SCOREP_LOCATION_TYPE_GPU:
             location_data = scorep_unwinding_gpu_get_location_data( location );
@@ -344,6 +422,28 @@ unwinding_subsystem_init_location( SCOREP_Location* location,
     return SCOREP_SUCCESS;
 }
 
+static SCOREP_ErrorCode
+unwinding_subsystem_activate_cpu_location( SCOREP_Location*        location,
+                                           SCOREP_Location*        parentLocation,
+                                           uint32_t                forkSequenceCount,
+                                           SCOREP_CPULocationPhase phase )
+{
+    if ( !SCOREP_IsUnwindingEnabled() )
+    {
+        return SCOREP_SUCCESS;
+    }
+
+    if ( phase == SCOREP_CPU_LOCATION_PHASE_EVENTS )
+    {
+        /* Called by the thread now owning the location, it may have been
+           used by a different thread before */
+        void* location_data = SCOREP_Location_GetSubsystemData( location, scorep_unwinding_subsystem_id );
+        scorep_unwinding_cpu_activate( location_data, scorep_unwinding_frame_pointers );
+    }
+
+    return SCOREP_SUCCESS;
+}
+
 static void
 unwinding_subsystem_deactivate_cpu_location( SCOREP_Location*        location,
                                              SCOREP_Location*        parentLocation,
@@ -373,7 +473,9 @@ const SCOREP_Subsystem SCOREP_Subsystem_UnwindingService =
 {
     .subsystem_name                    = "UNWINDING",
     .subsystem_register                = &unwinding_subsystem_register,
+    .subsystem_init                    = &unwinding_subsystem_init,
     .subsystem_init_location           = &unwinding_subsystem_init_location,
+    .subsystem_activate_cpu_location   = &unwinding_subsystem_activate_cpu_location,
     .subsystem_deactivate_cpu_location = &unwinding_subsystem_deactivate_cpu_location,
     .subsystem_pre_unify               = &unwinding_subsystem_pre_unify
 };
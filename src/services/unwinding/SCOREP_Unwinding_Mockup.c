@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -48,6 +48,23 @@ SCOREP_Unwinding_GetCallingContext( SCOREP_Location*             location,
     UTILS_BUG( "This function should not have been called." );
 }
 
+bool
+SCOREP_Unwinding_DeferSample( SCOREP_Location*                location,
+                              void*                           contextPtr,
+                              uint64_t                        timestamp,
+                              SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
+                              const uint64_t*                 metricValues )
+{
+    UTILS_BUG( "This function should not have been called." );
+    return false;
+}
+
+void
+SCOREP_Unwinding_ProcessDeferredSamples( SCOREP_Location* location )
+{
+    UTILS_BUG( "This function should not have been called." );
+}
+
 void
 SCOREP_Unwinding_ProcessCallingContext( SCOREP_Location*                location,
                                         uint64_t                        timestamp,
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015,
+ * Copyright (c) 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -21,11 +21,68 @@
  * Sampling setup
  */
 
+/**
+ * Number of samples per location, whose calling contexts are created in a
+ * batch outside of the signal handler. 0 disables deferred unwinding.
+ */
+static uint64_t scorep_unwinding_deferred_samples;
+
+/**
+ * Maximal number of stack frames recorded per deferred sample.
+ */
+static uint64_t scorep_unwinding_deferred_depth;
+
+/**
+ * Follow the frame pointers instead of using libunwind.
+ */
+static bool scorep_unwinding_frame_pointers;
+
 /**
  * Array of configuration variables.
  * They are registered to the measurement system and are filled during
  * until the initialization function is called.
  */
 static const SCOREP_ConfigVariable scorep_unwinding_confvars[] = {
+    {
+        "deferred_samples",
+        SCOREP_CONFIG_TYPE_NUMBER,
+        &scorep_unwinding_deferred_samples,
+        NULL,
+        "0",
+        "Number of samples per thread whose calling contexts are created later",
+        "If greater than 0, the signal handler of a sample records only the\n"
+        "instruction addresses of the current stack. The calling contexts of\n"
+        "the recorded samples are created outside of the signal handler, before\n"
+        "the next event of the thread. If this many samples are pending, the\n"
+        "next sample processes them in the signal handler. This reduces the\n"
+        "time spent in the signal handler.\n"
+        "This is only in effect if SCOREP_ENABLE_UNWINDING is on."
+    },
+    {
+        "deferred_depth",
+        SCOREP_CONFIG_TYPE_NUMBER,
+        &scorep_unwinding_deferred_depth,
+        NULL,
+        "128",
+        "Maximal number of stack frames recorded per deferred sample",
+        "Samples with deeper stacks are handled immediately in the signal\n"
+        "handler. Only in effect if SCOREP_UNWINDING_DEFERRED_SAMPLES is\n"
+        "greater than 0."
+    },
+    {
+        "frame_pointers",
+        SCOREP_CONFIG_TYPE_BOOL,
+        &scorep_unwinding_frame_pointers,
+        NULL,
+        "false",
+        "Unwind the stack by following the frame pointers",
+        "Instead of using the DWARF call frame information via libunwind,\n"
+        "the stack is walked by following the chain of frame pointers. This\n"
+        "is considerably faster, but requires that the application was built\n"
+        "with frame pointers (e.g., -fno-omit-frame-pointer). If the chain is\n"
+        "found to be broken, libunwind is used for this stack. Frames of\n"
+        "functions without a frame pointer may be missing from the calling\n"
+        "context. Only available on x86-64 and AArch64."
+    },
     SCOREP_CONFIG_TERMINATOR
 };
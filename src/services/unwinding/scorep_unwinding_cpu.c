@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -22,6 +22,7 @@
 #include <SCOREP_Subsystem.h>
 #include <SCOREP_Location.h>
 #include <SCOREP_Events.h>
+#include <SCOREP_Metric_Management.h>
 
 #define SCOREP_DEBUG_MODULE_NAME UNWINDING
 #include <UTILS_Debug.h>
@@ -32,6 +33,10 @@
 #include <stdio.h>
 #include <ctype.h>
 
+#if HAVE( FRAME_POINTER_UNWINDING )
+#include <pthread.h>
+#endif
+
 #include "scorep_unwinding_region.h"
 #include "scorep_unwinding_cct.h"
 
@@ -229,6 +234,89 @@ create_region( SCOREP_Unwinding_CpuLocationData* unwindData,
     return region;
 }
 
+/**
+ * Looks-up the region by IP in the regions known to this location, and
+ * then in the regions known to any location. Does not call libunwind.
+ *
+ * @param unwindData    Unwinding data of this location
+ * @param ip            The instruction address
+ *
+ * @return The region belonging to the instruction address, or NULL.
+ */
+static scorep_unwinding_region*
+find_region( SCOREP_Unwinding_CpuLocationData* unwindData,
+             uint64_t                          ip )
+{
+    scorep_unwinding_region* region = scorep_unwinding_region_find( unwindData, ip );
+    if ( region )
+    {
+        return region;
+    }
+
+    /* Another location may already have asked libunwind for this function */
+    uint64_t    start;
+    uint64_t    end;
+    const char* name;
+    if ( !scorep_unwinding_shared_region_find( ip, &start, &end, &name ) )
+    {
+        return NULL;
+    }
+
+    return create_region( unwindData, start, end, name );
+}
+
+/**
+ * Creates the region from libunwind's information and publishes it to all
+ * locations.
+ *
+ * @param unwindData    Unwinding data of this location
+ * @param procInfo      The procedure information of the region
+ *
+ * @return The newly created region.
+ */
+static scorep_unwinding_region*
+create_and_share_region( SCOREP_Unwinding_CpuLocationData* unwindData,
+                         const unw_proc_info_t*            procInfo )
+{
+    scorep_unwinding_shared_region_insert( unwindData,
+                                           procInfo->start_ip,
+                                           procInfo->end_ip,
+                                           unwindData->region_name_buffer );
+
+    return create_region( unwindData,
+                          procInfo->start_ip,
+                          procInfo->end_ip,
+                          unwindData->region_name_buffer );
+}
+
+/**
+ * Validates the procedure information libunwind provided for @p ip.
+ *
+ * @param ip            The instruction address
+ * @param procInfo      The procedure information of @p ip
+ *
+ * @return True if @p procInfo can be used to create a region.
+ */
+static bool
+check_proc_info( uint64_t               ip,
+                 const unw_proc_info_t* procInfo )
+{
+    /* FIXME: libunwind bug workaround */
+    /* This has been introduced by Zoltan, We use it because it might fix something */
+    if ( procInfo->end_ip == 0 || procInfo->end_ip == ip )
+    {
+        UTILS_DEBUG( "workaround active: proc_info.end_ip == ip: %#" PRIx64 ", start=%#" PRIx64 "",
+                     ip, procInfo->start_ip );
+        return false;
+    }
+
+    UTILS_BUG_ON( procInfo->start_ip > ip || ip >= procInfo->end_ip,
+                  "IP %#" PRIx64 " is not inside region [%#" PRIx64 ",%#" PRIx64 ")",
+                  ip, procInfo->start_ip, procInfo->end_ip );
+
+    return true;
+}
+
 /**
  * Looks-up the region by IP. If not fownd create one.
  *
@@ -244,7 +332,7 @@ get_region( SCOREP_Unwinding_CpuLocationData* unwindData,
             uint64_t                          ip )
 {
     /* Look for the region belonging to ip */
-    scorep_unwinding_region* region = scorep_unwinding_region_find( unwindData, ip );
+    scorep_unwinding_region* region = find_region( unwindData, ip );
 
     if ( region )
     {
@@ -261,19 +349,11 @@ get_region( SCOREP_Unwinding_CpuLocationData* unwindData,
         return NULL;
     }
 
-    /* FIXME: libunwind bug workaround */
-    /* This has been introduced by Zoltan, We use it because it might fix something */
-    if ( proc_info.end_ip == 0 || proc_info.end_ip == ip )
+    if ( !check_proc_info( ip, &proc_info ) )
     {
-        UTILS_DEBUG( "workaround active: proc_info.end_ip == ip: %#" PRIx64 ", start=%#" PRIx64 "",
-                     ip, proc_info.start_ip );
         return NULL;
     }
 
-    UTILS_BUG_ON( proc_info.start_ip > ip || ip >= proc_info.end_ip,
-                  "IP %#" PRIx64 " is not inside region [%#" PRIx64 ",%#" PRIx64 ")",
-                  ip, proc_info.start_ip, proc_info.end_ip );
-
     // the function name, libunwind can give us
     /* char       SCOREP_Unwinding_LocationData::region_name_buffer[ MAX_FUNC_NAME_LENGTH ]; */
     // the offset of the current instruction
@@ -292,12 +372,68 @@ get_region( SCOREP_Unwinding_CpuLocationData* unwindData,
         // ??? return NULL;
     }
 
-    return create_region( unwindData,
-                          proc_info.start_ip,
-                          proc_info.end_ip,
-                          unwindData->region_name_buffer );
+    return create_and_share_region( unwindData, &proc_info );
+}
+
+#if HAVE( DECL_UNW_GET_PROC_NAME_BY_IP )
+
+/**
+ * Looks-up the region by IP. If not found create one. In contrast to
+ * @a get_region, this does not need a cursor pointing to the frame of @p ip,
+ * thus it can be used after the stack was unwound.
+ *
+ * @param unwindData    Unwinding data of this location
+ * @param ip            The instruction address
+ *
+ * @return The region belonging to the instruction address.
+ */
+static scorep_unwinding_region*
+get_region_by_ip( SCOREP_Unwinding_CpuLocationData* unwindData,
+                  uint64_t                          ip )
+{
+    scorep_unwinding_region* region = find_region( unwindData, ip );
+
+    if ( region )
+    {
+        return region;
+    }
+
+    unw_proc_info_t proc_info;
+    int             ret = unw_get_proc_info_by_ip( unw_local_addr_space,
+                                                   ip,
+                                                   &proc_info,
+                                                   NULL );
+    if ( ret < 0 )
+    {
+        UTILS_DEBUG( "unw_get_proc_info_by_ip() failed for IP %#" PRIx64 ": %s", ip, unw_strerror( ret ) );
+        return NULL;
+    }
+
+    if ( !check_proc_info( ip, &proc_info ) )
+    {
+        return NULL;
+    }
+
+    unw_word_t offset;
+    ret = unw_get_proc_name_by_ip( unw_local_addr_space,
+                                   ip,
+                                   unwindData->region_name_buffer,
+                                   MAX_FUNC_NAME_LENGTH,
+                                   &offset,
+                                   NULL );
+    if ( ret < 0 )
+    {
+        UTILS_DEBUG( "error while retrieving function name for IP %#" PRIx64 ": %s",
+                     proc_info.start_ip, unw_strerror( ret ) );
+        snprintf( unwindData->region_name_buffer, MAX_FUNC_NAME_LENGTH,
+                  "UNKNOWN@[%#" PRIx64 ",%#" PRIx64 ")", proc_info.start_ip, proc_info.end_ip );
+    }
+
+    return create_and_share_region( unwindData, &proc_info );
 }
 
+#endif /* HAVE( DECL_UNW_GET_PROC_NAME_BY_IP ) */
+
 static void
 put_unused( SCOREP_Unwinding_CpuLocationData* unwindData,
             void*                             unusedObject )
@@ -460,27 +596,289 @@ pop_skipped_frames( SCOREP_Unwinding_CpuLocationData* unwindData )
     UTILS_DEBUG_ENTRY();
 }
 
+#if HAVE( FRAME_POINTER_UNWINDING )
+
+#if defined( __x86_64__ )
+#define FRAME_POINTER_REGISTER UNW_X86_64_RBP
+#elif defined( __aarch64__ )
+#define FRAME_POINTER_REGISTER UNW_AARCH64_X29
+#endif
+
+/**
+ * Gets the frame pointer and the stack pointer of the current cursor
+ * position, as the start of a frame pointer chain.
+ *
+ * @param unwindData    Unwinding data of the location
+ * @param[out] fp       The frame pointer
+ * @param[out] sp       The stack pointer
+ *
+ * @return False if the registers are not available or the frame pointer is
+ *         not inside the stack of this thread.
+ */
+static bool
+get_current_frame_pointer( SCOREP_Unwinding_CpuLocationData* unwindData,
+                           uint64_t*                         fp,
+                           uint64_t*                         sp )
+{
+    unw_word_t reg;
+    int        ret = unw_get_reg( &unwindData->cursor, FRAME_POINTER_REGISTER, &reg );
+    if ( ret < 0 )
+    {
+        UTILS_DEBUG( "Could not get frame pointer register (unw_get_reg() returned %s)", unw_strerror( ret ) );
+        return false;
+    }
+    *fp = reg;
+
+    ret = unw_get_reg( &unwindData->cursor, UNW_REG_SP, &reg );
+    if ( ret < 0 )
+    {
+        UTILS_DEBUG( "Could not get stack pointer register (unw_get_reg() returned %s)", unw_strerror( ret ) );
+        return false;
+    }
+    *sp = reg;
+
+    /* The stack below the stack pointer may not be mapped, and frames
+       outside of the thread's stack (e.g., on an alternate signal stack)
+       cannot be checked */
+    return *sp >= unwindData->stack_low && *sp < unwindData->stack_high
+           && *fp >= *sp && *fp < unwindData->stack_high;
+}
+
+/**
+ * Follows the frame pointer chain to the calling frame. On x86-64 and
+ * AArch64 the frame pointer points to the frame record, consisting of
+ * the frame pointer of the caller, followed by the return address.
+ *
+ * @param unwindData    Unwinding data of the location
+ * @param[inout] fp     The frame pointer
+ * @param[out] ip       The return address into the calling frame
+ *
+ * @return 1 if @p fp and @p ip now describe the calling frame, 0 at the
+ *         end of the chain, and -1 if the chain is broken.
+ */
+static int
+step_frame_pointer( SCOREP_Unwinding_CpuLocationData* unwindData,
+                    uint64_t*                         fp,
+                    uint64_t*                         ip )
+{
+    uint64_t frame_address = *fp;
+    if ( 0 == frame_address )
+    {
+        /* The outermost frame clears the frame pointer */
+        return 0;
+    }
+
+    /* The whole frame record must be inside the stack, and properly aligned */
+    if ( frame_address < unwindData->stack_low
+         || frame_address > unwindData->stack_high - 2 * sizeof( uint64_t )
+         || frame_address % sizeof( uint64_t ) != 0 )
+    {
+        UTILS_DEBUG( "Frame pointer %#" PRIx64 " outside of stack [%#" PRIx64 ",%#" PRIx64 ")",
+                     frame_address, unwindData->stack_low, unwindData->stack_high );
+        return -1;
+    }
+
+    const uint64_t* frame_record = ( const uint64_t* )( uintptr_t )frame_address;
+    uint64_t        caller_fp    = frame_record[ 0 ];
+    uint64_t        return_ip    = frame_record[ 1 ];
+
+    if ( 0 == return_ip )
+    {
+        return 0;
+    }
+
+    /* The stack grows downwards, thus callers have higher frame addresses */
+    if ( caller_fp != 0 && caller_fp <= frame_address )
+    {
+        UTILS_DEBUG( "Frame pointer %#" PRIx64 " does not progress to %#" PRIx64,
+                     frame_address, caller_fp );
+        return -1;
+    }
+
+    *fp = caller_fp;
+    *ip = return_ip;
+    return 1;
+}
+
+/**
+ * Pushes the frames of the stack by following the frame pointers, starting
+ * at the frame of the unwind cursor. The cursor itself is not moved, thus
+ * libunwind can continue from there if the chain is broken.
+ *
+ * @param unwindData            Unwinding data of the location
+ * @param interrupted           Whether the frame of the cursor was interrupted
+ *                              by a signal, its IP is then exact
+ * @param[inout] currentStack   The stack
+ *
+ * @return False if the chain is broken before main or the fork region was
+ *         reached. @p currentStack is unchanged in this case.
+ */
+static bool
+push_frame_pointer_stack( SCOREP_Unwinding_CpuLocationData* unwindData,
+                          bool                              interrupted,
+                          scorep_unwinding_frame**          currentStack )
+{
+    uint64_t fp;
+    uint64_t sp;
+    uint64_t ip = get_current_ip( unwindData );
+    if ( 0 == ip || !get_current_frame_pointer( unwindData, &fp, &sp ) )
+    {
+        return false;
+    }
+
+    scorep_unwinding_frame* stack          = *currentStack;
+    int                     use_prev_instr = interrupted ? 0 : 1;
+    int                     ret            = 1;
+    for (; ret > 0; ret = step_frame_pointer( unwindData, &fp, &ip ), use_prev_instr = 1 )
+    {
+        scorep_unwinding_region* region = get_region_by_ip( unwindData, ip );
+
+        /* Return addresses not belonging to any function are a sign of a
+           corrupted chain */
+        if ( !region )
+        {
+            UTILS_DEBUG( "No region for IP %#" PRIx64 " in frame pointer chain", ip );
+            ret = -1;
+            break;
+        }
+
+        if ( region->skip )
+        {
+            continue;
+        }
+
+        /* All but an interrupted frame have a return address as ip */
+        push_stack( unwindData, &stack, region, ip - use_prev_instr );
+
+        if ( region->is_fork || region->is_main )
+        {
+            break;
+        }
+    }
+
+    if ( ret < 0 )
+    {
+        /* drop the frames pushed so far */
+        while ( stack != *currentStack )
+        {
+            scorep_unwinding_frame* top = stack;
+            stack = top->next;
+            put_unused( unwindData, top );
+        }
+        return false;
+    }
+
+    *currentStack = stack;
+    return true;
+}
+
+/**
+ * Records the instruction addresses of a deferred sample by following the
+ * frame pointers, starting at the frame of the unwind cursor. Regions are
+ * only looked-up if already known, as in the libunwind case.
+ *
+ * @param unwindData        Unwinding data of the location
+ * @param interrupted       Whether the frame of the cursor was interrupted
+ *                          by a signal, its IP is then exact
+ * @param frames            The frames of the deferred sample
+ * @param[inout] nFrames    Number of recorded frames
+ *
+ * @return 1 if the stack was recorded completely, 0 if it is deeper than
+ *         the maximal depth, and -1 if the chain is broken. @p nFrames is
+ *         unchanged in the latter case.
+ */
+static int
+record_frame_pointer_stack( SCOREP_Unwinding_CpuLocationData* unwindData,
+                            bool                              interrupted,
+                            scorep_unwinding_deferred_frame*  frames,
+                            uint32_t*                         nFrames )
+{
+    uint64_t fp;
+    uint64_t sp;
+    uint64_t ip = get_current_ip( unwindData );
+    if ( 0 == ip || !get_current_frame_pointer( unwindData, &fp, &sp ) )
+    {
+        return -1;
+    }
+
+    uint32_t n_frames       = *nFrames;
+    int      use_prev_instr = interrupted ? 0 : 1;
+    int      ret            = 1;
+    for (; ret > 0; ret = step_frame_pointer( unwindData, &fp, &ip ), use_prev_instr = 1 )
+    {
+        scorep_unwinding_region* region = find_region( unwindData, ip );
+        if ( region && region->skip )
+        {
+            continue;
+        }
+
+        if ( n_frames == unwindData->deferred_depth )
+        {
+            *nFrames = n_frames;
+            return 0;
+        }
+        frames[ n_frames ].ip             = ip;
+        frames[ n_frames ].use_prev_instr = use_prev_instr;
+        n_frames++;
+
+        if ( region && ( region->is_fork || region->is_main ) )
+        {
+            break;
+        }
+    }
+    if ( ret < 0 )
+    {
+        return -1;
+    }
+
+    *nFrames = n_frames;
+    return 1;
+}
+
+#endif /* HAVE( FRAME_POINTER_UNWINDING ) */
+
 /** Creates the current stack out of the unwind cursor
  *
  *  @param unwindData             Unwinding data of the location
+ *  @param interrupted            Whether the cursor was initialized from a
+ *                                signal context
  *
  *  @return the stack
  */
 static scorep_unwinding_frame*
-get_current_stack( SCOREP_Unwinding_CpuLocationData* unwindData )
+get_current_stack( SCOREP_Unwinding_CpuLocationData* unwindData,
+                   bool                              interrupted )
 {
     scorep_unwinding_frame* current_stack = NULL;
 
     UTILS_DEBUG_ENTRY();
 
+#if HAVE( FRAME_POINTER_UNWINDING )
+    bool try_frame_pointers = unwindData->frame_pointer_unwinding;
+#endif
+
     int ret = 1;
     for (; ret > 0; ret = unw_step( &unwindData->cursor ) )
     {
-        int use_prev_instr = 1;
-        if ( unw_is_signal_frame( &unwindData->cursor ) )
+        /* The frame interrupted by a signal has the exact IP, like the
+           signal frame itself, all others a return address */
+        bool signal_frame   = unw_is_signal_frame( &unwindData->cursor ) > 0;
+        int  use_prev_instr = ( interrupted || signal_frame ) ? 0 : 1;
+        interrupted = signal_frame;
+
+#if HAVE( FRAME_POINTER_UNWINDING )
+        if ( try_frame_pointers && !signal_frame )
         {
-            use_prev_instr = 0;
+            /* Take over from the first regular frame, i.e., after any signal frame */
+            if ( push_frame_pointer_stack( unwindData, use_prev_instr == 0, &current_stack ) )
+            {
+                return current_stack;
+            }
+
+            UTILS_DEBUG( "Broken frame pointer chain, using libunwind" );
+            try_frame_pointers = false;
         }
+#endif
 
         /* the current instruction pointer */
         unw_word_t ip = get_current_ip( unwindData );
@@ -714,31 +1112,189 @@ drop_unhandled_wrappers( SCOREP_Unwinding_CpuLocationData* unwindData )
     }
 }
 
-SCOREP_ErrorCode
-scorep_unwinding_cpu_handle_enter( SCOREP_Unwinding_CpuLocationData* unwindData,
-                                   void*                             contextPtr,
-                                   SCOREP_RegionHandle               instrumentedRegionHandle,
-                                   SCOREP_CallingContextHandle*      callingContext,
-                                   uint32_t*                         unwindDistance,
-                                   SCOREP_CallingContextHandle*      previousCallingContext )
+/**
+ * Descents with the current stack down the calling context tree, starting
+ * at the last instrumented region on the augmented stack, and pushes the
+ * new surrogates.
+ *
+ * @param unwindData                  Unwinding data of the location
+ * @param currentStack                The current stack, will be consumed
+ * @param instrumentedRegionHandle    The instrumented region to enter, or
+ *                                    SCOREP_INVALID_REGION for samples
+ * @param newSurrogates               Surrogates of resolved wrappers
+ * @param[out] callingContext         The resulting calling context
+ * @param[out] unwindDistance         The resulting unwind distance
+ */
+static void
+create_calling_context( SCOREP_Unwinding_CpuLocationData* unwindData,
+                        scorep_unwinding_frame*           currentStack,
+                        SCOREP_RegionHandle               instrumentedRegionHandle,
+                        scorep_unwinding_surrogate*       newSurrogates,
+                        SCOREP_CallingContextHandle*      callingContext,
+                        uint32_t*                         unwindDistance )
 {
-    if ( !unwindData )
+    /* As this is the virtual root, we need to assume that it made progress,
+       thus start with an unwind distance of 1 */
+    *unwindDistance = 1;
+    scorep_unwinding_calling_context_tree_node* unwind_context = &unwindData->calling_context_root;
+
+    /* If we have instrumented regions on the stack, determine the unwind context
+     * and the tail of the current unwind stack. */
+    if ( unwindData->augmented_stack )
     {
-        return UTILS_ERROR( SCOREP_ERROR_INVALID_ARGUMENT, "location has no unwind data?" );
-    }
+        uint64_t                          previous_ip = unwindData->augmented_stack->ip;
+        scorep_unwinding_augmented_frame* frame       = unwindData->augmented_stack->prev;
+        while ( currentStack )
+        {
+            if ( frame->region != currentStack->region )
+            {
+                break;
+            }
+            previous_ip = currentStack->ip;
 
-    UTILS_DEBUG_ENTRY( "%p instrumentedRegionHandle=%u[%s]",
-                       unwindData->location,
-                       instrumentedRegionHandle,
-                       instrumentedRegionHandle
-                       ? SCOREP_RegionHandle_GetName( instrumentedRegionHandle )
-                       : "" );
+            scorep_unwinding_frame* top = currentStack;
+            currentStack = currentStack->next;
+            put_unused( unwindData, top );
 
-    /* export the previous calling context, but do not reset our previous yet,
-       as we may fail to get a backtrace */
-    *previousCallingContext = unwindData->previous_calling_context;
+            if ( frame == unwindData->augmented_stack )
+            {
+                break;
+            }
+            frame = frame->prev;
+        }
 
-#if HAVE( DECL_UNW_INIT_LOCAL2 ) || HAVE( DECL_UNW_INIT_LOCAL_SIGNAL )
+        /* Use the unwind context from the last instrumented region, as this
+           is a real node, we start the unwind distance with 0 again */
+        unwind_context                  = unwindData->augmented_stack->surrogates->unwind_context;
+        *unwindDistance                 = 0;
+        unwindData->augmented_stack->ip = previous_ip;
+
+        /* Decent into the instrumented region */
+        calling_context_descent( unwindData->location,
+                                 &unwind_context,
+                                 unwindDistance,
+                                 unwindData->augmented_stack->ip,
+                                 unwindData->augmented_stack->surrogates->region_handle );
+    }
+
+    /* Descent with the tail of the current stack down the unwind context
+       Build the augmented stack, if needed */
+    while ( currentStack )
+    {
+        UTILS_BUG_ON( currentStack->region == NULL, "Missing region for stack frame" );
+
+        if ( currentStack->region->handle == SCOREP_INVALID_REGION )
+        {
+            /* Need to define the region first */
+            currentStack->region->handle = SCOREP_Definitions_NewRegion(
+                currentStack->region->name,
+                NULL,
+                SCOREP_INVALID_SOURCE_FILE,
+                SCOREP_INVALID_LINE_NO,
+                SCOREP_INVALID_LINE_NO,
+                SCOREP_PARADIGM_SAMPLING,
+                SCOREP_REGION_FUNCTION );
+        }
+
+        /* Decent into the calling context tree */
+        calling_context_descent( unwindData->location,
+                                 &unwind_context,
+                                 unwindDistance,
+                                 currentStack->ip,
+                                 currentStack->region->handle );
+
+        /* We want to enter an instrumented region, thus we need to create
+           the augmented stack, thus convert the current frame to an augmented
+           one */
+        if ( instrumentedRegionHandle != SCOREP_INVALID_REGION
+             || newSurrogates )
+        {
+            scorep_unwinding_augmented_frame* augmented_frame = get_unused( unwindData );
+            augmented_frame->ip     = currentStack->ip;
+            augmented_frame->region = currentStack->region;
+
+            if ( unwindData->augmented_stack == NULL )
+            {
+                /* First frame */
+                augmented_frame->next = augmented_frame;
+                augmented_frame->prev = augmented_frame;
+            }
+            else
+            {
+                augmented_frame->next       = unwindData->augmented_stack;
+                augmented_frame->prev       = unwindData->augmented_stack->prev;
+                augmented_frame->prev->next = augmented_frame;
+                augmented_frame->next->prev = augmented_frame;
+            }
+            unwindData->augmented_stack = augmented_frame;
+        }
+
+        /* Move stack frame to the unused list */
+        scorep_unwinding_frame* frame = currentStack;
+        currentStack = currentStack->next;
+        put_unused( unwindData, frame );
+    }
+
+    /*
+     * we could successfully resolve all unhandled wrappers, we can now safely
+     * drop them all
+     */
+    drop_unhandled_wrappers( unwindData );
+
+    /* create the surrogate for the instrumented (non-wrapped) region */
+    if ( instrumentedRegionHandle != SCOREP_INVALID_REGION && !newSurrogates )
+    {
+        newSurrogates = get_surrogate( unwindData,
+                                       unwindData->augmented_stack->ip,
+                                       instrumentedRegionHandle,
+                                       false );
+    }
+
+    /* We now have the calling context for the current CPU stack, now enter
+       all provided instrumented region */
+    while ( newSurrogates )
+    {
+        scorep_unwinding_surrogate* surrogate = newSurrogates;
+        newSurrogates = surrogate->prev;
+        push_surrogate( unwindData,
+                        surrogate,
+                        &unwind_context,
+                        unwindDistance );
+    }
+
+    *callingContext                      = unwind_context->handle;
+    unwindData->previous_calling_context = *callingContext;
+}
+
+SCOREP_ErrorCode
+scorep_unwinding_cpu_handle_enter( SCOREP_Unwinding_CpuLocationData* unwindData,
+                                   void*                             contextPtr,
+                                   SCOREP_RegionHandle               instrumentedRegionHandle,
+                                   SCOREP_CallingContextHandle*      callingContext,
+                                   uint32_t*                         unwindDistance,
+                                   SCOREP_CallingContextHandle*      previousCallingContext )
+{
+    if ( !unwindData )
+    {
+        return UTILS_ERROR( SCOREP_ERROR_INVALID_ARGUMENT, "location has no unwind data?" );
+    }
+
+    /* Samples recorded earlier rely on the current state, process them first */
+    scorep_unwinding_cpu_process_deferred_samples( unwindData );
+
+    UTILS_DEBUG_ENTRY( "%p instrumentedRegionHandle=%u[%s]",
+                       unwindData->location,
+                       instrumentedRegionHandle,
+                       instrumentedRegionHandle
+                       ? SCOREP_RegionHandle_GetName( instrumentedRegionHandle )
+                       : "" );
+
+    /* export the previous calling context, but do not reset our previous yet,
+       as we may fail to get a backtrace */
+    *previousCallingContext = unwindData->previous_calling_context;
+
+    bool interrupted = false;
+#if HAVE( DECL_UNW_INIT_LOCAL2 ) || HAVE( DECL_UNW_INIT_LOCAL_SIGNAL )
     if ( contextPtr )
     {
 #if HAVE( DECL_UNW_INIT_LOCAL2 )
@@ -751,6 +1307,7 @@ scorep_unwinding_cpu_handle_enter( SCOREP_Unwinding_CpuLocationData* unwindData,
             return UTILS_ERROR( SCOREP_ERROR_PROCESSED_WITH_FAULTS,
                                 "Could not get libunwind cursor from signal context: %s", unw_strerror( ret ) );
         }
+        interrupted = true;
     }
     else
 #endif
@@ -879,7 +1436,7 @@ scorep_unwinding_cpu_handle_enter( SCOREP_Unwinding_CpuLocationData* unwindData,
         return SCOREP_SUCCESS;
     }
 
-    scorep_unwinding_frame* current_stack = get_current_stack( unwindData );
+    scorep_unwinding_frame* current_stack = get_current_stack( unwindData, interrupted );
     if ( !current_stack )
     {
         UTILS_BUG_ON( instrumentedRegionHandle, "Empty stack for enter" );
@@ -888,137 +1445,12 @@ scorep_unwinding_cpu_handle_enter( SCOREP_Unwinding_CpuLocationData* unwindData,
         return SCOREP_SUCCESS;
     }
 
-    /* As this is the virtual root, we need to assume that it made progress,
-       thus start with an unwind distance of 1 */
-    *unwindDistance = 1;
-    scorep_unwinding_calling_context_tree_node* unwind_context = &unwindData->calling_context_root;
-
-    /* If we have instrumented regions on the stack, determine the unwind context
-     * and the tail of the current unwind stack. */
-    if ( unwindData->augmented_stack )
-    {
-        uint64_t                          previous_ip = unwindData->augmented_stack->ip;
-        scorep_unwinding_augmented_frame* frame       = unwindData->augmented_stack->prev;
-        while ( current_stack )
-        {
-            if ( frame->region != current_stack->region )
-            {
-                break;
-            }
-            previous_ip = current_stack->ip;
-
-            scorep_unwinding_frame* top = current_stack;
-            current_stack = current_stack->next;
-            put_unused( unwindData, top );
-
-            if ( frame == unwindData->augmented_stack )
-            {
-                break;
-            }
-            frame = frame->prev;
-        }
-
-        /* Use the unwind context from the last instrumented region, as this
-           is a real node, we start the unwind distance with 0 again */
-        unwind_context                  = unwindData->augmented_stack->surrogates->unwind_context;
-        *unwindDistance                 = 0;
-        unwindData->augmented_stack->ip = previous_ip;
-
-        /* Decent into the instrumented region */
-        calling_context_descent( unwindData->location,
-                                 &unwind_context,
-                                 unwindDistance,
-                                 unwindData->augmented_stack->ip,
-                                 unwindData->augmented_stack->surrogates->region_handle );
-    }
-
-    /* Descent with the tail of the current stack down the unwind context
-       Build the augmented stack, if needed */
-    while ( current_stack )
-    {
-        UTILS_BUG_ON( current_stack->region == NULL, "Missing region for stack frame" );
-
-        if ( current_stack->region->handle == SCOREP_INVALID_REGION )
-        {
-            /* Need to define the region first */
-            current_stack->region->handle = SCOREP_Definitions_NewRegion(
-                current_stack->region->name,
-                NULL,
-                SCOREP_INVALID_SOURCE_FILE,
-                SCOREP_INVALID_LINE_NO,
-                SCOREP_INVALID_LINE_NO,
-                SCOREP_PARADIGM_SAMPLING,
-                SCOREP_REGION_FUNCTION );
-        }
-
-        /* Decent into the calling context tree */
-        calling_context_descent( unwindData->location,
-                                 &unwind_context,
-                                 unwindDistance,
-                                 current_stack->ip,
-                                 current_stack->region->handle );
-
-        /* We want to enter an instrumented region, thus we need to create
-           the augmented stack, thus convert the current frame to an augmented
-           one */
-        if ( instrumentedRegionHandle != SCOREP_INVALID_REGION
-             || new_surrogates )
-        {
-            scorep_unwinding_augmented_frame* augmented_frame = get_unused( unwindData );
-            augmented_frame->ip     = current_stack->ip;
-            augmented_frame->region = current_stack->region;
-
-            if ( unwindData->augmented_stack == NULL )
-            {
-                /* First frame */
-                augmented_frame->next = augmented_frame;
-                augmented_frame->prev = augmented_frame;
-            }
-            else
-            {
-                augmented_frame->next       = unwindData->augmented_stack;
-                augmented_frame->prev       = unwindData->augmented_stack->prev;
-                augmented_frame->prev->next = augmented_frame;
-                augmented_frame->next->prev = augmented_frame;
-            }
-            unwindData->augmented_stack = augmented_frame;
-        }
-
-        /* Move stack frame to the unused list */
-        scorep_unwinding_frame* frame = current_stack;
-        current_stack = current_stack->next;
-        put_unused( unwindData, frame );
-    }
-
-    /*
-     * we could successfully resolve all unhandled wrappers, we can now safely
-     * drop them all
-     */
-    drop_unhandled_wrappers( unwindData );
-
-    /* create the surrogate for the instrumented (non-wrapped) region */
-    if ( instrumentedRegionHandle != SCOREP_INVALID_REGION && !new_surrogates )
-    {
-        new_surrogates = get_surrogate( unwindData,
-                                        unwindData->augmented_stack->ip,
-                                        instrumentedRegionHandle,
-                                        false );
-    }
-
-    /* We now have the calling context for the current CPU stack, now enter
-       all provided instrumented region */
-    while ( new_surrogates )
-    {
-        scorep_unwinding_surrogate* surrogate = new_surrogates;
-        new_surrogates = surrogate->prev;
-        push_surrogate( unwindData,
-                        surrogate,
-                        &unwind_context,
-                        unwindDistance );
-    }
-
-    *callingContext                      = unwind_context->handle;
-    unwindData->previous_calling_context = *callingContext;
+    create_calling_context( unwindData,
+                            current_stack,
+                            instrumentedRegionHandle,
+                            new_surrogates,
+                            callingContext,
+                            unwindDistance );
 
     return SCOREP_SUCCESS;
 }
@@ -1034,6 +1466,9 @@ scorep_unwinding_cpu_handle_exit( SCOREP_Unwinding_CpuLocationData* unwindData,
         return UTILS_ERROR( SCOREP_ERROR_INVALID_ARGUMENT, "location has no unwind data?" );
     }
 
+    /* Samples recorded earlier rely on the current state, process them first */
+    scorep_unwinding_cpu_process_deferred_samples( unwindData );
+
     UTILS_DEBUG_ENTRY( "%p",
                        unwindData->location );
 
@@ -1060,7 +1495,7 @@ scorep_unwinding_cpu_handle_exit( SCOREP_Unwinding_CpuLocationData* unwindData,
         }
         pop_skipped_frames( unwindData );
 
-        scorep_unwinding_frame* current_stack = get_current_stack( unwindData );
+        scorep_unwinding_frame* current_stack = get_current_stack( unwindData, false );
         if ( !current_stack )
         {
             return UTILS_ERROR( SCOREP_ERROR_PROCESSED_WITH_FAULTS,
@@ -1111,6 +1546,334 @@ scorep_unwinding_cpu_handle_exit( SCOREP_Unwinding_CpuLocationData* unwindData,
     return SCOREP_SUCCESS;
 }
 
+bool
+scorep_unwinding_cpu_defer_sample( SCOREP_Unwinding_CpuLocationData* unwindData,
+                                   void*                             contextPtr,
+                                   uint64_t                          timestamp,
+                                   SCOREP_InterruptGeneratorHandle   interruptGeneratorHandle,
+                                   const uint64_t*                   metricValues )
+{
+    if ( !unwindData
+         || unwindData->deferred_capacity == 0
+         || unwindData->deferred_depth == 0
+         || unwindData->processing_deferred_samples )
+    {
+        return false;
+    }
+
+    /* Unhandled wrappers need the cursor of this sample, and samples inside
+       wrapped regions do not unwind at all. Handle these immediately. */
+    if ( unwindData->unhandled_wrappers
+         || ( unwindData->augmented_stack
+              && unwindData->augmented_stack->surrogates->is_wrapped ) )
+    {
+        return false;
+    }
+
+    if ( unwindData->deferred_samples == NULL )
+    {
+        unwindData->n_deferred_metrics = SCOREP_Metric_GetNumberOfStrictlySynchronousMetrics();
+        unwindData->deferred_samples   = SCOREP_Location_AllocForMisc(
+            unwindData->location,
+            unwindData->deferred_capacity * sizeof( *unwindData->deferred_samples ) );
+        unwindData->deferred_frames = SCOREP_Location_AllocForMisc(
+            unwindData->location,
+            ( size_t )unwindData->deferred_capacity * unwindData->deferred_depth
+            * sizeof( *unwindData->deferred_frames ) );
+        unwindData->deferred_metrics = SCOREP_Location_AllocForMisc(
+            unwindData->location,
+            ( size_t )unwindData->deferred_capacity * unwindData->n_deferred_metrics
+            * sizeof( *unwindData->deferred_metrics ) );
+    }
+
+    if ( unwindData->n_deferred_samples == unwindData->deferred_capacity )
+    {
+        /* The buffer is full, no event drained it yet. Trigger the pending
+           samples in order and handle this one immediately. */
+        scorep_unwinding_cpu_process_deferred_samples( unwindData );
+        return false;
+    }
+
+    bool interrupted = false;
+#if HAVE( DECL_UNW_INIT_LOCAL2 ) || HAVE( DECL_UNW_INIT_LOCAL_SIGNAL )
+    if ( contextPtr )
+    {
+#if HAVE( DECL_UNW_INIT_LOCAL2 )
+        int ret = unw_init_local2( &unwindData->cursor, contextPtr, UNW_INIT_SIGNAL_FRAME );
+#elif HAVE( DECL_UNW_INIT_LOCAL_SIGNAL )
+        int ret = unw_init_local_signal( &unwindData->cursor, contextPtr );
+#endif
+        if ( ret < 0 )
+        {
+            return false;
+        }
+        interrupted = true;
+    }
+    else
+#endif
+    {
+        int ret = unw_getcontext( &unwindData->context );
+        if ( ret < 0 )
+        {
+            return false;
+        }
+        ret = unw_init_local( &unwindData->cursor, &unwindData->context );
+        if ( ret < 0 )
+        {
+            return false;
+        }
+
+        drop_signal_context( unwindData );
+    }
+
+    /* Record the raw stack, regions are only looked-up if already known,
+       to skip Score-P frames and to stop at main or the fork region */
+    scorep_unwinding_deferred_frame* frames = unwindData->deferred_frames
+                                              + ( size_t )unwindData->n_deferred_samples * unwindData->deferred_depth;
+    uint32_t n_frames = 0;
+    bool     complete = false;
+#if HAVE( FRAME_POINTER_UNWINDING )
+    bool try_frame_pointers = unwindData->frame_pointer_unwinding;
+#endif
+    int ret = 1;
+    for (; ret > 0; ret = unw_step( &unwindData->cursor ) )
+    {
+        /* The frame interrupted by a signal has the exact IP, like the
+           signal frame itself, all others a return address */
+        bool signal_frame   = unw_is_signal_frame( &unwindData->cursor ) > 0;
+        int  use_prev_instr = ( interrupted || signal_frame ) ? 0 : 1;
+        interrupted = signal_frame;
+
+#if HAVE( FRAME_POINTER_UNWINDING )
+        if ( try_frame_pointers && !signal_frame )
+        {
+            /* Take over from the first regular frame, i.e., after any signal frame */
+            int fp_ret = record_frame_pointer_stack( unwindData, use_prev_instr == 0, frames, &n_frames );
+            if ( fp_ret >= 0 )
+            {
+                complete = fp_ret > 0;
+                break;
+            }
+
+            UTILS_DEBUG( "Broken frame pointer chain, using libunwind" );
+            try_frame_pointers = false;
+        }
+#endif
+
+        unw_word_t ip = get_current_ip( unwindData );
+        if ( 0 == ip )
+        {
+            complete = true;
+            break;
+        }
+
+        scorep_unwinding_region* region = find_region( unwindData, ip );
+#if !HAVE( DECL_UNW_GET_PROC_NAME_BY_IP )
+        /* The region can only be created with the cursor at this frame */
+        if ( !region )
+        {
+            region = get_region( unwindData, &unwindData->cursor, ip );
+            if ( !region )
+            {
+                continue;
+            }
+        }
+#endif
+        if ( region && region->skip )
+        {
+            continue;
+        }
+
+        if ( n_frames == unwindData->deferred_depth )
+        {
+            break;
+        }
+        frames[ n_frames ].ip             = ip;
+        frames[ n_frames ].use_prev_instr = use_prev_instr;
+        n_frames++;
+
+        if ( region && ( region->is_fork || region->is_main ) )
+        {
+            complete = true;
+            break;
+        }
+    }
+    if ( ret <= 0 )
+    {
+        complete = true;
+    }
+
+    if ( !complete )
+    {
+        /* Stack too deep, the calling context would be truncated */
+        return false;
+    }
+
+    scorep_unwinding_deferred_sample* sample =
+        &unwindData->deferred_samples[ unwindData->n_deferred_samples ];
+    sample->timestamp           = timestamp;
+    sample->interrupt_generator = interruptGeneratorHandle;
+    sample->n_frames            = n_frames;
+    if ( unwindData->n_deferred_metrics && metricValues )
+    {
+        memcpy( unwindData->deferred_metrics
+                + ( size_t )unwindData->n_deferred_samples * unwindData->n_deferred_metrics,
+                metricValues,
+                unwindData->n_deferred_metrics * sizeof( *metricValues ) );
+    }
+    unwindData->n_deferred_samples++;
+
+    return true;
+}
+
+void
+scorep_unwinding_cpu_process_deferred_samples( SCOREP_Unwinding_CpuLocationData* unwindData )
+{
+    if ( unwindData->n_deferred_samples == 0
+         || unwindData->processing_deferred_samples )
+    {
+        return;
+    }
+
+    UTILS_DEBUG_ENTRY( "%p %" PRIu32 " samples",
+                       unwindData->location,
+                       unwindData->n_deferred_samples );
+
+    unwindData->processing_deferred_samples = true;
+
+    for ( uint32_t i = 0; i < unwindData->n_deferred_samples; i++ )
+    {
+        scorep_unwinding_deferred_sample* sample = &unwindData->deferred_samples[ i ];
+        scorep_unwinding_deferred_frame*  frames = unwindData->deferred_frames
+                                                   + ( size_t )i * unwindData->deferred_depth;
+
+        /* Same as get_current_stack, but from the recorded addresses */
+        scorep_unwinding_frame* current_stack = NULL;
+        for ( uint32_t j = 0; j < sample->n_frames; j++ )
+        {
+#if HAVE( DECL_UNW_GET_PROC_NAME_BY_IP )
+            scorep_unwinding_region* region = get_region_by_ip( unwindData, frames[ j ].ip );
+#else
+            scorep_unwinding_region* region = find_region( unwindData, frames[ j ].ip );
+#endif
+            if ( !region || region->skip )
+            {
+                continue;
+            }
+
+            push_stack( unwindData, &current_stack, region, frames[ j ].ip - frames[ j ].use_prev_instr );
+
+            if ( region->is_fork || region->is_main )
+            {
+                break;
+            }
+        }
+        if ( !current_stack )
+        {
+            /* Just ignore this sample */
+            continue;
+        }
+
+        SCOREP_CallingContextHandle previous_calling_context = unwindData->previous_calling_context;
+        SCOREP_CallingContextHandle current_calling_context;
+        uint32_t                    unwind_distance;
+        create_calling_context( unwindData,
+                                current_stack,
+                                SCOREP_INVALID_REGION,
+                                NULL,
+                                &current_calling_context,
+                                &unwind_distance );
+
+        uint64_t* metric_values = NULL;
+        if ( unwindData->n_deferred_metrics )
+        {
+            metric_values = unwindData->deferred_metrics
+                            + ( size_t )i * unwindData->n_deferred_metrics;
+        }
+
+        SCOREP_Location_DeferredCpuSample( unwindData->location,
+                                           sample->timestamp,
+                                           current_calling_context,
+                                           previous_calling_context,
+                                           unwind_distance,
+                                           sample->interrupt_generator,
+                                           metric_values );
+    }
+
+    unwindData->n_deferred_samples          = 0;
+    unwindData->processing_deferred_samples = false;
+}
+
+void
+scorep_unwinding_cpu_activate( SCOREP_Unwinding_CpuLocationData* unwindData,
+                               bool                              useFramePointers )
+{
+    if ( !unwindData )
+    {
+        UTILS_ERROR( SCOREP_ERROR_INVALID_ARGUMENT, "location has no unwind data?" );
+        return;
+    }
+
+#if HAVE( FRAME_POINTER_UNWINDING )
+    unwindData->frame_pointer_unwinding = false;
+    if ( !useFramePointers )
+    {
+        return;
+    }
+
+    /* The location is activated at every fork and thread creation, but
+       pthread_getattr_np is expensive, it parses /proc/self/maps for the
+       master thread. Query the stack only once per thread. A location
+       reused by another thread, or a recycled pthread_t with a new stack,
+       is detected by the current frame being outside of the cached bounds. */
+    pthread_t self  = pthread_self();
+    uintptr_t frame = ( uintptr_t )__builtin_frame_address( 0 );
+    if ( unwindData->stack_cached
+         && pthread_equal( unwindData->stack_thread, self )
+         && ( unwindData->stack_high == 0
+              || ( frame >= unwindData->stack_low && frame < unwindData->stack_high ) ) )
+    {
+        /* No frame pointer unwinding if the query failed the first time */
+        unwindData->frame_pointer_unwinding = unwindData->stack_high != 0;
+        return;
+    }
+
+    unwindData->stack_thread = self;
+    unwindData->stack_cached = true;
+    unwindData->stack_low    = 0;
+    unwindData->stack_high   = 0;
+
+    pthread_attr_t attr;
+    int            ret = pthread_getattr_np( self, &attr );
+    if ( ret != 0 )
+    {
+        UTILS_WARNING( "Could not determine stack of thread, unwinding with libunwind: %s",
+                       strerror( ret ) );
+        return;
+    }
+
+    void*  stack_addr;
+    size_t stack_size;
+    ret = pthread_attr_getstack( &attr, &stack_addr, &stack_size );
+    pthread_attr_destroy( &attr );
+    if ( ret != 0 )
+    {
+        UTILS_WARNING( "Could not determine stack of thread, unwinding with libunwind: %s",
+                       strerror( ret ) );
+        return;
+    }
+
+    unwindData->stack_low               = ( uintptr_t )stack_addr;
+    unwindData->stack_high              = ( uintptr_t )stack_addr + stack_size;
+    unwindData->frame_pointer_unwinding = true;
+
+    UTILS_DEBUG( "%p stack [%#" PRIx64 ",%#" PRIx64 ")",
+                 unwindData->location,
+                 unwindData->stack_low,
+                 unwindData->stack_high );
+#endif
+}
+
 void
 scorep_unwinding_cpu_deactivate( SCOREP_Unwinding_CpuLocationData* unwindData )
 {
@@ -1122,6 +1885,9 @@ scorep_unwinding_cpu_deactivate( SCOREP_Unwinding_CpuLocationData* unwindData )
 
     UTILS_DEBUG_ENTRY( "%p", unwindData->location );
 
+    /* Samples recorded earlier rely on the current state, process them first */
+    scorep_unwinding_cpu_process_deferred_samples( unwindData );
+
     while ( unwindData->augmented_stack )
     {
         /* This is a real stack region, remove from augmented stack */
@@ -1174,6 +1940,9 @@ scorep_unwinding_cpu_push_wrapper( SCOREP_Unwinding_CpuLocationData* unwindData,
                        SCOREP_RegionHandle_GetName( regionHandle ),
                        wrapperIp, framesToSkip );
 
+    /* Samples recorded earlier rely on the current state, process them first */
+    scorep_unwinding_cpu_process_deferred_samples( unwindData );
+
     if ( wrapperIp == 0 )
     {
         int ret = unw_getcontext( &unwindData->context );
@@ -1261,6 +2030,9 @@ scorep_unwinding_cpu_pop_wrapper( SCOREP_Unwinding_CpuLocationData* unwindData,
                        unwindData->location, regionHandle,
                        SCOREP_RegionHandle_GetName( regionHandle ) );
 
+    /* Samples recorded earlier rely on the current state, process them first */
+    scorep_unwinding_cpu_process_deferred_samples( unwindData );
+
     if ( unwindData->unhandled_wrappers == NULL )
     {
         /* The wrapper was handled (enter or sample) */
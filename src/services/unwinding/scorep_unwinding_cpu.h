@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -60,6 +60,28 @@ scorep_unwinding_cpu_handle_exit( SCOREP_Unwinding_CpuLocationData* unwindData,
                                   uint32_t*                         unwindDistance,
                                   SCOREP_CallingContextHandle*      previousCallingContext );
 
+/** Called by @a SCOREP_Unwinding_DeferSample for CPU locations. */
+bool
+scorep_unwinding_cpu_defer_sample( SCOREP_Unwinding_CpuLocationData* unwindData,
+                                   void*                             contextPtr,
+                                   uint64_t                          timestamp,
+                                   SCOREP_InterruptGeneratorHandle   interruptGeneratorHandle,
+                                   const uint64_t*                   metricValues );
+
+/** Creates the calling contexts of the deferred samples and triggers their
+ *  sample events. Called before any other event on the location, before the
+ *  augmented stack changes, and when the buffer is full. */
+void
+scorep_unwinding_cpu_process_deferred_samples( SCOREP_Unwinding_CpuLocationData* unwindData );
+
+/**
+ * Called when the location was activated by its thread. Determines the
+ * stack limits of this thread, if frame pointers should be used.
+ */
+void
+scorep_unwinding_cpu_activate( SCOREP_Unwinding_CpuLocationData* unwindData,
+                               bool                              useFramePointers );
+
 void
 scorep_unwinding_cpu_deactivate( SCOREP_Unwinding_CpuLocationData* unwindData );
 
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -35,6 +35,16 @@
 /** Size of the region name buffer passed to libunwind. */
 #define  MAX_FUNC_NAME_LENGTH 1024
 
+/* Following frame pointers needs a known layout of the frame record and
+   libunwind's look-up of functions by instruction address. */
+#if ( defined( __x86_64__ ) || defined( __aarch64__ ) ) && HAVE( DECL_UNW_GET_PROC_NAME_BY_IP )
+#define HAVE_FRAME_POINTER_UNWINDING 1
+#endif
+
+#if HAVE( FRAME_POINTER_UNWINDING )
+#include <pthread.h>
+#endif
+
 
 /** Our subsystem id, used to address our per-location unwinding data */
 extern size_t scorep_unwinding_subsystem_id;
@@ -171,6 +181,30 @@ typedef union scorep_unwinding_unused_object
     scorep_unwinding_unhandled_wrapper    unhandled_wrapper;
 } scorep_unwinding_unused_object;
 
+/**
+ * Stack frame of a deferred sample, as recorded in the signal handler.
+ */
+typedef struct scorep_unwinding_deferred_frame
+{
+    /** The instruction address as provided by libunwind */
+    uint64_t ip;
+    /** 1 if @p ::ip is a return address, 0 for the interrupted frame */
+    uint64_t use_prev_instr;
+} scorep_unwinding_deferred_frame;
+
+/**
+ * A sample, whose calling context was not yet created.
+ */
+typedef struct scorep_unwinding_deferred_sample
+{
+    /** Time when the sample was taken */
+    uint64_t                        timestamp;
+    /** The interrupt generator which triggered the sample */
+    SCOREP_InterruptGeneratorHandle interrupt_generator;
+    /** Number of recorded stack frames, the innermost first */
+    uint32_t                        n_frames;
+} scorep_unwinding_deferred_sample;
+
 /** Per-location based data related to unwinding for all CPU locations. */
 typedef struct SCOREP_Unwinding_CpuLocationData
 {
@@ -206,6 +240,37 @@ typedef struct SCOREP_Unwinding_CpuLocationData
     /** Last known calling context */
     SCOREP_CallingContextHandle previous_calling_context;
 
+    /** Deferred samples, allocated on first use */
+    scorep_unwinding_deferred_sample* deferred_samples;
+    /** Stack frames of the deferred samples, @p ::deferred_depth per sample */
+    scorep_unwinding_deferred_frame*  deferred_frames;
+    /** Metric values of the deferred samples, @p ::n_deferred_metrics per sample */
+    uint64_t*                         deferred_metrics;
+    /** Capacity of the buffers above in samples, 0 if deferred unwinding is disabled */
+    uint32_t                          deferred_capacity;
+    /** Maximal number of stack frames per deferred sample */
+    uint32_t                          deferred_depth;
+    /** Number of strictly synchronous metrics per deferred sample */
+    uint32_t                          n_deferred_metrics;
+    /** Number of recorded deferred samples */
+    uint32_t                          n_deferred_samples;
+    /** True while the deferred samples are processed */
+    bool                              processing_deferred_samples;
+
+    /** Follow the frame pointers instead of using libunwind, if the chain is intact */
+    bool     frame_pointer_unwinding;
+    /** Lowest address of the thread's stack */
+    uint64_t stack_low;
+    /** Highest address (exclusive) of the thread's stack */
+    uint64_t stack_high;
+#if HAVE( FRAME_POINTER_UNWINDING )
+    /** Thread the stack bounds above were fetched for, valid if @p ::stack_cached */
+    pthread_t stack_thread;
+    /** True if the stack of @p ::stack_thread was already queried, the bounds
+     *  are 0 if that failed */
+    bool      stack_cached;
+#endif
+
     /* Below is storage normally allocated on the stack.
        As they are rather big, we allocate them in the per-location data.
        None of these variables are used in recursive calls. */
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015, 2017,
+ * Copyright (c) 2015, 2017, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -24,6 +24,8 @@
 
 #define SCOREP_DEBUG_MODULE_NAME UNWINDING
 #include <UTILS_Debug.h>
+#include <UTILS_Atomic.h>
+#include <UTILS_Mutex.h>
 
 #include <unistd.h>
 #include <string.h>
@@ -276,3 +278,161 @@ scorep_unwinding_region_clear( SCOREP_Unwinding_CpuLocationData* unwindData,
         unwindData->known_regions = node;
     }
 }
+
+/* Process-wide index of known function ranges.
+ *
+ * An insert-only skip list ordered by the start address. Writers are
+ * serialized by a mutex and link a new node bottom-up with release stores,
+ * readers traverse it with acquire loads and without locking. As nodes are
+ * never removed or modified after publication, a reader sees either the
+ * list before or after an insertion on each level, both are valid skip
+ * lists.
+ *
+ * Memory ordering:
+ *  - Every store of a next pointer that makes a node reachable is a release
+ *    store. All plain stores to the node before it, its start, end, name,
+ *    and its own next pointers, happen-before any acquire load which reads
+ *    the new pointer.
+ *  - Every load of a next pointer by a reader is an acquire load, thus the
+ *    fields of the loaded node are complete when they are read.
+ *  - The writer reads the next pointers with plain loads, as only the
+ *    holder of the mutex stores them, and the mutex orders the writers.
+ *  - The levels are linked bottom-up. A node reachable on a level is
+ *    therefore reachable on all levels below, and a reader that passes it
+ *    on a higher level still finds it on level 0.
+ *  - The check for an existing start and the linking happen under the
+ *    mutex. Threads racing to insert the same function thus publish exactly
+ *    one node, and all of them find the same entry afterwards.
+ */
+
+/** Maximal height of a skip list node, sufficient for about 2^16 functions */
+#define SHARED_REGION_MAX_HEIGHT 16
+
+typedef struct shared_region shared_region;
+struct shared_region
+{
+    /** Start IP of the function */
+    uint64_t       start;
+    /** End IP of the function (exclusive) */
+    uint64_t       end;
+    /** Name of the function */
+    const char*    name;
+    /** Number of levels this node is linked into */
+    uint32_t       height;
+    /** Successor on each level */
+    shared_region* next[];
+};
+
+/** Successors of the skip list head on each level */
+static shared_region* shared_regions_head[ SHARED_REGION_MAX_HEIGHT ];
+
+static UTILS_Mutex shared_regions_mutex = UTILS_MUTEX_INIT;
+/** State of the random generator for node heights, guarded by the mutex */
+static uint32_t    shared_regions_random = 2463534242;
+
+
+/** The successor links of @p node, NULL denotes the head */
+static inline shared_region**
+shared_region_links( shared_region* node )
+{
+    return node ? node->next : shared_regions_head;
+}
+
+
+bool
+scorep_unwinding_shared_region_find( uint64_t     addr,
+                                     uint64_t*    start,
+                                     uint64_t*    end,
+                                     const char** name )
+{
+    shared_region* node = NULL;
+    for ( uint32_t level = SHARED_REGION_MAX_HEIGHT; level-- > 0; )
+    {
+        shared_region* next;
+        /* acquire: pairs with the release store publishing next */
+        while ( ( next = UTILS_Atomic_LoadN_void_ptr( &shared_region_links( node )[ level ],
+                                                      UTILS_ATOMIC_ACQUIRE ) )
+                && next->start <= addr )
+        {
+            node = next;
+        }
+    }
+
+    /* node is the last function starting at or before addr */
+    if ( node == NULL || addr >= node->end )
+    {
+        return false;
+    }
+
+    *start = node->start;
+    *end   = node->end;
+    *name  = node->name;
+    return true;
+}
+
+
+void
+scorep_unwinding_shared_region_insert( SCOREP_Unwinding_CpuLocationData* unwindData,
+                                       uint64_t                          start,
+                                       uint64_t                          end,
+                                       const char*                       name )
+{
+    shared_region* predecessors[ SHARED_REGION_MAX_HEIGHT ];
+
+    UTILS_MutexLock( &shared_regions_mutex );
+
+    /* plain loads, only the holder of the mutex stores next pointers */
+    shared_region* node = NULL;
+    for ( uint32_t level = SHARED_REGION_MAX_HEIGHT; level-- > 0; )
+    {
+        shared_region* next;
+        while ( ( next = shared_region_links( node )[ level ] ) && next->start < start )
+        {
+            node = next;
+        }
+        predecessors[ level ] = node;
+    }
+    if ( shared_region_links( node )[ 0 ]
+         && shared_region_links( node )[ 0 ]->start == start )
+    {
+        /* another location was faster */
+        UTILS_MutexUnlock( &shared_regions_mutex );
+        return;
+    }
+
+    /* xorshift32, each level with probability 1/2 */
+    shared_regions_random ^= shared_regions_random << 13;
+    shared_regions_random ^= shared_regions_random >> 17;
+    shared_regions_random ^= shared_regions_random << 5;
+    uint32_t height = 1;
+    while ( height < SHARED_REGION_MAX_HEIGHT && ( shared_regions_random >> ( height - 1 ) ) & 1 )
+    {
+        height++;
+    }
+
+    size_t         len      = strlen( name );
+    shared_region* new_node = SCOREP_Location_AllocForMisc(
+        unwindData->location,
+        sizeof( *new_node ) + height * sizeof( *new_node->next ) + len + 1 );
+    char* new_name = ( char* )&new_node->next[ height ];
+    memcpy( new_name, name, len + 1 );
+    new_node->start  = start;
+    new_node->end    = end;
+    new_node->name   = new_name;
+    new_node->height = height;
+    for ( uint32_t level = 0; level < height; level++ )
+    {
+        new_node->next[ level ] = shared_region_links( predecessors[ level ] )[ level ];
+    }
+
+    /* publish bottom-up, release: the node is complete before it becomes
+       reachable on any level */
+    for ( uint32_t level = 0; level < height; level++ )
+    {
+        UTILS_Atomic_StoreN_void_ptr( &shared_region_links( predecessors[ level ] )[ level ],
+                                      new_node,
+                                      UTILS_ATOMIC_RELEASE );
+    }
+
+    UTILS_MutexUnlock( &shared_regions_mutex );
+}
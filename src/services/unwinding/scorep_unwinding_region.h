@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015,
+ * Copyright (c) 2015, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -63,4 +63,39 @@ scorep_unwinding_region_clear( SCOREP_Unwinding_CpuLocationData* unwindData,
                                void*                             arg );
 
 
+/** Finds a function range known to any location by an address inside it.
+ *
+ *  The process-wide index is filled by @a scorep_unwinding_shared_region_insert
+ *  and can be read without locking, also from signal context.
+ *
+ *  @param addr          The address to search the function for
+ *  @param[out] start    The start address of the function (inclusive)
+ *  @param[out] end      The end address of the function (exclusive)
+ *  @param[out] name     Name of the function, valid until the end of the measurement
+ *
+ *  @return True if the function was found
+ */
+bool
+scorep_unwinding_shared_region_find( uint64_t     addr,
+                                     uint64_t*    start,
+                                     uint64_t*    end,
+                                     const char** name );
+
+
+/** Publishes a function range, as reported by libunwind, to all locations.
+ *
+ *  Does nothing if a function starting at @p start is already known.
+ *
+ *  @param unwindData  The unwindData of the calling location, provides the memory
+ *  @param start     The start address of the function (inclusive)
+ *  @param end       The end address of the function (exclusive)
+ *  @param name      Name of the function
+ */
+void
+scorep_unwinding_shared_region_insert( SCOREP_Unwinding_CpuLocationData* unwindData,
+                                       uint64_t                          start,
+                                       uint64_t                          end,
+                                       const char*                       name );
+
+
 #endif /* SCOREP_UNWINDING_REGION_H */
@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2012,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2016, 2019-2020, 2022,
+ * Copyright (c) 2009-2016, 2019-2020, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2012,
@@ -48,6 +48,7 @@ extern const SCOREP_Subsystem SCOREP_Subsystem_MetricService;
 extern const SCOREP_Subsystem SCOREP_Subsystem_UnwindingService;
 extern const SCOREP_Subsystem SCOREP_Subsystem_SamplingService;
 extern const SCOREP_Subsystem SCOREP_Subsystem_UserAdapter;
+extern const SCOREP_Subsystem SCOREP_Subsystem_CompilerAdapter;
 extern const SCOREP_Subsystem SCOREP_Subsystem_MpiAdapter;
 extern const SCOREP_Subsystem SCOREP_Subsystem_ShmemAdapter;
 extern const SCOREP_Subsystem SCOREP_Subsystem_Opari2UserAdapter;
@@ -76,6 +77,7 @@ const SCOREP_Subsystem* scorep_subsystems[] = {
     &SCOREP_Subsystem_Topologies,
     &SCOREP_Subsystem_PlatformTopology,
     &SCOREP_Subsystem_UserAdapter,
+    &SCOREP_Subsystem_CompilerAdapter,
     &SCOREP_Subsystem_Opari2UserAdapter,
     &SCOREP_Subsystem_MpiAdapter,
     &SCOREP_Subsystem_ShmemAdapter,
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2015-2018,
+ * Copyright (c) 2015-2018, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * This software may be modified and distributed under the terms of
@@ -115,7 +115,9 @@ SCOREP_Instrumenter_Posix::SCOREP_Instrumenter_Posix
                                     "POSIX I/O support using library wrapping. "
                                     "This includes the file descriptor based POSIX API (i.e., `open`/`close`). "
                                     "The POSIX asynchronous I/O API (i.e., `aio_read`/`aio_write`), if available. "
-                                    "And the ISO C `FILE` handle based API (i.e., `fopen`/`fclose`)." )
+                                    "And the ISO C `FILE` handle based API (i.e., `fopen`/`fclose`). "
+                                    "The io_uring API (i.e., `io_uring_setup`/`io_uring_enter`), if available, "
+                                    "by wrapping `syscall`, all other system calls are passed through." )
 {
 #if !( HAVE_BACKEND( POSIX_IO_SUPPORT ) )
     unsupported();
@@ -1,7 +1,7 @@
 /*
  * This file is part of the Score-P software (http://www.score-p.org)
  *
- * Copyright (c) 2016-2018, 2020-2022,
+ * Copyright (c) 2016-2018, 2020-2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2016, 2022,
@@ -25,6 +25,9 @@
 #include <string.h>
 #include <stdint.h>
 #include <inttypes.h>
+#if HAVE( STDALIGN_H )
+#include <stdalign.h>
+#endif
 
 #include <SCOREP_AllocMetric.h>
 
@@ -39,6 +42,8 @@
 #include <SCOREP_Memory.h>
 #include <scorep_substrates_definition.h>
 
+#include <jenkins_hash.h>
+
 #include <UTILS_Atomic.h>
 #define SCOREP_DEBUG_MODULE_NAME MEMORY
 #include <UTILS_Debug.h>
@@ -53,11 +58,11 @@
  */
 typedef struct allocation_item
 {
-    struct allocation_item* left;
-    struct allocation_item* right;
-    uint64_t                address; /**< pointer address of allocated memory */
-    size_t                  size;    /**< allocated memory */
-    void*                   substrate_data[ SCOREP_SUBSTRATES_NUM_SUBSTRATES ];
+    SCOREP_AllocMetric* metric;
+    uint64_t            address; /**< pointer address of allocated memory */
+    size_t              size;    /**< allocated memory */
+    uint64_t            weight;  /**< memory accounted in the totals */
+    void*               substrate_data[ SCOREP_SUBSTRATES_NUM_SUBSTRATES ];
 } allocation_item;
 
 typedef struct free_list_item
@@ -67,177 +72,86 @@ typedef struct free_list_item
 
 struct SCOREP_AllocMetric
 {
-    UTILS_Mutex              mutex;
-
-    allocation_item*         allocations;
-    free_list_item*          free_list;
-
     SCOREP_SamplingSetHandle sampling_set;
+    /* Protected by the per-process metrics location. */
     uint64_t                 total_allocated_memory;
 };
 
 
-/* Splay tree based on: */
 /*
-                An implementation of top-down splaying
-                    D. Sleator <sleator@cs.cmu.edu>
-                            March 1992
-
-   "Splay trees", or "self-adjusting search trees" are a simple and
-   efficient data structure for storing an ordered set.  The data
-   structure consists of a binary tree, without parent pointers, and no
-   additional fields.  It allows searching, insertion, deletion,
-   deletemin, deletemax, splitting, joining, and many other operations,
-   all with amortized logarithmic performance.  Since the trees adapt to
-   the sequence of requests, their performance on real access patterns is
-   typically even better.  Splay trees are described in a number of texts
-   and papers [1,2,3,4,5].
-
-   The code here is adapted from simple top-down splay, at the bottom of
-   page 669 of [3].  It can be obtained via anonymous ftp from
-   spade.pc.cs.cmu.edu in directory /usr/sleator/public.
-
-   The chief modification here is that the splay operation works even if the
-   item being splayed is not in the tree, and even if the tree root of the
-   tree is NULL.  So the line:
-
-                              t = splay(i, t);
-
-   causes it to search for item with key i in the tree rooted at t.  If it's
-   there, it is splayed to the root.  If it isn't there, then the node put
-   at the root is the last one before NULL that would have been reached in a
-   normal binary search for i.  (It's a neighbor of i in the tree.)  This
-   allows many other operations to be easily implemented, as shown below.
-
-   [1] "Fundamentals of data structures in C", Horowitz, Sahni,
-       and Anderson-Freed, Computer Science Press, pp 542-547.
-   [2] "Data Structures and Their Algorithms", Lewis and Denenberg,
-       Harper Collins, 1991, pp 243-251.
-   [3] "Self-adjusting Binary Search Trees" Sleator and Tarjan,
-       JACM Volume 32, No 3, July 1985, pp 652-686.
-   [4] "Data Structure and Algorithm Analysis", Mark Weiss,
-       Benjamin Cummins, 1992, pp 119-130.
-   [5] "Data Structures, Algorithms, and Performance", Derick Wood,
-       Addison-Wesley, 1993, pp 367-375.
+ * The allocations of all SCOREP_AllocMetric objects are tracked in
+ * address-sharded open-addressing tables. Each shard has its own lock,
+ * thus threads only contend, if they hit the same shard at the same time.
+ * Slots are probed linearly and deletion shifts following entries back,
+ * hence there are no tombstones.
  */
+#define ALLOCATION_SHARDS_EXPONENT 6
+#define ALLOCATION_SHARDS          hashsize( ALLOCATION_SHARDS_EXPONENT )
 
-static allocation_item*
-splay( allocation_item* root,
-       uint64_t         key )
+/* Initial number of slots per shard, tables are grown at a load of 1/2. */
+#define ALLOCATION_SHARD_MIN_CAPACITY 64
+
+typedef struct allocation_slot
 {
-    allocation_item  sentinel;
-    allocation_item* left;
-    allocation_item* right;
-    allocation_item* node;
+    uint64_t         address;
+    allocation_item* item; /**< NULL if the slot is empty */
+} allocation_slot;
 
-    if ( root == NULL )
-    {
-        return root;
-    }
+typedef struct allocation_shard
+{
+    SCOREP_ALIGNAS( SCOREP_CACHELINESIZE ) UTILS_Mutex lock;
+    uint32_t                                           count;
+    uint32_t                                           capacity;
+    allocation_slot*                                   slots;
+    free_list_item*                                    free_list;
+} allocation_shard;
 
-    sentinel.left = sentinel.right = NULL;
-    left          = right = &sentinel;
+static allocation_shard allocation_shards[ ALLOCATION_SHARDS ];
 
-    for (;; )
-    {
-        if ( key < root->address )
-        {
-            if ( root->left == NULL )
-            {
-                break;
-            }
-            if ( key < root->left->address )
-            {
-                node        = root->left;                    /* rotate right */
-                root->left  = node->right;
-                node->right = root;
-                root        = node;
-                if ( root->left == NULL )
-                {
-                    break;
-                }
-            }
-            right->left = root;                               /* link right */
-            right       = root;
-            root        = root->left;
-        }
-        else if ( key > root->address )
-        {
-            if ( root->right == NULL )
-            {
-                break;
-            }
-            if ( key > root->right->address )
-            {
-                node        = root->right;                   /* rotate left */
-                root->right = node->left;
-                node->left  = root;
-                root        = node;
-                if ( root->right == NULL )
-                {
-                    break;
-                }
-            }
-            left->right = root;                              /* link left */
-            left        = root;
-            root        = root->right;
-        }
-        else
-        {
-            break;
-        }
-    }
+/*
+ * Tables replaced by grow_shard(), indexed by log2 of their capacity relative
+ * to ALLOCATION_SHARD_MIN_CAPACITY. Misc memory cannot be released, thus
+ * other shards reuse these tables, when they grow to the same capacity.
+ */
+typedef struct free_table
+{
+    struct free_table* next;
+} free_table;
 
-    left->right = root->left;                                /* assemble */
-    right->left = root->right;
-    root->left  = sentinel.right;
-    root->right = sentinel.left;
+static free_table* free_tables[ 32 ];
+static UTILS_Mutex free_tables_lock;
 
-    return root;
+
+static inline uint32_t
+hash_address( uint64_t addr )
+{
+    return jenkins_hash( &addr, sizeof( addr ), 0 );
 }
 
+static inline allocation_shard*
+get_shard( uint32_t hash )
+{
+    return &allocation_shards[ hash & hashmask( ALLOCATION_SHARDS_EXPONENT ) ];
+}
 
-static void
-insert_memory_allocation( SCOREP_AllocMetric* allocMetric,
-                          allocation_item*    allocation )
+/* The shard was selected by the low bits, probe with the remaining ones. */
+static inline uint32_t
+get_home_slot( const allocation_shard* shard,
+               uint32_t                hash )
 {
-    if ( allocMetric->allocations )
-    {
-        allocMetric->allocations = splay( allocMetric->allocations, allocation->address );
-        if ( allocation->address < allocMetric->allocations->address )
-        {
-            allocation->right       = allocMetric->allocations;
-            allocation->left        = allocation->right->left;
-            allocation->right->left = NULL;
-        }
-        else if ( allocation->address > allocMetric->allocations->address )
-        {
-            allocation->left        = allocMetric->allocations;
-            allocation->right       = allocation->left->right;
-            allocation->left->right = NULL;
-        }
-        else
-        {
-            UTILS_WARNING( "Allocation already known: 0x%" PRIx64, allocation->address );
-        }
-    }
-    allocMetric->allocations = allocation;
+    return ( hash >> ALLOCATION_SHARDS_EXPONENT ) & ( shard->capacity - 1 );
 }
 
+/* Needs to hold the lock of @a shard. */
 static allocation_item*
-add_memory_allocation( SCOREP_AllocMetric* allocMetric,
-                       uint64_t            addr,
-                       size_t              size )
+get_allocation_item( allocation_shard* shard,
+                     uint64_t          addr,
+                     size_t            size )
 {
-    if ( allocMetric == NULL )
-    {
-        return NULL;
-    }
-
-    allocation_item* new_item = ( allocation_item* )allocMetric->free_list;
+    allocation_item* new_item = ( allocation_item* )shard->free_list;
     if ( new_item )
     {
-        allocMetric->free_list = allocMetric->free_list->next;
+        shard->free_list = shard->free_list->next;
     }
     else
     {
@@ -247,72 +161,214 @@ add_memory_allocation( SCOREP_AllocMetric* allocMetric,
     new_item->address = addr;
     new_item->size    = size;
 
-    insert_memory_allocation( allocMetric, new_item );
-
     return new_item;
 }
 
-static allocation_item*
-find_memory_allocation( SCOREP_AllocMetric* allocMetric,
-                        uint64_t            addr )
+/* Needs to hold the lock of @a shard. */
+static void
+free_memory_allocation( allocation_shard* shard,
+                        allocation_item*  allocation )
+{
+    free_list_item* next = shard->free_list;
+    shard->free_list       = ( free_list_item* )allocation;
+    shard->free_list->next = next;
+}
+
+static uint32_t
+get_table_order( uint32_t capacity )
 {
-    if ( allocMetric == NULL || allocMetric->allocations == NULL )
+    uint32_t order = 0;
+    while ( ( ( uint32_t )ALLOCATION_SHARD_MIN_CAPACITY << order ) < capacity )
     {
-        return NULL;
+        order++;
     }
+    return order;
+}
+
+static allocation_slot*
+get_table( uint32_t capacity )
+{
+    uint32_t order = get_table_order( capacity );
 
-    allocMetric->allocations = splay( allocMetric->allocations, addr );
-    if ( addr == allocMetric->allocations->address )
+    UTILS_MutexLock( &free_tables_lock );
+    free_table* table = free_tables[ order ];
+    if ( table )
     {
-        return allocMetric->allocations;
+        free_tables[ order ] = table->next;
     }
+    UTILS_MutexUnlock( &free_tables_lock );
 
-    return NULL;
+    if ( !table )
+    {
+        table = SCOREP_Memory_AllocForMisc( capacity * sizeof( allocation_slot ) );
+    }
+    memset( table, 0, capacity * sizeof( allocation_slot ) );
+    return ( allocation_slot* )table;
 }
 
+static void
+release_table( allocation_slot* slots,
+               uint32_t         capacity )
+{
+    uint32_t    order = get_table_order( capacity );
+    free_table* table = ( free_table* )slots;
+
+    UTILS_MutexLock( &free_tables_lock );
+    table->next          = free_tables[ order ];
+    free_tables[ order ] = table;
+    UTILS_MutexUnlock( &free_tables_lock );
+}
 
+/* Needs to hold the lock of @a shard. */
 static void
-remove_memory_allocation( SCOREP_AllocMetric* allocMetric,
+grow_shard( allocation_shard* shard )
+{
+    uint32_t         old_capacity = shard->capacity;
+    allocation_slot* old_slots    = shard->slots;
+
+    shard->capacity = old_capacity ? 2 * old_capacity : ALLOCATION_SHARD_MIN_CAPACITY;
+    shard->slots    = get_table( shard->capacity );
+
+    for ( uint32_t i = 0; i < old_capacity; i++ )
+    {
+        if ( old_slots[ i ].item == NULL )
+        {
+            continue;
+        }
+        uint32_t slot = get_home_slot( shard, hash_address( old_slots[ i ].address ) );
+        while ( shard->slots[ slot ].item != NULL )
+        {
+            slot = ( slot + 1 ) & ( shard->capacity - 1 );
+        }
+        shard->slots[ slot ] = old_slots[ i ];
+    }
+    if ( old_slots )
+    {
+        release_table( old_slots, old_capacity );
+    }
+}
+
+/* Needs to hold the lock of @a shard. Returns the slot of the allocation or
+ * the empty slot, where it would be inserted. */
+static uint32_t
+find_slot( allocation_shard*   shard,
+           uint32_t            hash,
+           SCOREP_AllocMetric* allocMetric,
+           uint64_t            addr )
+{
+    uint32_t slot = get_home_slot( shard, hash );
+    while ( shard->slots[ slot ].item != NULL
+            && ( shard->slots[ slot ].address != addr
+                 || shard->slots[ slot ].item->metric != allocMetric ) )
+    {
+        slot = ( slot + 1 ) & ( shard->capacity - 1 );
+    }
+    return slot;
+}
+
+/* Needs to hold the lock of @a shard. */
+static void
+remove_slot( allocation_shard* shard,
+             uint32_t          hole )
+{
+    uint32_t mask = shard->capacity - 1;
+    uint32_t slot = hole;
+    while ( true )
+    {
+        slot = ( slot + 1 ) & mask;
+        if ( shard->slots[ slot ].item == NULL )
+        {
+            break;
+        }
+        /* Move the entry into the hole, if the hole lies on its probe sequence. */
+        uint32_t home = get_home_slot( shard, hash_address( shard->slots[ slot ].address ) );
+        if ( ( ( slot - home ) & mask ) >= ( ( slot - hole ) & mask ) )
+        {
+            shard->slots[ hole ] = shard->slots[ slot ];
+            hole                 = slot;
+        }
+    }
+    shard->slots[ hole ].item    = NULL;
+    shard->slots[ hole ].address = 0;
+    shard->count--;
+}
+
+static void
+insert_memory_allocation( SCOREP_AllocMetric* allocMetric,
                           allocation_item*    allocation )
 {
-    if ( allocMetric == NULL
-         || allocMetric->allocations == NULL
-         || allocMetric->allocations != allocation )
+    uint32_t          hash  = hash_address( allocation->address );
+    allocation_shard* shard = get_shard( hash );
+
+    allocation->metric = allocMetric;
+
+    UTILS_MutexLock( &shard->lock );
+
+    if ( 2 * ( shard->count + 1 ) > shard->capacity )
     {
-        return;
+        grow_shard( shard );
     }
 
-    if ( allocation->left == NULL )
+    uint32_t slot = find_slot( shard, hash, allocMetric, allocation->address );
+    if ( shard->slots[ slot ].item != NULL )
     {
-        allocMetric->allocations = allocation->right;
+        UTILS_WARNING( "Allocation already known: 0x%" PRIx64, allocation->address );
+        free_memory_allocation( shard, shard->slots[ slot ].item );
     }
     else
     {
-        /* Serach in the sub-tree where all entries are smaller than the allocation
-         * to delete, the bigest, for this, the right child must be NULL */
-        allocMetric->allocations        = splay( allocation->left, allocation->address );
-        allocMetric->allocations->right = allocation->right;
+        shard->count++;
     }
+    shard->slots[ slot ].address = allocation->address;
+    shard->slots[ slot ].item    = allocation;
 
-    allocation->right = NULL;
-    allocation->left  = NULL;
+    UTILS_MutexUnlock( &shard->lock );
 }
 
-static void
-free_memory_allocation( SCOREP_AllocMetric* allocMetric,
-                        allocation_item*    allocation )
+static allocation_item*
+add_memory_allocation( uint64_t addr,
+                       size_t   size )
 {
-    free_list_item* next = allocMetric->free_list;
-    allocMetric->free_list       = ( free_list_item* )allocation;
-    allocMetric->free_list->next = next;
+    allocation_shard* shard = get_shard( hash_address( addr ) );
+
+    UTILS_MutexLock( &shard->lock );
+    allocation_item* new_item = get_allocation_item( shard, addr, size );
+    UTILS_MutexUnlock( &shard->lock );
+
+    return new_item;
+}
+
+static allocation_item*
+acquire_memory_allocation( SCOREP_AllocMetric* allocMetric,
+                           uint64_t            addr )
+{
+    uint32_t          hash       = hash_address( addr );
+    allocation_shard* shard      = get_shard( hash );
+    allocation_item*  allocation = NULL;
+
+    UTILS_MutexLock( &shard->lock );
+    if ( shard->count > 0 )
+    {
+        uint32_t slot = find_slot( shard, hash, allocMetric, addr );
+        allocation = shard->slots[ slot ].item;
+        if ( allocation )
+        {
+            remove_slot( shard, slot );
+        }
+    }
+    UTILS_MutexUnlock( &shard->lock );
+
+    return allocation;
 }
 
 static void
-delete_memory_allocation( SCOREP_AllocMetric* allocMetric,
-                          allocation_item*    allocation )
+release_memory_allocation( allocation_item* allocation )
 {
-    remove_memory_allocation( allocMetric, allocation );
-    free_memory_allocation( allocMetric, allocation );
+    allocation_shard* shard = get_shard( hash_address( allocation->address ) );
+
+    UTILS_MutexLock( &shard->lock );
+    free_memory_allocation( shard, allocation );
+    UTILS_MutexUnlock( &shard->lock );
 }
 
 /* Keep track of the allocated memory per process, not only per SCOREP_AllocMetric */
@@ -372,84 +428,108 @@ SCOREP_AllocMetric_Destroy( SCOREP_AllocMetric* allocMetric )
 }
 
 
-void
-SCOREP_AllocMetric_AcquireAlloc( SCOREP_AllocMetric* allocMetric,
-                                 uint64_t            addr,
-                                 void**              allocation )
+bool
+SCOREP_AllocMetric_TryAcquireAlloc( SCOREP_AllocMetric* allocMetric,
+                                    uint64_t            addr,
+                                    void**              allocation )
 {
-    UTILS_MutexLock( &allocMetric->mutex );
-
     UTILS_DEBUG_ENTRY( "%p", ( void* )addr );
 
     UTILS_BUG_ON( addr == 0, "Can't acquire allocation for NULL pointers." );
 
-    *allocation = find_memory_allocation( allocMetric, addr );
-    if ( *allocation )
-    {
-        remove_memory_allocation( allocMetric, *allocation );
-    }
-    else
+    *allocation = acquire_memory_allocation( allocMetric, addr );
+
+    UTILS_DEBUG_EXIT( "%p", *allocation );
+    return *allocation != NULL;
+}
+
+
+void
+SCOREP_AllocMetric_AcquireAlloc( SCOREP_AllocMetric* allocMetric,
+                                 uint64_t            addr,
+                                 void**              allocation )
+{
+    if ( !SCOREP_AllocMetric_TryAcquireAlloc( allocMetric, addr, allocation ) )
     {
         UTILS_WARNING( "Could not find allocation %p.",
                        ( void* )addr );
     }
-
-    UTILS_DEBUG_EXIT( "Total Memory: %" PRIu64, allocMetric->total_allocated_memory );
-
-    UTILS_MutexUnlock( &allocMetric->mutex );
 }
 
 
-void
-SCOREP_AllocMetric_HandleAlloc( SCOREP_AllocMetric* allocMetric,
-                                uint64_t            resultAddr,
-                                size_t              size )
+static void
+handle_alloc( SCOREP_AllocMetric* allocMetric,
+              uint64_t            resultAddr,
+              size_t              size,
+              uint64_t            weight )
 {
-    UTILS_MutexLock( &allocMetric->mutex );
-
-    UTILS_DEBUG_ENTRY( "%p , %zu", ( void* )resultAddr, size );
+    UTILS_DEBUG_ENTRY( "%p , %zu, %" PRIu64, ( void* )resultAddr, size, weight );
 
     uint64_t process_allocated_memory_save = UTILS_Atomic_AddFetch_uint64(
-        &process_allocated_memory, size, UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
+        &process_allocated_memory, weight, UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
 
-    allocMetric->total_allocated_memory += size;
-    allocation_item* allocation =
-        add_memory_allocation( allocMetric, resultAddr, size );
+    allocation_item* allocation = add_memory_allocation( resultAddr, size );
+    allocation->weight = weight;
 
     /* We need to ensure, that we take the timestamp  *after* we acquired
-       the metric location, else we may end up with an invalid timestamp order */
+       the metric location, else we may end up with an invalid timestamp order.
+       The total is updated under the same lock, thus the written values
+       follow the timestamps. */
     uint64_t         timestamp;
     SCOREP_Location* per_process_metric_location =
         SCOREP_Location_AcquirePerProcessMetricsLocation( &timestamp );
+    allocMetric->total_allocated_memory += weight;
+    uint64_t total_allocated_memory_save = allocMetric->total_allocated_memory;
     SCOREP_Location_TriggerCounterUint64( per_process_metric_location,
                                           timestamp,
                                           allocMetric->sampling_set,
-                                          allocMetric->total_allocated_memory );
+                                          total_allocated_memory_save );
     SCOREP_Location_ReleasePerProcessMetricsLocation();
 
     SCOREP_TrackAlloc( resultAddr, size, allocation->substrate_data,
-                       allocMetric->total_allocated_memory,
+                       total_allocated_memory_save,
                        process_allocated_memory_save );
 
-    UTILS_DEBUG_EXIT( "Total Memory: %" PRIu64, allocMetric->total_allocated_memory );
+    /* Publish the allocation only after the substrates are done with it. */
+    insert_memory_allocation( allocMetric, allocation );
 
-    UTILS_MutexUnlock( &allocMetric->mutex );
+    UTILS_DEBUG_EXIT( "Total Memory: %" PRIu64, total_allocated_memory_save );
 }
 
 
 void
-SCOREP_AllocMetric_HandleRealloc( SCOREP_AllocMetric* allocMetric,
-                                  uint64_t            resultAddr,
-                                  size_t              size,
-                                  void*               prevAllocation,
-                                  uint64_t*           prevSize )
+SCOREP_AllocMetric_HandleAlloc( SCOREP_AllocMetric* allocMetric,
+                                uint64_t            resultAddr,
+                                size_t              size )
 {
-    UTILS_MutexLock( &allocMetric->mutex );
+    handle_alloc( allocMetric, resultAddr, size, size );
+}
+
 
-    UTILS_DEBUG_ENTRY( "%p , %zu, %p", ( void* )resultAddr, size, prevAllocation );
+void
+SCOREP_AllocMetric_HandleSampledAlloc( SCOREP_AllocMetric* allocMetric,
+                                       uint64_t            resultAddr,
+                                       size_t              size,
+                                       uint64_t            weight )
+{
+    handle_alloc( allocMetric, resultAddr, size, weight );
+}
 
-    uint64_t total_allocated_memory_save;
-    uint64_t process_allocated_memory_save;
+
+static void
+handle_realloc( SCOREP_AllocMetric* allocMetric,
+                uint64_t            resultAddr,
+                size_t              size,
+                uint64_t            weight,
+                void*               prevAllocation,
+                uint64_t*           prevSize )
+{
+    UTILS_DEBUG_ENTRY( "%p , %zu, %" PRIu64 ", %p", ( void* )resultAddr, size, weight, prevAllocation );
+
+    uint64_t         total_allocated_memory_save;
+    uint64_t         process_allocated_memory_save;
+    uint64_t         timestamp;
+    SCOREP_Location* per_process_metric_location;
 
     /* get the handle of the previously allocated memory */
     allocation_item* allocation = prevAllocation;
@@ -466,19 +546,13 @@ SCOREP_AllocMetric_HandleRealloc( SCOREP_AllocMetric* allocMetric,
         if ( allocation->address == resultAddr )
         {
             process_allocated_memory_save = UTILS_Atomic_AddFetch_uint64(
-                &process_allocated_memory, size - allocation->size,
+                &process_allocated_memory, weight - allocation->weight,
                 UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
 
-            allocMetric->total_allocated_memory += ( size - allocation->size );
+            per_process_metric_location =
+                SCOREP_Location_AcquirePerProcessMetricsLocation( &timestamp );
+            allocMetric->total_allocated_memory += ( weight - allocation->weight );
             total_allocated_memory_save          = allocMetric->total_allocated_memory;
-
-            SCOREP_TrackRealloc( allocation->address, allocation->size, allocation->substrate_data,
-                                 resultAddr, size, allocation->substrate_data,
-                                 total_allocated_memory_save,
-                                 process_allocated_memory_save );
-
-            allocation->size = size;
-            insert_memory_allocation( allocMetric, allocation );
         }
         /* System allocates size before freeing allocation->size (actually,
          * a free(prevAddr) is done), report the memory usage after the allocation
@@ -487,24 +561,32 @@ SCOREP_AllocMetric_HandleRealloc( SCOREP_AllocMetric* allocMetric,
         else
         {
             process_allocated_memory_save = UTILS_Atomic_AddFetch_uint64(
-                &process_allocated_memory, size, UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
+                &process_allocated_memory, weight, UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
             UTILS_Atomic_SubFetch_uint64( &process_allocated_memory,
-                                          allocation->size,
+                                          allocation->weight,
                                           UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
 
-            allocMetric->total_allocated_memory += size;
+            per_process_metric_location =
+                SCOREP_Location_AcquirePerProcessMetricsLocation( &timestamp );
+            allocMetric->total_allocated_memory += weight;
             total_allocated_memory_save          = allocMetric->total_allocated_memory;
-            allocMetric->total_allocated_memory -= allocation->size;
-
-            SCOREP_TrackRealloc( allocation->address, allocation->size, allocation->substrate_data,
-                                 resultAddr, size, allocation->substrate_data,
-                                 total_allocated_memory_save,
-                                 process_allocated_memory_save );
-
-            allocation->address = resultAddr;
-            allocation->size    = size;
-            insert_memory_allocation( allocMetric, allocation );
+            allocMetric->total_allocated_memory -= allocation->weight;
         }
+        SCOREP_Location_TriggerCounterUint64( per_process_metric_location,
+                                              timestamp,
+                                              allocMetric->sampling_set,
+                                              total_allocated_memory_save );
+        SCOREP_Location_ReleasePerProcessMetricsLocation();
+
+        SCOREP_TrackRealloc( allocation->address, allocation->size, allocation->substrate_data,
+                             resultAddr, size, allocation->substrate_data,
+                             total_allocated_memory_save,
+                             process_allocated_memory_save );
+
+        allocation->address = resultAddr;
+        allocation->size    = size;
+        allocation->weight  = weight;
+        insert_memory_allocation( allocMetric, allocation );
     }
     else
     {
@@ -515,32 +597,33 @@ SCOREP_AllocMetric_HandleRealloc( SCOREP_AllocMetric* allocMetric,
             *prevSize = 0;
         }
 
-        process_allocated_memory_save = UTILS_Atomic_AddFetch_uint64(
-            &process_allocated_memory, size, UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
+        handle_alloc( allocMetric, resultAddr, size, weight );
+    }
 
-        allocMetric->total_allocated_memory += size;
-        total_allocated_memory_save          = allocMetric->total_allocated_memory;
+    UTILS_DEBUG_EXIT();
+}
 
-        allocation = add_memory_allocation( allocMetric, resultAddr, size );
-        SCOREP_TrackAlloc( resultAddr, size, allocation->substrate_data,
-                           total_allocated_memory_save,
-                           process_allocated_memory_save );
-    }
 
-    /* We need to ensure, that we take the timestamp  *after* we acquired
-       the metric location, else we may end up with an invalid timestamp order */
-    uint64_t         timestamp;
-    SCOREP_Location* per_process_metric_location =
-        SCOREP_Location_AcquirePerProcessMetricsLocation( &timestamp );
-    SCOREP_Location_TriggerCounterUint64( per_process_metric_location,
-                                          timestamp,
-                                          allocMetric->sampling_set,
-                                          total_allocated_memory_save );
-    SCOREP_Location_ReleasePerProcessMetricsLocation();
+void
+SCOREP_AllocMetric_HandleRealloc( SCOREP_AllocMetric* allocMetric,
+                                  uint64_t            resultAddr,
+                                  size_t              size,
+                                  void*               prevAllocation,
+                                  uint64_t*           prevSize )
+{
+    handle_realloc( allocMetric, resultAddr, size, size, prevAllocation, prevSize );
+}
 
-    UTILS_DEBUG_EXIT( "Total Memory: %" PRIu64, allocMetric->total_allocated_memory );
 
-    UTILS_MutexUnlock( &allocMetric->mutex );
+void
+SCOREP_AllocMetric_HandleSampledRealloc( SCOREP_AllocMetric* allocMetric,
+                                         uint64_t            resultAddr,
+                                         size_t              size,
+                                         uint64_t            weight,
+                                         void*               prevAllocation,
+                                         uint64_t*           prevSize )
+{
+    handle_realloc( allocMetric, resultAddr, size, weight, prevAllocation, prevSize );
 }
 
 
@@ -549,8 +632,6 @@ SCOREP_AllocMetric_HandleFree( SCOREP_AllocMetric* allocMetric,
                                void*               allocation_,
                                uint64_t*           size )
 {
-    UTILS_MutexLock( &allocMetric->mutex );
-
     UTILS_DEBUG_ENTRY( "%p", allocation_ );
 
     allocation_item* allocation = allocation_;
@@ -563,33 +644,33 @@ SCOREP_AllocMetric_HandleFree( SCOREP_AllocMetric* allocMetric,
             *size = 0;
         }
 
-        UTILS_MutexUnlock( &allocMetric->mutex );
         return;
     }
 
     uint64_t allocation_addr   = allocation->address;
     uint64_t deallocation_size = allocation->size;
+    uint64_t weight            = allocation->weight;
 
     uint64_t process_allocated_memory_save = UTILS_Atomic_SubFetch_uint64(
-        &process_allocated_memory, deallocation_size,
+        &process_allocated_memory, weight,
         UTILS_ATOMIC_SEQUENTIAL_CONSISTENT );
 
-    allocMetric->total_allocated_memory -= deallocation_size;
-
     void* substrate_data[ SCOREP_SUBSTRATES_NUM_SUBSTRATES ];
     memcpy( substrate_data, allocation->substrate_data,
             SCOREP_SUBSTRATES_NUM_SUBSTRATES * sizeof( void* ) );
-    free_memory_allocation( allocMetric, allocation );
+    release_memory_allocation( allocation );
 
     /* We need to ensure, that we take the timestamp  *after* we acquired
        the metric location, else we may end up with an invalid timestamp order */
     uint64_t         timestamp;
     SCOREP_Location* per_process_metric_location =
         SCOREP_Location_AcquirePerProcessMetricsLocation( &timestamp );
+    allocMetric->total_allocated_memory -= weight;
+    uint64_t total_allocated_memory_save = allocMetric->total_allocated_memory;
     SCOREP_Location_TriggerCounterUint64( per_process_metric_location,
                                           timestamp,
                                           allocMetric->sampling_set,
-                                          allocMetric->total_allocated_memory );
+                                          total_allocated_memory_save );
     SCOREP_Location_ReleasePerProcessMetricsLocation();
 
     if ( size )
@@ -598,30 +679,44 @@ SCOREP_AllocMetric_HandleFree( SCOREP_AllocMetric* allocMetric,
     }
 
     SCOREP_TrackFree( allocation_addr, deallocation_size, substrate_data,
-                      allocMetric->total_allocated_memory,
+                      total_allocated_memory_save,
                       process_allocated_memory_save );
 
-    UTILS_DEBUG_EXIT( "Total Memory: %" PRIu64, allocMetric->total_allocated_memory );
-
-    UTILS_MutexUnlock( &allocMetric->mutex );
+    UTILS_DEBUG_EXIT( "Total Memory: %" PRIu64, total_allocated_memory_save );
 }
 
 
 void
 SCOREP_AllocMetric_ReportLeaked( SCOREP_AllocMetric* allocMetric )
 {
-    /* walk through tree, every item represents leaked memory */
-    while ( allocMetric->allocations != NULL )
+    /* walk through all shards, every item of this metric represents leaked memory */
+    for ( uint32_t i = 0; i < ALLOCATION_SHARDS; i++ )
     {
-        allocation_item* node = allocMetric->allocations;
+        allocation_shard* shard = &allocation_shards[ i ];
 
-        UTILS_DEBUG( "[leaked] ptr %p, size %zu",
-                     ( void* )( node->address ), node->size );
+        UTILS_MutexLock( &shard->lock );
+        uint32_t slot = 0;
+        while ( slot < shard->capacity && shard->count > 0 )
+        {
+            allocation_item* node = shard->slots[ slot ].item;
+            if ( node == NULL || node->metric != allocMetric )
+            {
+                slot++;
+                continue;
+            }
 
-        SCOREP_LeakedMemory( node->address,
-                             node->size,
-                             node->substrate_data );
-        delete_memory_allocation( allocMetric, node );
+            UTILS_DEBUG( "[leaked] ptr %p, size %zu",
+                         ( void* )( node->address ), node->size );
+
+            SCOREP_LeakedMemory( node->address,
+                                 node->size,
+                                 node->substrate_data );
+
+            /* Entries shifted into this slot need to be visited again. */
+            remove_slot( shard, slot );
+            free_memory_allocation( shard, node );
+        }
+        UTILS_MutexUnlock( &shard->lock );
     }
 }
 
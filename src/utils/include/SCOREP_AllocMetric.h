@@ -25,6 +25,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 
 #include <SCOREP_ErrorCodes.h>
@@ -67,6 +68,19 @@ SCOREP_AllocMetric_AcquireAlloc( SCOREP_AllocMetric* allocMetric,
                                  uint64_t            addr,
                                  void**              allocation );
 
+/**
+ *  Like @a SCOREP_AllocMetric_AcquireAlloc, but an unknown @p addr is not
+ *  reported. For callers which track only a subset of the allocations.
+ *  @param allocMetric      Object handle.
+ *  @param addr             The address of the allocation.
+ *  @param[out] allocation  The allocation, or NULL.
+ *  @return true if the allocation was found.
+ */
+bool
+SCOREP_AllocMetric_TryAcquireAlloc( SCOREP_AllocMetric* allocMetric,
+                                    uint64_t            addr,
+                                    void**              allocation );
+
 /**
  *  Handles an allocation in this metric.
  *
@@ -79,6 +93,21 @@ SCOREP_AllocMetric_HandleAlloc( SCOREP_AllocMetric* allocMetric,
                                 uint64_t            resultAddr,
                                 size_t              size );
 
+/**
+ *  Handles a sampled allocation in this metric. The allocation accounts
+ *  for @p weight bytes in the totals, until it is freed.
+ *  @param allocMetric   Object handle.
+ *  @param resultAddr    The resulting address of the allocation.
+ *  @param size          The size of the allocation.
+ *  @param weight        The estimated number of bytes this allocation
+ *                       represents.
+ */
+void
+SCOREP_AllocMetric_HandleSampledAlloc( SCOREP_AllocMetric* allocMetric,
+                                       uint64_t            resultAddr,
+                                       size_t              size,
+                                       uint64_t            weight );
+
 /**
  *  Handles an reallocation in this metric.
  *
@@ -97,6 +126,18 @@ SCOREP_AllocMetric_HandleRealloc( SCOREP_AllocMetric* allocMetric,
                                   void*               prevAllocation,
                                   uint64_t*           prevSize );
 
+/**
+ *  Handles a reallocation of a sampled allocation in this metric. See
+ *  @a SCOREP_AllocMetric_HandleSampledAlloc for @p weight.
+ */
+void
+SCOREP_AllocMetric_HandleSampledRealloc( SCOREP_AllocMetric* allocMetric,
+                                         uint64_t            resultAddr,
+                                         size_t              size,
+                                         uint64_t            weight,
+                                         void*               prevAllocation,
+                                         uint64_t*           prevSize );
+
 
 /**
  *  Handles an deallocation in this metric.
@@ -117,6 +117,31 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
                                   SCOREP_Allocator_GuardObject lockObject );
 
 
+/**
+ * Create a memory allocator object that starts with @a totalMemory of
+ * memory and grows on demand up to @a maxMemory. The address space for
+ * @a maxMemory is reserved up-front, thus page ids and movable memory stay
+ * valid while growing. If the reservation fails, the allocator is restricted
+ * to @a totalMemory.
+ *
+ * @param[out] totalMemory Amount of memory that is initially committed, also
+ *                       the minimum amount of memory committed when growing.
+ * @param[out] maxMemory Amount of memory the allocator may grow to, at least
+ *                       @a totalMemory. Returns the final capacity.
+ *
+ * For the other parameters see SCOREP_Allocator_CreateAllocator.
+ *
+ * @return A valid allocator object or a null pointer if the creation fails.
+ */
+SCOREP_Allocator_Allocator*
+SCOREP_Allocator_CreateGrowableAllocator( uint32_t*                    totalMemory,
+                                          uint32_t*                    maxMemory,
+                                          uint32_t*                    pageSize,
+                                          SCOREP_Allocator_Guard       lockFunction,
+                                          SCOREP_Allocator_Guard       unlockFunction,
+                                          SCOREP_Allocator_GuardObject lockObject );
+
+
 /**
  * Delete the allocator object @a allocator and free all it's memory.
  *
@@ -130,6 +155,19 @@ SCOREP_Allocator_PageManager*
 SCOREP_Allocator_CreatePageManager( SCOREP_Allocator_Allocator* allocator );
 
 
+/**
+ * Create a page manager, which keeps up to @a pageCacheSize free single pages
+ * in a private cache. The cache is refilled in batches of @a pageCacheSize
+ * pages, thus the allocator lock is taken only once per batch. Pages released
+ * by SCOREP_Allocator_Free go back into the cache, as long as it has room.
+ *
+ * As the page manager itself, the cache is not thread-safe.
+ */
+SCOREP_Allocator_PageManager*
+SCOREP_Allocator_CreateCachedPageManager( SCOREP_Allocator_Allocator* allocator,
+                                          uint32_t                    pageCacheSize );
+
+
 SCOREP_Allocator_PageManager*
 SCOREP_Allocator_CreateMovedPageManager( SCOREP_Allocator_Allocator* allocator );
 
@@ -138,6 +176,18 @@ void
 SCOREP_Allocator_DeletePageManager( SCOREP_Allocator_PageManager* pageManager );
 
 
+/**
+ * Moves all pages in use from @a source to @a destination. Both page managers
+ * need to be from the same allocator. Movable memory allocated from @a source
+ * stays valid and is owned by @a destination afterwards.
+ *
+ * As the page managers itself, this is not thread-safe.
+ */
+void
+SCOREP_Allocator_MovePages( SCOREP_Allocator_PageManager* destination,
+                            SCOREP_Allocator_PageManager* source );
+
+
 /**
  * Returns the start address of a memory chunk of at least @a memorySize bytes
  * from a @a pageManager's page. The contents of the memory block is undetermined.
@@ -238,6 +288,14 @@ uint32_t
 SCOREP_Allocator_GetMaxNumberOfPages( const SCOREP_Allocator_Allocator* allocator );
 
 
+/**
+ * Returns the number of pages currently committed by the @a allocator.
+ * @param allocator
+ */
+uint32_t
+SCOREP_Allocator_GetNumberOfCommittedPages( SCOREP_Allocator_Allocator* allocator );
+
+
 /**
  * Fill @a pageStats partially with the maximum number of pages used at a time
  * (high watermark) and the current number of allocated pages, w.r.t. @a allocator.
@@ -46,9 +46,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if HAVE( SYS_MMAN_H )
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #define SCOREP_DEBUG_MODULE_NAME ALLOCATOR
 #include <UTILS_Debug.h>
 #include <UTILS_Error.h>
+#include <UTILS_Atomic.h>
 
 #define roundup( x ) roundupto( x, SCOREP_ALLOCATOR_ALIGNMENT )
 
@@ -81,6 +87,17 @@ union_size( void )
 }
 
 
+/**
+ * Space for the allocator object at the start of the first page, in
+ * multiples of the union object size.
+ */
+static inline size_t
+allocator_size( void )
+{
+    return roundupto( sizeof( SCOREP_Allocator_Allocator ), union_size() );
+}
+
+
 static void
 null_guard( SCOREP_Allocator_GuardObject guardObject )
 {
@@ -104,7 +121,92 @@ unlock_allocator( SCOREP_Allocator_Allocator* allocator )
 static inline void*
 page_bitset( SCOREP_Allocator_Allocator* allocator )
 {
-    return ( char* )allocator + union_size();
+    return ( char* )allocator + allocator_size();
+}
+
+
+/*
+ * Reserves @a size bytes of address space without backing them, pages are
+ * made accessible with commit_memory. Returns NULL if not supported.
+ */
+static void*
+reserve_memory( size_t size )
+{
+#if HAVE( SYS_MMAN_H ) && defined( MAP_ANONYMOUS ) && defined( MAP_NORESERVE )
+    void* memory = mmap( NULL, size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+    if ( memory == MAP_FAILED )
+    {
+        return NULL;
+    }
+    return memory;
+#else
+    return NULL;
+#endif
+}
+
+
+static bool
+commit_memory( char* start,
+               char* end )
+{
+#if HAVE( SYS_MMAN_H ) && defined( MAP_ANONYMOUS ) && defined( MAP_NORESERVE )
+    /* our pages may be smaller than the OS pages, the reservation itself
+     * is OS page aligned */
+    uintptr_t os_page_mask = ( uintptr_t )sysconf( _SC_PAGESIZE ) - 1;
+    uintptr_t start_addr   = ( uintptr_t )start & ~os_page_mask;
+    uintptr_t end_addr     = ( ( uintptr_t )end + os_page_mask ) & ~os_page_mask;
+    return 0 == mprotect( ( void* )start_addr, end_addr - start_addr,
+                          PROT_READ | PROT_WRITE );
+#else
+    return false;
+#endif
+}
+
+
+/*
+ * Ensures that all pages below @a endPageId are committed. Grows at least
+ * by n_pages_commit_increment pages, to keep the number of calls low.
+ *
+ * Caller needs to hold the allocator lock.
+ */
+static bool
+commit_pages( SCOREP_Allocator_Allocator* allocator,
+              uint32_t                    endPageId )
+{
+    if ( endPageId <= allocator->n_pages_committed )
+    {
+        return true;
+    }
+
+    uint32_t n_pages_committed = allocator->n_pages_committed
+                                 + allocator->n_pages_commit_increment;
+    if ( n_pages_committed < endPageId )
+    {
+        n_pages_committed = endPageId;
+    }
+    if ( n_pages_committed > allocator->n_pages_capacity )
+    {
+        n_pages_committed = allocator->n_pages_capacity;
+    }
+
+    char* start = ( char* )allocator
+                  + ( ( size_t )allocator->n_pages_committed << allocator->page_shift );
+    char* end = ( char* )allocator
+                + ( ( size_t )n_pages_committed << allocator->page_shift );
+    if ( !commit_memory( start, end ) )
+    {
+        UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR,
+                            "cannot commit pages %" PRIu32 " to %" PRIu32 ".",
+                            allocator->n_pages_committed, n_pages_committed );
+        return false;
+    }
+
+    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR,
+                        "committed pages %" PRIu32 " to %" PRIu32 ".",
+                        allocator->n_pages_committed, n_pages_committed );
+    allocator->n_pages_committed = n_pages_committed;
+    return true;
 }
 
 
@@ -162,18 +264,122 @@ track_bitset_find_and_set_range( SCOREP_Allocator_Allocator* allocator,
 }
 
 
+/*
+ * The free union objects are kept in a lock-free stack. The head encodes the
+ * offset of the top object relative to the allocator in the lower and an ABA
+ * tag in the upper 32 bits. All union objects live inside the allocator
+ * memory, thus the offset fits and the memory of a popped object can always
+ * be read.
+ */
+static inline SCOREP_Allocator_Object*
+union_object_from_head( SCOREP_Allocator_Allocator* allocator,
+                        uint64_t                    head )
+{
+    uint32_t offset = ( uint32_t )head;
+    if ( offset == 0 )
+    {
+        return NULL;
+    }
+    return ( SCOREP_Allocator_Object* )( ( char* )allocator + offset );
+}
+
+
+static inline uint64_t
+union_object_to_head( SCOREP_Allocator_Allocator* allocator,
+                      SCOREP_Allocator_Object*    object,
+                      uint64_t                    oldHead )
+{
+    uint64_t tag    = ( ( oldHead >> 32 ) + 1 ) << 32;
+    uint32_t offset = object ? ( uint32_t )( ( char* )object - ( char* )allocator ) : 0;
+    return tag | offset;
+}
+
+
+/*
+ * Pushes the chain @a first to @a last onto the free union objects.
+ */
+static void
+push_union_objects( SCOREP_Allocator_Allocator* allocator,
+                    SCOREP_Allocator_Object*    first,
+                    SCOREP_Allocator_Object*    last,
+                    uint32_t                    nObjects )
+{
+    uint64_t head = UTILS_Atomic_LoadN_uint64( &allocator->free_objects,
+                                               UTILS_ATOMIC_RELAXED );
+    uint64_t new_head;
+    do
+    {
+        /* concurrent pops may read this */
+        UTILS_Atomic_StoreN_void_ptr( &last->next,
+                                      union_object_from_head( allocator, head ),
+                                      UTILS_ATOMIC_RELAXED );
+        new_head = union_object_to_head( allocator, first, head );
+    }
+    while ( !UTILS_Atomic_CompareExchangeN_uint64( &allocator->free_objects,
+                                                   &head, new_head, false,
+                                                   UTILS_ATOMIC_RELEASE,
+                                                   UTILS_ATOMIC_RELAXED ) );
+
+    UTILS_Atomic_AddFetch_uint32( &allocator->n_free_objects, nObjects,
+                                  UTILS_ATOMIC_RELAXED );
+}
+
+
+static SCOREP_Allocator_Object*
+pop_union_object( SCOREP_Allocator_Allocator* allocator )
+{
+    uint64_t head = UTILS_Atomic_LoadN_uint64( &allocator->free_objects,
+                                               UTILS_ATOMIC_ACQUIRE );
+    SCOREP_Allocator_Object* object;
+    while ( ( object = union_object_from_head( allocator, head ) ) )
+    {
+        /* may read a stale value, if object was popped concurrently,
+         * but than the tag changed and the exchange fails */
+        SCOREP_Allocator_Object* next =
+            UTILS_Atomic_LoadN_void_ptr( &object->next, UTILS_ATOMIC_RELAXED );
+        uint64_t new_head = union_object_to_head( allocator, next, head );
+        if ( UTILS_Atomic_CompareExchangeN_uint64( &allocator->free_objects,
+                                                   &head, new_head, false,
+                                                   UTILS_ATOMIC_ACQUIRE,
+                                                   UTILS_ATOMIC_ACQUIRE ) )
+        {
+            UTILS_Atomic_SubFetch_uint32( &allocator->n_free_objects, 1,
+                                          UTILS_ATOMIC_RELAXED );
+            UTILS_Atomic_StoreN_void_ptr( &object->next, NULL,
+                                          UTILS_ATOMIC_RELAXED );
+            return object;
+        }
+    }
+
+    return NULL;
+}
+
+
 static inline void
 fill_with_union_objects( SCOREP_Allocator_Allocator* allocator,
                          uint32_t                    freeMemory,
                          char*                       startAddr )
 {
+    SCOREP_Allocator_Object* first     = NULL;
+    SCOREP_Allocator_Object* last      = NULL;
+    uint32_t                 n_objects = 0;
     while ( freeMemory > union_size() )
     {
         SCOREP_Allocator_Object* object = ( SCOREP_Allocator_Object* )startAddr;
-        object->next            = allocator->free_objects;
-        allocator->free_objects = object;
-        startAddr              += union_size();
-        freeMemory             -= union_size();
+        object->next = first;
+        first        = object;
+        if ( !last )
+        {
+            last = object;
+        }
+        n_objects++;
+        startAddr  += union_size();
+        freeMemory -= union_size();
+    }
+
+    if ( first )
+    {
+        push_union_objects( allocator, first, last, n_objects );
     }
 }
 
@@ -182,10 +388,11 @@ fill_with_union_objects( SCOREP_Allocator_Allocator* allocator,
  * Caller needs to hold the allocator lock.
  */
 static void*
-get_union_object( SCOREP_Allocator_Allocator* allocator )
+get_union_object_locked( SCOREP_Allocator_Allocator* allocator )
 {
     UTILS_DEBUG_ENTRY();
-    if ( !allocator->free_objects )
+    SCOREP_Allocator_Object* object;
+    while ( !( object = pop_union_object( allocator ) ) )
     {
         /* try to get a new maintenance page */
         uint32_t page_id = track_bitset_find_and_set( allocator );
@@ -194,6 +401,12 @@ get_union_object( SCOREP_Allocator_Allocator* allocator )
             UTILS_DEBUG_EXIT( "out-of-memory: no free page" );
             return NULL;
         }
+        if ( !commit_pages( allocator, page_id + 1 ) )
+        {
+            track_bitset_clear( allocator, page_id );
+            UTILS_DEBUG_EXIT( "out-of-memory: cannot commit page" );
+            return NULL;
+        }
         char*    start_addr  = ( char* )allocator + ( page_id << allocator->page_shift );
         uint32_t free_memory = page_size( allocator );
         fill_with_union_objects( allocator, free_memory, start_addr );
@@ -201,17 +414,30 @@ get_union_object( SCOREP_Allocator_Allocator* allocator )
         UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "\'allocated\' 1 maintenance page." );
     }
 
-    SCOREP_Allocator_Object* object = allocator->free_objects;
-    allocator->free_objects = object->next;
-    object->next            = NULL;
-
     UTILS_DEBUG_EXIT();
     return object;
 }
 
 
 /*
- * Caller needs to hold the allocator lock.
+ * Takes the allocator lock only if a new maintenance page is needed.
+ */
+static void*
+get_union_object( SCOREP_Allocator_Allocator* allocator )
+{
+    SCOREP_Allocator_Object* object = pop_union_object( allocator );
+    if ( !object )
+    {
+        lock_allocator( allocator );
+        object = get_union_object_locked( allocator );
+        unlock_allocator( allocator );
+    }
+    return object;
+}
+
+
+/*
+ * Does not need the allocator lock.
  */
 static void
 put_union_object( SCOREP_Allocator_Allocator* allocator,
@@ -219,8 +445,7 @@ put_union_object( SCOREP_Allocator_Allocator* allocator,
 {
     UTILS_DEBUG_ENTRY();
     SCOREP_Allocator_Object* object = objectPtr;
-    object->next            = allocator->free_objects;
-    allocator->free_objects = object;
+    push_union_objects( allocator, object, object, 1 );
     UTILS_DEBUG_EXIT();
 }
 
@@ -259,7 +484,7 @@ get_page( SCOREP_Allocator_Allocator* allocator,
     UTILS_DEBUG_ENTRY();
     uint32_t page_id;
 
-    SCOREP_Allocator_Page* page = get_union_object( allocator );
+    SCOREP_Allocator_Page* page = get_union_object_locked( allocator );
     if ( !page )
     {
         UTILS_DEBUG_EXIT( "out-of-memory: no free union_object, order=%" PRIu32 "", order );
@@ -281,6 +506,13 @@ get_page( SCOREP_Allocator_Allocator* allocator,
         UTILS_DEBUG_EXIT( "out-of-memory: no free page(s), order=%" PRIu32 "", order );
         return 0;
     }
+    if ( !commit_pages( allocator, page_id + order ) )
+    {
+        track_bitset_clear_range( allocator, page_id, order );
+        put_union_object( allocator, page );
+        UTILS_DEBUG_EXIT( "out-of-memory: cannot commit page(s), order=%" PRIu32 "", order );
+        return 0;
+    }
     init_page( allocator, page, page_id, order );
 
     UTILS_DEBUG_EXIT( "new page=%p, order=%" PRIu32 ", page_id=%" PRIu32 "", page, order, page_id );
@@ -288,6 +520,90 @@ get_page( SCOREP_Allocator_Allocator* allocator,
 }
 
 
+/*
+ * Caller needs to hold the allocator lock.
+ */
+static void
+put_pages( SCOREP_Allocator_Allocator* allocator,
+           SCOREP_Allocator_Page*      pages )
+{
+    while ( pages )
+    {
+        SCOREP_Allocator_Page* next_page = pages->next;
+        put_page( allocator, pages );
+        pages = next_page;
+    }
+}
+
+
+/*
+ * Takes a single page from the page cache of @a pageManager. An empty cache
+ * is refilled with up to page_cache_size pages under one allocator lock.
+ */
+static SCOREP_Allocator_Page*
+page_cache_get_page( SCOREP_Allocator_PageManager* pageManager )
+{
+    SCOREP_Allocator_Allocator* allocator = pageManager->allocator;
+
+    if ( !pageManager->page_cache )
+    {
+        uint32_t n_pages = 0;
+        lock_allocator( allocator );
+        while ( n_pages < pageManager->page_cache_size )
+        {
+            SCOREP_Allocator_Page* page = get_page( allocator, 1 );
+            if ( !page )
+            {
+                break;
+            }
+            page->next              = pageManager->page_cache;
+            pageManager->page_cache = page;
+            n_pages++;
+        }
+        unlock_allocator( allocator );
+
+        if ( n_pages == 0 )
+        {
+            return NULL;
+        }
+        UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR,
+                            "refilled page cache with %" PRIu32 " page(s).", n_pages );
+        pageManager->n_cached_pages = n_pages;
+        UTILS_Atomic_AddFetch_uint32( &allocator->n_pages_cached, n_pages,
+                                      UTILS_ATOMIC_RELAXED );
+    }
+
+    SCOREP_Allocator_Page* page = pageManager->page_cache;
+    pageManager->page_cache = page->next;
+    pageManager->n_cached_pages--;
+    UTILS_Atomic_SubFetch_uint32( &allocator->n_pages_cached, 1,
+                                  UTILS_ATOMIC_RELAXED );
+    page->next = NULL;
+
+    return page;
+}
+
+
+/*
+ * Takes the page cache of @a pageManager away, the pages still need to be
+ * released with put_pages.
+ */
+static SCOREP_Allocator_Page*
+page_cache_detach( SCOREP_Allocator_PageManager* pageManager )
+{
+    SCOREP_Allocator_Page* pages = pageManager->page_cache;
+    if ( pages )
+    {
+        UTILS_Atomic_SubFetch_uint32( &pageManager->allocator->n_pages_cached,
+                                      pageManager->n_cached_pages,
+                                      UTILS_ATOMIC_RELAXED );
+    }
+    pageManager->page_cache     = NULL;
+    pageManager->n_cached_pages = 0;
+    return pages;
+}
+
+
 static SCOREP_Allocator_Page*
 page_manager_get_new_page( SCOREP_Allocator_PageManager* pageManager,
                            uint32_t                      minPageSize )
@@ -295,9 +611,17 @@ page_manager_get_new_page( SCOREP_Allocator_PageManager* pageManager,
     uint32_t order = get_order( pageManager->allocator, minPageSize );
     UTILS_DEBUG_ENTRY( "minPageSize=%" PRIu32 " -> order=%" PRIu32 "", minPageSize, order );
 
-    lock_allocator( pageManager->allocator );
-    SCOREP_Allocator_Page* page = get_page( pageManager->allocator, order );
-    unlock_allocator( pageManager->allocator );
+    SCOREP_Allocator_Page* page;
+    if ( order == 1 && pageManager->page_cache_size )
+    {
+        page = page_cache_get_page( pageManager );
+    }
+    else
+    {
+        lock_allocator( pageManager->allocator );
+        page = get_page( pageManager->allocator, order );
+        unlock_allocator( pageManager->allocator );
+    }
 
     if ( !page )
     {
@@ -368,18 +692,19 @@ SCOREP_Allocator_RoundupToAlignment( size_t size )
 }
 
 
-SCOREP_Allocator_Allocator*
-SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
-                                  uint32_t*                    pageSize,
-                                  SCOREP_Allocator_Guard       lockFunction,
-                                  SCOREP_Allocator_Guard       unlockFunction,
-                                  SCOREP_Allocator_GuardObject lockObject )
+static SCOREP_Allocator_Allocator*
+create_allocator( uint32_t*                    totalMemory,
+                  uint32_t*                    maxMemory,
+                  uint32_t*                    pageSize,
+                  SCOREP_Allocator_Guard       lockFunction,
+                  SCOREP_Allocator_Guard       unlockFunction,
+                  SCOREP_Allocator_GuardObject lockObject )
 {
     UTILS_DEBUG_ENTRY();
     *pageSize = npot( *pageSize );
 
-    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "0: m=%u p=%u",
-                        *totalMemory, *pageSize );
+    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "0: m=%u mx=%u p=%u",
+                        *totalMemory, *maxMemory, *pageSize );
 
     if ( *totalMemory <= *pageSize || *totalMemory == 0 || *pageSize == 0 || *pageSize < SCOREP_ALLOCATOR_ALIGNMENT )
     {
@@ -390,6 +715,10 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
     {
         return 0;
     }
+    if ( *maxMemory < *totalMemory )
+    {
+        *maxMemory = *totalMemory;
+    }
 
     uint32_t page_shift = 0;
     while ( ( *pageSize ) >> ( page_shift + 1 ) )
@@ -397,13 +726,34 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
         page_shift++;
     }
 
-    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "1: m=%u p=%u ps=%u",
-                        *totalMemory, *pageSize,
+    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "1: m=%u mx=%u p=%u ps=%u",
+                        *totalMemory, *maxMemory, *pageSize,
                         page_shift );
 
-    uint32_t n_pages = ( *totalMemory ) / ( *pageSize );
+    /* the pages committed initially */
+    uint32_t n_pages_initial = ( *totalMemory ) / ( *pageSize );
     /* round the total memory down to a multiple of pageSize */
-    *totalMemory = n_pages * ( *pageSize );
+    *totalMemory = n_pages_initial * ( *pageSize );
+
+    /* the pages we can grow to, page ids are relative to the start of the
+     * reserved range and therefore stay valid while growing */
+    uint32_t n_pages  = ( *maxMemory ) / ( *pageSize );
+    void*    raw      = NULL;
+    size_t   reserved = 0;
+    if ( n_pages > n_pages_initial )
+    {
+        reserved = ( size_t )n_pages << page_shift;
+        raw      = reserve_memory( reserved );
+        if ( !raw )
+        {
+            UTILS_WARNING( "Cannot reserve %zu bytes of address space, "
+                           "memory is restricted to %" PRIu32 " bytes.",
+                           reserved, *totalMemory );
+            reserved = 0;
+            n_pages  = n_pages_initial;
+        }
+    }
+    *maxMemory = n_pages * ( *pageSize );
 
     uint32_t n_pages_bits = 1;
     while ( n_pages >> ( n_pages_bits ) )
@@ -411,16 +761,16 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
         n_pages_bits++;
     }
 
-    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "2: m=%u p=%u ps=%u np=%u",
-                        *totalMemory, *pageSize,
-                        page_shift, n_pages );
+    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "2: m=%u mx=%u p=%u ps=%u np=%u npi=%u",
+                        *totalMemory, *maxMemory, *pageSize,
+                        page_shift, n_pages, n_pages_initial );
 
-    uint32_t maint_memory_needed = union_size() + bitset_size( n_pages );
+    uint32_t maint_memory_needed = allocator_size() + bitset_size( n_pages );
     maint_memory_needed = roundupto( maint_memory_needed, 64 ); // why 64?
     if ( ( *totalMemory ) <= maint_memory_needed )
     {
         /* too few memory to hold maintenance stuff */
-        return 0;
+        goto out_release;
     }
 
     UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "3: m=%u p=%u ps=%u np=%u mm=%u",
@@ -443,16 +793,17 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
                         already_used_pages,
                         ( double )( free_memory_in_last_page / union_size() ) / n_pages );
 
-    /* guarantee at least for .5% of the total number of pages pre-allocated page structs */ // why .5% ?
-    while ( ( free_memory_in_last_page / union_size() ) < ( n_pages / 200 ) )
+    /* guarantee at least for .5% of the total number of initial pages
+     * pre-allocated page structs, more are taken from maintenance pages */ // why .5% ?
+    while ( ( free_memory_in_last_page / union_size() ) < ( n_pages_initial / 200 ) )
     {
         already_used_pages++;
         free_memory_in_last_page += ( *pageSize );
     }
     /* we may loose one page because of alignment */
-    if ( already_used_pages >= ( n_pages - 1 ) )
+    if ( already_used_pages >= ( n_pages_initial - 1 ) )
     {
-        return 0;
+        goto out_release;
     }
 
     UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "5: m=%u p=%u ps=%u np=%u mm=%u fm=%u aup=%u puor=%f",
@@ -463,29 +814,53 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
                         already_used_pages,
                         ( double )( free_memory_in_last_page / union_size() ) / n_pages );
 
-    void* raw = calloc( 1, *totalMemory );
-    if ( !raw )
+    if ( raw )
     {
-        return 0;
+        /* reserved memory is zero-filled once committed, like from calloc */
+        char* initial_end = ( char* )roundupto( raw, *pageSize )
+                            + ( ( size_t )n_pages_initial << page_shift );
+        if ( initial_end > ( char* )raw + reserved )
+        {
+            initial_end = ( char* )raw + reserved;
+        }
+        if ( !commit_memory( raw, initial_end ) )
+        {
+            goto out_release;
+        }
+    }
+    else
+    {
+        raw = calloc( 1, *totalMemory );
+        if ( !raw )
+        {
+            return 0;
+        }
     }
     SCOREP_Allocator_Allocator* allocator = ( void* )roundupto( raw, *pageSize );
-    allocator->allocated_memory = raw;
-    allocator->page_shift       = page_shift;
-    allocator->n_pages_bits     = n_pages_bits;
-    allocator->n_pages_capacity = n_pages;
+    allocator->allocated_memory         = raw;
+    allocator->reserved_memory          = reserved;
+    allocator->page_shift               = page_shift;
+    allocator->n_pages_bits             = n_pages_bits;
+    allocator->n_pages_capacity         = n_pages;
+    allocator->n_pages_committed        = n_pages_initial;
+    allocator->n_pages_commit_increment = n_pages_initial;
     if ( allocator != allocator->allocated_memory )
     {
         /* we already ensured that we can loose one page */
         allocator->n_pages_capacity--;
+        allocator->n_pages_committed--;
     }
     allocator->n_pages_maintenance = already_used_pages;
-    allocator->free_objects        = NULL;
+    allocator->free_objects        = 0;
+    allocator->n_free_objects      = 0;
+    allocator->n_pages_cached      = 0;
 
     /* announce the final usable total memory back to the caller */
-    *totalMemory = allocator->n_pages_capacity << page_shift;
+    *totalMemory = allocator->n_pages_committed << page_shift;
+    *maxMemory   = allocator->n_pages_capacity << page_shift;
 
-    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "6: m=%u p=%u ps=%u np=%u mm=%u fm=%u aup=%u",
-                        *totalMemory, *pageSize,
+    UTILS_DEBUG_PRINTF( SCOREP_DEBUG_ALLOCATOR, "6: m=%u mx=%u p=%u ps=%u np=%u mm=%u fm=%u aup=%u",
+                        *totalMemory, *maxMemory, *pageSize,
                         page_shift, allocator->n_pages_capacity,
                         maint_memory_needed,
                         free_memory_in_last_page,
@@ -512,16 +887,60 @@ SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
 
     UTILS_DEBUG_EXIT();
     return allocator;
+
+out_release:
+#if HAVE( SYS_MMAN_H )
+    if ( raw )
+    {
+        munmap( raw, reserved );
+    }
+#endif
+    return 0;
+}
+
+
+SCOREP_Allocator_Allocator*
+SCOREP_Allocator_CreateAllocator( uint32_t*                    totalMemory,
+                                  uint32_t*                    pageSize,
+                                  SCOREP_Allocator_Guard       lockFunction,
+                                  SCOREP_Allocator_Guard       unlockFunction,
+                                  SCOREP_Allocator_GuardObject lockObject )
+{
+    uint32_t max_memory = *totalMemory;
+    return create_allocator( totalMemory, &max_memory, pageSize,
+                             lockFunction, unlockFunction, lockObject );
+}
+
+
+SCOREP_Allocator_Allocator*
+SCOREP_Allocator_CreateGrowableAllocator( uint32_t*                    totalMemory,
+                                          uint32_t*                    maxMemory,
+                                          uint32_t*                    pageSize,
+                                          SCOREP_Allocator_Guard       lockFunction,
+                                          SCOREP_Allocator_Guard       unlockFunction,
+                                          SCOREP_Allocator_GuardObject lockObject )
+{
+    return create_allocator( totalMemory, maxMemory, pageSize,
+                             lockFunction, unlockFunction, lockObject );
 }
 
 
 void
 SCOREP_Allocator_DeleteAllocator( SCOREP_Allocator_Allocator* allocator )
 {
-    if ( allocator )
+    if ( !allocator )
+    {
+        return;
+    }
+
+#if HAVE( SYS_MMAN_H )
+    if ( allocator->reserved_memory )
     {
-        free( allocator->allocated_memory );
+        munmap( allocator->allocated_memory, allocator->reserved_memory );
+        return;
     }
+#endif
+    free( allocator->allocated_memory );
 }
 
 
@@ -532,12 +951,20 @@ SCOREP_Allocator_GetMaxNumberOfPages( const SCOREP_Allocator_Allocator* allocato
 }
 
 
+uint32_t
+SCOREP_Allocator_GetNumberOfCommittedPages( SCOREP_Allocator_Allocator* allocator )
+{
+    lock_allocator( allocator );
+    uint32_t n_pages_committed = allocator->n_pages_committed;
+    unlock_allocator( allocator );
+    return n_pages_committed;
+}
+
+
 static inline SCOREP_Allocator_PageManager*
 get_page_manager( SCOREP_Allocator_Allocator* allocator )
 {
-    lock_allocator( allocator );
     SCOREP_Allocator_PageManager* page_manager = get_union_object( allocator );
-    unlock_allocator( allocator );
 
     if ( !page_manager )
     {
@@ -548,6 +975,9 @@ get_page_manager( SCOREP_Allocator_Allocator* allocator )
     page_manager->pages_in_use_list          = 0;
     page_manager->moved_page_id_mapping_page = 0;
     page_manager->last_allocation            = 0;
+    page_manager->page_cache                 = 0;
+    page_manager->n_cached_pages             = 0;
+    page_manager->page_cache_size            = 0;
 
     return page_manager;
 }
@@ -574,6 +1004,29 @@ SCOREP_Allocator_CreatePageManager( SCOREP_Allocator_Allocator* allocator )
 }
 
 
+SCOREP_Allocator_PageManager*
+SCOREP_Allocator_CreateCachedPageManager( SCOREP_Allocator_Allocator* allocator,
+                                          uint32_t                    pageCacheSize )
+{
+    UTILS_DEBUG_ENTRY();
+    assert( allocator );
+
+    SCOREP_Allocator_PageManager* page_manager = get_page_manager( allocator );
+    if ( !page_manager )
+    {
+        UTILS_DEBUG_EXIT( "out-of-memory: no union object" );
+        return 0;
+    }
+    page_manager->page_cache_size = pageCacheSize;
+
+    /* may fail, but maybe we have free pages later */
+    page_manager_get_new_page( page_manager, page_size( allocator ) );
+
+    UTILS_DEBUG_EXIT();
+    return page_manager;
+}
+
+
 SCOREP_Allocator_PageManager*
 SCOREP_Allocator_CreateMovedPageManager( SCOREP_Allocator_Allocator* allocator )
 {
@@ -620,27 +1073,45 @@ SCOREP_Allocator_DeletePageManager( SCOREP_Allocator_PageManager* pageManager )
     assert( pageManager );
     SCOREP_Allocator_Allocator* allocator = pageManager->allocator;
 
-    SCOREP_Allocator_Page* page = pageManager->pages_in_use_list;
+    SCOREP_Allocator_Page* cached_pages = page_cache_detach( pageManager );
     lock_allocator( allocator );
-    while ( page )
-    {
-        SCOREP_Allocator_Page* next_page = page->next;
-        put_page( allocator, page );
-        page = next_page;
-    }
+    put_pages( allocator, pageManager->pages_in_use_list );
+    put_pages( allocator, cached_pages );
 
     if ( pageManager->moved_page_id_mapping_page )
     {
         put_page( allocator, pageManager->moved_page_id_mapping_page );
     }
+    unlock_allocator( allocator );
 
     put_union_object( allocator, pageManager );
 
-    unlock_allocator( allocator );
     UTILS_DEBUG_EXIT();
 }
 
 
+void
+SCOREP_Allocator_MovePages( SCOREP_Allocator_PageManager* destination,
+                            SCOREP_Allocator_PageManager* source )
+{
+    assert( destination );
+    assert( source );
+    assert( destination->allocator == source->allocator );
+    assert( !destination->moved_page_id_mapping_page );
+    assert( !source->moved_page_id_mapping_page );
+
+    /* append, so that allocations still search the pages of destination first */
+    SCOREP_Allocator_Page** tail = &destination->pages_in_use_list;
+    while ( *tail )
+    {
+        tail = &( *tail )->next;
+    }
+    *tail                     = source->pages_in_use_list;
+    source->pages_in_use_list = 0;
+    source->last_allocation   = 0;
+}
+
+
 void*
 SCOREP_Allocator_Alloc( SCOREP_Allocator_PageManager* pageManager,
                         size_t                        memorySize )
@@ -668,14 +1139,40 @@ SCOREP_Allocator_Free( SCOREP_Allocator_PageManager* pageManager )
     assert( pageManager );
     assert( pageManager->allocator );
 
-    lock_allocator( pageManager->allocator );
+    /* keep single pages in the page cache, release all others */
+    SCOREP_Allocator_Page* release  = NULL;
+    uint32_t               n_cached = 0;
     while ( pageManager->pages_in_use_list )
     {
-        SCOREP_Allocator_Page* next_page = pageManager->pages_in_use_list->next;
-        put_page( pageManager->allocator, pageManager->pages_in_use_list );
-        pageManager->pages_in_use_list = next_page;
+        SCOREP_Allocator_Page* page = pageManager->pages_in_use_list;
+        pageManager->pages_in_use_list = page->next;
+        if ( pageManager->n_cached_pages < pageManager->page_cache_size
+             && get_page_order( page ) == 1 )
+        {
+            clear_page( page );
+            page->memory_alignment_loss = 0;
+            page->next                  = pageManager->page_cache;
+            pageManager->page_cache     = page;
+            pageManager->n_cached_pages++;
+            n_cached++;
+        }
+        else
+        {
+            page->next = release;
+            release    = page;
+        }
+    }
+    if ( n_cached )
+    {
+        UTILS_Atomic_AddFetch_uint32( &pageManager->allocator->n_pages_cached, n_cached,
+                                      UTILS_ATOMIC_RELAXED );
+    }
+    if ( release )
+    {
+        lock_allocator( pageManager->allocator );
+        put_pages( pageManager->allocator, release );
+        unlock_allocator( pageManager->allocator );
     }
-    unlock_allocator( pageManager->allocator );
 
     if ( pageManager->moved_page_id_mapping_page )
     {
@@ -861,19 +1358,19 @@ SCOREP_Allocator_GetStats( SCOREP_Allocator_Allocator*        allocator,
 
     lock_allocator( allocator );
 
+    /* pages in the page caches are taken from the allocator, but unused */
     pageStats->pages_allocated = allocator->n_pages_high_watermark;
-    pageStats->pages_used      = allocator->n_pages_allocated;
+    pageStats->pages_used      = allocator->n_pages_allocated
+                                 - UTILS_Atomic_LoadN_uint32( &allocator->n_pages_cached,
+                                                              UTILS_ATOMIC_RELAXED );
 
     maintStats->pages_allocated       = allocator->n_pages_maintenance;
     maintStats->pages_used            = maintStats->pages_allocated;
     maintStats->memory_allocated      = maintStats->pages_allocated * page_size( allocator );
     maintStats->memory_alignment_loss = ( char* )allocator - ( char* )allocator->allocated_memory;
-    SCOREP_Allocator_Object* free_obj = allocator->free_objects;
-    while ( free_obj )
-    {
-        maintStats->memory_available += union_size();
-        free_obj                      = free_obj->next;
-    }
+    maintStats->memory_available     += ( size_t )UTILS_Atomic_LoadN_uint32( &allocator->n_free_objects,
+                                                                            UTILS_ATOMIC_RELAXED )
+                                        * union_size();
     maintStats->memory_used = maintStats->memory_allocated - maintStats->memory_available;
 
     unlock_allocator( allocator );
@@ -918,6 +1415,14 @@ SCOREP_Allocator_GetPageManagerStats( SCOREP_Allocator_PageManager*      pageMan
         page = page->next;
     }
 
+    /* cached pages are allocated, but available */
+    page = pageManager->page_cache;
+    while ( page )
+    {
+        update_page_stats( page, stats );
+        page = page->next;
+    }
+
     if ( pageManager->moved_page_id_mapping_page ) /* moved page manager */
     {
         update_page_stats( pageManager->moved_page_id_mapping_page, stats );
@@ -69,17 +69,26 @@ struct SCOREP_Allocator_Page
 struct SCOREP_Allocator_Allocator
 {
     void*    allocated_memory;
+    /* size of the reserved address range, 0 if allocated_memory is from calloc */
+    size_t   reserved_memory;
     uint32_t page_shift;
     uint32_t n_pages_bits;
     uint32_t n_pages_capacity;
+    /* pages [0, n_pages_committed) are accessible */
+    uint32_t n_pages_committed;
+    /* minimum number of pages to commit when growing */
+    uint32_t n_pages_commit_increment;
     uint32_t n_pages_maintenance;
     uint32_t n_pages_high_watermark;
     uint32_t n_pages_allocated;
     //uint32_t union_size;
     //uint32_t reserved;
 
-    /** free objects */
-    SCOREP_Allocator_Object*     free_objects;
+    /** free objects, lock-free stack, see push_union_objects */
+    uint64_t                     free_objects;
+    uint32_t                     n_free_objects;
+    /** pages taken by the page caches of the page managers, but unused */
+    uint32_t                     n_pages_cached;
 
     SCOREP_Allocator_Guard       lock;
     SCOREP_Allocator_Guard       unlock;
@@ -101,6 +110,12 @@ struct SCOREP_Allocator_PageManager
     /* sentinel which allocation could be rolled back */
     /* only movable allocations currently */
     SCOREP_Allocator_MovableMemory last_allocation;
+
+    /* private stash of free single pages, refilled in batches from the
+     * allocator, without a need for the allocator lock */
+    uint32_t               n_cached_pages;
+    uint32_t               page_cache_size;
+    SCOREP_Allocator_Page* page_cache;
 };
 
 
@@ -120,7 +135,7 @@ union SCOREP_Allocator_Object
     union SCOREP_Allocator_Object*        next;
     /* 32: 28, 64: 48 */
     struct SCOREP_Allocator_Page          page;
-    /* 32: 16, 64: 32 */
+    /* 32: 28, 64: 48 */
     struct SCOREP_Allocator_PageManager   page_manager;
     /* 32: 16, 64: 32 */
     struct SCOREP_Allocator_ObjectManager object_manager;
@@ -0,0 +1,270 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Tests the allocation sampling of the memory adapter with fixed seeds: the
+ * exponentially distributed sample distances, the weights of the sampled
+ * allocations, and the counting filter over the sampled addresses.
+ */
+
+
+#include <config.h>
+
+#include <CuTest.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <scorep_memory_sampling.h>
+
+#define SEED UINT64_C( 42 )
+#define INTERVAL UINT64_C( 4096 )
+#define NUM_DRAWS 100000
+
+
+static void
+test_determinism( CuTest* tc )
+{
+    scorep_memory_sampler a;
+    scorep_memory_sampler b;
+    scorep_memory_sampler_init( &a, SEED, INTERVAL );
+    scorep_memory_sampler_init( &b, SEED, INTERVAL );
+    CuAssertTrue( tc, a.bytes_until_sample == b.bytes_until_sample );
+
+    for ( int i = 0; i < 1000; i++ )
+    {
+        CuAssertTrue( tc, scorep_memory_sampler_next_distance( &a, INTERVAL )
+                      == scorep_memory_sampler_next_distance( &b, INTERVAL ) );
+    }
+
+    /* The fixed point of xorshift must not be used as seed */
+    scorep_memory_sampler_init( &a, 0, INTERVAL );
+    CuAssertTrue( tc, a.random_state != 0 );
+    int64_t first = scorep_memory_sampler_next_distance( &a, INTERVAL );
+    int64_t other = first;
+    for ( int i = 0; i < 10 && other == first; i++ )
+    {
+        other = scorep_memory_sampler_next_distance( &a, INTERVAL );
+    }
+    CuAssertTrue( tc, other != first );
+}
+
+
+static void
+test_distance( CuTest* tc )
+{
+    scorep_memory_sampler sampler;
+    scorep_memory_sampler_init( &sampler, SEED, INTERVAL );
+
+    double sum    = 0;
+    double sum_sq = 0;
+    for ( int i = 0; i < NUM_DRAWS; i++ )
+    {
+        int64_t distance = scorep_memory_sampler_next_distance( &sampler, INTERVAL );
+        CuAssertTrue( tc, distance >= 1 );
+        sum    += distance;
+        sum_sq += ( double )distance * distance;
+    }
+
+    /* Exponentially distributed, thus the standard deviation equals the mean.
+     * The distances are truncated and shifted by one byte. */
+    double mean     = sum / NUM_DRAWS;
+    double variance = sum_sq / NUM_DRAWS - mean * mean;
+    CuAssertDblEquals( tc, INTERVAL + 0.5, mean, 0.02 * INTERVAL );
+    CuAssertDblEquals( tc, ( double )INTERVAL, sqrt( variance ), 0.03 * INTERVAL );
+
+    /* Half of the distances are below the median interval * ln 2 */
+    scorep_memory_sampler_init( &sampler, SEED, INTERVAL );
+    int below_median = 0;
+    for ( int i = 0; i < NUM_DRAWS; i++ )
+    {
+        below_median += scorep_memory_sampler_next_distance( &sampler, INTERVAL )
+                        <= INTERVAL * M_LN2;
+    }
+    CuAssertDblEquals( tc, 0.5, ( double )below_median / NUM_DRAWS, 0.01 );
+}
+
+
+static void
+test_weight( CuTest* tc )
+{
+    CuAssertTrue( tc, scorep_memory_sample_weight( 0, INTERVAL ) == 0 );
+
+    static const size_t sizes[] = { 1, 8, 64, 1000, 4096, 10000, 1 << 20 };
+    for ( size_t i = 0; i < sizeof( sizes ) / sizeof( sizes[ 0 ] ); i++ )
+    {
+        double probability = -expm1( -( double )sizes[ i ] / INTERVAL );
+        CuAssertTrue( tc, scorep_memory_sample_weight( sizes[ i ], INTERVAL )
+                      == ( uint64_t )( sizes[ i ] / probability + 0.5 ) );
+        CuAssertTrue( tc, scorep_memory_sample_weight( sizes[ i ], INTERVAL ) >= sizes[ i ] );
+    }
+
+    /* Small allocations represent about one interval, large ones themselves */
+    CuAssertTrue( tc, scorep_memory_sample_weight( 1, INTERVAL ) == INTERVAL + 1 );
+    CuAssertTrue( tc, scorep_memory_sample_weight( 1 << 20, INTERVAL ) == 1 << 20 );
+
+    /* expm1 keeps the precision, where 1 - exp() would cancel to zero */
+    CuAssertDblEquals( tc, ( double )( UINT64_C( 1 ) << 60 ),
+                       ( double )scorep_memory_sample_weight( 1, UINT64_C( 1 ) << 60 ), 1e3 );
+}
+
+
+static void
+check_estimate( CuTest* tc,
+                size_t  minSize,
+                size_t  maxSize )
+{
+    scorep_memory_sampler sampler;
+    scorep_memory_sampler_init( &sampler, SEED, INTERVAL );
+
+    double total    = 0;
+    double estimate = 0;
+    for ( uint32_t i = 0; i < 10 * NUM_DRAWS; i++ )
+    {
+        size_t   size = minSize + ( i * UINT32_C( 2654435761 ) ) % ( maxSize - minSize + 1 );
+        uint64_t weight;
+        if ( scorep_memory_sampler_sample( &sampler, INTERVAL, size, &weight ) )
+        {
+            estimate += weight;
+        }
+        else
+        {
+            CuAssertTrue( tc, weight == size );
+        }
+        CuAssertTrue( tc, sampler.bytes_until_sample > 0 );
+        total += size;
+    }
+
+    CuAssertDblEquals( tc, 1.0, estimate / total, 0.03 );
+}
+
+
+static void
+test_estimate( CuTest* tc )
+{
+    check_estimate( tc, 64, 64 );
+    check_estimate( tc, 16, 512 );
+    check_estimate( tc, 1000, 100000 );
+}
+
+
+static void
+test_large_allocation( CuTest* tc )
+{
+    scorep_memory_sampler sampler;
+    scorep_memory_sampler_init( &sampler, SEED, INTERVAL );
+
+    /* Spans many samples, but is recorded once with its own size */
+    uint64_t weight;
+    CuAssertTrue( tc, scorep_memory_sampler_sample( &sampler, INTERVAL, 100 * INTERVAL, &weight ) );
+    CuAssertTrue( tc, weight == 100 * INTERVAL );
+    CuAssertTrue( tc, sampler.bytes_until_sample > 0 );
+
+    /* The next sample is at the remaining distance */
+    int64_t remaining = sampler.bytes_until_sample;
+    if ( remaining > 1 )
+    {
+        CuAssertTrue( tc, !scorep_memory_sampler_sample( &sampler, INTERVAL, remaining - 1, &weight ) );
+        CuAssertTrue( tc, weight == ( uint64_t )remaining - 1 );
+    }
+    CuAssertTrue( tc, scorep_memory_sampler_sample( &sampler, INTERVAL, 1, &weight ) );
+    CuAssertTrue( tc, weight == scorep_memory_sample_weight( 1, INTERVAL ) );
+}
+
+
+#define NUM_ADDRESSES 1000
+
+static uint64_t
+get_address( uint32_t i )
+{
+    return 0x7f0000000000 + ( uint64_t )i * 16;
+}
+
+
+static void
+test_filter( CuTest* tc )
+{
+    memset( scorep_memory_sampled_filter, 0, sizeof( scorep_memory_sampled_filter ) );
+
+    /* Aligned addresses spread over the counters */
+    for ( uint32_t i = 0; i < NUM_ADDRESSES; i++ )
+    {
+        CuAssertTrue( tc, *scorep_memory_sampled_filter_counter( get_address( i ) ) == 0 );
+        ( *scorep_memory_sampled_filter_counter( get_address( i ) ) )++;
+    }
+    uint32_t used = 0;
+    for ( uint32_t i = 0; i < ( 1 << SCOREP_MEMORY_SAMPLED_FILTER_EXPONENT ); i++ )
+    {
+        used += scorep_memory_sampled_filter[ i ] != 0;
+    }
+    CuAssertTrue( tc, used >= NUM_ADDRESSES * 9 / 10 );
+
+    /* Sampled addresses always pass, unrelated ones only on collisions */
+    uint32_t false_positives = 0;
+    for ( uint32_t i = 0; i < NUM_ADDRESSES; i++ )
+    {
+        CuAssertTrue( tc, *scorep_memory_sampled_filter_counter( get_address( i ) ) != 0 );
+        false_positives +=
+            *scorep_memory_sampled_filter_counter( get_address( i + 10 * NUM_ADDRESSES ) ) != 0;
+    }
+    CuAssertTrue( tc, false_positives < NUM_ADDRESSES / 10 );
+
+    /* A counter covers several addresses, until all of them are gone */
+    for ( uint32_t i = 0; i < NUM_ADDRESSES; i += 2 )
+    {
+        ( *scorep_memory_sampled_filter_counter( get_address( i ) ) )--;
+    }
+    for ( uint32_t i = 1; i < NUM_ADDRESSES; i += 2 )
+    {
+        CuAssertTrue( tc, *scorep_memory_sampled_filter_counter( get_address( i ) ) != 0 );
+    }
+    for ( uint32_t i = 1; i < NUM_ADDRESSES; i += 2 )
+    {
+        ( *scorep_memory_sampled_filter_counter( get_address( i ) ) )--;
+    }
+    for ( uint32_t i = 0; i < ( 1 << SCOREP_MEMORY_SAMPLED_FILTER_EXPONENT ); i++ )
+    {
+        CuAssertTrue( tc, scorep_memory_sampled_filter[ i ] == 0 );
+    }
+}
+
+
+int
+main()
+{
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "memory sampling" );
+
+    SUITE_ADD_TEST_NAME( suite, test_determinism, "fixed seeds" );
+    SUITE_ADD_TEST_NAME( suite, test_distance, "exponential sample distances" );
+    SUITE_ADD_TEST_NAME( suite, test_weight, "weights of sampled allocations" );
+    SUITE_ADD_TEST_NAME( suite, test_estimate, "unbiased estimate of the total" );
+    SUITE_ADD_TEST_NAME( suite, test_large_allocation, "allocations spanning samples" );
+    SUITE_ADD_TEST_NAME( suite, test_filter, "filter over sampled addresses" );
+
+    CuSuiteRun( suite );
+    CuSuiteSummary( suite, output );
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
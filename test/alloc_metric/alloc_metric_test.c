@@ -0,0 +1,181 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Tests the address-sharded allocation tables of SCOREP_AllocMetric: lookups
+ * after the tables grew and removals inside collision clusters.
+ */
+
+
+#include <config.h>
+
+#include <CuTest.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <SCOREP_RuntimeManagement.h>
+#include <SCOREP_AllocMetric.h>
+
+#include <jenkins_hash.h>
+
+/* Needs to match SCOREP_AllocMetric.c */
+#define ALLOCATION_SHARDS_EXPONENT 6
+
+#define NUM_ALLOCATIONS 16384
+
+
+static uint64_t
+get_address( uint32_t i )
+{
+    return 0x10000 + ( uint64_t )i * 16;
+}
+
+
+/* Returns the i-th address, which falls into the first shard */
+static uint64_t
+get_colliding_address( uint32_t i )
+{
+    static uint64_t addresses[ NUM_ALLOCATIONS ];
+    static uint32_t count;
+    static uint64_t next = 0x10000;
+
+    while ( count <= i )
+    {
+        uint64_t addr = next;
+        next += 16;
+        if ( ( jenkins_hash( &addr, sizeof( addr ), 0 )
+               & hashmask( ALLOCATION_SHARDS_EXPONENT ) ) == 0 )
+        {
+            addresses[ count++ ] = addr;
+        }
+    }
+    return addresses[ i ];
+}
+
+
+/* Removes the allocation and returns its size, 0 if it was not found. */
+static uint64_t
+remove_allocation( SCOREP_AllocMetric* metric,
+                   uint64_t            addr )
+{
+    void* allocation;
+    if ( !SCOREP_AllocMetric_TryAcquireAlloc( metric, addr, &allocation ) )
+    {
+        return 0;
+    }
+    uint64_t size;
+    SCOREP_AllocMetric_HandleFree( metric, allocation, &size );
+    return size;
+}
+
+
+static void
+test_growth( CuTest* tc )
+{
+    SCOREP_AllocMetric* metric;
+    SCOREP_AllocMetric_New( "growth", &metric );
+
+    /* Each shard starts with 64 slots */
+    for ( uint32_t i = 0; i < NUM_ALLOCATIONS; i++ )
+    {
+        SCOREP_AllocMetric_HandleAlloc( metric, get_address( i ), i + 1 );
+    }
+
+    for ( uint32_t i = NUM_ALLOCATIONS; i-- > 0; )
+    {
+        CuAssertIntEquals( tc, i + 1, ( int )remove_allocation( metric, get_address( i ) ) );
+    }
+    for ( uint32_t i = 0; i < NUM_ALLOCATIONS; i++ )
+    {
+        CuAssertIntEquals( tc, 0, ( int )remove_allocation( metric, get_address( i ) ) );
+    }
+
+    SCOREP_AllocMetric_Destroy( metric );
+}
+
+
+static void
+test_remove_in_clusters( CuTest* tc )
+{
+    SCOREP_AllocMetric* metric;
+    SCOREP_AllocMetric* other;
+    SCOREP_AllocMetric_New( "clusters", &metric );
+    SCOREP_AllocMetric_New( "clusters other", &other );
+
+    /* All in one shard, which thus has long probe sequences, also wrapping
+     * around the end of the table. The same addresses in a second metric
+     * occupy further slots of the same clusters. */
+    uint32_t n = 1000;
+    for ( uint32_t i = 0; i < n; i++ )
+    {
+        SCOREP_AllocMetric_HandleAlloc( metric, get_colliding_address( i ), i + 1 );
+        SCOREP_AllocMetric_HandleAlloc( other, get_colliding_address( i ), n + i + 1 );
+    }
+
+    /* Leave holes, which the following entries need to be shifted into */
+    for ( uint32_t i = 0; i < n; i += 3 )
+    {
+        CuAssertIntEquals( tc, i + 1,
+                           ( int )remove_allocation( metric, get_colliding_address( i ) ) );
+    }
+
+    for ( uint32_t i = 0; i < n; i++ )
+    {
+        uint64_t expected = i % 3 == 0 ? 0 : i + 1;
+        CuAssertIntEquals( tc, ( int )expected,
+                           ( int )remove_allocation( metric, get_colliding_address( i ) ) );
+    }
+    for ( uint32_t i = 0; i < n; i++ )
+    {
+        CuAssertIntEquals( tc, n + i + 1,
+                           ( int )remove_allocation( other, get_colliding_address( i ) ) );
+    }
+
+    SCOREP_AllocMetric_Destroy( metric );
+    SCOREP_AllocMetric_Destroy( other );
+}
+
+
+int
+main()
+{
+    /* Only the tables are tested, no substrate needs to see the events */
+    setenv( "SCOREP_ENABLE_PROFILING", "false", 1 );
+    setenv( "SCOREP_ENABLE_TRACING", "false", 1 );
+
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "SCOREP_AllocMetric" );
+
+    SUITE_ADD_TEST_NAME( suite, test_growth, "lookups after the tables grew" );
+    SUITE_ADD_TEST_NAME( suite, test_remove_in_clusters, "removal within clusters" );
+
+    SCOREP_InitMeasurement();
+
+    CuSuiteRun( suite );
+
+    SCOREP_FinalizeMeasurement();
+
+    CuSuiteSummary( suite, output );
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
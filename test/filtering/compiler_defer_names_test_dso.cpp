@@ -0,0 +1,31 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+#include <iostream>
+
+using std::cout;
+
+namespace Deferred
+{
+void
+dlclosed_visible()
+{
+    cout << "V";
+}
+}
+
+extern "C" {
+void
+dso_entry()
+{
+    Deferred::dlclosed_visible();
+}
+};
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include <dlfcn.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+namespace Kokkos
+{
+namespace Tools
+{
+void
+hidden();
+}
+
+namespace Profiling
+{
+void
+hidden();
+}
+
+void
+visible();
+}
+
+extern "C"
+{
+void
+pomp_hidden();
+
+void
+Pomp_hidden();
+
+void
+POMP_hidden();
+
+void
+visible_pomp();
+};
+
+int
+main( int argc, char** argv )
+{
+    if ( argc != 2 )
+    {
+        cerr << "Usage: " << argv[ 0 ] << " <shared object>" << endl;
+        return EXIT_FAILURE;
+    }
+
+    Kokkos::Tools::hidden();
+    Kokkos::Profiling::hidden();
+    Kokkos::visible();
+    pomp_hidden();
+    Pomp_hidden();
+    POMP_hidden();
+    visible_pomp();
+
+    /* The names of the regions of the shared object are resolved at dlclose */
+    void* handle = dlopen( argv[ 1 ], RTLD_NOW );
+    if ( !handle )
+    {
+        cerr << dlerror() << endl;
+        return EXIT_FAILURE;
+    }
+    void ( * dso_entry )( void ) = ( void ( * )( void ) )dlsym( handle, "dso_entry" );
+    if ( !dso_entry )
+    {
+        cerr << dlerror() << endl;
+        return EXIT_FAILURE;
+    }
+    dso_entry();
+    dlclose( handle );
+
+    cout << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Submits requests to a real io_uring instance through the raw system calls:
+ * a write and a read of a file, a submission the kernel only consumes
+ * partially, and a ring closed while another thread waits in io_uring_enter.
+ *
+ * Exits with 77 if the kernel does not provide io_uring.
+ */
+
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/io_uring.h>
+
+#define BYTES_PER_IO_OP 128
+#define TEST_FILE       "scorep_io_uring_test.dat"
+
+typedef struct ring
+{
+    int                  fd;
+    unsigned*            sq_head;
+    unsigned*            sq_tail;
+    unsigned*            sq_mask;
+    unsigned*            sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned*            cq_head;
+    unsigned*            cq_tail;
+    unsigned*            cq_mask;
+    struct io_uring_cqe* cqes;
+} ring;
+
+static void
+check( int         condition,
+       const char* what )
+{
+    if ( !condition )
+    {
+        fprintf( stderr, "io_uring test: %s failed: %s\n", what, strerror( errno ) );
+        exit( EXIT_FAILURE );
+    }
+}
+
+static int
+ring_setup( ring* r )
+{
+    struct io_uring_params params;
+    memset( &params, 0, sizeof( params ) );
+
+    r->fd = syscall( SYS_io_uring_setup, 8, &params );
+    if ( r->fd < 0 )
+    {
+        return -1;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+    if ( params.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        sq_size = cq_size = sq_size > cq_size ? sq_size : cq_size;
+    }
+
+    char* sq = mmap( NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->fd, IORING_OFF_SQ_RING );
+    check( sq != MAP_FAILED, "mmap of the submission queue" );
+    char* cq = sq;
+    if ( !( params.features & IORING_FEAT_SINGLE_MMAP ) )
+    {
+        cq = mmap( NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   r->fd, IORING_OFF_CQ_RING );
+        check( cq != MAP_FAILED, "mmap of the completion queue" );
+    }
+    r->sqes = mmap( NULL, params.sq_entries * sizeof( struct io_uring_sqe ),
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    r->fd, IORING_OFF_SQES );
+    check( r->sqes != MAP_FAILED, "mmap of the submission queue entries" );
+
+    r->sq_head  = ( unsigned* )( sq + params.sq_off.head );
+    r->sq_tail  = ( unsigned* )( sq + params.sq_off.tail );
+    r->sq_mask  = ( unsigned* )( sq + params.sq_off.ring_mask );
+    r->sq_array = ( unsigned* )( sq + params.sq_off.array );
+    r->cq_head  = ( unsigned* )( cq + params.cq_off.head );
+    r->cq_tail  = ( unsigned* )( cq + params.cq_off.tail );
+    r->cq_mask  = ( unsigned* )( cq + params.cq_off.ring_mask );
+    r->cqes     = ( struct io_uring_cqe* )( cq + params.cq_off.cqes );
+
+    return 0;
+}
+
+static void
+ring_push( ring*    r,
+           uint8_t  opcode,
+           int      fd,
+           void*    buffer,
+           unsigned len,
+           uint64_t offset,
+           uint64_t userData )
+{
+    unsigned tail  = *r->sq_tail;
+    unsigned index = tail & *r->sq_mask;
+
+    struct io_uring_sqe* sqe = &r->sqes[ index ];
+    memset( sqe, 0, sizeof( *sqe ) );
+    sqe->opcode    = opcode;
+    sqe->fd        = fd;
+    sqe->addr      = ( uintptr_t )buffer;
+    sqe->len       = len;
+    sqe->off       = offset;
+    sqe->user_data = userData;
+
+    r->sq_array[ index ] = index;
+    __atomic_store_n( r->sq_tail, tail + 1, __ATOMIC_RELEASE );
+}
+
+static int
+ring_enter( ring*    r,
+            unsigned toSubmit,
+            unsigned minComplete )
+{
+    return syscall( SYS_io_uring_enter, r->fd, toSubmit, minComplete,
+                    minComplete ? IORING_ENTER_GETEVENTS : 0, NULL, 0 );
+}
+
+/* Consumes one completion and checks its result. */
+static void
+ring_pop( ring*    r,
+          uint64_t userData )
+{
+    unsigned head = *r->cq_head;
+    check( head != __atomic_load_n( r->cq_tail, __ATOMIC_ACQUIRE ), "waiting for a completion" );
+
+    struct io_uring_cqe* cqe = &r->cqes[ head & *r->cq_mask ];
+    errno = cqe->res < 0 ? -cqe->res : 0;
+    check( cqe->user_data == userData && cqe->res == BYTES_PER_IO_OP, "request" );
+
+    __atomic_store_n( r->cq_head, head + 1, __ATOMIC_RELEASE );
+}
+
+static void
+test_read_write( void )
+{
+    ring r;
+    check( ring_setup( &r ) == 0, "io_uring_setup" );
+
+    int fd = open( TEST_FILE, O_RDWR | O_CREAT | O_TRUNC, 0600 );
+    check( fd >= 0, "open" );
+
+    char out[ BYTES_PER_IO_OP ];
+    char in[ BYTES_PER_IO_OP ];
+    memset( out, 'x', sizeof( out ) );
+
+    /* One request per io_uring_enter */
+    ring_push( &r, IORING_OP_WRITE, fd, out, BYTES_PER_IO_OP, 0, 1 );
+    check( ring_enter( &r, 1, 1 ) == 1, "io_uring_enter of a write" );
+    ring_pop( &r, 1 );
+
+    ring_push( &r, IORING_OP_READ, fd, in, BYTES_PER_IO_OP, 0, 2 );
+    check( ring_enter( &r, 1, 1 ) == 1, "io_uring_enter of a read" );
+    ring_pop( &r, 2 );
+    check( memcmp( in, out, BYTES_PER_IO_OP ) == 0, "read back" );
+
+    /* Two queued requests, the first io_uring_enter submits only one */
+    ring_push( &r, IORING_OP_WRITE, fd, out, BYTES_PER_IO_OP, BYTES_PER_IO_OP, 3 );
+    ring_push( &r, IORING_OP_READ, fd, in, BYTES_PER_IO_OP, 0, 4 );
+    check( ring_enter( &r, 1, 1 ) == 1, "io_uring_enter of the first request" );
+    ring_pop( &r, 3 );
+    check( ring_enter( &r, 1, 1 ) == 1, "io_uring_enter of the second request" );
+    ring_pop( &r, 4 );
+
+    close( fd );
+    close( r.fd );
+    unlink( TEST_FILE );
+}
+
+static void*
+wait_for_read( void* arg )
+{
+    ring* r = arg;
+    /* Returns, once the pipe is written, even if the ring was closed */
+    ring_enter( r, 1, 1 );
+    return NULL;
+}
+
+static void
+test_close_during_enter( void )
+{
+    ring r;
+    check( ring_setup( &r ) == 0, "io_uring_setup" );
+
+    int pipe_fds[ 2 ];
+    check( pipe( pipe_fds ) == 0, "pipe" );
+
+    char buffer[ BYTES_PER_IO_OP ];
+    ring_push( &r, IORING_OP_READ, pipe_fds[ 0 ], buffer, BYTES_PER_IO_OP, ( uint64_t )-1, 5 );
+
+    pthread_t thread;
+    check( pthread_create( &thread, NULL, wait_for_read, &r ) == 0, "pthread_create" );
+
+    /* Close the ring, once the request is consumed and the thread waits */
+    while ( __atomic_load_n( r.sq_head, __ATOMIC_ACQUIRE ) != *r.sq_tail )
+    {
+        usleep( 1000 );
+    }
+    usleep( 10000 );
+    check( close( r.fd ) == 0, "close of the ring" );
+
+    memset( buffer, 'y', sizeof( buffer ) );
+    check( write( pipe_fds[ 1 ], buffer, BYTES_PER_IO_OP ) == BYTES_PER_IO_OP, "write to the pipe" );
+    check( pthread_join( thread, NULL ) == 0, "pthread_join" );
+
+    close( pipe_fds[ 0 ] );
+    close( pipe_fds[ 1 ] );
+}
+
+int
+main()
+{
+    ring r;
+    if ( ring_setup( &r ) != 0 )
+    {
+        printf( "io_uring not available: %s\n", strerror( errno ) );
+        return 77;
+    }
+    close( r.fd );
+
+    test_read_write();
+    test_close_during_enter();
+
+    return EXIT_SUCCESS;
+}
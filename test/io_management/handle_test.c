@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2013, 2015, 2019, 2023,
+ * Copyright (c) 2009-2013, 2015, 2019, 2023-2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -448,6 +448,81 @@ tc_duplicate_handle( CuTest* tc )
     SCOREP_IoMgmt_DestroyHandle( new_handle );
 }
 
+static SCOREP_IoHandleHandle
+create_handle( SCOREP_IoParadigmType paradigm,
+               SCOREP_IoFileHandle   file,
+               const void*           ioHandle )
+{
+    SCOREP_IoMgmt_BeginHandleCreation( paradigm,
+                                       SCOREP_IO_HANDLE_FLAG_NONE,
+                                       SCOREP_INVALID_INTERIM_COMMUNICATOR,
+                                       "" );
+    return SCOREP_IoMgmt_CompleteHandleCreation( paradigm, file, 0, ioHandle );
+}
+
+#define NUM_STREAMS 1000
+
+static void
+tc_many_stream_handles( CuTest* tc )
+{
+    /* Enough handles to grow the hash table several times */
+    static SCOREP_IoHandleHandle handles[ NUM_STREAMS ];
+    static char                  streams[ NUM_STREAMS ];
+    SCOREP_IoFileHandle          file = SCOREP_Definitions_NewIoFile( "/tmp", SCOREP_INVALID_SYSTEM_TREE_NODE );
+
+    for ( int i = 0; i < NUM_STREAMS; i++ )
+    {
+        void* stream = &streams[ i ];
+        handles[ i ] = create_handle( SCOREP_IO_PARADIGM_ISOC, file, &stream );
+        CuAssertIntNotEquals( tc, handles[ i ], SCOREP_INVALID_IO_HANDLE );
+    }
+    for ( int i = 0; i < NUM_STREAMS; i += 2 )
+    {
+        void* stream = &streams[ i ];
+        CuAssertIntEquals( tc, SCOREP_IoMgmt_RemoveHandle( SCOREP_IO_PARADIGM_ISOC, &stream ),
+                           handles[ i ] );
+        SCOREP_IoMgmt_DestroyHandle( handles[ i ] );
+    }
+    for ( int i = 0; i < NUM_STREAMS; i++ )
+    {
+        void* stream = &streams[ i ];
+        CuAssertIntEquals( tc, SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_ISOC, &stream ),
+                           i % 2 ? handles[ i ] : SCOREP_INVALID_IO_HANDLE );
+    }
+    for ( int i = 1; i < NUM_STREAMS; i += 2 )
+    {
+        void* stream = &streams[ i ];
+        CuAssertIntEquals( tc, SCOREP_IoMgmt_RemoveHandle( SCOREP_IO_PARADIGM_ISOC, &stream ),
+                           handles[ i ] );
+        CuAssertIntEquals( tc, SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_ISOC, &stream ),
+                           SCOREP_INVALID_IO_HANDLE );
+        SCOREP_IoMgmt_DestroyHandle( handles[ i ] );
+    }
+}
+
+static void
+tc_large_fd_handle( CuTest* tc )
+{
+    /* Beyond the direct-indexed file descriptors */
+    int                 fds[] = { 1 << 30, ( 1 << 30 ) + 1, 1023, 1024 };
+    SCOREP_IoFileHandle file  = SCOREP_Definitions_NewIoFile( "/tmp", SCOREP_INVALID_SYSTEM_TREE_NODE );
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        SCOREP_IoHandleHandle handle = create_handle( SCOREP_IO_PARADIGM_POSIX, file, &fds[ i ] );
+        CuAssertIntEquals( tc, SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fds[ i ] ),
+                           handle );
+    }
+    for ( int i = 0; i < 4; i++ )
+    {
+        SCOREP_IoHandleHandle handle = SCOREP_IoMgmt_RemoveHandle( SCOREP_IO_PARADIGM_POSIX, &fds[ i ] );
+        CuAssertIntNotEquals( tc, handle, SCOREP_INVALID_IO_HANDLE );
+        CuAssertIntEquals( tc, SCOREP_IoMgmt_GetIoHandle( SCOREP_IO_PARADIGM_POSIX, &fds[ i ] ),
+                           SCOREP_INVALID_IO_HANDLE );
+        SCOREP_IoMgmt_DestroyHandle( handle );
+    }
+}
+
 static inline void
 init( void )
 {
@@ -458,11 +533,18 @@ init( void )
                                     sizeof( int ),
                                     SCOREP_IO_PARADIGM_PROPERTY_VERSION, "2.3",
                                     SCOREP_INVALID_IO_PARADIGM_PROPERTY );
+    SCOREP_IoMgmt_RegisterParadigm( SCOREP_IO_PARADIGM_ISOC,
+                                    SCOREP_IO_PARADIGM_CLASS_SERIAL,
+                                    "ISO C I/O",
+                                    SCOREP_IO_PARADIGM_FLAG_NONE,
+                                    sizeof( void* ),
+                                    SCOREP_INVALID_IO_PARADIGM_PROPERTY );
 }
 
 static inline void
 fini( void )
 {
+    SCOREP_IoMgmt_DeregisterParadigm( SCOREP_IO_PARADIGM_ISOC );
     SCOREP_IoMgmt_DeregisterParadigm( SCOREP_IO_PARADIGM_POSIX );
 }
 
@@ -497,6 +579,8 @@ main()
     SUITE_ADD_TEST_NAME( suite, tc_reinsert_handle, "mgmt: reinsert handle" );
     SUITE_ADD_TEST_NAME( suite, tc_remove_handle, "mgmt: remove handle" );
     SUITE_ADD_TEST_NAME( suite, tc_duplicate_handle, "mgmt: duplicate handle" );
+    SUITE_ADD_TEST_NAME( suite, tc_many_stream_handles, "mgmt: many stream handles" );
+    SUITE_ADD_TEST_NAME( suite, tc_large_fd_handle, "mgmt: large fd handle" );
     SUITE_ADD_TEST_NAME( suite, tc_open, "wrapper: open" );
     SUITE_ADD_TEST_NAME( suite, tc_close, "wrapper: close" );
     SUITE_ADD_TEST_NAME( suite, tc_duplicate, "wrapper: duplicate" );
@@ -0,0 +1,250 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Tests the table of memory-mapped files of the POSIX I/O adapter: partial
+ * unmaps, splits, and mappings replacing others.
+ */
+
+
+#include <config.h>
+
+#include <CuTest.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <scorep_posix_io_mapping.h>
+
+#define PAGE 4096
+#define BASE ( ( uintptr_t )0x10000000 )
+
+#define MAX_RELEASED 16
+
+static SCOREP_IoHandleHandle released[ MAX_RELEASED ];
+static uint32_t              released_count;
+
+void
+scorep_posix_io_mapping_release( SCOREP_IoHandleHandle handle )
+{
+    if ( released_count < MAX_RELEASED )
+    {
+        released[ released_count ] = handle;
+    }
+    released_count++;
+}
+
+static void
+reset( void )
+{
+    scorep_posix_io_mapping_table_clear();
+    released_count = 0;
+}
+
+static uintptr_t
+page( uint32_t i )
+{
+    return BASE + ( uintptr_t )i * PAGE;
+}
+
+/* Checks, that the page @a i belongs to @a handle at file offset @a offset */
+static void
+check_page( CuTest*               tc,
+            uint32_t              i,
+            SCOREP_IoHandleHandle handle,
+            uint64_t              offset )
+{
+    SCOREP_IoHandleHandle found_handle = 0;
+    uint64_t              found_offset = 0;
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_find( page( i ), page( i + 1 ),
+                                                          &found_handle, &found_offset ) );
+    CuAssertIntEquals( tc, handle, found_handle );
+    CuAssertTrue( tc, found_offset == offset );
+}
+
+static void
+check_unmapped( CuTest*  tc,
+                uint32_t i )
+{
+    SCOREP_IoHandleHandle found_handle;
+    uint64_t              found_offset;
+    CuAssertTrue( tc, !scorep_posix_io_mapping_table_find( page( i ), page( i + 1 ),
+                                                           &found_handle, &found_offset ) );
+}
+
+
+static void
+test_partial_unmap( CuTest* tc )
+{
+    reset();
+
+    /* Pages 0-3 of file 1 at offset 8 pages */
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 0 ), page( 4 ), 8 * PAGE, 1 ) );
+
+    /* Unmapping the head and the tail keeps the offsets of the rest */
+    scorep_posix_io_mapping_table_remove( page( 0 ), page( 1 ), true );
+    scorep_posix_io_mapping_table_remove( page( 3 ), page( 4 ), true );
+    check_unmapped( tc, 0 );
+    check_page( tc, 1, 1, 9 * PAGE );
+    check_page( tc, 2, 1, 10 * PAGE );
+    check_unmapped( tc, 3 );
+    CuAssertIntEquals( tc, 0, released_count );
+
+    /* A lookup within a page reports the offset of the address */
+    SCOREP_IoHandleHandle handle;
+    uint64_t              offset;
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_find( page( 2 ) + 100, page( 2 ) + 200,
+                                                          &handle, &offset ) );
+    CuAssertTrue( tc, offset == 10 * PAGE + 100 );
+
+    /* A range starting before the mapping reports its first byte */
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_find( page( 0 ), page( 2 ), &handle, &offset ) );
+    CuAssertTrue( tc, offset == 9 * PAGE );
+
+    /* The handle is released with the last page */
+    scorep_posix_io_mapping_table_remove( page( 0 ), page( 8 ), true );
+    check_unmapped( tc, 1 );
+    check_unmapped( tc, 2 );
+    CuAssertIntEquals( tc, 1, released_count );
+    CuAssertIntEquals( tc, 1, released[ 0 ] );
+}
+
+
+static void
+test_split( CuTest* tc )
+{
+    reset();
+
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 0 ), page( 8 ), 0, 1 ) );
+
+    /* Punch two holes, the mapping is split into three parts */
+    scorep_posix_io_mapping_table_remove( page( 2 ), page( 3 ), true );
+    scorep_posix_io_mapping_table_remove( page( 5 ), page( 6 ), true );
+    check_page( tc, 1, 1, 1 * PAGE );
+    check_unmapped( tc, 2 );
+    check_page( tc, 3, 1, 3 * PAGE );
+    check_page( tc, 4, 1, 4 * PAGE );
+    check_unmapped( tc, 5 );
+    check_page( tc, 6, 1, 6 * PAGE );
+    check_page( tc, 7, 1, 7 * PAGE );
+
+    /* The parts share the handle, it is released with the last one */
+    scorep_posix_io_mapping_table_remove( page( 0 ), page( 2 ), true );
+    scorep_posix_io_mapping_table_remove( page( 6 ), page( 8 ), true );
+    CuAssertIntEquals( tc, 0, released_count );
+    check_page( tc, 4, 1, 4 * PAGE );
+
+    scorep_posix_io_mapping_table_remove( page( 3 ), page( 5 ), true );
+    CuAssertIntEquals( tc, 1, released_count );
+    CuAssertIntEquals( tc, 1, released[ 0 ] );
+}
+
+
+static void
+test_overlap( CuTest* tc )
+{
+    reset();
+
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 0 ), page( 4 ), 0, 1 ) );
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 4 ), page( 8 ), 0, 2 ) );
+
+    /* A new mapping over the boundary trims both */
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 3 ), page( 5 ), 16 * PAGE, 3 ) );
+    check_page( tc, 2, 1, 2 * PAGE );
+    check_page( tc, 3, 3, 16 * PAGE );
+    check_page( tc, 4, 3, 17 * PAGE );
+    check_page( tc, 5, 2, 1 * PAGE );
+    CuAssertIntEquals( tc, 0, released_count );
+
+    /* A new mapping inside another one splits it */
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 6 ), page( 7 ), 0, 4 ) );
+    check_page( tc, 5, 2, 1 * PAGE );
+    check_page( tc, 6, 4, 0 );
+    check_page( tc, 7, 2, 3 * PAGE );
+
+    /* A new mapping covering others replaces them completely */
+    CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 3 ), page( 8 ), 0, 5 ) );
+    CuAssertIntEquals( tc, 3, released_count );
+    CuAssertIntEquals( tc, 3, released[ 0 ] );
+    CuAssertIntEquals( tc, 4, released[ 1 ] );
+    CuAssertIntEquals( tc, 2, released[ 2 ] );
+    check_page( tc, 2, 1, 2 * PAGE );
+    for ( uint32_t i = 3; i < 8; i++ )
+    {
+        check_page( tc, i, 5, ( i - 3 ) * PAGE );
+    }
+
+    /* An anonymous mapping over a recorded range outside of the measurement
+     * forgets it, without releasing the handles */
+    scorep_posix_io_mapping_table_remove( page( 0 ), page( 8 ), false );
+    for ( uint32_t i = 0; i < 8; i++ )
+    {
+        check_unmapped( tc, i );
+    }
+    CuAssertIntEquals( tc, 3, released_count );
+}
+
+
+static void
+test_many_mappings( CuTest* tc )
+{
+    reset();
+
+    /* Every other page, enough to grow the table */
+    for ( uint32_t i = 0; i < 200; i++ )
+    {
+        CuAssertTrue( tc, scorep_posix_io_mapping_table_insert( page( 2 * i ), page( 2 * i + 1 ),
+                                                                i * PAGE, i + 1 ) );
+    }
+    for ( uint32_t i = 0; i < 200; i++ )
+    {
+        check_page( tc, 2 * i, i + 1, i * PAGE );
+        check_unmapped( tc, 2 * i + 1 );
+    }
+
+    /* One unmap over all of them */
+    scorep_posix_io_mapping_table_remove( page( 1 ), page( 398 ), true );
+    check_page( tc, 0, 1, 0 );
+    check_page( tc, 398, 200, 199 * PAGE );
+    CuAssertIntEquals( tc, 198, released_count );
+
+    reset();
+    check_unmapped( tc, 0 );
+}
+
+
+int
+main()
+{
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "POSIX I/O memory mappings" );
+
+    SUITE_ADD_TEST_NAME( suite, test_partial_unmap, "partial unmap" );
+    SUITE_ADD_TEST_NAME( suite, test_split, "split mappings" );
+    SUITE_ADD_TEST_NAME( suite, test_overlap, "overlapping mappings" );
+    SUITE_ADD_TEST_NAME( suite, test_many_mappings, "many mappings" );
+
+    CuSuiteRun( suite );
+    CuSuiteSummary( suite, output );
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
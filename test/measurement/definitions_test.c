@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2011,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2011, 2014,
+ * Copyright (c) 2009-2011, 2014, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2011,
@@ -41,9 +41,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include <SCOREP_Definitions.h>
 #include <SCOREP_Memory.h>
+#include <SCOREP_Substrates_Management.h>
 
 /* *INDENT-OFF* */
 /* *INDENT-ON*  */
@@ -253,6 +255,255 @@ test_1( CuTest* tc )
 }
 
 
+/* Tests below use the real definition manager */
+static void
+measurement_initialize( void )
+{
+    SCOREP_Substrates_EarlyInitialize();
+    SCOREP_Memory_Initialize( 16 * 1024 * 1024, 16 * 1024 * 1024, 8192 );
+    SCOREP_Definitions_Initialize();
+}
+
+
+static void
+measurement_finalize( void )
+{
+    SCOREP_Definitions_Finalize();
+    SCOREP_Memory_Finalize();
+}
+
+
+#define NUM_THREADS     8
+#define NUM_DEFINITIONS 2000
+
+typedef struct
+{
+    int                 thread_id;
+    pthread_barrier_t*  barrier;
+    SCOREP_StringHandle strings[ NUM_DEFINITIONS ];
+    SCOREP_RegionHandle regions[ NUM_DEFINITIONS ];
+} define_thread_args;
+
+
+static void*
+define_thread( void* arg )
+{
+    define_thread_args* args = arg;
+    char                name[ 32 ];
+
+    pthread_barrier_wait( args->barrier );
+
+    /* All threads define the same names, but starting at different offsets */
+    for ( int j = 0; j < NUM_DEFINITIONS; j++ )
+    {
+        int i = ( j + args->thread_id * NUM_DEFINITIONS / NUM_THREADS ) % NUM_DEFINITIONS;
+        sprintf( name, "name_%d", i );
+        args->strings[ i ] = SCOREP_Definitions_NewString( name );
+        args->regions[ i ] = SCOREP_Definitions_NewRegion( name,
+                                                           NULL,
+                                                           SCOREP_INVALID_SOURCE_FILE,
+                                                           i,
+                                                           i,
+                                                           SCOREP_PARADIGM_USER,
+                                                           SCOREP_REGION_FUNCTION );
+    }
+
+    return NULL;
+}
+
+
+static void
+test_concurrent_definitions( CuTest* tc )
+{
+    measurement_initialize();
+
+    uint32_t string_counter = scorep_local_definition_manager.string.counter;
+    uint32_t region_counter = scorep_local_definition_manager.region.counter;
+
+    pthread_barrier_t   barrier;
+    pthread_t           threads[ NUM_THREADS ];
+    define_thread_args* args = calloc( NUM_THREADS, sizeof( *args ) );
+    CuAssertPtrNotNull( tc, args );
+
+    pthread_barrier_init( &barrier, NULL, NUM_THREADS );
+    for ( int t = 0; t < NUM_THREADS; t++ )
+    {
+        args[ t ].thread_id = t;
+        args[ t ].barrier   = &barrier;
+        CuAssertIntEquals( tc, 0, pthread_create( &threads[ t ], NULL, define_thread, &args[ t ] ) );
+    }
+    for ( int t = 0; t < NUM_THREADS; t++ )
+    {
+        pthread_join( threads[ t ], NULL );
+    }
+    pthread_barrier_destroy( &barrier );
+
+    char name[ 32 ];
+    for ( int i = 0; i < NUM_DEFINITIONS; i++ )
+    {
+        sprintf( name, "name_%d", i );
+        CuAssertStrEquals( tc, name, SCOREP_StringHandle_Get( args[ 0 ].strings[ i ] ) );
+        CuAssertStrEquals( tc, name, SCOREP_RegionHandle_GetName( args[ 0 ].regions[ i ] ) );
+        for ( int t = 1; t < NUM_THREADS; t++ )
+        {
+            CuAssert( tc, "threads got different string handles",
+                      args[ t ].strings[ i ] == args[ 0 ].strings[ i ] );
+            CuAssert( tc, "threads got different region handles",
+                      args[ t ].regions[ i ] == args[ 0 ].regions[ i ] );
+        }
+    }
+
+    /* No duplicates were added */
+    CuAssertIntEquals( tc, string_counter + NUM_DEFINITIONS,
+                       scorep_local_definition_manager.string.counter );
+    CuAssertIntEquals( tc, region_counter + NUM_DEFINITIONS,
+                       scorep_local_definition_manager.region.counter );
+
+    free( args );
+    measurement_finalize();
+}
+
+
+static void*
+define_string_thread( void* arg )
+{
+    /* A new thread starts with an empty lookup cache */
+    *( SCOREP_StringHandle* )arg = SCOREP_Definitions_NewString( "cached" );
+    return NULL;
+}
+
+
+static SCOREP_StringHandle
+define_string_in_new_thread( void )
+{
+    SCOREP_StringHandle handle = SCOREP_INVALID_STRING;
+    pthread_t           thread;
+    pthread_create( &thread, NULL, define_string_thread, &handle );
+    pthread_join( thread, NULL );
+    return handle;
+}
+
+
+static void
+test_lookup_caches( CuTest* tc )
+{
+    measurement_initialize();
+
+    scorep_definitions_manager_entry* entry = &scorep_local_definition_manager.string;
+
+    /* The second call is answered by the cache of this thread */
+    SCOREP_StringHandle cached = SCOREP_Definitions_NewString( "cached" );
+    CuAssert( tc, "cache returned a different handle",
+              cached == SCOREP_Definitions_NewString( "cached" ) );
+    CuAssert( tc, "cache and manager disagree",
+              cached == scorep_definitions_new_string( &scorep_local_definition_manager, "cached" ) );
+    CuAssert( tc, "cache and other thread disagree",
+              cached == define_string_in_new_thread() );
+
+    /* Grow the hash table, evicting most slots of the cache */
+    uint32_t initial_mask = entry->hash_table_mask;
+    char     name[ 32 ];
+    for ( int i = 0; i < 5000; i++ )
+    {
+        sprintf( name, "string_%d", i );
+        SCOREP_Definitions_NewString( name );
+    }
+    CuAssert( tc, "hash table did not grow", entry->hash_table_mask > initial_mask );
+
+    uint32_t counter = entry->counter;
+    CuAssert( tc, "cache returned a different handle after growth",
+              cached == SCOREP_Definitions_NewString( "cached" ) );
+    CuAssert( tc, "cache returned a different handle after growth",
+              cached == SCOREP_Definitions_NewString( "cached" ) );
+    CuAssert( tc, "manager returned a different handle after growth",
+              cached == scorep_definitions_new_string( &scorep_local_definition_manager, "cached" ) );
+    CuAssert( tc, "other thread got a different handle after growth",
+              cached == define_string_in_new_thread() );
+    CuAssertStrEquals( tc, "cached", SCOREP_StringHandle_Get( cached ) );
+    CuAssertIntEquals( tc, counter, entry->counter );
+
+    /* Callpaths are not hashed by the local manager, only the cache
+     * avoids duplicates */
+    SCOREP_RegionHandle region = SCOREP_Definitions_NewRegion( "region",
+                                                               NULL,
+                                                               SCOREP_INVALID_SOURCE_FILE,
+                                                               SCOREP_INVALID_LINE_NO,
+                                                               SCOREP_INVALID_LINE_NO,
+                                                               SCOREP_PARADIGM_USER,
+                                                               SCOREP_REGION_FUNCTION );
+    SCOREP_CallpathHandle callpath = SCOREP_Definitions_NewCallpath( SCOREP_INVALID_CALLPATH,
+                                                                     region, 0, NULL );
+    CuAssert( tc, "cache returned a different callpath",
+              callpath == SCOREP_Definitions_NewCallpath( SCOREP_INVALID_CALLPATH,
+                                                          region, 0, NULL ) );
+    SCOREP_CallpathHandle parent = callpath;
+    for ( int i = 0; i < 5000; i++ )
+    {
+        parent = SCOREP_Definitions_NewCallpath( parent, region, 0, NULL );
+    }
+    SCOREP_CallpathHandle again = SCOREP_Definitions_NewCallpath( SCOREP_INVALID_CALLPATH,
+                                                                  region, 0, NULL );
+    SCOREP_CallpathDef* definition = SCOREP_LOCAL_HANDLE_DEREF( again, Callpath );
+    CuAssert( tc, "wrong callpath after eviction", definition->region_handle == region );
+    CuAssert( tc, "wrong callpath after eviction",
+              definition->parent_callpath_handle == SCOREP_INVALID_CALLPATH );
+
+    measurement_finalize();
+}
+
+
+static void
+test_lookup_during_growth( CuTest* tc )
+{
+    measurement_initialize();
+
+    scorep_definitions_manager_entry* entry           = &scorep_local_definition_manager.string;
+    uint32_t                          initial_mask    = entry->hash_table_mask;
+    uint32_t                          initial_counter = entry->counter;
+    int                               num_strings     = 10000;
+    int                               checked_growths = 0;
+    SCOREP_StringHandle*              handles         = calloc( num_strings, sizeof( *handles ) );
+    CuAssertPtrNotNull( tc, handles );
+
+    char name[ 32 ];
+    for ( int i = 0; i < num_strings; i++ )
+    {
+        sprintf( name, "string_%d", i );
+        handles[ i ] = scorep_definitions_new_string( &scorep_local_definition_manager, name );
+
+        /* While the chains are moved into the grown table, all strings need
+         * to be found in one of the two tables. */
+        if ( entry->old_hash_table == NULL )
+        {
+            continue;
+        }
+        checked_growths++;
+        for ( int j = 0; j <= i; j++ )
+        {
+            sprintf( name, "string_%d", j );
+            CuAssert( tc, "string not found while the hash table grows",
+                      handles[ j ] == scorep_definitions_new_string( &scorep_local_definition_manager, name ) );
+        }
+    }
+
+    CuAssert( tc, "hash table did not grow", entry->hash_table_mask > initial_mask );
+    CuAssert( tc, "no lookup during growth", checked_growths > 0 );
+    CuAssertIntEquals( tc, initial_counter + num_strings, entry->counter );
+
+    /* And all are found after the growth */
+    for ( int i = 0; i < num_strings; i++ )
+    {
+        sprintf( name, "string_%d", i );
+        CuAssert( tc, "string not found after the hash table grew",
+                  handles[ i ] == scorep_definitions_new_string( &scorep_local_definition_manager, name ) );
+    }
+    CuAssertIntEquals( tc, initial_counter + num_strings, entry->counter );
+
+    free( handles );
+    measurement_finalize();
+}
+
+
 int
 main()
 {
@@ -261,6 +512,12 @@ main()
     CuSuite*  suite  = CuSuiteNew( "definition manager" );
 
     SUITE_ADD_TEST_NAME( suite, test_1, "string definitions" );
+    SUITE_ADD_TEST_NAME( suite, test_concurrent_definitions,
+                         "concurrent definitions without duplicates" );
+    SUITE_ADD_TEST_NAME( suite, test_lookup_caches,
+                         "lookup caches agree with the manager" );
+    SUITE_ADD_TEST_NAME( suite, test_lookup_during_growth,
+                         "lookups while the hash table grows" );
 
     CuSuiteRun( suite );
 
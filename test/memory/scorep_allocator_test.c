@@ -497,6 +497,165 @@ allocator_test_18( CuTest* tc )
 }
 
 
+void
+allocator_test_19( CuTest* tc )
+{
+    uint32_t total_mem = 16 * 4096;
+    uint32_t max_mem   = 256 * 4096;
+    uint32_t page_size = 4096;
+
+    SCOREP_Allocator_Allocator* allocator
+        = SCOREP_Allocator_CreateGrowableAllocator( &total_mem, &max_mem, &page_size, 0, 0, 0 );
+    CuAssertPtrNotNull( tc, allocator );
+    CuAssert( tc, "initial memory below limit", total_mem < max_mem );
+    CuAssertIntEquals( tc, total_mem / page_size,
+                       SCOREP_Allocator_GetNumberOfCommittedPages( allocator ) );
+
+    SCOREP_Allocator_PageManager* page_manager
+        = SCOREP_Allocator_CreatePageManager( allocator );
+    CuAssertPtrNotNull( tc, page_manager );
+
+    /* exceed the initial memory, the first allocation survives the growth */
+    SCOREP_Allocator_MovableMemory first
+        = SCOREP_Allocator_AllocMovable( page_manager, 64 );
+    CuAssert( tc, "valid movable memory", first != 0 );
+    memset( SCOREP_Allocator_GetAddressFromMovableMemory( page_manager, first ), 0x5a, 64 );
+
+    uint32_t i;
+    for ( i = 0; i < 64; i++ )
+    {
+        void* memory = SCOREP_Allocator_Alloc( page_manager, page_size );
+        CuAssertPtrNotNullMsg( tc, "grows beyond initial memory", memory );
+        memset( memory, 0xa5, page_size );
+    }
+    CuAssert( tc, "committed more pages",
+              SCOREP_Allocator_GetNumberOfCommittedPages( allocator ) > total_mem / page_size );
+
+    unsigned char* first_memory
+        = SCOREP_Allocator_GetAddressFromMovableMemory( page_manager, first );
+    CuAssertIntEquals( tc, 0x5a, first_memory[ 0 ] );
+    CuAssertIntEquals( tc, 0x5a, first_memory[ 63 ] );
+
+    /* the limit is a hard one */
+    void* memory = SCOREP_Allocator_Alloc( page_manager, max_mem );
+    CuAssertPtrEquals( tc, 0, memory );
+
+    SCOREP_Allocator_DeletePageManager( page_manager );
+    SCOREP_Allocator_DeleteAllocator( allocator );
+}
+
+
+/* pages used by page managers, i.e., without maintenance pages */
+static uint32_t
+get_used_pages( SCOREP_Allocator_Allocator* allocator )
+{
+    SCOREP_Allocator_PageManagerStats page_stats;
+    SCOREP_Allocator_PageManagerStats maint_stats;
+    memset( &page_stats, 0, sizeof( page_stats ) );
+    memset( &maint_stats, 0, sizeof( maint_stats ) );
+    SCOREP_Allocator_GetStats( allocator, &page_stats, &maint_stats );
+    return page_stats.pages_used - maint_stats.pages_allocated;
+}
+
+
+void
+allocator_test_20( CuTest* tc )
+{
+    uint32_t total_mem = 32 * 512;
+    uint32_t page_size = 512;
+
+    SCOREP_Allocator_Allocator* allocator
+        = SCOREP_Allocator_CreateAllocator( &total_mem, &page_size, 0, 0, 0 );
+    CuAssertPtrNotNull( tc, allocator );
+    CuAssertIntEquals( tc, 0, get_used_pages( allocator ) );
+
+    /* takes one page and caches three */
+    SCOREP_Allocator_PageManager* page_manager
+        = SCOREP_Allocator_CreateCachedPageManager( allocator, 4 );
+    CuAssertPtrNotNull( tc, page_manager );
+    CuAssertIntEquals( tc, 1, get_used_pages( allocator ) );
+
+    SCOREP_Allocator_PageManagerStats stats;
+    memset( &stats, 0, sizeof( stats ) );
+    SCOREP_Allocator_GetPageManagerStats( page_manager, &stats );
+    CuAssertIntEquals( tc, 4, stats.pages_allocated );
+
+    /* three more pages come from the cache */
+    for ( int i = 0; i < 4; i++ )
+    {
+        void* memory = SCOREP_Allocator_Alloc( page_manager, page_size );
+        CuAssertPtrNotNull( tc, memory );
+    }
+    CuAssertIntEquals( tc, 4, get_used_pages( allocator ) );
+
+    /* freed pages stay in the cache, but are not used anymore */
+    SCOREP_Allocator_Free( page_manager );
+    CuAssertIntEquals( tc, 0, get_used_pages( allocator ) );
+
+    void* memory = SCOREP_Allocator_Alloc( page_manager, page_size );
+    CuAssertPtrNotNull( tc, memory );
+    CuAssertIntEquals( tc, 1, get_used_pages( allocator ) );
+
+    SCOREP_Allocator_DeletePageManager( page_manager );
+    CuAssertIntEquals( tc, 0, get_used_pages( allocator ) );
+
+    SCOREP_Allocator_DeleteAllocator( allocator );
+}
+
+
+void
+allocator_test_21( CuTest* tc )
+{
+    uint32_t total_mem = 32 * 512;
+    uint32_t page_size = 512;
+
+    SCOREP_Allocator_Allocator* allocator
+        = SCOREP_Allocator_CreateAllocator( &total_mem, &page_size, 0, 0, 0 );
+    CuAssertPtrNotNull( tc, allocator );
+
+    SCOREP_Allocator_PageManager* destination
+        = SCOREP_Allocator_CreatePageManager( allocator );
+    SCOREP_Allocator_PageManager* source
+        = SCOREP_Allocator_CreatePageManager( allocator );
+    CuAssertPtrNotNull( tc, destination );
+    CuAssertPtrNotNull( tc, source );
+
+    SCOREP_Allocator_MovableMemory kept
+        = SCOREP_Allocator_AllocMovable( destination, 64 );
+    SCOREP_Allocator_MovableMemory moved
+        = SCOREP_Allocator_AllocMovable( source, 64 );
+    CuAssert( tc, "valid movable memory", kept != 0 && moved != 0 );
+    memset( SCOREP_Allocator_GetAddressFromMovableMemory( source, moved ), 0x5a, 64 );
+    for ( int i = 0; i < 3; i++ )
+    {
+        CuAssertPtrNotNull( tc, SCOREP_Allocator_Alloc( source, page_size ) );
+    }
+    CuAssertIntEquals( tc, 1, SCOREP_Allocator_GetNumberOfUsedPages( destination ) );
+    CuAssertIntEquals( tc, 4, SCOREP_Allocator_GetNumberOfUsedPages( source ) );
+    uint32_t used_pages = get_used_pages( allocator );
+
+    SCOREP_Allocator_MovePages( destination, source );
+    CuAssertIntEquals( tc, 5, SCOREP_Allocator_GetNumberOfUsedPages( destination ) );
+    CuAssertIntEquals( tc, 0, SCOREP_Allocator_GetNumberOfUsedPages( source ) );
+    CuAssertIntEquals( tc, used_pages, get_used_pages( allocator ) );
+
+    unsigned char* moved_memory
+        = SCOREP_Allocator_GetAddressFromMovableMemory( destination, moved );
+    CuAssertIntEquals( tc, 0x5a, moved_memory[ 0 ] );
+    CuAssertIntEquals( tc, 0x5a, moved_memory[ 63 ] );
+
+    /* the source can still be used */
+    CuAssertPtrNotNull( tc, SCOREP_Allocator_Alloc( source, 64 ) );
+    CuAssertIntEquals( tc, 1, SCOREP_Allocator_GetNumberOfUsedPages( source ) );
+
+    SCOREP_Allocator_DeletePageManager( source );
+    SCOREP_Allocator_DeletePageManager( destination );
+    CuAssertIntEquals( tc, 0, get_used_pages( allocator ) );
+
+    SCOREP_Allocator_DeleteAllocator( allocator );
+}
+
+
 int
 main()
 {
@@ -532,6 +691,12 @@ main()
                          "min page size 512" );
     SUITE_ADD_TEST_NAME( suite, allocator_test_18,
                          "big pages" );
+    SUITE_ADD_TEST_NAME( suite, allocator_test_19,
+                         "growable memory" );
+    SUITE_ADD_TEST_NAME( suite, allocator_test_20,
+                         "page cache" );
+    SUITE_ADD_TEST_NAME( suite, allocator_test_21,
+                         "move pages" );
 
     CuSuiteRun( suite );
     CuSuiteSummary( suite, output );
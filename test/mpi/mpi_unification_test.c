@@ -0,0 +1,78 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Defines regions with long names, which are shared by all ranks, by the
+ * even ranks, or are only known to one rank, plus some short names. Every
+ * rank defines them in a different order, thus their local handles differ
+ * from the unified ones. run_mpi_unification_test.sh checks the unified
+ * definitions and the region of every event.
+ */
+
+
+#include <config.h>
+#include <stdio.h>
+#include <mpi.h>
+#include <scorep/SCOREP_User.h>
+
+#define NUMBER_OF_SHARED_REGIONS 64
+#define NUMBER_OF_OWN_REGIONS    16
+
+static void
+visit( const char* name )
+{
+    SCOREP_USER_REGION_BY_NAME_BEGIN( name, SCOREP_USER_REGION_TYPE_COMMON )
+    SCOREP_USER_REGION_BY_NAME_END( name )
+}
+
+int
+main( int    argc,
+      char** argv )
+{
+    int  rank, size;
+    char name[ 128 ];
+
+    MPI_Init( &argc, &argv );
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+    MPI_Comm_size( MPI_COMM_WORLD, &size );
+
+    for ( int i = 0; i < NUMBER_OF_OWN_REGIONS; i++ )
+    {
+        sprintf( name, "mpi_unification_test_region_of_rank_%d_%02d", rank, i );
+        visit( name );
+    }
+
+    /* Start at a different region on every rank */
+    for ( int i = 0; i < NUMBER_OF_SHARED_REGIONS; i++ )
+    {
+        int region = ( i + 7 * rank ) % NUMBER_OF_SHARED_REGIONS;
+        sprintf( name, "mpi_unification_test_region_shared_by_all_ranks_%02d", region );
+        visit( name );
+        if ( rank % 2 == 0 && region % 4 == 0 )
+        {
+            sprintf( name, "mpi_unification_test_region_shared_by_even_ranks_%02d", region );
+            visit( name );
+        }
+        if ( region % 8 == 0 )
+        {
+            /* Not exchanged as digest */
+            sprintf( name, "short_%02d", region );
+            visit( name );
+        }
+    }
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Tests the futex states of UTILS_Mutex and its contended path in the
+ * 'spin' and 'adaptive' modes.
+ */
+
+#include <config.h>
+
+#include <UTILS_Mutex.h>
+
+#include <CuTest.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define NUM_THREADS    8
+#define NUM_INCREMENTS 10000
+
+static UTILS_Mutex       counter_mutex;
+static uint64_t          counter;
+static pthread_barrier_t barrier;
+
+
+typedef struct contention_stats
+{
+    const UTILS_Mutex* mutex;
+    bool               found;
+    uint64_t           contended;
+    uint64_t           parked;
+} contention_stats;
+
+
+static void
+find_contention( const UTILS_Mutex* mutex,
+                 uint64_t           contended,
+                 uint64_t           parked,
+                 void*              arg )
+{
+    contention_stats* stats = arg;
+    if ( mutex == stats->mutex )
+    {
+        stats->found     = true;
+        stats->contended = contended;
+        stats->parked    = parked;
+    }
+}
+
+
+static contention_stats
+get_contention( const UTILS_Mutex* mutex )
+{
+    contention_stats stats = { mutex, false, 0, 0 };
+    UTILS_MutexForEachContended( find_contention, &stats );
+    return stats;
+}
+
+
+static void*
+increment_counter( void* arg )
+{
+    pthread_barrier_wait( &barrier );
+    for ( int i = 0; i < NUM_INCREMENTS; i++ )
+    {
+        UTILS_MutexLock( &counter_mutex );
+        /* Not atomic, lost updates show a broken mutual exclusion */
+        uint64_t value = counter;
+        if ( i % 64 == 0 )
+        {
+            sched_yield();
+        }
+        counter = value + 1;
+        UTILS_MutexUnlock( &counter_mutex );
+    }
+    return NULL;
+}
+
+
+static void
+run_contended_increments( CuTest* tc )
+{
+    pthread_t threads[ NUM_THREADS ];
+
+    counter = 0;
+    pthread_barrier_init( &barrier, NULL, NUM_THREADS );
+    for ( int i = 0; i < NUM_THREADS; i++ )
+    {
+        pthread_create( &threads[ i ], NULL, increment_counter, NULL );
+    }
+    for ( int i = 0; i < NUM_THREADS; i++ )
+    {
+        pthread_join( threads[ i ], NULL );
+    }
+    pthread_barrier_destroy( &barrier );
+
+    CuAssertIntEquals( tc, NUM_THREADS * NUM_INCREMENTS, ( int )counter );
+    CuAssertIntEquals( tc, 0, ( int )counter_mutex );
+}
+
+
+static void
+test_states( CuTest* tc )
+{
+    UTILS_Mutex mutex = UTILS_MUTEX_INIT;
+
+    UTILS_MutexLock( &mutex );
+    CuAssertIntEquals( tc, 1, ( int )mutex );
+    CuAssert( tc, "locked mutex acquired", !UTILS_MutexTrylock( &mutex ) );
+    UTILS_MutexUnlock( &mutex );
+    CuAssertIntEquals( tc, 0, ( int )mutex );
+
+    CuAssert( tc, "unlocked mutex not acquired", UTILS_MutexTrylock( &mutex ) );
+    CuAssertIntEquals( tc, 1, ( int )mutex );
+
+    /* Unlocking the parked state wakes nobody, but needs to unlock */
+    mutex = 2;
+    UTILS_MutexUnlock( &mutex );
+    CuAssertIntEquals( tc, 0, ( int )mutex );
+}
+
+
+static void
+test_spin( CuTest* tc )
+{
+    UTILS_MutexConfigure( UTILS_MUTEX_MODE_SPIN, 1000, true );
+    run_contended_increments( tc );
+
+    contention_stats stats = get_contention( &counter_mutex );
+    CuAssert( tc, "contention not counted", stats.found && stats.contended > 0 );
+    CuAssertIntEquals( tc, 0, ( int )stats.parked );
+}
+
+
+static void
+test_adaptive( CuTest* tc )
+{
+    contention_stats before = get_contention( &counter_mutex );
+
+    UTILS_MutexConfigure( UTILS_MUTEX_MODE_ADAPTIVE, 10, true );
+    run_contended_increments( tc );
+
+    contention_stats after = get_contention( &counter_mutex );
+    CuAssert( tc, "contention not counted", after.contended > before.contended );
+}
+
+
+static void*
+lock_and_unlock( void* arg )
+{
+    UTILS_MutexLock( arg );
+    counter++;
+    UTILS_MutexUnlock( arg );
+    return NULL;
+}
+
+
+static void
+test_park_and_wake( CuTest* tc )
+{
+    static UTILS_Mutex mutex;
+    pthread_t          threads[ NUM_THREADS ];
+
+    /* Without spinning, every waiter parks immediately */
+    UTILS_MutexConfigure( UTILS_MUTEX_MODE_ADAPTIVE, 0, true );
+
+    counter = 0;
+    UTILS_MutexLock( &mutex );
+    for ( int i = 0; i < NUM_THREADS; i++ )
+    {
+        pthread_create( &threads[ i ], NULL, lock_and_unlock, &mutex );
+    }
+
+    /* Waiters mark the mutex before they park */
+    while ( UTILS_Atomic_LoadN_uint32( &mutex, UTILS_ATOMIC_ACQUIRE ) != 2 )
+    {
+        sched_yield();
+    }
+    UTILS_MutexUnlock( &mutex );
+
+    /* Each unlock of the parked state wakes the next waiter */
+    for ( int i = 0; i < NUM_THREADS; i++ )
+    {
+        pthread_join( threads[ i ], NULL );
+    }
+
+    CuAssertIntEquals( tc, NUM_THREADS, ( int )counter );
+    CuAssertIntEquals( tc, 0, ( int )mutex );
+    contention_stats stats = get_contention( &mutex );
+    CuAssert( tc, "parking not counted", stats.found && stats.parked > 0 );
+}
+
+
+static void
+test_no_statistics( CuTest* tc )
+{
+    static UTILS_Mutex mutex;
+    pthread_t          thread;
+
+    UTILS_MutexConfigure( UTILS_MUTEX_MODE_ADAPTIVE, 0, false );
+
+    counter = 0;
+    UTILS_MutexLock( &mutex );
+    pthread_create( &thread, NULL, lock_and_unlock, &mutex );
+    while ( UTILS_Atomic_LoadN_uint32( &mutex, UTILS_ATOMIC_ACQUIRE ) != 2 )
+    {
+        sched_yield();
+    }
+    UTILS_MutexUnlock( &mutex );
+    pthread_join( thread, NULL );
+
+    CuAssertIntEquals( tc, 1, ( int )counter );
+    CuAssert( tc, "contention counted", !get_contention( &mutex ).found );
+}
+
+
+int
+main()
+{
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "UTILS_Mutex" );
+
+    SUITE_ADD_TEST_NAME( suite, test_states, "lock states" );
+    SUITE_ADD_TEST_NAME( suite, test_no_statistics, "no statistics unless requested" );
+    SUITE_ADD_TEST_NAME( suite, test_spin, "contended lock in spin mode" );
+    SUITE_ADD_TEST_NAME( suite, test_adaptive, "contended lock in adaptive mode" );
+    SUITE_ADD_TEST_NAME( suite, test_park_and_wake, "parked waiters are woken" );
+
+    CuSuiteRun( suite );
+    CuSuiteSummary( suite, output );
+
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
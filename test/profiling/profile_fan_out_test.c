@@ -0,0 +1,73 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+
+/**
+ * @ file
+ *
+ * @brief Tests the profile call tree for a node with many children, some of
+ *        which exceed the depth limitation.
+ *
+ * main calls NUM_LEAVES different regions repeatedly, thus the children of
+ * main are looked up via the child index. Every eighth of them recurses
+ * beyond the depth limit, which results in collapse nodes.
+ */
+
+#include <config.h>
+
+#include <scorep/SCOREP_User.h>
+
+#include <stdio.h>
+
+#define NUM_LEAVES 64
+#define NUM_CALLS  10
+
+void
+deep( int depth )
+{
+    SCOREP_USER_FUNC_BEGIN();
+
+    if ( depth < 10 )
+    {
+        deep( depth + 1 );
+    }
+
+    SCOREP_USER_FUNC_END();
+}
+
+int
+main()
+{
+    char names[ NUM_LEAVES ][ 16 ];
+    for ( int i = 0; i < NUM_LEAVES; i++ )
+    {
+        sprintf( names[ i ], "leaf_%02d", i );
+    }
+
+    SCOREP_USER_FUNC_BEGIN();
+
+    for ( int call = 0; call < NUM_CALLS; call++ )
+    {
+        for ( int i = 0; i < NUM_LEAVES; i++ )
+        {
+            SCOREP_USER_REGION_BY_NAME_BEGIN( names[ i ], SCOREP_USER_REGION_TYPE_COMMON );
+            if ( i % 8 == 0 )
+            {
+                deep( 0 );
+            }
+            SCOREP_USER_REGION_BY_NAME_END( names[ i ] );
+        }
+    }
+
+    SCOREP_USER_FUNC_END();
+    return 0;
+}
@@ -0,0 +1,292 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Forschungszentrum Juelich GmbH, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Tests the source code location lookup without the measurement system:
+ * call sites and functions of this executable, which is built with debug
+ * information, are resolved to their known file, line, and function.
+ * Several threads race on the first lookup, which loads the executable's
+ * libbfd image and builds its indexes, and resolve the same addresses
+ * concurrently afterwards.
+ */
+
+
+#include <config.h>
+
+#include <CuTest.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include <SCOREP_Memory.h>
+#include <SCOREP_RuntimeManagement.h>
+
+#include <SCOREP_Addr2line.h>
+
+
+#define NUMBER_OF_THREADS 8
+#define NUMBER_OF_LOOKUPS 10000
+
+
+/* Provided by the measurement system otherwise */
+const char*
+SCOREP_GetExecutableName( bool* executableNameIsFile )
+{
+    static char executable[ PATH_MAX ];
+    if ( executable[ 0 ] == '\0' )
+    {
+        ssize_t length = readlink( "/proc/self/exe", executable, sizeof( executable ) - 1 );
+        if ( length < 0 )
+        {
+            length = 0;
+        }
+        executable[ length ] = '\0';
+    }
+    *executableNameIsFile = true;
+    return executable;
+}
+
+
+void*
+SCOREP_Memory_AllocForMisc( size_t size )
+{
+    return malloc( size );
+}
+
+
+void*
+SCOREP_Memory_AlignedAllocForMisc( size_t alignment,
+                                   size_t size )
+{
+    void* memory = NULL;
+    if ( posix_memalign( &memory, alignment, size ) != 0 )
+    {
+        return NULL;
+    }
+    return memory;
+}
+
+
+/* A call site of this executable and its known source code location */
+typedef struct
+{
+    uintptr_t program_counter;
+    unsigned  line_no;
+} call_site;
+
+
+static __attribute__( ( noinline ) ) uintptr_t
+get_return_address( void )
+{
+    return ( uintptr_t )__builtin_return_address( 0 );
+}
+
+
+static __attribute__( ( noinline ) ) void
+known_location( call_site* first, call_site* second )
+{
+    /* Each call and its line need to stay on the same line */
+    first->program_counter = get_return_address(); first->line_no = __LINE__;
+    second->program_counter = get_return_address(); second->line_no = __LINE__;
+
+    first->program_counter  = SCOREP_Addr2line_ConvertRetAddr2PrgCntAddr( first->program_counter );
+    second->program_counter = SCOREP_Addr2line_ConvertRetAddr2PrgCntAddr( second->program_counter );
+}
+
+
+static bool
+ends_with( const char* string, const char* suffix )
+{
+    size_t string_length = strlen( string );
+    size_t suffix_length = strlen( suffix );
+    return string_length >= suffix_length
+           && strcmp( string + string_length - suffix_length, suffix ) == 0;
+}
+
+
+typedef struct
+{
+    uintptr_t    program_counter;
+    bool         found;
+    const char*  file_name;
+    const char*  function_name;
+    unsigned int line_no;
+    uint32_t     differing_lookups;
+} thread_result;
+
+
+static pthread_barrier_t barrier;
+
+
+static void*
+lookup_thread( void* arg )
+{
+    thread_result* result = arg;
+    void*          so_handle;
+    const char*    so_file_name;
+    uintptr_t      so_base_addr;
+    uint16_t       so_token;
+
+    /* all threads race on loading the image */
+    pthread_barrier_wait( &barrier );
+
+    SCOREP_Addr2line_LookupAddr( result->program_counter,
+                                 &so_handle, &so_file_name, &so_base_addr, &so_token,
+                                 &result->found,
+                                 &result->file_name,
+                                 &result->function_name,
+                                 &result->line_no );
+
+    for ( uint32_t i = 0; i < NUMBER_OF_LOOKUPS; i++ )
+    {
+        bool         found;
+        const char*  file_name;
+        const char*  function_name;
+        unsigned int line_no;
+        SCOREP_Addr2line_LookupAddr( result->program_counter,
+                                     &so_handle, &so_file_name, &so_base_addr, &so_token,
+                                     &found, &file_name, &function_name, &line_no );
+        if ( found != result->found
+             || file_name != result->file_name
+             || function_name != result->function_name
+             || line_no != result->line_no )
+        {
+            result->differing_lookups++;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void
+test_concurrent_lookups( CuTest* tc )
+{
+    call_site first;
+    call_site second;
+    known_location( &first, &second );
+
+    pthread_t     threads[ NUMBER_OF_THREADS ];
+    thread_result results[ NUMBER_OF_THREADS ];
+    memset( results, 0, sizeof( results ) );
+
+    pthread_barrier_init( &barrier, NULL, NUMBER_OF_THREADS );
+    for ( uint32_t t = 0; t < NUMBER_OF_THREADS; t++ )
+    {
+        results[ t ].program_counter = t % 2 ? second.program_counter : first.program_counter;
+        CuAssertIntEquals( tc, 0, pthread_create( &threads[ t ], NULL, lookup_thread, &results[ t ] ) );
+    }
+    for ( uint32_t t = 0; t < NUMBER_OF_THREADS; t++ )
+    {
+        pthread_join( threads[ t ], NULL );
+    }
+    pthread_barrier_destroy( &barrier );
+
+    for ( uint32_t t = 0; t < NUMBER_OF_THREADS; t++ )
+    {
+        CuAssertIntEquals( tc, 0, results[ t ].differing_lookups );
+        CuAssertTrue( tc, results[ t ].found );
+        CuAssertTrue( tc, ends_with( results[ t ].file_name, "addr2line_test.c" ) );
+        CuAssertStrEquals( tc, "known_location", results[ t ].function_name );
+        CuAssertIntEquals( tc, t % 2 ? second.line_no : first.line_no, results[ t ].line_no );
+    }
+}
+
+
+static void
+test_call_sites( CuTest* tc )
+{
+    call_site first;
+    call_site second;
+    known_location( &first, &second );
+
+    void*        so_handle;
+    const char*  so_file_name;
+    uintptr_t    so_base_addr;
+    uint16_t     so_token;
+    bool         found_begin;
+    bool         found_end;
+    const char*  file_name;
+    const char*  function_name;
+    unsigned int begin_line_no;
+    unsigned int end_line_no;
+    SCOREP_Addr2line_LookupAddrRange( first.program_counter,
+                                      second.program_counter,
+                                      &so_handle, &so_file_name, &so_base_addr, &so_token,
+                                      &found_begin, &found_end,
+                                      &file_name, &function_name,
+                                      &begin_line_no, &end_line_no );
+    CuAssertPtrNotNull( tc, so_handle );
+    CuAssertIntEquals( tc, SCOREP_ADDR2LINE_LT_OBJECT_TOKEN, so_token );
+    CuAssertTrue( tc, found_begin );
+    CuAssertTrue( tc, found_end );
+    CuAssertTrue( tc, ends_with( file_name, "addr2line_test.c" ) );
+    CuAssertStrEquals( tc, "known_location", function_name );
+    CuAssertIntEquals( tc, first.line_no, begin_line_no );
+    CuAssertIntEquals( tc, second.line_no, end_line_no );
+
+    /* The entry of a function resolves to the function itself */
+    uintptr_t   function_addr = ( uintptr_t )&known_location;
+    const char* name          = NULL;
+    SCOREP_Addr2line_LookupSo( function_addr,
+                               &so_handle, &so_file_name, &so_base_addr, &so_token );
+    CuAssertPtrNotNull( tc, so_handle );
+    CuAssertTrue( tc, SCOREP_Addr2line_SoLookupFunctionName( function_addr - so_base_addr,
+                                                             so_handle, &name ) );
+    CuAssertStrEquals( tc, "known_location", name );
+
+    bool         found;
+    unsigned int line_no;
+    SCOREP_Addr2line_SoLookupAddr( function_addr - so_base_addr, so_handle,
+                                   &so_file_name, &so_token,
+                                   &found, &file_name, &function_name, &line_no );
+    CuAssertTrue( tc, found );
+    CuAssertTrue( tc, ends_with( file_name, "addr2line_test.c" ) );
+    CuAssertStrEquals( tc, "known_location", function_name );
+    /* the line of the function's signature or opening brace */
+    CuAssertTrue( tc, line_no > 0 && line_no < first.line_no );
+}
+
+
+int
+main()
+{
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "addr2line" );
+
+    SCOREP_Addr2line_Initialize();
+
+    /* first, to race on loading the image */
+    SUITE_ADD_TEST_NAME( suite, test_concurrent_lookups, "concurrent lookups" );
+    SUITE_ADD_TEST_NAME( suite, test_call_sites, "known call sites" );
+
+    CuSuiteRun( suite );
+    CuSuiteSummary( suite, output );
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    SCOREP_Addr2line_Finalize();
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Tests the per-thread timer interrupt generator without the measurement
+ * system: every thread creates its own timer and burns CPU time, the samples
+ * are counted per thread by a replacement of SCOREP_Sample. Every thread
+ * needs to get its own samples, and threads without a timer none. SIGPROF
+ * needs to stay free for the itimer and perf interrupt generators.
+ */
+
+
+#include <config.h>
+
+#include <CuTest.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <SCOREP_InMeasurement.h>
+#include <SCOREP_Definitions.h>
+#include <SCOREP_Events.h>
+
+#include "SCOREP_Sampling.h"
+
+#if HAVE( SAMPLING_THREAD_TIMER )
+
+#define NUMBER_OF_THREADS 4
+/* In micro seconds */
+#define SAMPLING_PERIOD 1000
+/* CPU time each thread burns, in micro seconds */
+#define BURN_TIME 200000
+
+extern const scorep_sampling_interrupt_generator scorep_sampling_interrupt_generator_thread_timer;
+
+/* Provided by the measurement system and the sampling service otherwise */
+THREAD_LOCAL_STORAGE_SPECIFIER volatile sig_atomic_t scorep_in_measurement
+THREAD_LOCAL_STORAGE_MODEL( "initial-exec" ) = 0;
+THREAD_LOCAL_STORAGE_SPECIFIER volatile sig_atomic_t scorep_in_signal_context
+THREAD_LOCAL_STORAGE_MODEL( "initial-exec" ) = 0;
+THREAD_LOCAL_STORAGE_SPECIFIER volatile sig_atomic_t scorep_sampling_is_known_pthread = SCOREP_SAMPLING_UNKNOWN_THREAD;
+
+#define INTERRUPT_GENERATOR_HANDLE ( ( SCOREP_InterruptGeneratorHandle )42 )
+
+static THREAD_LOCAL_STORAGE_SPECIFIER volatile sig_atomic_t samples_of_this_thread;
+static volatile sig_atomic_t                                samples_with_wrong_handle;
+
+
+SCOREP_InterruptGeneratorHandle
+SCOREP_Definitions_NewInterruptGenerator( const char*                   name,
+                                          SCOREP_InterruptGeneratorMode mode,
+                                          SCOREP_MetricBase             base,
+                                          int64_t                       exponent,
+                                          uint64_t                      period )
+{
+    return INTERRUPT_GENERATOR_HANDLE;
+}
+
+
+void
+SCOREP_Sample( SCOREP_InterruptGeneratorHandle interruptGeneratorHandle,
+               void*                           contextPtr )
+{
+    if ( interruptGeneratorHandle != INTERRUPT_GENERATOR_HANDLE )
+    {
+        samples_with_wrong_handle++;
+    }
+    samples_of_this_thread++;
+}
+
+
+static uint64_t
+get_thread_cpu_time( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &now );
+    return ( uint64_t )now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+
+typedef struct
+{
+    scorep_sampling_interrupt_generator_definition definition;
+    uint64_t                                       samples;
+    uint64_t                                       samples_while_disabled;
+} thread_result;
+
+
+static void*
+sampled_thread( void* arg )
+{
+    thread_result*                       result = arg;
+    scorep_sampling_single_location_data sampling_data;
+    memset( &sampling_data, 0, sizeof( sampling_data ) );
+
+    scorep_sampling_is_known_pthread = SCOREP_SAMPLING_ENABLED_THREAD;
+    scorep_sampling_interrupt_generator_thread_timer.create_interrupt_generator( &sampling_data,
+                                                                                  result->definition );
+
+    volatile uint64_t work  = 0;
+    uint64_t          start = get_thread_cpu_time();
+    while ( get_thread_cpu_time() - start < BURN_TIME )
+    {
+        work++;
+    }
+
+    scorep_sampling_interrupt_generator_thread_timer.disable_interrupt_generator( &sampling_data );
+    result->samples = samples_of_this_thread;
+
+    start = get_thread_cpu_time();
+    while ( get_thread_cpu_time() - start < BURN_TIME / 10 )
+    {
+        work++;
+    }
+    result->samples_while_disabled = samples_of_this_thread - result->samples;
+
+    scorep_sampling_interrupt_generator_thread_timer.finalize_interrupt_generator( &sampling_data );
+
+    return NULL;
+}
+
+
+static void
+test_samples_per_thread( CuTest* tc )
+{
+    scorep_sampling_interrupt_generator_definition definition;
+    memset( &definition, 0, sizeof( definition ) );
+    definition.type   = SCOREP_SAMPLING_TRIGGER_THREAD_TIMER;
+    definition.event  = "timer";
+    definition.period = SAMPLING_PERIOD;
+
+    scorep_sampling_interrupt_generator_thread_timer.initialize_interrupt_generator( definition );
+
+    /* The itimer and perf generators use SIGPROF */
+    struct sigaction prof_action;
+    sigaction( SIGPROF, NULL, &prof_action );
+    CuAssertTrue( tc, !( prof_action.sa_flags & SA_SIGINFO ) );
+    CuAssertTrue( tc, prof_action.sa_handler == SIG_DFL );
+
+    pthread_t     threads[ NUMBER_OF_THREADS ];
+    thread_result results[ NUMBER_OF_THREADS ];
+    memset( results, 0, sizeof( results ) );
+    for ( int i = 0; i < NUMBER_OF_THREADS; i++ )
+    {
+        results[ i ].definition = definition;
+        CuAssertIntEquals( tc, 0, pthread_create( &threads[ i ], NULL, sampled_thread, &results[ i ] ) );
+    }
+
+    /* This thread has no timer, it burns CPU time concurrently */
+    volatile uint64_t work  = 0;
+    uint64_t          start = get_thread_cpu_time();
+    while ( get_thread_cpu_time() - start < BURN_TIME / 2 )
+    {
+        work++;
+    }
+
+    for ( int i = 0; i < NUMBER_OF_THREADS; i++ )
+    {
+        pthread_join( threads[ i ], NULL );
+    }
+
+    CuAssertIntEquals( tc, 0, samples_of_this_thread );
+    CuAssertIntEquals( tc, 0, samples_with_wrong_handle );
+    for ( int i = 0; i < NUMBER_OF_THREADS; i++ )
+    {
+        /* The kernel checks CPU-time timers only at scheduler ticks and
+           merges expirations into one signal, thus not every period fires */
+        CuAssertTrue( tc, results[ i ].samples > 0 );
+        CuAssertTrue( tc, results[ i ].samples <= BURN_TIME / SAMPLING_PERIOD );
+        CuAssertTrue( tc, results[ i ].samples_while_disabled == 0 );
+    }
+}
+
+#endif /* HAVE( SAMPLING_THREAD_TIMER ) */
+
+
+int
+main()
+{
+#if !HAVE( SAMPLING_THREAD_TIMER )
+    /* skipped */
+    return 77;
+#else
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "thread timer sampling" );
+
+    SUITE_ADD_TEST_NAME( suite, test_samples_per_thread, "samples per thread" );
+
+    CuSuiteRun( suite );
+    CuSuiteSummary( suite, output );
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+#endif /* HAVE( SAMPLING_THREAD_TIMER ) */
+}
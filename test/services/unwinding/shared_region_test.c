@@ -0,0 +1,208 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ */
+
+
+/**
+ * @file
+ *
+ * Tests the process-wide index of function ranges without the measurement
+ * system: all threads race to insert the same functions, each in a different
+ * order, and look up functions while others insert them. Every function needs
+ * to be published exactly once, thus all threads get the same entry for it,
+ * and a lookup never sees an incomplete entry.
+ */
+
+
+#include <config.h>
+
+#include <CuTest.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <SCOREP_Memory.h>
+#include <UTILS_Atomic.h>
+
+#include "scorep_unwinding_region.h"
+
+
+#define NUMBER_OF_THREADS   8
+/* A power of 2, the insertion orders below are permutations of it */
+#define NUMBER_OF_FUNCTIONS 4096
+
+#define FUNCTION_START( i ) ( ( uint64_t )0x10000 + ( uint64_t )( i ) * 0x100 )
+#define FUNCTION_END( i )   ( FUNCTION_START( i ) + 0x80 )
+
+
+/* Number of published entries, each one needs exactly one allocation */
+static uint64_t number_of_allocations;
+
+
+/* Provided by the measurement system otherwise */
+void*
+SCOREP_Location_AllocForMisc( SCOREP_Location* locationData,
+                              size_t           size )
+{
+    UTILS_Atomic_AddFetch_uint64( &number_of_allocations, 1, UTILS_ATOMIC_RELAXED );
+    return malloc( size );
+}
+
+
+static pthread_barrier_t barrier;
+
+typedef struct
+{
+    uint32_t    id;
+    /* The name of each function as found by this thread after inserting it */
+    const char* entries[ NUMBER_OF_FUNCTIONS ];
+    /* Lookups of other functions which returned wrong data */
+    uint32_t    wrong_lookups;
+} thread_result;
+
+
+static bool
+check_lookup( uint64_t addr,
+              uint32_t function )
+{
+    uint64_t    start;
+    uint64_t    end;
+    const char* name;
+    if ( !scorep_unwinding_shared_region_find( addr, &start, &end, &name ) )
+    {
+        /* not inserted yet */
+        return true;
+    }
+
+    char expected[ 32 ];
+    sprintf( expected, "function_%04u", function );
+    return start == FUNCTION_START( function )
+           && end == FUNCTION_END( function )
+           && strcmp( name, expected ) == 0;
+}
+
+
+static void*
+racing_thread( void* arg )
+{
+    thread_result*                   result = arg;
+    SCOREP_Unwinding_CpuLocationData unwind_data;
+    memset( &unwind_data, 0, sizeof( unwind_data ) );
+
+    /* Odd strides are coprime to NUMBER_OF_FUNCTIONS, thus every thread
+       inserts all functions, but in its own order */
+    uint32_t stride = 2 * result->id + 1;
+    uint32_t offset = 97 * result->id;
+
+    pthread_barrier_wait( &barrier );
+
+    for ( uint32_t i = 0; i < NUMBER_OF_FUNCTIONS; i++ )
+    {
+        uint32_t function = ( offset + i * stride ) % NUMBER_OF_FUNCTIONS;
+        char     name[ 32 ];
+        sprintf( name, "function_%04u", function );
+        scorep_unwinding_shared_region_insert( &unwind_data,
+                                               FUNCTION_START( function ),
+                                               FUNCTION_END( function ),
+                                               name );
+
+        uint64_t    start;
+        uint64_t    end;
+        const char* entry = NULL;
+        if ( scorep_unwinding_shared_region_find( FUNCTION_START( function ) + 0x10,
+                                                  &start, &end, &entry ) )
+        {
+            result->entries[ function ] = entry;
+        }
+
+        /* A function which may be inserted concurrently by another thread */
+        uint32_t other = ( function + NUMBER_OF_FUNCTIONS / 2 + result->id ) % NUMBER_OF_FUNCTIONS;
+        if ( !check_lookup( FUNCTION_START( other ) + 0x7f, other ) )
+        {
+            result->wrong_lookups++;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void
+test_racing_inserts( CuTest* tc )
+{
+    pthread_t     threads[ NUMBER_OF_THREADS ];
+    thread_result results[ NUMBER_OF_THREADS ];
+    memset( results, 0, sizeof( results ) );
+
+    pthread_barrier_init( &barrier, NULL, NUMBER_OF_THREADS );
+    for ( uint32_t t = 0; t < NUMBER_OF_THREADS; t++ )
+    {
+        results[ t ].id = t;
+        CuAssertIntEquals( tc, 0, pthread_create( &threads[ t ], NULL, racing_thread, &results[ t ] ) );
+    }
+    for ( uint32_t t = 0; t < NUMBER_OF_THREADS; t++ )
+    {
+        pthread_join( threads[ t ], NULL );
+    }
+    pthread_barrier_destroy( &barrier );
+
+    /* No function was published twice */
+    CuAssertIntEquals( tc, NUMBER_OF_FUNCTIONS, ( int )number_of_allocations );
+    for ( uint32_t t = 0; t < NUMBER_OF_THREADS; t++ )
+    {
+        CuAssertIntEquals( tc, 0, results[ t ].wrong_lookups );
+    }
+
+    for ( uint32_t function = 0; function < NUMBER_OF_FUNCTIONS; function++ )
+    {
+        /* Found directly after its insertion, and the same entry for all */
+        CuAssertPtrNotNull( tc, results[ 0 ].entries[ function ] );
+        for ( uint32_t t = 1; t < NUMBER_OF_THREADS; t++ )
+        {
+            CuAssertPtrEquals( tc, ( void* )results[ 0 ].entries[ function ],
+                               ( void* )results[ t ].entries[ function ] );
+        }
+
+        CuAssertTrue( tc, check_lookup( FUNCTION_START( function ), function ) );
+        CuAssertTrue( tc, check_lookup( FUNCTION_END( function ) - 1, function ) );
+
+        uint64_t    start;
+        uint64_t    end;
+        const char* name;
+        /* Between two functions */
+        CuAssertTrue( tc, !scorep_unwinding_shared_region_find( FUNCTION_END( function ),
+                                                                &start, &end, &name ) );
+    }
+}
+
+
+int
+main()
+{
+    CuUseColors();
+    CuString* output = CuStringNew();
+    CuSuite*  suite  = CuSuiteNew( "shared unwinding regions" );
+
+    SUITE_ADD_TEST_NAME( suite, test_racing_inserts, "racing inserts" );
+
+    CuSuiteRun( suite );
+    CuSuiteSummary( suite, output );
+    int failCount = suite->failCount;
+    if ( failCount )
+    {
+        printf( "%s", output->buffer );
+    }
+
+    CuSuiteFree( suite );
+    CuStringFree( output );
+
+    return failCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
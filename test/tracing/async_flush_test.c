@@ -0,0 +1,43 @@
+/*
+ * This file is part of the Score-P software (http://www.score-p.org)
+ *
+ * Copyright (c) 2024,
+ * Technische Universitaet Dresden, Germany
+ *
+ * This software may be modified and distributed under the terms of
+ * a BSD-style license.  See the COPYING file in the package base
+ * directory for details.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Records enough events to fill the trace buffer of the location several
+ * times, see run_async_flush_test.sh.
+ */
+
+#include <config.h>
+
+#include <scorep/SCOREP_User.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ITERATIONS 200000
+
+int
+main( int argc, char* argv[] )
+{
+    SCOREP_USER_REGION_DEFINE( foo )
+
+    for ( int i = 0; i < ITERATIONS; i++ )
+    {
+        SCOREP_USER_REGION_BEGIN( foo, "foo", SCOREP_USER_REGION_TYPE_COMMON )
+        SCOREP_USER_REGION_END( foo )
+    }
+
+    printf( "%d\n", ITERATIONS );
+
+    return 0;
+}
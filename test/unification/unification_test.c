@@ -7,7 +7,7 @@
  * Copyright (c) 2009-2013,
  * Gesellschaft fuer numerische Simulation mbH Braunschweig, Germany
  *
- * Copyright (c) 2009-2013, 2015, 2022,
+ * Copyright (c) 2009-2013, 2015, 2022, 2024,
  * Technische Universitaet Dresden, Germany
  *
  * Copyright (c) 2009-2013,
@@ -46,6 +46,7 @@
 #include <SCOREP_RuntimeManagement.h>
 #include <SCOREP_Definitions.h>
 #include <SCOREP_Memory.h>
+#include <scorep_unify.h>
 
 /* *INDENT-OFF* */
 void init_definition_manager(CuTest* tc, SCOREP_DefinitionManager** manager, bool allocHashTables);
@@ -137,6 +138,169 @@ test_1( CuTest* tc )
 //);
 
 
+/* Enough string, region, and callpath definitions to unify concurrently */
+static void
+define_many_definitions( void )
+{
+    char                    name[ 32 ];
+    SCOREP_SourceFileHandle files[ 16 ];
+    for ( int i = 0; i < 16; i++ )
+    {
+        sprintf( name, "file_%d.c", i );
+        files[ i ] = SCOREP_Definitions_NewSourceFile( name );
+    }
+
+    SCOREP_RegionHandle regions[ 1024 ];
+    for ( int i = 0; i < 1024; i++ )
+    {
+        /* Every fourth region is a duplicate of the previous one */
+        sprintf( name, "region_%d", i - ( i % 4 == 3 ) );
+        regions[ i ] = SCOREP_Definitions_NewRegion( name,
+                                                     NULL,
+                                                     files[ ( i - ( i % 4 == 3 ) ) % 16 ],
+                                                     i - ( i % 4 == 3 ),
+                                                     i - ( i % 4 == 3 ),
+                                                     SCOREP_PARADIGM_USER,
+                                                     SCOREP_REGION_FUNCTION );
+    }
+
+    for ( int i = 0; i < 2048; i++ )
+    {
+        sprintf( name, "string_%d", i );
+        SCOREP_Definitions_NewString( name );
+    }
+
+    /* Chains of callpaths, every region is called from several parents */
+    SCOREP_CallpathHandle parent = SCOREP_INVALID_CALLPATH;
+    for ( int i = 0; i < 2048; i++ )
+    {
+        if ( i % 8 == 0 )
+        {
+            parent = SCOREP_INVALID_CALLPATH;
+        }
+        parent = SCOREP_Definitions_NewCallpath( parent, regions[ ( i * 7 ) % 1024 ], 0, NULL );
+    }
+}
+
+
+/* Appends @a value to the result array @a result of size @a size */
+static void
+append_result( uint32_t** result,
+               size_t*    size,
+               uint32_t   value )
+{
+    if ( ( *size & 1023 ) == 0 )
+    {
+        *result = realloc( *result, ( *size + 1024 ) * sizeof( **result ) );
+        assert( *result );
+    }
+    ( *result )[ ( *size )++ ] = value;
+}
+
+
+/* Unifies the local definitions with @a numberOfThreads threads into a new
+ * unified definition manager, 0 uses the number SCOREP_CopyDefinitionsToUnified()
+ * chooses. Returns the number of unified definitions and the mappings of all
+ * types. */
+static uint32_t*
+unify_local_definitions( CuTest*  tc,
+                         uint32_t numberOfThreads,
+                         size_t*  size )
+{
+    /* memory leak, like in test_1 */
+    scorep_unified_definition_manager = NULL;
+    init_definition_manager( tc, &scorep_unified_definition_manager, true );
+
+    /* Strings already unified are skipped, see scorep_definitions_unify_string() */
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_BEGIN( &scorep_local_definition_manager, String, string )
+    {
+        definition->unified = SCOREP_INVALID_STRING;
+    }
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_END();
+
+    if ( numberOfThreads == 0 )
+    {
+        SCOREP_CopyDefinitionsToUnified( &scorep_local_definition_manager );
+    }
+    else
+    {
+        scorep_unify_copy_definitions( &scorep_local_definition_manager, numberOfThreads );
+    }
+    SCOREP_CreateDefinitionMappings( &scorep_local_definition_manager );
+    SCOREP_AssignDefinitionMappingsFromUnified( &scorep_local_definition_manager );
+
+    uint32_t* result = NULL;
+    *size = 0;
+
+    #define DEF_WITH_MAPPING( Type, type ) \
+    append_result( &result, size, scorep_unified_definition_manager->type.counter ); \
+    for ( uint32_t i = 0; i < scorep_local_definition_manager.type.counter; i++ ) \
+    { \
+        append_result( &result, size, scorep_local_definition_manager.type.mapping[ i ] ); \
+    }
+    SCOREP_LIST_OF_DEFS_WITH_MAPPINGS
+    #undef DEF_WITH_MAPPING
+
+    /* The unified definitions reference the unified ones of the local references */
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_BEGIN( &scorep_local_definition_manager, String, string )
+    {
+        CuAssertStrEquals( tc, definition->string_data,
+                           SCOREP_UNIFIED_HANDLE_DEREF( definition->unified, String )->string_data );
+    }
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_END();
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_BEGIN( &scorep_local_definition_manager, Region, region )
+    {
+        SCOREP_RegionDef* unified = SCOREP_UNIFIED_HANDLE_DEREF( definition->unified, Region );
+        CuAssert( tc, "unified region has a different name",
+                  unified->name_handle == SCOREP_LOCAL_HANDLE_DEREF( definition->name_handle, String )->unified );
+        CuAssertIntEquals( tc, definition->begin_line, unified->begin_line );
+    }
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_END();
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_BEGIN( &scorep_local_definition_manager, Callpath, callpath )
+    {
+        SCOREP_CallpathDef* unified = SCOREP_UNIFIED_HANDLE_DEREF( definition->unified, Callpath );
+        CuAssert( tc, "unified callpath has a different region",
+                  unified->region_handle == SCOREP_LOCAL_HANDLE_DEREF( definition->region_handle, Region )->unified );
+        CuAssert( tc, "unified callpath has a different parent",
+                  definition->parent_callpath_handle == SCOREP_INVALID_CALLPATH
+                  ? unified->parent_callpath_handle == SCOREP_INVALID_CALLPATH
+                  : unified->parent_callpath_handle == SCOREP_LOCAL_HANDLE_DEREF( definition->parent_callpath_handle, Callpath )->unified );
+    }
+    SCOREP_DEFINITIONS_MANAGER_FOREACH_DEFINITION_END();
+
+    SCOREP_DestroyDefinitionMappings( &scorep_local_definition_manager );
+
+    return result;
+}
+
+
+void
+test_parallel_unification( CuTest* tc )
+{
+    define_many_definitions();
+
+    size_t    serial_size;
+    uint32_t* serial = unify_local_definitions( tc, 1, &serial_size );
+
+    /* The concurrent unification needs to give the same unified definitions
+     * in the same order, try several times to catch races. The first run
+     * lets the unification decide, it is concurrent on a multi-core system,
+     * as there are more definitions than UNIFY_PARALLEL_THRESHOLD. */
+    for ( int run = 0; run < 8; run++ )
+    {
+        size_t    concurrent_size;
+        uint32_t* concurrent = unify_local_definitions( tc, run == 0 ? 0 : 4, &concurrent_size );
+        CuAssertIntEquals( tc, serial_size, concurrent_size );
+        CuAssert( tc, "concurrent unification differs from the serial one",
+                  memcmp( serial, concurrent, serial_size * sizeof( *serial ) ) == 0 );
+        free( concurrent );
+    }
+
+    free( serial );
+    scorep_unified_definition_manager = NULL;
+}
+
+
 void
 init_definition_manager( CuTest*                    tc,
                          SCOREP_DefinitionManager** manager,
@@ -159,6 +323,7 @@ main()
     CuSuite*  suite  = CuSuiteNew( "unification" );
 
     SUITE_ADD_TEST_NAME( suite, test_1, "simple string unification" );
+    SUITE_ADD_TEST_NAME( suite, test_parallel_unification, "concurrent unification" );
 
     SCOREP_InitMeasurement();
 